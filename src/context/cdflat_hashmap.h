@@ -0,0 +1,427 @@
+/*********************                                                        */
+/*! \file cdflat_hashmap.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Context-dependent hashmap in a flat open-addressed table
+ **
+ ** Context-dependent hashmap with the interface of CDHashMap, kept in one
+ ** flat open-addressed table instead of one ContextObj per element.
+ **
+ ** The elements live in a vector, in the order they were inserted; the
+ ** table holds (element index, hash) pairs and is probed linearly.  The
+ ** map itself is the only ContextObj: saving it records the number of
+ ** elements and the length of a trail of overwritten values, and
+ ** restoring it undoes the overwrites and drops the elements inserted
+ ** since.  So an insertion costs no allocation beyond the amortized
+ ** growth of two vectors, and a pop costs one virtual call per map
+ ** rather than one per element.
+ **
+ ** See also:
+ **  CDHashMap : A fully featured CD hash map. (The closest to <ext/hash_map>)
+ **  CDInsertHashMap : An "insert-once" CD hash map.
+ **  CDTrailHashMap : A lightweight CD hash map with poor iteration
+ **    characteristics and some quirks in usage.
+ **
+ ** Notes:
+ ** - operator[], insert(), insertAtContextLevelZero(), find(), count()
+ **   and iteration behave as for CDHashMap, except that operator[]
+ **   returns its Element by value (it refers back into the map).
+ ** - Elements are iterated over in insertion order, those inserted with
+ **   insertAtContextLevelZero() first.
+ ** - Any insertion may invalidate iterators and Elements.
+ ** - TNode keys are fine: popping an element never looks at its key.
+ ** - As for CDHashMap, clear() is not undone by a pop, and there is no
+ **   erase().
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__CONTEXT__CDFLAT_HASHMAP_H
+#define __CVC4__CONTEXT__CDFLAT_HASHMAP_H
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/cvc4_assert.h"
+#include "base/output.h"
+#include "context/context.h"
+#include "context/cdflat_hashmap_forward.h"
+
+namespace CVC4 {
+namespace context {
+
+template <class Key, class Data, class HashFcn>
+class CDFlatHashMap : public ContextObj {
+public:
+  typedef std::pair<const Key, Data> value_type;
+
+private:
+  /** A reference to an element: its index, tagged with PINNED if it is
+   * one of the elements inserted at context level zero. */
+  typedef uint32_t Ref;
+
+  static const Ref EMPTY = 0xffffffff;
+  static const Ref PINNED = 0x80000000;
+
+  /** A slot of the open-addressed table. */
+  struct Slot {
+    Ref d_ref;
+    uint32_t d_hash;
+  };/* struct CDFlatHashMap<>::Slot */
+
+  /** The table; its size is a power of two, and at most half full. */
+  std::vector<Slot> d_table;
+
+  /** The shift taking a hash to its home slot. */
+  unsigned d_shift;
+
+  /** The elements, in insertion order. */
+  std::vector<value_type> d_elements;
+
+  /** The hashes of d_elements. */
+  std::vector<uint32_t> d_hashes;
+
+  /** The elements inserted with insertAtContextLevelZero(). */
+  std::vector<value_type> d_pinned;
+
+  /** The trail of values overwritten since level zero. */
+  std::vector<std::pair<Ref, Data> > d_overwritten;
+
+  /** The number of elements when this map was last saved. */
+  size_t d_scopeElements;
+
+  /** In a saved copy: the size of d_elements. */
+  size_t d_savedElements;
+
+  /** In a saved copy: the size of d_overwritten. */
+  size_t d_savedOverwritten;
+
+  /**
+   * Private copy constructor used only by save().  Only the sizes are
+   * copied; the table and the elements stay with the map.
+   */
+  CDFlatHashMap(const CDFlatHashMap& m) :
+    ContextObj(m),
+    d_shift(0),
+    d_scopeElements(m.d_scopeElements),
+    d_savedElements(m.d_elements.size()),
+    d_savedOverwritten(m.d_overwritten.size()) {
+  }
+  CDFlatHashMap& operator=(const CDFlatHashMap&) CVC4_UNDEFINED;
+
+  ContextObj* save(ContextMemoryManager* pCMM) override
+  {
+    ContextObj* data = new(pCMM) CDFlatHashMap(*this);
+    d_scopeElements = d_elements.size();
+    return data;
+  }
+
+  void restore(ContextObj* data) override
+  {
+    CDFlatHashMap* saved = static_cast<CDFlatHashMap*>(data);
+    Debug("CDFlatHashMap") << "restore " << this << " level "
+                           << getContext()->getLevel() << " from "
+                           << d_elements.size() << " to "
+                           << saved->d_savedElements << " elements"
+                           << std::endl;
+    while(d_overwritten.size() > saved->d_savedOverwritten) {
+      getElement(d_overwritten.back().first).second =
+          d_overwritten.back().second;
+      d_overwritten.pop_back();
+    }
+    while(d_elements.size() > saved->d_savedElements) {
+      removeFromTable(d_elements.size() - 1, d_hashes.back());
+      d_elements.pop_back();
+      d_hashes.pop_back();
+    }
+    d_scopeElements = saved->d_scopeElements;
+  }
+
+  static uint32_t mix(size_t h) {
+    return uint32_t((uint64_t(h) * 0x9e3779b97f4a7c15ULL) >> 32);
+  }
+
+  size_t home(uint32_t hash) const { return hash >> d_shift; }
+
+  size_t mask() const { return d_table.size() - 1; }
+
+  value_type& getElement(Ref r) {
+    return (r & PINNED) ? d_pinned[r & ~PINNED] : d_elements[r];
+  }
+
+  const value_type& getElement(Ref r) const {
+    return (r & PINNED) ? d_pinned[r & ~PINNED] : d_elements[r];
+  }
+
+  /** The reference of the element with key k, or EMPTY. */
+  Ref lookup(const Key& k) const {
+    uint32_t hash = mix(HashFcn()(k));
+    for(size_t i = home(hash);; i = (i + 1) & mask()) {
+      const Slot& s = d_table[i];
+      if(s.d_ref == EMPTY) {
+        return EMPTY;
+      }
+      if(s.d_hash == hash && getElement(s.d_ref).first == k) {
+        return s.d_ref;
+      }
+    }
+  }
+
+  void addToTable(Ref r, uint32_t hash) {
+    size_t i = home(hash);
+    while(d_table[i].d_ref != EMPTY) {
+      i = (i + 1) & mask();
+    }
+    d_table[i].d_ref = r;
+    d_table[i].d_hash = hash;
+  }
+
+  /** Remove r from the table, shifting back the rest of its cluster. */
+  void removeFromTable(Ref r, uint32_t hash) {
+    size_t i = home(hash);
+    while(d_table[i].d_ref != r) {
+      i = (i + 1) & mask();
+    }
+    for(size_t j = (i + 1) & mask(); d_table[j].d_ref != EMPTY;
+        j = (j + 1) & mask()) {
+      // move slot j to the hole at i unless its home is in (i, j]
+      size_t h = home(d_table[j].d_hash);
+      if(((j - h) & mask()) >= ((j - i) & mask())) {
+        d_table[i] = d_table[j];
+        i = j;
+      }
+    }
+    d_table[i].d_ref = EMPTY;
+  }
+
+  /** Make room for one more element. */
+  void reserveOne() {
+    size_t n = d_elements.size() + d_pinned.size() + 1;
+    if(__builtin_expect(2 * n <= d_table.size(), true)) {
+      return;
+    }
+    std::vector<Slot> old;
+    old.swap(d_table);
+    Slot empty = { EMPTY, 0 };
+    d_table.assign(old.size() * 2, empty);
+    --d_shift;
+    for(size_t i = 0; i < old.size(); ++i) {
+      if(old[i].d_ref != EMPTY) {
+        addToTable(old[i].d_ref, old[i].d_hash);
+      }
+    }
+  }
+
+  Ref insertNew(const Key& k, const Data& d) {
+    makeCurrent();
+    reserveOne();
+    Ref r = d_elements.size();
+    AlwaysAssert(r < PINNED, "CDFlatHashMap is full");
+    uint32_t hash = mix(HashFcn()(k));
+    d_elements.push_back(value_type(k, d));
+    d_hashes.push_back(hash);
+    addToTable(r, hash);
+    return r;
+  }
+
+  void setData(Ref r, const Data& d) {
+    makeCurrent();
+    // Elements inserted since the last save go away on pop anyway
+    if(getLevel() > 0 && ((r & PINNED) || r < d_scopeElements)) {
+      d_overwritten.push_back(std::make_pair(r, getElement(r).second));
+    }
+    getElement(r).second = d;
+  }
+
+public:
+
+  CDFlatHashMap(Context* context) :
+    ContextObj(context),
+    d_shift(32 - 4),
+    d_scopeElements(0),
+    d_savedElements(0),
+    d_savedOverwritten(0) {
+    Slot empty = { EMPTY, 0 };
+    d_table.assign(16, empty);
+  }
+
+  ~CDFlatHashMap() {
+    destroy();
+  }
+
+  /**
+   * A reference to an element of the map, with the interface of
+   * CDHashMap's elements.
+   */
+  class Element {
+    CDFlatHashMap* d_map;
+    Ref d_ref;
+
+  public:
+    Element(CDFlatHashMap* map, Ref r) : d_map(map), d_ref(r) {}
+
+    const Key& getKey() const { return d_map->getElement(d_ref).first; }
+    const Data& get() const { return d_map->getElement(d_ref).second; }
+    operator Data() const { return get(); }
+
+    void set(const Data& data) { d_map->setData(d_ref, data); }
+    const Data& operator=(const Data& data) {
+      set(data);
+      return get();
+    }
+  };/* class CDFlatHashMap<>::Element */
+
+  /**
+   * Remove every element.  Like CDHashMap::clear(), this is not undone
+   * by a pop.
+   */
+  void clear() {
+    Slot empty = { EMPTY, 0 };
+    d_table.assign(d_table.size(), empty);
+    d_elements.clear();
+    d_hashes.clear();
+    d_pinned.clear();
+    d_overwritten.clear();
+    d_scopeElements = 0;
+  }
+
+  // The usual operators of map
+
+  size_t size() const {
+    return d_elements.size() + d_pinned.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  size_t count(const Key& k) const {
+    return lookup(k) != EMPTY ? 1 : 0;
+  }
+
+  // If a key is not present, a new element is inserted
+  Element operator[](const Key& k) {
+    Ref r = lookup(k);
+    if(r == EMPTY) {
+      r = insertNew(k, Data());
+    }
+    return Element(this, r);
+  }
+
+  bool insert(const Key& k, const Data& d) {
+    Ref r = lookup(k);
+    if(r == EMPTY) {
+      insertNew(k, d);
+      return true;
+    } else {
+      setData(r, d);
+      return false;
+    }
+  }
+
+  /**
+   * Version of insert() that inserts data value d at context level
+   * zero: the key stays in the map on pop, and a later insert() of it
+   * is undone back to d.  See CDHashMap::insertAtContextLevelZero().
+   *
+   * It is an error (checked via AlwaysAssert()) to
+   * insertAtContextLevelZero() a key that already is in the map.
+   */
+  void insertAtContextLevelZero(const Key& k, const Data& d) {
+    AlwaysAssert(lookup(k) == EMPTY);
+    reserveOne();
+    Ref r = PINNED | Ref(d_pinned.size());
+    d_pinned.push_back(value_type(k, d));
+    addToTable(r, mix(HashFcn()(k)));
+  }
+
+  class iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef std::pair<const Key, Data> value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+  private:
+    const CDFlatHashMap* d_map;
+    size_t d_pos;
+
+    const value_type& get() const {
+      size_t pinned = d_map->d_pinned.size();
+      return d_pos < pinned ? d_map->d_pinned[d_pos]
+                            : d_map->d_elements[d_pos - pinned];
+    }
+
+  public:
+
+    iterator(const CDFlatHashMap* map, size_t pos) : d_map(map), d_pos(pos) {}
+
+    // Default constructor
+    iterator() : d_map(NULL), d_pos(0) {}
+
+    // (Dis)equality
+    bool operator==(const iterator& i) const {
+      return d_pos == i.d_pos;
+    }
+    bool operator!=(const iterator& i) const {
+      return d_pos != i.d_pos;
+    }
+
+    // Dereference operators.
+    const value_type& operator*() const { return get(); }
+    const value_type* operator->() const { return &get(); }
+
+    // Prefix increment
+    iterator& operator++() {
+      ++d_pos;
+      return *this;
+    }
+
+    // Postfix increment
+    iterator operator++(int) {
+      iterator i = *this;
+      ++d_pos;
+      return i;
+    }
+  };/* class CDFlatHashMap<>::iterator */
+
+  typedef iterator const_iterator;
+
+  iterator begin() const {
+    return iterator(this, 0);
+  }
+
+  iterator end() const {
+    return iterator(this, size());
+  }
+
+  iterator find(const Key& k) const {
+    Ref r = lookup(k);
+    if(r == EMPTY) {
+      return end();
+    } else if(r & PINNED) {
+      return iterator(this, r & ~PINNED);
+    } else {
+      return iterator(this, d_pinned.size() + r);
+    }
+  }
+
+};/* class CDFlatHashMap<> */
+
+}/* CVC4::context namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__CONTEXT__CDFLAT_HASHMAP_H */
@@ -0,0 +1,38 @@
+/*********************                                                        */
+/*! \file cdflat_hashmap_forward.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief This is a forward declaration header to declare the CDFlatHashMap<>
+ ** template
+ **
+ ** This is a forward declaration header to declare the CDFlatHashMap<>
+ ** template.  It's useful if you want to forward-declare CDFlatHashMap<>
+ ** without including the full cdflat_hashmap.h header, for example, in a
+ ** public header context.
+ **
+ ** For CDFlatHashMap<> in particular, it's difficult to forward-declare it
+ ** yourself, because it has a default template argument.
+ **/
+
+#include "cvc4_public.h"
+
+#ifndef __CVC4__CONTEXT__CDFLAT_HASHMAP_FORWARD_H
+#define __CVC4__CONTEXT__CDFLAT_HASHMAP_FORWARD_H
+
+#include <functional>
+
+namespace CVC4 {
+namespace context {
+template <class Key, class Data, class HashFcn = std::hash<Key> >
+class CDFlatHashMap;
+}  // namespace context
+}  // namespace CVC4
+
+#endif /* __CVC4__CONTEXT__CDFLAT_HASHMAP_FORWARD_H */
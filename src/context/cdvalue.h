@@ -0,0 +1,167 @@
+/*********************                                                        */
+/*! \file cdvalue.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A context-dependent value of primitive type.
+ **
+ ** A context-dependent value of primitive type, saved on an undo log
+ ** rather than copied like a ContextObj.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__CONTEXT__CDVALUE_H
+#define __CVC4__CONTEXT__CDVALUE_H
+
+#include <stdint.h>
+
+#include <cstring>
+#include <type_traits>
+
+#include "context/context.h"
+
+namespace CVC4 {
+namespace context {
+
+/**
+ * The untyped part of a CDValue<T>: the bits of the value and the stamp
+ * of the Scope in which it was last logged.  The value trail of the
+ * Context writes both back on pop().
+ */
+class CDValueBase {
+
+  /** The Context this value belongs to. */
+  Context* d_context;
+
+  /** The bits of the value. */
+  uint64_t d_bits;
+
+  /**
+   * The stamp of the Scope in which the value was last logged, or 0 if
+   * it hasn't been logged in any Scope that is still around.
+   */
+  uint64_t d_stamp;
+
+  friend class Context;
+
+  // disable copy, assignment
+  CDValueBase(const CDValueBase&) CVC4_UNDEFINED;
+  CDValueBase& operator=(const CDValueBase&) CVC4_UNDEFINED;
+
+protected:
+
+  CDValueBase(Context* context, uint64_t bits) :
+    d_context(context),
+    d_bits(bits),
+    d_stamp(0) {
+  }
+
+  ~CDValueBase() {
+    if(d_stamp != 0) {
+      d_context->forgetValue(this);
+    }
+  }
+
+  uint64_t getBits() const { return d_bits; }
+
+  /**
+   * Set the bits, logging the old ones first if this is the first
+   * change in the current Scope.
+   */
+  void setBits(uint64_t bits) {
+    if(__builtin_expect(d_stamp != d_context->d_stamp, false)) {
+      d_context->logValue(this);
+    }
+    d_bits = bits;
+  }
+
+public:
+
+  /** Get the Context this value belongs to. */
+  Context* getContext() const { return d_context; }
+
+};/* class CDValueBase */
+
+/**
+ * A context-dependent value of a primitive type T (an integer, bool,
+ * enumeration or pointer type of at most 64 bits).  It behaves like a
+ * CDO<T>, but the first change in a Scope merely appends (address, old
+ * value) to a flat undo log in the Context, and pop() restores it with
+ * a non-virtual store.  This makes both saving and restoring much
+ * cheaper than for a CDO<T>, which copies itself into context memory
+ * and is restored by a virtual call.
+ *
+ * Like a CDO<T> created with the plain constructor, a CDValue<T> holds
+ * T() at the bottom Scope.  It must not be allocated in context memory.
+ */
+template <class T>
+class CDValue : public CDValueBase {
+
+  static_assert(std::is_scalar<T>::value && sizeof(T) <= sizeof(uint64_t),
+                "CDValue<T> requires a primitive type of at most 64 bits");
+
+  static uint64_t toBits(const T& data) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &data, sizeof(T));
+    return bits;
+  }
+
+public:
+
+  /**
+   * Main constructor - the value is T() in every Scope.
+   */
+  CDValue(Context* context) :
+    CDValueBase(context, toBits(T())) {
+  }
+
+  /**
+   * Constructor from object of type T.  The value is data in the current
+   * Scope; if the Scope is popped, the value reverts to T().
+   */
+  CDValue(Context* context, const T& data) :
+    CDValueBase(context, toBits(T())) {
+    set(data);
+  }
+
+  /**
+   * Set the value in the current Scope.
+   */
+  void set(const T& data) { setBits(toBits(data)); }
+
+  /**
+   * Get the current value.
+   */
+  T get() const {
+    T data;
+    uint64_t bits = getBits();
+    std::memcpy(&data, &bits, sizeof(T));
+    return data;
+  }
+
+  /**
+   * For convenience, define operator T() to be the same as get().
+   */
+  operator T() const { return get(); }
+
+  /**
+   * For convenience, define operator= that takes an object of type T.
+   */
+  CDValue<T>& operator=(const T& data) {
+    set(data);
+    return *this;
+  }
+
+};/* class CDValue */
+
+}/* CVC4::context namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__CONTEXT__CDVALUE_H */
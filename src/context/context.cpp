@@ -20,13 +20,15 @@
 
 #include "base/cvc4_assert.h"
 #include "context/context.h"
+#include "context/cdvalue.h"
 
 
 namespace CVC4 {
 namespace context {
 
 
-Context::Context() : d_pCNOpre(NULL), d_pCNOpost(NULL) {
+Context::Context()
+    : d_pCNOpre(NULL), d_pCNOpost(NULL), d_stamp(0), d_lastStamp(0) {
   // Create new memory manager
   d_pCMM = new ContextMemoryManager();
 
@@ -66,6 +68,11 @@ void Context::push() {
   // Create a new memory region
   d_pCMM->push();
 
+  // Start a new segment of the value trail
+  d_valueTrailLimits.push_back(d_valueTrail.size());
+  d_stampStack.push_back(d_stamp);
+  d_stamp = ++d_lastStamp;
+
   // Create a new top Scope
   d_scopeList.push_back(new(d_pCMM) Scope(this, d_pCMM, getLevel()+1));
 }
@@ -89,7 +96,8 @@ void Context::pop() {
   // Restore the previous Scope
   d_scopeList.pop_back();
 
-  // Restore all objects in the top Scope
+  // Restore all values and objects in the top Scope
+  restoreValues();
   delete pScope;
 
   // Pop the memory region
@@ -116,6 +124,41 @@ void Context::popto(int toLevel) {
 }
 
 
+void Context::logValue(CDValueBase* v) {
+  ValueTrailEntry entry = { v, v->d_bits, v->d_stamp };
+  d_valueTrail.push_back(entry);
+  v->d_stamp = d_stamp;
+}
+
+
+void Context::forgetValue(CDValueBase* v) {
+  // Only entries of Scopes that haven't been popped refer to v
+  for(size_t i = 0; i < d_valueTrail.size(); ++i) {
+    if(d_valueTrail[i].d_value == v) {
+      d_valueTrail[i].d_value = NULL;
+    }
+  }
+}
+
+
+void Context::restoreValues() {
+  size_t limit = d_valueTrailLimits.back();
+  d_valueTrailLimits.pop_back();
+  ValueTrailEntry* begin = d_valueTrail.data() + limit;
+  for(ValueTrailEntry* e = d_valueTrail.data() + d_valueTrail.size();
+      e != begin;) {
+    --e;
+    if(__builtin_expect(e->d_value != NULL, true)) {
+      e->d_value->d_bits = e->d_bits;
+      e->d_value->d_stamp = e->d_stamp;
+    }
+  }
+  d_valueTrail.resize(limit);
+  d_stamp = d_stampStack.back();
+  d_stampStack.pop_back();
+}
+
+
 void Context::addNotifyObjPre(ContextNotifyObj* pCNO) {
   // Insert pCNO at *front* of list
   if(d_pCNOpre != NULL)
@@ -19,6 +19,8 @@
 #ifndef __CVC4__CONTEXT__CONTEXT_H
 #define __CVC4__CONTEXT__CONTEXT_H
 
+#include <stdint.h>
+
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -39,6 +41,7 @@ class Context;
 class Scope;
 class ContextObj;
 class ContextNotifyObj;
+class CDValueBase;
 
 /** Pretty-printing of Contexts (for debugging) */
 std::ostream& operator<<(std::ostream&, const Context&);
@@ -91,6 +94,64 @@ class Context {
    */
   ContextNotifyObj* d_pCNOpost;
 
+  /**
+   * An entry of the value trail: a CDValue and what it held before it
+   * was first changed in some Scope.
+   */
+  struct ValueTrailEntry {
+    CDValueBase* d_value;
+    uint64_t d_bits;
+    uint64_t d_stamp;
+  };/* struct Context::ValueTrailEntry */
+
+  /**
+   * The undo log of the CDValue objects of this context.  Unlike a
+   * ContextObj, a CDValue isn't copied into context memory and
+   * restored by a virtual call; pop() just writes back the old values
+   * logged since the matching push().
+   */
+  std::vector<ValueTrailEntry> d_valueTrail;
+
+  /**
+   * For each Scope above the bottom one, the size of d_valueTrail when
+   * it was pushed.
+   */
+  std::vector<size_t> d_valueTrailLimits;
+
+  /**
+   * The stamp of the current Scope.  Every Scope gets a stamp that is
+   * never reused; a CDValue holding the current stamp has already been
+   * logged in the current Scope.  The bottom Scope, which is never
+   * popped, has stamp 0.
+   */
+  uint64_t d_stamp;
+
+  /**
+   * The stamps of the Scopes below the current one.
+   */
+  std::vector<uint64_t> d_stampStack;
+
+  /**
+   * The last stamp handed out.
+   */
+  uint64_t d_lastStamp;
+
+  /**
+   * Log the value of v before it is changed in the current Scope.
+   */
+  void logValue(CDValueBase* v);
+
+  /**
+   * Remove v, which is being destroyed, from the value trail.
+   */
+  void forgetValue(CDValueBase* v);
+
+  /**
+   * Write back the values logged since the last push().
+   */
+  void restoreValues();
+
+  friend class CDValueBase;
   friend std::ostream& operator<<(std::ostream&, const Context&);
 
   // disable copy, assignment
@@ -15,11 +15,17 @@
  **/
 
 
+#include <algorithm>
 #include <cstdlib>
 #include <vector>
 #include <deque>
+#include <limits>
 #include <new>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif /* _WIN32 */
+
 #ifdef CVC4_VALGRIND
 #include <valgrind/memcheck.h>
 #endif /* CVC4_VALGRIND */
@@ -33,6 +39,59 @@ namespace context {
 
 #ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
 
+char* ContextMemoryManager::allocateChunk(size_t size) {
+  char* chunk;
+#ifndef _WIN32
+  if(size % hugePageBytes == 0) {
+    // Align to huge pages so the kernel can back the chunk with them
+    void* p;
+    if(posix_memalign(&p, hugePageBytes, size) != 0) {
+      throw std::bad_alloc();
+    }
+    chunk = static_cast<char*>(p);
+#ifdef MADV_HUGEPAGE
+    madvise(chunk, size, MADV_HUGEPAGE);
+#endif /* MADV_HUGEPAGE */
+  } else
+#endif /* _WIN32 */
+  {
+    chunk = (char*)malloc(size);
+    if(chunk == NULL) {
+      throw std::bad_alloc();
+    }
+  }
+
+  ++d_statistics.d_chunksAllocated;
+  d_statistics.d_bytesAllocated += size;
+  d_statistics.d_maxBytesAllocated =
+      std::max(d_statistics.d_maxBytesAllocated,
+               d_statistics.d_bytesAllocated);
+
+#ifdef CVC4_VALGRIND
+  VALGRIND_MAKE_MEM_NOACCESS(chunk, size);
+#endif /* CVC4_VALGRIND */
+  return chunk;
+}
+
+
+void ContextMemoryManager::freeChunk(const Chunk& chunk) {
+  free(chunk.d_data);
+  ++d_statistics.d_chunksFreed;
+  d_statistics.d_bytesAllocated -= chunk.d_size;
+}
+
+
+void ContextMemoryManager::recordChunk(size_t size) {
+  size_t level = d_levelBytes.size() - 1;
+  d_levelBytes[level] += size;
+  if(d_levelHighWater.size() <= level) {
+    d_levelHighWater.resize(level + 1, 0);
+  }
+  d_levelHighWater[level] =
+      std::max(d_levelHighWater[level], d_levelBytes[level]);
+}
+
+
 void ContextMemoryManager::newChunk() {
 
   // Increment index to chunk list
@@ -42,38 +101,102 @@ void ContextMemoryManager::newChunk() {
 
   // Create new chunk if no free chunk available
   if(d_freeChunks.empty()) {
-    d_chunkList.push_back((char*)malloc(chunkSizeBytes));
-    if(d_chunkList.back() == NULL) {
-      throw std::bad_alloc();
-    }
+    d_chunkList.push_back(Chunk(allocateChunk(d_chunkSize), d_chunkSize));
 
-#ifdef CVC4_VALGRIND
-    VALGRIND_MAKE_MEM_NOACCESS(d_chunkList.back(), chunkSizeBytes);
-#endif /* CVC4_VALGRIND */
+    // Running out of chunks often: make the next ones bigger
+    if(d_statistics.d_chunksAllocated % chunkGrowthInterval == 0 &&
+       d_chunkSize < maxChunkSizeBytes) {
+      d_chunkSize *= 2;
+    }
   }
   // If there is a free chunk, use that
   else {
     d_chunkList.push_back(d_freeChunks.back());
     d_freeChunks.pop_back();
+    d_freeBytes -= d_chunkList.back().d_size;
+    ++d_statistics.d_chunksReused;
   }
+  recordChunk(d_chunkList.back().d_size);
+
   // Set up the current chunk pointers
-  d_nextFree = d_chunkList.back();
-  d_endChunk = d_nextFree + chunkSizeBytes;
+  d_nextFree = d_chunkList.back().d_data;
+  d_endChunk = d_nextFree + d_chunkList.back().d_size;
 }
 
 
-ContextMemoryManager::ContextMemoryManager() : d_indexChunkList(0) {
-  // Create initial chunk
-  d_chunkList.push_back((char*)malloc(chunkSizeBytes));
-  d_nextFree = d_chunkList.back();
-  if(d_nextFree == NULL) {
-    throw std::bad_alloc();
+void* ContextMemoryManager::newHugeData(size_t size) {
+  ++d_statistics.d_hugeAllocations;
+
+  // Use the smallest free huge chunk that fits, if any
+  size_t best = d_freeHugeChunks.size();
+  for(size_t i = 0; i < d_freeHugeChunks.size(); ++i) {
+    if(d_freeHugeChunks[i].d_size >= size &&
+       (best == d_freeHugeChunks.size() ||
+        d_freeHugeChunks[i].d_size < d_freeHugeChunks[best].d_size)) {
+      best = i;
+    }
+  }
+  if(best < d_freeHugeChunks.size()) {
+    d_hugeChunkList.push_back(d_freeHugeChunks[best]);
+    d_freeHugeChunks[best] = d_freeHugeChunks.back();
+    d_freeHugeChunks.pop_back();
+    d_freeBytes -= d_hugeChunkList.back().d_size;
+    ++d_statistics.d_chunksReused;
+  } else {
+    // Round up to a page, or to a huge page if it is that big anyway
+    size_t granularity = size >= hugePageBytes ? hugePageBytes : 4096;
+    size_t chunkSize = (size + granularity - 1) / granularity * granularity;
+    d_hugeChunkList.push_back(Chunk(allocateChunk(chunkSize), chunkSize));
   }
+  recordChunk(d_hugeChunkList.back().d_size);
+
+  return d_hugeChunkList.back().d_data;
+}
+
+
+void ContextMemoryManager::trimFreeChunks() {
+  if(d_freeBytes <= minRetainedBytes) {
+    return;
+  }
+
+  // Keep what the levels above the current one took at their peak
+  size_t retain = 0;
+  for(size_t level = d_levelBytes.size(); level < d_levelHighWater.size();
+      ++level) {
+    retain += d_levelHighWater[level];
+  }
+  retain = std::min(retain, d_maxRetainedBytes);
+  if(retain < minRetainedBytes) {
+    retain = minRetainedBytes;
+  }
+
+  // Huge chunks are the least likely to fit the next request; drop them first
+  while(d_freeBytes > retain && !d_freeHugeChunks.empty()) {
+    d_freeBytes -= d_freeHugeChunks.back().d_size;
+    freeChunk(d_freeHugeChunks.back());
+    d_freeHugeChunks.pop_back();
+  }
+  while(d_freeBytes > retain && !d_freeChunks.empty()) {
+    d_freeBytes -= d_freeChunks.front().d_size;
+    freeChunk(d_freeChunks.front());
+    d_freeChunks.pop_front();
+  }
+}
+
+
+ContextMemoryManager::ContextMemoryManager()
+    : d_freeBytes(0),
+      d_chunkSize(chunkSizeBytes),
+      d_maxRetainedBytes(std::numeric_limits<size_t>::max()),
+      d_indexChunkList(0),
+      d_levelBytes(1, 0) {
+  // Create initial chunk
+  d_chunkList.push_back(Chunk(allocateChunk(chunkSizeBytes), chunkSizeBytes));
+  d_nextFree = d_chunkList.back().d_data;
   d_endChunk = d_nextFree + chunkSizeBytes;
 
 #ifdef CVC4_VALGRIND
   VALGRIND_CREATE_MEMPOOL(this, 0, false);
-  VALGRIND_MAKE_MEM_NOACCESS(d_nextFree, chunkSizeBytes);
   d_allocations.push_back(std::vector<char*>());
 #endif /* CVC4_VALGRIND */
 }
@@ -84,29 +207,44 @@ ContextMemoryManager::~ContextMemoryManager() {
   VALGRIND_DESTROY_MEMPOOL(this);
 #endif /* CVC4_VALGRIND */
 
+  Debug("context-mm") << "ContextMemoryManager: "
+                      << d_statistics.d_chunksAllocated << " chunks allocated, "
+                      << d_statistics.d_chunksReused << " reused, "
+                      << d_statistics.d_hugeAllocations << " huge, peak "
+                      << d_statistics.d_maxBytesAllocated << " bytes"
+                      << std::endl;
+
   // Delete all chunks
-  while(!d_chunkList.empty()) {
-    free(d_chunkList.back());
-    d_chunkList.pop_back();
+  for(size_t i = 0; i < d_chunkList.size(); ++i) {
+    free(d_chunkList[i].d_data);
   }
-  while(!d_freeChunks.empty()) {
-    free(d_freeChunks.back());
-    d_freeChunks.pop_back();
+  for(size_t i = 0; i < d_freeChunks.size(); ++i) {
+    free(d_freeChunks[i].d_data);
+  }
+  for(size_t i = 0; i < d_hugeChunkList.size(); ++i) {
+    free(d_hugeChunkList[i].d_data);
+  }
+  for(size_t i = 0; i < d_freeHugeChunks.size(); ++i) {
+    free(d_freeHugeChunks[i].d_data);
   }
 }
 
 
 void* ContextMemoryManager::newData(size_t size) {
+  void* res;
   // Use next available free location in current chunk
-  void* res = (void*)d_nextFree;
-  d_nextFree += size;
-  // Check if the request is too big for the chunk
-  if(d_nextFree > d_endChunk) {
+  if(__builtin_expect(size <= size_t(d_endChunk - d_nextFree), true)) {
+    res = (void*)d_nextFree;
+    d_nextFree += size;
+  }
+  // Check if the request is too big for any chunk
+  else if(size > chunkSizeBytes) {
+    res = newHugeData(size);
+  }
+  else {
     newChunk();
     res = (void*)d_nextFree;
     d_nextFree += size;
-    AlwaysAssert(d_nextFree <= d_endChunk,
-                 "Request is bigger than memory chunk size");
   }
   Debug("context") << "ContextMemoryManager::newData(" << size
                    << ") returning " << res << " at level "
@@ -130,6 +268,8 @@ void ContextMemoryManager::push() {
   d_nextFreeStack.push_back(d_nextFree);
   d_endChunkStack.push_back(d_endChunk);
   d_indexChunkListStack.push_back(d_indexChunkList);
+  d_hugeChunkListStack.push_back(d_hugeChunkList.size());
+  d_levelBytes.push_back(0);
 }
 
 
@@ -153,19 +293,31 @@ void ContextMemoryManager::pop() {
   // Free all the new chunks since the last push
   while(d_indexChunkList > d_indexChunkListStack.back()) {
     d_freeChunks.push_back(d_chunkList.back());
+    d_freeBytes += d_chunkList.back().d_size;
 #ifdef CVC4_VALGRIND
-    VALGRIND_MAKE_MEM_NOACCESS(d_chunkList.back(), chunkSizeBytes);
+    VALGRIND_MAKE_MEM_NOACCESS(d_chunkList.back().d_data,
+                               d_chunkList.back().d_size);
 #endif /* CVC4_VALGRIND */
     d_chunkList.pop_back();
     --d_indexChunkList;
   }
   d_indexChunkListStack.pop_back();
 
-  // Delete excess free chunks
-  while(d_freeChunks.size() > maxFreeChunks) {
-    free(d_freeChunks.front());
-    d_freeChunks.pop_front();
+  // ... and the huge ones
+  while(d_hugeChunkList.size() > d_hugeChunkListStack.back()) {
+    d_freeHugeChunks.push_back(d_hugeChunkList.back());
+    d_freeBytes += d_hugeChunkList.back().d_size;
+#ifdef CVC4_VALGRIND
+    VALGRIND_MAKE_MEM_NOACCESS(d_hugeChunkList.back().d_data,
+                               d_hugeChunkList.back().d_size);
+#endif /* CVC4_VALGRIND */
+    d_hugeChunkList.pop_back();
   }
+  d_hugeChunkListStack.pop_back();
+  d_levelBytes.pop_back();
+
+  // Delete excess free chunks
+  trimFreeChunks();
 }
 
 #endif /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
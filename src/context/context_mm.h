@@ -20,6 +20,8 @@
 #ifndef __CVC4__CONTEXT__CONTEXT_MM_H
 #define __CVC4__CONTEXT__CONTEXT_MM_H
 
+#include <stdint.h>
+
 #include <deque>
 #include <limits>
 #include <vector>
@@ -38,29 +40,126 @@ namespace context {
  * stack, and a new current region is created.  A subsequent call to pop
  * releases the new region and restores the top region from the stack.
  *
+ * Memory is carved out of chunks with a bump pointer.  Chunks released by
+ * pop are kept on a free list and handed out again by later regions.  To
+ * keep backtracking-heavy searches away from the system allocator:
+ *
+ *   - chunks get bigger (up to maxChunkSizeBytes) the more of them have to
+ *     be malloc'ed, so a manager that keeps running out settles on fewer,
+ *     larger chunks;
+ *   - requests bigger than chunkSizeBytes get a chunk of their own (a
+ *     "huge" chunk) instead of failing; and
+ *   - the free list is trimmed, on pop, to what the levels above the
+ *     current one needed at their high-water mark (but at least
+ *     minRetainedBytes and at most the limit set by setMaxRetainedBytes()),
+ *     since those are the levels the search is about to push again.
+ *
+ * Chunks whose size is a multiple of hugePageBytes are aligned to it and,
+ * where the platform supports it, advised to be backed by huge pages.
  */
 class ContextMemoryManager {
+ public:
+  /**
+   * Counters of the chunk traffic of a ContextMemoryManager.
+   */
+  struct Statistics {
+    /** number of chunks obtained from the system allocator */
+    uint64_t d_chunksAllocated;
+    /** number of chunks taken from the free list */
+    uint64_t d_chunksReused;
+    /** number of chunks given back to the system allocator */
+    uint64_t d_chunksFreed;
+    /** number of requests that needed a chunk of their own */
+    uint64_t d_hugeAllocations;
+    /** bytes currently obtained from the system allocator */
+    uint64_t d_bytesAllocated;
+    /** maximum of d_bytesAllocated so far */
+    uint64_t d_maxBytesAllocated;
+
+    Statistics()
+        : d_chunksAllocated(0),
+          d_chunksReused(0),
+          d_chunksFreed(0),
+          d_hugeAllocations(0),
+          d_bytesAllocated(0),
+          d_maxBytesAllocated(0)
+    {
+    }
+  };/* struct ContextMemoryManager::Statistics */
 
+ private:
   /**
-   * Memory in regions is allocated in chunks.  This is the chunk size
+   * Memory in regions is allocated in chunks.  This is the size of the
+   * first chunks, and the largest request served from a shared chunk.
    */
-  static const unsigned chunkSizeBytes = 16384;
+  static const size_t chunkSizeBytes = 16384;
 
   /**
-   * A list of free chunks is maintained.  This is the maximum number of
-   * free chunks.
+   * Chunk sizes double every chunkGrowthInterval chunks obtained from the
+   * system allocator, up to this size.
    */
-  static const unsigned maxFreeChunks = 100;
+  static const size_t maxChunkSizeBytes = 2 * 1024 * 1024;
+
+  /**
+   * The number of chunks obtained from the system allocator between two
+   * doublings of the chunk size.
+   */
+  static const unsigned chunkGrowthInterval = 8;
+
+  /**
+   * The free list is never trimmed below this many bytes.
+   */
+  static const size_t minRetainedBytes = 100 * chunkSizeBytes;
+
+  /**
+   * The size of a huge page, and the granularity of huge chunks.
+   */
+  static const size_t hugePageBytes = 2 * 1024 * 1024;
+
+  /**
+   * A chunk of memory and its size.
+   */
+  struct Chunk {
+    char* d_data;
+    size_t d_size;
+    Chunk(char* data, size_t size) : d_data(data), d_size(size) {}
+  };/* struct ContextMemoryManager::Chunk */
 
   /**
    * List of all chunks that are currently active
    */
-  std::vector<char*> d_chunkList;
+  std::vector<Chunk> d_chunkList;
 
   /**
    * Queue of free chunks (for best cache performance, LIFO order is used)
    */
-  std::deque<char*> d_freeChunks;
+  std::deque<Chunk> d_freeChunks;
+
+  /**
+   * List of the huge chunks that are currently active, each holding a
+   * single request.
+   */
+  std::vector<Chunk> d_hugeChunkList;
+
+  /**
+   * Free huge chunks, kept for requests of a similar size.
+   */
+  std::vector<Chunk> d_freeHugeChunks;
+
+  /**
+   * Total size of d_freeChunks and d_freeHugeChunks.
+   */
+  size_t d_freeBytes;
+
+  /**
+   * Size of the next chunk obtained from the system allocator.
+   */
+  size_t d_chunkSize;
+
+  /**
+   * Upper bound on d_freeBytes after a pop.
+   */
+  size_t d_maxRetainedBytes;
 
   /**
    * Pointer to the beginning of available memory in the current chunk in
@@ -97,6 +196,30 @@ class ContextMemoryManager {
    */
   std::vector<unsigned> d_indexChunkListStack;
 
+  /**
+   * Part of the stack of saved regions.  This vector stores the saved size
+   * of d_hugeChunkList.
+   */
+  std::vector<size_t> d_hugeChunkListStack;
+
+  /**
+   * The bytes of chunks taken by each region on the stack (and the current
+   * one) since it was created.
+   */
+  std::vector<size_t> d_levelBytes;
+
+  /**
+   * For each level, the most bytes of chunks any region at that level has
+   * taken.  Its entries beyond the current level are what the free list
+   * retains on pop.
+   */
+  std::vector<size_t> d_levelHighWater;
+
+  /**
+   * Chunk traffic so far.
+   */
+  Statistics d_statistics;
+
   /**
    * Private method to grab a new chunk for the current region.  Uses chunk
    * from d_freeChunks if available.  Creates a new one otherwise.  Sets the
@@ -104,6 +227,33 @@ class ContextMemoryManager {
    */
   void newChunk();
 
+  /**
+   * Private method to serve a request too big for a shared chunk from a
+   * huge chunk of its own.
+   */
+  void* newHugeData(size_t size);
+
+  /**
+   * Obtain a chunk of the given size from the system allocator.
+   */
+  char* allocateChunk(size_t size);
+
+  /**
+   * Give a chunk back to the system allocator.
+   */
+  void freeChunk(const Chunk& chunk);
+
+  /**
+   * Record that the current region took size bytes of chunks.
+   */
+  void recordChunk(size_t size);
+
+  /**
+   * Give free chunks back to the system allocator until no more than
+   * what the levels above the current one need is retained.
+   */
+  void trimFreeChunks();
+
 #ifdef CVC4_VALGRIND
   /**
    * Vector of allocations for each level. Used for accurately marking
@@ -114,10 +264,12 @@ class ContextMemoryManager {
 
  public:
   /**
-   * Get the maximum allocation size for this memory manager.
+   * Get the maximum allocation size for this memory manager.  Requests
+   * bigger than a chunk get a chunk of their own, so there is no limit
+   * beyond that of the system allocator.
    */
   static unsigned getMaxAllocationSize() {
-    return chunkSizeBytes;
+    return std::numeric_limits<unsigned>::max();
   }
 
   /**
@@ -146,6 +298,23 @@ class ContextMemoryManager {
    */
   void pop();
 
+  /**
+   * Set an upper bound on the bytes of free chunks kept after a pop.  It
+   * takes precedence over the high-water marks of the levels, but not
+   * over minRetainedBytes.
+   */
+  void setMaxRetainedBytes(size_t bytes) { d_maxRetainedBytes = bytes; }
+
+  /**
+   * Get the bytes of free chunks currently kept for reuse.
+   */
+  size_t getRetainedBytes() const { return d_freeBytes; }
+
+  /**
+   * Get the chunk traffic of this memory manager so far.
+   */
+  const Statistics& getStatistics() const { return d_statistics; }
+
 };/* class ContextMemoryManager */
 
 #else /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
@@ -51,6 +51,14 @@ void AttributeManager::deleteAllAttributes(NodeValue* nv) {
   deleteFromTable(d_types, nv);
   deleteFromTable(d_strings, nv);
   deleteFromTable(d_ptrs, nv);
+
+  deleteFromTable(d_denseBools, nv);
+  deleteFromTable(d_denseInts, nv);
+  deleteFromTable(d_denseTNodes, nv);
+  deleteFromTable(d_denseNodes, nv);
+  deleteFromTable(d_denseTypes, nv);
+  deleteFromTable(d_denseStrings, nv);
+  deleteFromTable(d_densePtrs, nv);
 }
 
 void AttributeManager::deleteAllAttributes() {
@@ -61,6 +69,14 @@ void AttributeManager::deleteAllAttributes() {
   deleteAllFromTable(d_types);
   deleteAllFromTable(d_strings);
   deleteAllFromTable(d_ptrs);
+
+  deleteAllFromTable(d_denseBools);
+  deleteAllFromTable(d_denseInts);
+  deleteAllFromTable(d_denseTNodes);
+  deleteAllFromTable(d_denseNodes);
+  deleteAllFromTable(d_denseTypes);
+  deleteAllFromTable(d_denseStrings);
+  deleteAllFromTable(d_densePtrs);
 }
 
 void AttributeManager::deleteAttributes(const AttrIdVec& atids) {
@@ -111,6 +127,28 @@ void AttributeManager::deleteAttributes(const AttrIdVec& atids) {
       Unimplemented("CDAttributes cannot be deleted. Contact Tim/Morgan if this behavior is desired.");
       break;
 
+    case AttrTableDenseBool:
+      deleteAttributesFromTable(d_denseBools, ids);
+      break;
+    case AttrTableDenseUInt64:
+      deleteAttributesFromTable(d_denseInts, ids);
+      break;
+    case AttrTableDenseTNode:
+      deleteAttributesFromTable(d_denseTNodes, ids);
+      break;
+    case AttrTableDenseNode:
+      deleteAttributesFromTable(d_denseNodes, ids);
+      break;
+    case AttrTableDenseTypeNode:
+      deleteAttributesFromTable(d_denseTypes, ids);
+      break;
+    case AttrTableDenseString:
+      deleteAttributesFromTable(d_denseStrings, ids);
+      break;
+    case AttrTableDensePointer:
+      deleteAttributesFromTable(d_densePtrs, ids);
+      break;
+
     case LastAttrTable:
     default:
       Unreachable();
@@ -57,6 +57,15 @@ class AttributeManager {
   template <class T>
   void reconstructTable(AttrHash<T>& table);
 
+  template <class T>
+  void deleteFromTable(DenseAttrTable<T>& table, NodeValue* nv);
+
+  template <class T>
+  void deleteAllFromTable(DenseAttrTable<T>& table);
+
+  template <class T>
+  void deleteAttributesFromTable(DenseAttrTable<T>& table, const std::vector<uint64_t>& ids);
+
   /**
    * getTable<> is a helper template that gets the right table from an
    * AttributeManager given its type.
@@ -64,6 +73,13 @@ class AttributeManager {
   template <class T, bool context_dep>
   friend struct getTable;
 
+  /**
+   * getDenseTable<> is the analogue of getTable<> for attribute kinds
+   * declared with DenseAttribute<>.
+   */
+  template <class T>
+  friend struct getDenseTable;
+
   bool d_inGarbageCollection;
 
   void clearDeleteAllAttributesBuffer();
@@ -91,6 +107,21 @@ public:
   /** Underlying hash table for pointer-valued attributes */
   AttrHash<void*> d_ptrs;
 
+  /** Underlying dense table for boolean-valued dense attributes */
+  DenseAttrTable<bool> d_denseBools;
+  /** Underlying dense table for integral-valued dense attributes */
+  DenseAttrTable<uint64_t> d_denseInts;
+  /** Underlying dense table for node-valued dense attributes */
+  DenseAttrTable<TNode> d_denseTNodes;
+  /** Underlying dense table for node-valued dense attributes */
+  DenseAttrTable<Node> d_denseNodes;
+  /** Underlying dense table for type-valued dense attributes */
+  DenseAttrTable<TypeNode> d_denseTypes;
+  /** Underlying dense table for string-valued dense attributes */
+  DenseAttrTable<std::string> d_denseStrings;
+  /** Underlying dense table for pointer-valued dense attributes */
+  DenseAttrTable<void*> d_densePtrs;
+
   /**
    * Get a particular attribute on a particular node.
    *
@@ -300,31 +331,189 @@ struct getTable<const T*, false> {
   }
 };
 
-}/* CVC4::expr::attr namespace */
 
-// ATTRIBUTE MANAGER IMPLEMENTATIONS ===========================================
+/**
+ * The getDenseTable<> template provides (static) access to the
+ * AttributeManager field holding the dense table for a table value
+ * type.
+ */
+template <class T>
+struct getDenseTable;
 
-namespace attr {
+/** Access the "d_denseBools" member of AttributeManager. */
+template <>
+struct getDenseTable<bool> {
+  static const AttrTableId id = AttrTableDenseBool;
+  typedef DenseAttrTable<bool> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_denseBools;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_denseBools;
+  }
+};
 
-// implementation for AttributeManager::getAttribute()
+/** Access the "d_denseInts" member of AttributeManager. */
+template <>
+struct getDenseTable<uint64_t> {
+  static const AttrTableId id = AttrTableDenseUInt64;
+  typedef DenseAttrTable<uint64_t> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_denseInts;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_denseInts;
+  }
+};
+
+/** Access the "d_denseTNodes" member of AttributeManager. */
+template <>
+struct getDenseTable<TNode> {
+  static const AttrTableId id = AttrTableDenseTNode;
+  typedef DenseAttrTable<TNode> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_denseTNodes;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_denseTNodes;
+  }
+};
+
+/** Access the "d_denseNodes" member of AttributeManager. */
+template <>
+struct getDenseTable<Node> {
+  static const AttrTableId id = AttrTableDenseNode;
+  typedef DenseAttrTable<Node> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_denseNodes;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_denseNodes;
+  }
+};
+
+/** Access the "d_denseTypes" member of AttributeManager. */
+template <>
+struct getDenseTable<TypeNode> {
+  static const AttrTableId id = AttrTableDenseTypeNode;
+  typedef DenseAttrTable<TypeNode> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_denseTypes;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_denseTypes;
+  }
+};
+
+/** Access the "d_denseStrings" member of AttributeManager. */
+template <>
+struct getDenseTable<std::string> {
+  static const AttrTableId id = AttrTableDenseString;
+  typedef DenseAttrTable<std::string> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_denseStrings;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_denseStrings;
+  }
+};
+
+/** Access the "d_densePtrs" member of AttributeManager. */
+template <>
+struct getDenseTable<void*> {
+  static const AttrTableId id = AttrTableDensePointer;
+  typedef DenseAttrTable<void*> table_type;
+  static inline table_type& get(AttributeManager& am) {
+    return am.d_densePtrs;
+  }
+  static inline const table_type& get(const AttributeManager& am) {
+    return am.d_densePtrs;
+  }
+};
+
+/**
+ * The AttrStorage<> helper template reads and writes the values of
+ * attribute kind AttrKind in the table of an AttributeManager that
+ * holds them: an AttrHash<> (see getTable<>) or, for kinds declared
+ * with DenseAttribute<>, a DenseAttrTable<> (see getDenseTable<>).
+ */
+template <class AttrKind, bool dense = AttrKind::dense>
+struct AttrStorage {
+  typedef typename AttrKind::value_type value_type;
+  typedef KindValueToTableValueMapping<value_type> mapping;
+  typedef getTable<value_type, AttrKind::context_dependent> table;
+  typedef typename table::table_type table_type;
+
+  static const AttrTableId table_id = table::id;
+
+  static inline bool has(const AttributeManager& am, NodeValue* nv) {
+    const table_type& ah = table::get(am);
+    return !(ah.find(std::make_pair(AttrKind::getId(), nv)) == ah.end());
+  }
+
+  /** Get the value of AttrKind on nv into ret, if nv has one. */
+  static inline bool get(const AttributeManager& am, NodeValue* nv,
+                         value_type& ret) {
+    const table_type& ah = table::get(am);
+    typename table_type::const_iterator i =
+      ah.find(std::make_pair(AttrKind::getId(), nv));
+    if(i == ah.end()) {
+      return false;
+    }
+    ret = mapping::convertBack((*i).second);
+    return true;
+  }
+
+  static inline void set(AttributeManager& am, NodeValue* nv,
+                         const value_type& value) {
+    table::get(am)[std::make_pair(AttrKind::getId(), nv)] =
+      mapping::convert(value);
+  }
+};/* struct AttrStorage<> */
+
+/** Specialization of AttrStorage<> for dense attribute kinds. */
 template <class AttrKind>
-typename AttrKind::value_type
-AttributeManager::getAttribute(NodeValue* nv, const AttrKind&) const {
+struct AttrStorage<AttrKind, true> {
   typedef typename AttrKind::value_type value_type;
   typedef KindValueToTableValueMapping<value_type> mapping;
-  typedef typename getTable<value_type, AttrKind::context_dependent>::
-            table_type table_type;
+  typedef getDenseTable<typename mapping::table_value_type> table;
 
-  const table_type& ah =
-    getTable<value_type, AttrKind::context_dependent>::get(*this);
-  typename table_type::const_iterator i =
-    ah.find(std::make_pair(AttrKind::getId(), nv));
+  static const AttrTableId table_id = table::id;
 
-  if(i == ah.end()) {
-    return typename AttrKind::value_type();
+  static inline bool has(const AttributeManager& am, NodeValue* nv) {
+    return table::get(am).find(AttrKind::getId(), nv) != NULL;
   }
 
-  return mapping::convertBack((*i).second);
+  static inline bool get(const AttributeManager& am, NodeValue* nv,
+                         value_type& ret) {
+    const typename mapping::table_value_type* v =
+      table::get(am).find(AttrKind::getId(), nv);
+    if(v == NULL) {
+      return false;
+    }
+    ret = mapping::convertBack(*v);
+    return true;
+  }
+
+  static inline void set(AttributeManager& am, NodeValue* nv,
+                         const value_type& value) {
+    table::get(am).set(AttrKind::getId(), nv, mapping::convert(value));
+  }
+};/* struct AttrStorage<AttrKind, true> */
+
+}/* CVC4::expr::attr namespace */
+
+// ATTRIBUTE MANAGER IMPLEMENTATIONS ===========================================
+
+namespace attr {
+
+// implementation for AttributeManager::getAttribute()
+template <class AttrKind>
+typename AttrKind::value_type
+AttributeManager::getAttribute(NodeValue* nv, const AttrKind&) const {
+  typename AttrKind::value_type ret = typename AttrKind::value_type();
+  AttrStorage<AttrKind>::get(*this, nv, ret);
+  return ret;
 }
 
 /* Helper template class for hasAttribute(), specialized based on
@@ -352,21 +541,8 @@ struct HasAttribute<true, AttrKind> {
   static inline bool getAttribute(const AttributeManager* am,
                                   NodeValue* nv,
                                   typename AttrKind::value_type& ret) {
-    typedef typename AttrKind::value_type value_type;
-    typedef KindValueToTableValueMapping<value_type> mapping;
-    typedef typename getTable<value_type,
-                              AttrKind::context_dependent>::table_type
-      table_type;
-
-    const table_type& ah =
-      getTable<value_type, AttrKind::context_dependent>::get(*am);
-    typename table_type::const_iterator i =
-      ah.find(std::make_pair(AttrKind::getId(), nv));
-
-    if(i == ah.end()) {
+    if(!AttrStorage<AttrKind>::get(*am, nv, ret)) {
       ret = AttrKind::default_value;
-    } else {
-      ret = mapping::convertBack((*i).second);
     }
 
     return true;
@@ -381,43 +557,13 @@ template <class AttrKind>
 struct HasAttribute<false, AttrKind> {
   static inline bool hasAttribute(const AttributeManager* am,
                                   NodeValue* nv) {
-    typedef typename AttrKind::value_type value_type;
-    //typedef KindValueToTableValueMapping<value_type> mapping;
-    typedef typename getTable<value_type, AttrKind::context_dependent>::
-              table_type table_type;
-
-    const table_type& ah =
-      getTable<value_type, AttrKind::context_dependent>::get(*am);
-    typename table_type::const_iterator i =
-      ah.find(std::make_pair(AttrKind::getId(), nv));
-
-    if(i == ah.end()) {
-      return false;
-    }
-
-    return true;
+    return AttrStorage<AttrKind>::has(*am, nv);
   }
 
   static inline bool getAttribute(const AttributeManager* am,
                                   NodeValue* nv,
                                   typename AttrKind::value_type& ret) {
-    typedef typename AttrKind::value_type value_type;
-    typedef KindValueToTableValueMapping<value_type> mapping;
-    typedef typename getTable<value_type, AttrKind::context_dependent>::
-              table_type table_type;
-
-    const table_type& ah =
-      getTable<value_type, AttrKind::context_dependent>::get(*am);
-    typename table_type::const_iterator i =
-      ah.find(std::make_pair(AttrKind::getId(), nv));
-
-    if(i == ah.end()) {
-      return false;
-    }
-
-    ret = mapping::convertBack((*i).second);
-
-    return true;
+    return AttrStorage<AttrKind>::get(*am, nv, ret);
   }
 };
 
@@ -441,14 +587,7 @@ inline void
 AttributeManager::setAttribute(NodeValue* nv,
                                const AttrKind&,
                                const typename AttrKind::value_type& value) {
-  typedef typename AttrKind::value_type value_type;
-  typedef KindValueToTableValueMapping<value_type> mapping;
-  typedef typename getTable<value_type, AttrKind::context_dependent>::
-            table_type table_type;
-
-  table_type& ah =
-      getTable<value_type, AttrKind::context_dependent>::get(*this);
-  ah[std::make_pair(AttrKind::getId(), nv)] = mapping::convert(value);
+  AttrStorage<AttrKind>::set(*this, nv, value);
 }
 
 /**
@@ -518,9 +657,7 @@ inline void AttributeManager::deleteAllFromTable(AttrHash<T>& table) {
 
 template <class AttrKind>
 AttributeUniqueId AttributeManager::getAttributeId(const AttrKind& attr){
-  typedef typename AttrKind::value_type value_type;
-  AttrTableId tableId = getTable<value_type,
-                                 AttrKind::context_dependent>::id;
+  AttrTableId tableId = AttrStorage<AttrKind>::table_id;
   return AttributeUniqueId(tableId, attr.getId());
 }
 
@@ -569,6 +706,40 @@ void AttributeManager::reconstructTable(AttrHash<T>& table){
   d_inGarbageCollection = false;
 }
 
+/**
+ * Remove the NodeValue from all columns of a dense table, calling the
+ * cleanup function if one is defined.
+ */
+template <class T>
+inline void AttributeManager::deleteFromTable(DenseAttrTable<T>& table,
+                                              NodeValue* nv) {
+  table.erase(nv, DenseAttributeTraits<T>::getCleanup());
+}
+
+/**
+ * Remove all attributes from the dense table calling the cleanup
+ * function if one is defined.
+ */
+template <class T>
+inline void AttributeManager::deleteAllFromTable(DenseAttrTable<T>& table) {
+  Assert(!d_inGarbageCollection);
+  d_inGarbageCollection = true;
+  typedef DenseAttributeTraits<T> traits_t;
+  for(uint64_t id = 0; id < traits_t::getCleanup().size(); ++id) {
+    table.clear(id, traits_t::getCleanup()[id]);
+  }
+  d_inGarbageCollection = false;
+}
+
+template <class T>
+void AttributeManager::deleteAttributesFromTable(DenseAttrTable<T>& table, const std::vector<uint64_t>& ids){
+  d_inGarbageCollection = true;
+  typedef DenseAttributeTraits<T> traits_t;
+  for(std::vector<uint64_t>::const_iterator it = ids.begin(); it != ids.end(); ++it) {
+    table.clear(*it, traits_t::getCleanup()[*it]);
+  }
+  d_inGarbageCollection = false;
+}
 
 }/* CVC4::expr::attr namespace */
 }/* CVC4::expr namespace */
@@ -23,7 +23,9 @@
 #ifndef __CVC4__EXPR__ATTRIBUTE_INTERNALS_H
 #define __CVC4__EXPR__ATTRIBUTE_INTERNALS_H
 
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 namespace CVC4 {
 namespace expr {
@@ -368,6 +370,327 @@ public:
 
 }/* CVC4::expr::attr namespace */
 
+// DENSE ATTRIBUTE TABLES ======================================================
+
+namespace attr {
+
+/**
+ * A "DenseAttrTable<value_type>" is the table underlying attribute
+ * kinds declared with DenseAttribute<>.  Rather than hashing (id, Node)
+ * pairs, it keeps one column per attribute kind, indexed directly by
+ * NodeValue::getId().  Since NodeValue ids are handed out
+ * consecutively, a column is a vector of fixed-size pages, allocated
+ * on first use and freed again once none of their entries is set.
+ *
+ * This pays off for attribute kinds that most live Nodes end up
+ * carrying (types): a lookup is a couple of indexed loads, and an
+ * entry costs sizeof(value_type) plus a bit.  Sparse attribute kinds
+ * are better off in an AttrHash<>; that includes the per-theory
+ * rewrite caches, since each theory only rewrites its own part of
+ * the node pool and a dense column per theory would be mostly empty.
+ */
+template <class value_type>
+class DenseAttrTable {
+public:
+
+  /** log2 of the number of entries on a page */
+  static const unsigned PAGE_BITS = 10;
+  static const size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+
+  typedef void (*cleanup_t)(value_type);
+
+  DenseAttrTable() {}
+
+  ~DenseAttrTable() {
+    for(size_t id = 0; id < d_columns.size(); ++id) {
+      clear(id, NULL);
+    }
+  }
+
+  /**
+   * Find the value of attribute kind id on nv.  Returns NULL if it
+   * isn't set.
+   */
+  const value_type* find(uint64_t id, const NodeValue* nv) const {
+    const Page* page = getPage(id, nv->getId());
+    if(page == NULL) {
+      return NULL;
+    }
+    size_t i = nv->getId() & (PAGE_SIZE - 1);
+    return page->isSet(i) ? &page->d_values[i] : NULL;
+  }
+
+  /** Set the value of attribute kind id on nv. */
+  void set(uint64_t id, const NodeValue* nv, const value_type& value) {
+    if(id >= d_columns.size()) {
+      d_columns.resize(id + 1);
+    }
+    Column& column = d_columns[id];
+    size_t p = nv->getId() >> PAGE_BITS;
+    if(p >= column.size()) {
+      column.resize(p + 1, NULL);
+    }
+    if(column[p] == NULL) {
+      column[p] = new Page();
+    }
+    Page* page = column[p];
+    size_t i = nv->getId() & (PAGE_SIZE - 1);
+    if(!page->isSet(i)) {
+      page->d_set[i >> 6] |= uint64_t(1) << (i & 63);
+      ++page->d_count;
+    }
+    page->d_values[i] = value;
+  }
+
+  /**
+   * Remove the value of attribute kind id from nv (if set), calling
+   * cleanup on it first unless cleanup is NULL.
+   */
+  void erase(uint64_t id, const NodeValue* nv, cleanup_t cleanup) {
+    if(id >= d_columns.size()) {
+      return;
+    }
+    Column& column = d_columns[id];
+    size_t p = nv->getId() >> PAGE_BITS;
+    if(p >= column.size() || column[p] == NULL) {
+      return;
+    }
+    Page* page = column[p];
+    size_t i = nv->getId() & (PAGE_SIZE - 1);
+    if(!page->isSet(i)) {
+      return;
+    }
+    if(cleanup != NULL) {
+      cleanup(page->d_values[i]);
+    }
+    page->d_values[i] = value_type();
+    page->d_set[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    if(--page->d_count == 0) {
+      delete page;
+      column[p] = NULL;
+    }
+  }
+
+  /** Remove the values of all attribute kinds from nv. */
+  void erase(const NodeValue* nv, const std::vector<cleanup_t>& cleanups) {
+    for(size_t id = 0; id < d_columns.size(); ++id) {
+      erase(id, nv, cleanups[id]);
+    }
+  }
+
+  /**
+   * Remove attribute kind id from all Nodes, calling cleanup on each
+   * value unless cleanup is NULL.
+   */
+  void clear(uint64_t id, cleanup_t cleanup) {
+    if(id >= d_columns.size()) {
+      return;
+    }
+    Column& column = d_columns[id];
+    for(size_t p = 0; p < column.size(); ++p) {
+      Page* page = column[p];
+      if(page == NULL) {
+        continue;
+      }
+      if(cleanup != NULL) {
+        for(size_t i = 0; i < PAGE_SIZE; ++i) {
+          if(page->isSet(i)) {
+            cleanup(page->d_values[i]);
+          }
+        }
+      }
+      delete page;
+    }
+    Column().swap(column);
+  }
+
+  /** The number of (Node, attribute kind) entries set. */
+  size_t size() const {
+    size_t n = 0;
+    for(size_t id = 0; id < d_columns.size(); ++id) {
+      for(size_t p = 0; p < d_columns[id].size(); ++p) {
+        if(d_columns[id][p] != NULL) {
+          n += d_columns[id][p]->d_count;
+        }
+      }
+    }
+    return n;
+  }
+
+private:
+
+  struct Page {
+    value_type d_values[PAGE_SIZE];
+    /** which entries of d_values are set */
+    uint64_t d_set[PAGE_SIZE / 64];
+    size_t d_count;
+
+    Page() : d_count(0) {
+      std::fill(d_set, d_set + PAGE_SIZE / 64, uint64_t(0));
+    }
+
+    bool isSet(size_t i) const {
+      return (d_set[i >> 6] >> (i & 63)) & 1;
+    }
+  };/* struct DenseAttrTable<>::Page */
+
+  typedef std::vector<Page*> Column;
+
+  const Page* getPage(uint64_t id, uint64_t nvId) const {
+    if(__builtin_expect( ( id >= d_columns.size() ), false )) {
+      return NULL;
+    }
+    const Column& column = d_columns[id];
+    size_t p = nvId >> PAGE_BITS;
+    return p < column.size() ? column[p] : NULL;
+  }
+
+  std::vector<Column> d_columns;
+
+  // disallow copy
+  DenseAttrTable(const DenseAttrTable&) CVC4_UNDEFINED;
+  DenseAttrTable& operator=(const DenseAttrTable&) CVC4_UNDEFINED;
+};/* class DenseAttrTable<> */
+
+/**
+ * Boolean-valued dense attributes are plain bitmaps; a flag that is
+ * false counts as not set.
+ */
+template <>
+class DenseAttrTable<bool> {
+public:
+
+  /** log2 of the number of flags on a page */
+  static const unsigned PAGE_BITS = 12;
+  static const size_t PAGE_SIZE = size_t(1) << PAGE_BITS;
+
+  typedef void (*cleanup_t)(bool);
+
+  DenseAttrTable() {}
+
+  ~DenseAttrTable() {
+    for(size_t id = 0; id < d_columns.size(); ++id) {
+      clear(id, NULL);
+    }
+  }
+
+  /**
+   * Find flag id on nv.  Returns a pointer to true if the flag is
+   * set, NULL otherwise.
+   */
+  const bool* find(uint64_t id, const NodeValue* nv) const {
+    static const bool s_true = true;
+    if(__builtin_expect( ( id >= d_columns.size() ), false )) {
+      return NULL;
+    }
+    const Column& column = d_columns[id];
+    size_t p = nv->getId() >> PAGE_BITS;
+    if(p >= column.size() || column[p] == NULL) {
+      return NULL;
+    }
+    return column[p]->isSet(nv->getId() & (PAGE_SIZE - 1)) ? &s_true : NULL;
+  }
+
+  void set(uint64_t id, const NodeValue* nv, bool value) {
+    if(!value) {
+      erase(id, nv, NULL);
+      return;
+    }
+    if(id >= d_columns.size()) {
+      d_columns.resize(id + 1);
+    }
+    Column& column = d_columns[id];
+    size_t p = nv->getId() >> PAGE_BITS;
+    if(p >= column.size()) {
+      column.resize(p + 1, NULL);
+    }
+    if(column[p] == NULL) {
+      column[p] = new Page();
+    }
+    Page* page = column[p];
+    size_t i = nv->getId() & (PAGE_SIZE - 1);
+    if(!page->isSet(i)) {
+      page->d_bits[i >> 6] |= uint64_t(1) << (i & 63);
+      ++page->d_count;
+    }
+  }
+
+  void erase(uint64_t id, const NodeValue* nv, cleanup_t) {
+    if(id >= d_columns.size()) {
+      return;
+    }
+    Column& column = d_columns[id];
+    size_t p = nv->getId() >> PAGE_BITS;
+    if(p >= column.size() || column[p] == NULL) {
+      return;
+    }
+    Page* page = column[p];
+    size_t i = nv->getId() & (PAGE_SIZE - 1);
+    if(page->isSet(i)) {
+      page->d_bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+      if(--page->d_count == 0) {
+        delete page;
+        column[p] = NULL;
+      }
+    }
+  }
+
+  void erase(const NodeValue* nv, const std::vector<cleanup_t>& cleanups) {
+    for(size_t id = 0; id < d_columns.size(); ++id) {
+      erase(id, nv, NULL);
+    }
+  }
+
+  void clear(uint64_t id, cleanup_t) {
+    if(id >= d_columns.size()) {
+      return;
+    }
+    Column& column = d_columns[id];
+    for(size_t p = 0; p < column.size(); ++p) {
+      delete column[p];
+    }
+    Column().swap(column);
+  }
+
+  /** The number of flags set. */
+  size_t size() const {
+    size_t n = 0;
+    for(size_t id = 0; id < d_columns.size(); ++id) {
+      for(size_t p = 0; p < d_columns[id].size(); ++p) {
+        if(d_columns[id][p] != NULL) {
+          n += d_columns[id][p]->d_count;
+        }
+      }
+    }
+    return n;
+  }
+
+private:
+
+  struct Page {
+    uint64_t d_bits[PAGE_SIZE / 64];
+    size_t d_count;
+
+    Page() : d_count(0) {
+      std::fill(d_bits, d_bits + PAGE_SIZE / 64, uint64_t(0));
+    }
+
+    bool isSet(size_t i) const {
+      return (d_bits[i >> 6] >> (i & 63)) & 1;
+    }
+  };/* struct DenseAttrTable<bool>::Page */
+
+  typedef std::vector<Page*> Column;
+
+  std::vector<Column> d_columns;
+
+  // disallow copy
+  DenseAttrTable(const DenseAttrTable&) CVC4_UNDEFINED;
+  DenseAttrTable& operator=(const DenseAttrTable&) CVC4_UNDEFINED;
+};/* class DenseAttrTable<bool> */
+
+}/* CVC4::expr::attr namespace */
+
 // ATTRIBUTE CLEANUP FUNCTIONS =================================================
 
 namespace attr {
@@ -510,6 +833,20 @@ struct AttributeTraits {
   }
 };
 
+/**
+ * The cleanup functions of the dense attribute kinds with table value
+ * type T, indexed by their IDs; a DenseAttribute<>'s ID is the size of
+ * this vector when it is registered.
+ */
+template <class T>
+struct DenseAttributeTraits {
+  typedef void (*cleanup_t)(T);
+  static std::vector<cleanup_t>& getCleanup() {
+    static std::vector<cleanup_t> cleanup;
+    return cleanup;
+  }
+};
+
 }/* CVC4::expr::attr namespace */
 
 // ATTRIBUTE DEFINITION ========================================================
@@ -560,6 +897,9 @@ public:
    */
   static const bool context_dependent = context_dep;
 
+  /** Values are kept in the AttributeManager's hash tables. */
+  static const bool dense = false;
+
   /**
    * Register this attribute kind and check that the ID is a valid ID
    * for bool-valued attributes.  Fail an assert if not.  Otherwise
@@ -625,6 +965,9 @@ public:
    */
   static const bool context_dependent = context_dep;
 
+  /** Values are kept in the AttributeManager's hash tables. */
+  static const bool dense = false;
+
   /**
    * Register this attribute kind and check that the ID is a valid ID
    * for bool-valued attributes.  Fail an assert if not.  Otherwise
@@ -657,6 +1000,95 @@ template <class T,
 struct ManagedAttribute :
     public Attribute<T, value_type, CleanupStrategy, false> {};
 
+/**
+ * An "attribute type" structure for attribute kinds stored in a
+ * DenseAttrTable<> rather than an AttrHash<>.  Use this instead of
+ * Attribute<> for attribute kinds that are set on most Nodes and
+ * queried on hot paths; see DenseAttrTable<>.  Dense attributes
+ * cannot be context-dependent.
+ *
+ * @param T the tag for the attribute kind.
+ *
+ * @param value_t the underlying value_type for the attribute kind
+ *
+ * @param CleanupStrategy Clean-up routine for associated values when the
+ * Node goes away.
+ */
+template <class T,
+          class value_t,
+          class CleanupStrategy = attr::NullCleanupStrategy>
+class DenseAttribute {
+  /**
+   * The unique ID associated to this attribute (among the dense
+   * attributes).  Assigned statically, at load time.
+   */
+  static const uint64_t s_id;
+
+public:
+
+  /** The value type for this attribute. */
+  typedef value_t value_type;
+
+  /** Get the unique ID associated to this attribute. */
+  static inline uint64_t getId() { return s_id; }
+
+  /**
+   * This attribute does not have a default value; see Attribute<>.
+   */
+  static const bool has_default_value = false;
+
+  static const bool context_dependent = false;
+
+  /** Values are kept in the AttributeManager's dense tables. */
+  static const bool dense = true;
+
+  /** Register this attribute kind and return its id. */
+  static inline uint64_t registerAttribute() {
+    typedef typename attr::KindValueToTableValueMapping<value_t>::
+                     table_value_type table_value_type;
+    typedef attr::DenseAttributeTraits<table_value_type> traits;
+    uint64_t id = traits::getCleanup().size();
+    traits::getCleanup().push_back(attr::getCleanupStrategy<value_t,
+                                                       CleanupStrategy>::fn);
+    return id;
+  }
+};/* class DenseAttribute<> */
+
+/**
+ * An "attribute type" structure for dense boolean flags.  Unlike
+ * Attribute<..., bool>, there is no limit on the number of these.
+ */
+template <class T>
+class DenseAttribute<T, bool, attr::NullCleanupStrategy> {
+  static const uint64_t s_id;
+
+public:
+
+  /** The value type for this attribute; here, bool. */
+  typedef bool value_type;
+
+  /** Get the unique ID associated to this attribute. */
+  static inline uint64_t getId() { return s_id; }
+
+  /** Flags are false for all nodes on entry; see Attribute<>. */
+  static const bool has_default_value = true;
+
+  static const bool default_value = false;
+
+  static const bool context_dependent = false;
+
+  /** Values are kept in the AttributeManager's dense tables. */
+  static const bool dense = true;
+
+  /** Register this attribute kind and return its id. */
+  static inline uint64_t registerAttribute() {
+    typedef attr::DenseAttributeTraits<bool> traits;
+    uint64_t id = traits::getCleanup().size();
+    traits::getCleanup().push_back(NULL);
+    return id;
+  }
+};/* class DenseAttribute<..., bool, ...> */
+
 // ATTRIBUTE IDENTIFIER ASSIGNMENT =============================================
 
 /** Assign unique IDs to attributes at load time. */
@@ -680,6 +1112,16 @@ const uint64_t Attribute<T,
   Attribute<T, bool, attr::NullCleanupStrategy, context_dep>::
     registerAttribute();
 
+/** Assign unique IDs to dense attributes at load time. */
+template <class T, class value_t, class CleanupStrategy>
+const uint64_t DenseAttribute<T, value_t, CleanupStrategy>::s_id =
+  DenseAttribute<T, value_t, CleanupStrategy>::registerAttribute();
+
+/** Assign unique IDs to dense attributes at load time. */
+template <class T>
+const uint64_t DenseAttribute<T, bool, attr::NullCleanupStrategy>::s_id =
+  DenseAttribute<T, bool, attr::NullCleanupStrategy>::registerAttribute();
+
 }/* CVC4::expr namespace */
 }/* CVC4 namespace */
 
@@ -42,6 +42,13 @@ enum AttrTableId {
   AttrTableCDNode,
   AttrTableCDString,
   AttrTableCDPointer,
+  AttrTableDenseBool,
+  AttrTableDenseUInt64,
+  AttrTableDenseTNode,
+  AttrTableDenseNode,
+  AttrTableDenseTypeNode,
+  AttrTableDenseString,
+  AttrTableDensePointer,
   LastAttrTable
 };
 
@@ -989,6 +989,10 @@ unsigned ExprManager::maxArity(Kind kind) {
 NodeManager* ExprManager::getNodeManager() const {
   return d_nodeManager;
 }
+void ExprManager::reserveExprs(size_t n) {
+  d_nodeManager->reservePool(n);
+}
+
 Statistics ExprManager::getStatistics() const
 {
   return Statistics(*d_nodeManager->getStatisticsRegistry());
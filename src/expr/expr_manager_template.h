@@ -527,6 +527,14 @@ public:
    */
   Expr mkNullaryOperator( Type type, Kind k);
 
+  /**
+   * Hint that about n more distinct expressions are about to be created
+   * (e.g., by a parser, estimated from the size of its input), so the
+   * ExprManager can size its internal tables once rather than growing
+   * them step by step.  This is only a performance hint.
+   */
+  void reserveExprs(size_t n);
+
   /** Get a reference to the statistics registry for this ExprManager */
   Statistics getStatistics() const;
 
@@ -53,6 +53,8 @@ class TypeNode;
 class NodeManager;
 
 namespace expr {
+  class NodeArchiveReader;
+  class NodeArchiveWriter;
   namespace pickle {
     class PicklerPrivate;
   }/* CVC4::expr::pickle namespace */
@@ -184,6 +186,8 @@ class NodeTemplate {
 
   friend class expr::pickle::PicklerPrivate;
   friend class expr::ExportPrivate;
+  friend class expr::NodeArchiveReader;
+  friend class expr::NodeArchiveWriter;
 
   /** A convenient null-valued encapsulated pointer */
   static NodeTemplate s_null;
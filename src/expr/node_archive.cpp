@@ -0,0 +1,596 @@
+/*********************                                                        */
+/*! \file node_archive.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A compact binary format for sets of Nodes, preserving sharing.
+ **
+ ** A compact binary format for sets of Nodes, preserving sharing.
+ **/
+
+#include "expr/node_archive.h"
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif /* _WIN32 */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "base/cvc4_assert.h"
+#include "base/exception.h"
+#include "base/output.h"
+#include "expr/kind.h"
+#include "expr/metakind.h"
+#include "expr/node_builder.h"
+#include "expr/node_manager.h"
+#include "expr/node_manager_attributes.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace expr {
+
+namespace {
+
+/** The bits of a record's first word holding the kind. */
+const uint32_t KIND_MASK = 0xffff;
+/** Set if the record is a type. */
+const uint32_t FLAG_TYPE = uint32_t(1) << 30;
+/** Set if the record's next word is the index of its name. */
+const uint32_t FLAG_NAMED = uint32_t(1) << 31;
+
+const char MAGIC[8] = { 'C', 'V', 'C', '4', 'D', 'A', 'G', '\0' };
+
+size_t padTo8(size_t n) {
+  return (n + 7) & ~size_t(7);
+}
+
+void writePadding(ostream& out, size_t n) {
+  static const char zeros[8] = {};
+  out.write(zeros, padTo8(n) - n);
+}
+
+void corrupt(const string& what) {
+  throw Exception("corrupt node archive: " + what);
+}
+
+}  // namespace
+
+const uint32_t NodeArchiveWriter::NONE;
+const uint32_t NodeArchiveHeader::VERSION;
+const uint32_t NodeArchiveHeader::BYTE_ORDER_MARK;
+
+size_t NodeArchiveWriter::addRoot(TNode n) {
+  d_roots.push_back(internNode(n, false));
+  return d_roots.size() - 1;
+}
+
+uint32_t NodeArchiveWriter::internNode(TNode top, bool isType) {
+  // post-order, without recursion: terms can be very deep
+  struct Frame {
+    TNode d_node;
+    bool d_isType;
+    bool d_expanded;
+  };
+  vector<Frame> stack;
+  vector<pair<TNode, bool> > deps;
+  Frame first = { top, isType, false };
+  stack.push_back(first);
+  while(!stack.empty()) {
+    TNode n = stack.back().d_node;
+    bool t = stack.back().d_isType;
+    if(d_index.find(n) != d_index.end()) {
+      stack.pop_back();
+    } else if(stack.back().d_expanded) {
+      emit(n, t);
+      stack.pop_back();
+    } else {
+      stack.back().d_expanded = true;
+      deps.clear();
+      getDependencies(n, t, deps);
+      for(size_t i = deps.size(); i-- > 0;) {
+        if(d_index.find(deps[i].first) == d_index.end()) {
+          Frame f = { deps[i].first, deps[i].second, false };
+          stack.push_back(f);
+        }
+      }
+    }
+  }
+  return d_index[top];
+}
+
+void NodeArchiveWriter::getDependencies(TNode n, bool isType,
+                                        vector<pair<TNode, bool> >& deps) const {
+  switch(n.getMetaKind()) {
+  case kind::metakind::VARIABLE:
+  case kind::metakind::NULLARY_OPERATOR: {
+    TypeNode type;
+    if(n.getAttribute(TypeAttr(), type)) {
+      deps.push_back(make_pair(TNode(type.d_nv), true));
+    }
+    break;
+  }
+  case kind::metakind::PARAMETERIZED:
+    deps.push_back(make_pair(n.getOperator(), isType));
+    // fall through
+  case kind::metakind::OPERATOR:
+    for(TNode::iterator i = n.begin(); i != n.end(); ++i) {
+      deps.push_back(make_pair(*i, isType));
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+void NodeArchiveWriter::emit(TNode n, bool isType) {
+  Kind k = n.getKind();
+  uint32_t header = uint32_t(k);
+  Assert((header & KIND_MASK) == header);
+  if(isType) {
+    header |= FLAG_TYPE;
+  }
+  string name;
+  bool named = n.getAttribute(VarNameAttr(), name);
+  if(named) {
+    header |= FLAG_NAMED;
+  }
+
+  // intern strings before anything is appended to d_words
+  uint32_t nameIndex = named ? internString(name) : NONE;
+  uint32_t payload = NONE;
+  if(n.getMetaKind() == kind::metakind::CONSTANT) {
+    stringstream ss;
+    switch(k) {
+    case kind::CONST_BOOLEAN:
+      ss << (n.getConst<bool>() ? 1 : 0);
+      break;
+    case kind::CONST_RATIONAL:
+      ss << n.getConst<Rational>().toString(16);
+      break;
+    case kind::CONST_BITVECTOR: {
+      const BitVector& bv = n.getConst<BitVector>();
+      ss << bv.getSize() << ':' << bv.getValue().toString(16);
+      break;
+    }
+    case kind::BITVECTOR_TYPE:
+      ss << unsigned(n.getConst<BitVectorSize>());
+      break;
+    case kind::BITVECTOR_EXTRACT_OP: {
+      const BitVectorExtract& e = n.getConst<BitVectorExtract>();
+      ss << e.high << ':' << e.low;
+      break;
+    }
+    case kind::BITVECTOR_BITOF_OP:
+      ss << n.getConst<BitVectorBitOf>().bitIndex;
+      break;
+    case kind::BITVECTOR_REPEAT_OP:
+      ss << unsigned(n.getConst<BitVectorRepeat>());
+      break;
+    case kind::BITVECTOR_ZERO_EXTEND_OP:
+      ss << unsigned(n.getConst<BitVectorZeroExtend>());
+      break;
+    case kind::BITVECTOR_SIGN_EXTEND_OP:
+      ss << unsigned(n.getConst<BitVectorSignExtend>());
+      break;
+    case kind::BITVECTOR_ROTATE_LEFT_OP:
+      ss << unsigned(n.getConst<BitVectorRotateLeft>());
+      break;
+    case kind::BITVECTOR_ROTATE_RIGHT_OP:
+      ss << unsigned(n.getConst<BitVectorRotateRight>());
+      break;
+    case kind::INT_TO_BITVECTOR_OP:
+      ss << unsigned(n.getConst<IntToBitVector>());
+      break;
+    case kind::TYPE_CONSTANT:
+      ss << unsigned(n.getConst<TypeConstant>());
+      break;
+    case kind::BUILTIN:
+      ss << unsigned(n.getConst<Kind>());
+      break;
+    case kind::CONST_STRING: {
+      const vector<unsigned>& vec = n.getConst<String>().getVec();
+      for(size_t i = 0; i < vec.size(); ++i) {
+        ss << (i == 0 ? "" : " ") << vec[i];
+      }
+      break;
+    }
+    default: {
+      stringstream msg;
+      msg << "cannot archive constants of kind " << k;
+      throw Exception(msg.str());
+    }
+    }
+    payload = internString(ss.str());
+  }
+
+  d_words.push_back(header);
+  if(named) {
+    d_words.push_back(nameIndex);
+  }
+  switch(n.getMetaKind()) {
+  case kind::metakind::VARIABLE:
+  case kind::metakind::NULLARY_OPERATOR: {
+    TypeNode type;
+    if(n.getAttribute(TypeAttr(), type)) {
+      d_words.push_back(d_index[TNode(type.d_nv)]);
+    } else {
+      d_words.push_back(NONE);
+    }
+    break;
+  }
+  case kind::metakind::CONSTANT:
+    d_words.push_back(payload);
+    break;
+  case kind::metakind::PARAMETERIZED:
+    d_words.push_back(n.getNumChildren());
+    d_words.push_back(d_index[n.getOperator()]);
+    for(TNode::iterator i = n.begin(); i != n.end(); ++i) {
+      d_words.push_back(d_index[*i]);
+    }
+    break;
+  case kind::metakind::OPERATOR:
+    d_words.push_back(n.getNumChildren());
+    for(TNode::iterator i = n.begin(); i != n.end(); ++i) {
+      d_words.push_back(d_index[*i]);
+    }
+    break;
+  default:
+    Unhandled(n.getMetaKind());
+  }
+
+  AlwaysAssert(d_nodes.size() < NONE, "too many nodes for a node archive");
+  d_index[n] = d_nodes.size();
+  d_nodes.push_back(n);
+}
+
+uint32_t NodeArchiveWriter::internString(const string& s) {
+  unordered_map<string, uint32_t>::const_iterator i = d_stringIndex.find(s);
+  if(i != d_stringIndex.end()) {
+    return (*i).second;
+  }
+  AlwaysAssert(d_strings.size() < NONE, "too many strings for a node archive");
+  uint32_t index = d_strings.size();
+  d_stringIndex[s] = index;
+  d_strings.push_back(s);
+  return index;
+}
+
+void NodeArchiveWriter::write(ostream& out) const {
+  NodeArchiveHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.d_magic, MAGIC, sizeof(MAGIC));
+  header.d_version = NodeArchiveHeader::VERSION;
+  header.d_byteOrder = NodeArchiveHeader::BYTE_ORDER_MARK;
+  header.d_numStrings = d_strings.size();
+  vector<uint64_t> offsets;
+  offsets.reserve(d_strings.size() + 1);
+  offsets.push_back(0);
+  for(size_t i = 0; i < d_strings.size(); ++i) {
+    offsets.push_back(offsets.back() + d_strings[i].size());
+  }
+  header.d_stringBytes = offsets.back();
+  header.d_numNodes = d_nodes.size();
+  header.d_numWords = d_words.size();
+  header.d_numRoots = d_roots.size();
+  header.d_size = sizeof(header)
+    + sizeof(uint64_t) * offsets.size()
+    + padTo8(header.d_stringBytes)
+    + padTo8(sizeof(uint32_t) * d_words.size())
+    + padTo8(sizeof(uint32_t) * d_roots.size());
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(&offsets[0]),
+            sizeof(uint64_t) * offsets.size());
+  for(size_t i = 0; i < d_strings.size(); ++i) {
+    out.write(d_strings[i].data(), d_strings[i].size());
+  }
+  writePadding(out, header.d_stringBytes);
+  if(!d_words.empty()) {
+    out.write(reinterpret_cast<const char*>(&d_words[0]),
+              sizeof(uint32_t) * d_words.size());
+  }
+  writePadding(out, sizeof(uint32_t) * d_words.size());
+  if(!d_roots.empty()) {
+    out.write(reinterpret_cast<const char*>(&d_roots[0]),
+              sizeof(uint32_t) * d_roots.size());
+  }
+  writePadding(out, sizeof(uint32_t) * d_roots.size());
+
+  Debug("node-archive") << "wrote node archive: " << d_nodes.size()
+                        << " nodes, " << d_strings.size() << " strings, "
+                        << d_roots.size() << " roots, " << header.d_size
+                        << " bytes" << endl;
+}
+
+NodeArchiveReader::NodeArchiveReader(NodeManager* nm,
+                                     const char* data, size_t size) :
+  d_nm(nm),
+  d_header(reinterpret_cast<const NodeArchiveHeader*>(data)) {
+  if(size < sizeof(NodeArchiveHeader) ||
+     memcmp(d_header->d_magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw Exception("not a node archive");
+  }
+  if(d_header->d_byteOrder != NodeArchiveHeader::BYTE_ORDER_MARK) {
+    throw Exception("node archive was written with another byte order");
+  }
+  if(d_header->d_version != NodeArchiveHeader::VERSION) {
+    throw Exception("unsupported node archive version");
+  }
+  if(reinterpret_cast<uintptr_t>(data) % sizeof(uint64_t) != 0) {
+    throw Exception("node archive is not 8-byte aligned in memory");
+  }
+  // guard the size computation below against absurd counts
+  if(d_header->d_size != size ||
+     d_header->d_numStrings >= size ||
+     d_header->d_stringBytes >= size ||
+     d_header->d_numWords >= size ||
+     d_header->d_numRoots >= size ||
+     d_header->d_numNodes > d_header->d_numWords) {
+    corrupt("bad size");
+  }
+  size_t expected = sizeof(NodeArchiveHeader)
+    + sizeof(uint64_t) * (d_header->d_numStrings + 1)
+    + padTo8(d_header->d_stringBytes)
+    + padTo8(sizeof(uint32_t) * d_header->d_numWords)
+    + padTo8(sizeof(uint32_t) * d_header->d_numRoots);
+  if(expected != size) {
+    corrupt("bad size");
+  }
+
+  const char* p = data + sizeof(NodeArchiveHeader);
+  d_stringOffsets = reinterpret_cast<const uint64_t*>(p);
+  p += sizeof(uint64_t) * (d_header->d_numStrings + 1);
+  d_stringData = p;
+  p += padTo8(d_header->d_stringBytes);
+  d_words = reinterpret_cast<const uint32_t*>(p);
+  p += padTo8(sizeof(uint32_t) * d_header->d_numWords);
+  d_roots = reinterpret_cast<const uint32_t*>(p);
+
+  if(d_stringOffsets[d_header->d_numStrings] != d_header->d_stringBytes) {
+    corrupt("bad string table");
+  }
+}
+
+string NodeArchiveReader::getString(uint32_t i) const {
+  if(i >= d_header->d_numStrings ||
+     d_stringOffsets[i] > d_stringOffsets[i + 1] ||
+     d_stringOffsets[i + 1] > d_header->d_stringBytes) {
+    corrupt("bad string index");
+  }
+  return string(d_stringData + d_stringOffsets[i],
+                d_stringOffsets[i + 1] - d_stringOffsets[i]);
+}
+
+Node NodeArchiveReader::getNode(uint32_t i) const {
+  if(i >= d_nodes.size()) {
+    corrupt("bad node index");
+  }
+  return d_nodes[i];
+}
+
+uint32_t NodeArchiveReader::nextWord(size_t& pos) const {
+  if(pos >= d_header->d_numWords) {
+    corrupt("truncated node");
+  }
+  return d_words[pos++];
+}
+
+Node NodeArchiveReader::mkConstant(Kind k, const string& payload) const {
+  stringstream ss(payload);
+  unsigned u = 0, v = 0;
+  char sep = 0;
+  switch(k) {
+  case kind::CONST_BOOLEAN:
+    ss >> u;
+    return d_nm->mkConst(bool(u));
+  case kind::CONST_RATIONAL:
+    return d_nm->mkConst(Rational(payload, 16));
+  case kind::CONST_BITVECTOR: {
+    string value;
+    ss >> u >> sep >> value;
+    return d_nm->mkConst(BitVector(u, Integer(value, 16)));
+  }
+  case kind::BITVECTOR_TYPE:
+    ss >> u;
+    return d_nm->mkConst(BitVectorSize(u));
+  case kind::BITVECTOR_EXTRACT_OP:
+    ss >> u >> sep >> v;
+    return d_nm->mkConst(BitVectorExtract(u, v));
+  case kind::BITVECTOR_BITOF_OP:
+    ss >> u;
+    return d_nm->mkConst(BitVectorBitOf(u));
+  case kind::BITVECTOR_REPEAT_OP:
+    ss >> u;
+    return d_nm->mkConst(BitVectorRepeat(u));
+  case kind::BITVECTOR_ZERO_EXTEND_OP:
+    ss >> u;
+    return d_nm->mkConst(BitVectorZeroExtend(u));
+  case kind::BITVECTOR_SIGN_EXTEND_OP:
+    ss >> u;
+    return d_nm->mkConst(BitVectorSignExtend(u));
+  case kind::BITVECTOR_ROTATE_LEFT_OP:
+    ss >> u;
+    return d_nm->mkConst(BitVectorRotateLeft(u));
+  case kind::BITVECTOR_ROTATE_RIGHT_OP:
+    ss >> u;
+    return d_nm->mkConst(BitVectorRotateRight(u));
+  case kind::INT_TO_BITVECTOR_OP:
+    ss >> u;
+    return d_nm->mkConst(IntToBitVector(u));
+  case kind::TYPE_CONSTANT:
+    ss >> u;
+    if(u >= LAST_TYPE) {
+      corrupt("bad type constant");
+    }
+    return d_nm->mkConst(TypeConstant(u));
+  case kind::BUILTIN:
+    ss >> u;
+    if(u >= kind::LAST_KIND) {
+      corrupt("bad builtin kind");
+    }
+    return d_nm->mkConst(Kind(u));
+  case kind::CONST_STRING: {
+    vector<unsigned> vec;
+    while(ss >> u) {
+      vec.push_back(u);
+    }
+    return d_nm->mkConst(String(vec));
+  }
+  default:
+    corrupt("unexpected constant kind");
+  }
+  return Node::null();
+}
+
+void NodeArchiveReader::load(vector<Node>& roots) {
+  const uint64_t numWords = d_header->d_numWords;
+  size_t pos = 0;
+
+  d_nodes.clear();
+  d_nodes.reserve(d_header->d_numNodes);
+  while(pos < numWords) {
+    uint32_t header = d_words[pos++];
+    uint32_t k32 = header & KIND_MASK;
+    if(k32 >= kind::LAST_KIND) {
+      corrupt("bad kind");
+    }
+    Kind k = Kind(k32);
+    bool isType = (header & FLAG_TYPE) != 0;
+    bool named = (header & FLAG_NAMED) != 0;
+    string name;
+    if(named) {
+      name = getString(nextWord(pos));
+    }
+
+    Node n;
+    switch(kind::metaKindOf(k)) {
+    case kind::metakind::VARIABLE:
+    case kind::metakind::NULLARY_OPERATOR: {
+      uint32_t typeIndex = nextWord(pos);
+      TypeNode type;
+      if(typeIndex != NodeArchiveWriter::NONE) {
+        type = TypeNode(getNode(typeIndex).d_nv);
+      }
+      if(kind::metaKindOf(k) == kind::metakind::NULLARY_OPERATOR) {
+        if(type.isNull()) {
+          corrupt("untyped nullary operator");
+        }
+        n = d_nm->mkNullaryOperator(type, k);
+      } else if(k == kind::VARIABLE && !type.isNull()) {
+        n = named ? d_nm->mkVar(name, type) : d_nm->mkVar(type);
+      } else if(k == kind::BOUND_VARIABLE && !type.isNull()) {
+        n = named ? d_nm->mkBoundVar(name, type) : d_nm->mkBoundVar(type);
+      } else if(k == kind::SKOLEM && !type.isNull() && named) {
+        n = d_nm->mkSkolem(name, type, "loaded from a node archive",
+                           NodeManager::SKOLEM_EXACT_NAME);
+      } else {
+        n = NodeBuilder<0>(d_nm, k);
+        if(!type.isNull()) {
+          d_nm->setAttribute(n, TypeAttr(), type);
+          d_nm->setAttribute(n, TypeCheckedAttr(), true);
+        }
+      }
+      break;
+    }
+    case kind::metakind::CONSTANT:
+      n = mkConstant(k, getString(nextWord(pos)));
+      break;
+    case kind::metakind::OPERATOR:
+    case kind::metakind::PARAMETERIZED: {
+      uint32_t nchildren = nextWord(pos);
+      if(nchildren > numWords - pos) {
+        corrupt("truncated node");
+      }
+      NodeBuilder<> nb(d_nm, k);
+      if(kind::metaKindOf(k) == kind::metakind::PARAMETERIZED) {
+        nb << getNode(nextWord(pos));
+      }
+      for(uint32_t i = 0; i < nchildren; ++i) {
+        nb << getNode(nextWord(pos));
+      }
+      if(isType) {
+        n = Node(nb.constructTypeNode().d_nv);
+      } else {
+        n = nb.constructNode();
+      }
+      break;
+    }
+    default:
+      corrupt("bad kind");
+    }
+
+    if(named) {
+      d_nm->setAttribute(n, VarNameAttr(), name);
+    }
+    d_nodes.push_back(n);
+  }
+
+  if(d_nodes.size() != d_header->d_numNodes) {
+    corrupt("bad node count");
+  }
+  for(uint64_t i = 0; i < d_header->d_numRoots; ++i) {
+    roots.push_back(getNode(d_roots[i]));
+  }
+  d_nodes.clear();
+}
+
+void NodeArchiveReader::loadFile(NodeManager* nm, const string& filename,
+                                 vector<Node>& roots) {
+#ifndef _WIN32
+  int fd = open(filename.c_str(), O_RDONLY);
+  if(fd == -1) {
+    throw Exception("cannot open node archive `" + filename + "'");
+  }
+  struct stat st;
+  if(fstat(fd, &st) == -1 || size_t(st.st_size) < sizeof(NodeArchiveHeader)) {
+    close(fd);
+    throw Exception("not a node archive: `" + filename + "'");
+  }
+  size_t size = st.st_size;
+  void* data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED) {
+    throw Exception("cannot map node archive `" + filename + "'");
+  }
+  try {
+    NodeArchiveReader reader(nm, static_cast<const char*>(data), size);
+    reader.load(roots);
+  } catch(...) {
+    munmap(data, size);
+    throw;
+  }
+  munmap(data, size);
+#else /* _WIN32 */
+  ifstream in(filename.c_str(), ios::in | ios::binary);
+  if(!in) {
+    throw Exception("cannot open node archive `" + filename + "'");
+  }
+  in.seekg(0, ios::end);
+  size_t size = in.tellg();
+  in.seekg(0, ios::beg);
+  // uint64_t storage, for alignment
+  vector<uint64_t> buffer(size / sizeof(uint64_t) + 1);
+  in.read(reinterpret_cast<char*>(&buffer[0]), size);
+  if(!in) {
+    throw Exception("cannot read node archive `" + filename + "'");
+  }
+  NodeArchiveReader reader(nm, reinterpret_cast<const char*>(&buffer[0]), size);
+  reader.load(roots);
+#endif /* _WIN32 */
+}
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,211 @@
+/*********************                                                        */
+/*! \file node_archive.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A compact binary format for sets of Nodes, preserving sharing.
+ **
+ ** A compact binary format for sets of Nodes, preserving sharing.
+ ** Unlike the Pickler, which serializes one expression at a time as a
+ ** tree and refers to variables by address, a node archive holds a
+ ** whole term DAG: every distinct subterm is stored once, across all
+ ** of the archived roots, and strings (variable and sort names,
+ ** constant payloads) are interned.  Variables are stored by name and
+ ** type, so an archive can be loaded into a fresh NodeManager, e.g.
+ ** to reload a large set of assertions without parsing them again.
+ **
+ ** The layout is a fixed header followed by flat, 8-byte-aligned
+ ** sections that a reader consumes in place, so an archive can be
+ ** read straight out of a memory-mapped file:
+ **
+ **   header      magic, version, byte-order mark, section sizes
+ **   strings     numStrings + 1 uint64 offsets, then the string bytes
+ **   nodes       uint32 words: one record per node, children first
+ **   roots       uint32 node indices
+ **
+ ** A node record is a word holding the kind (and flags), optionally
+ ** followed by the index of its name, then:
+ **
+ **   VARIABLE,
+ **   NULLARY_OPERATOR  the index of its type (or NONE)
+ **   CONSTANT          the index of its payload, as an interned string
+ **   OPERATOR          the number of children and their indices
+ **   PARAMETERIZED     the number of children, then the indices of
+ **                     its operator and children
+ **
+ ** Every index refers to an earlier record, so an archive is loaded
+ ** in a single forward pass.  Archives use the host byte order;
+ ** loading an archive written on a host of the other byte order fails.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__EXPR__NODE_ARCHIVE_H
+#define __CVC4__EXPR__NODE_ARCHIVE_H
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expr/node.h"
+#include "expr/type_node.h"
+
+namespace CVC4 {
+
+class NodeManager;
+
+namespace expr {
+
+/** The on-disk header of a node archive. */
+struct NodeArchiveHeader {
+  /** "CVC4DAG" and a NUL */
+  char d_magic[8];
+  uint32_t d_version;
+  /** BYTE_ORDER_MARK as written by the host that made the archive */
+  uint32_t d_byteOrder;
+  uint64_t d_numStrings;
+  uint64_t d_stringBytes;
+  uint64_t d_numNodes;
+  uint64_t d_numWords;
+  uint64_t d_numRoots;
+  /** the size of the whole archive, in bytes */
+  uint64_t d_size;
+
+  static const uint32_t VERSION = 1;
+  static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+};/* struct NodeArchiveHeader */
+
+/**
+ * Collects Nodes into an archive.  Each addRoot() call adds the DAG
+ * below a Node, sharing whatever was added before; write() then
+ * emits the archive.  The writer holds references to everything
+ * added until it is destroyed.
+ */
+class NodeArchiveWriter {
+public:
+
+  /** The index of a node or string that isn't there. */
+  static const uint32_t NONE = 0xffffffff;
+
+  NodeArchiveWriter() {}
+
+  /**
+   * Add n, and everything it depends on, to the archive.
+   *
+   * @return the index of n among the roots
+   * @throws Exception if n contains a constant whose kind cannot be
+   * archived
+   */
+  size_t addRoot(TNode n);
+
+  /** Write the archive to out. */
+  void write(std::ostream& out) const;
+
+  /** The number of distinct nodes added so far. */
+  size_t getNumNodes() const { return d_nodes.size(); }
+
+  /** The number of distinct strings added so far. */
+  size_t getNumStrings() const { return d_strings.size(); }
+
+private:
+
+  uint32_t internNode(TNode n, bool isType);
+  uint32_t internString(const std::string& s);
+  /** Append the record of n, whose dependencies are all interned. */
+  void emit(TNode n, bool isType);
+  /** The dependencies of n: operator, children, type. */
+  void getDependencies(TNode n, bool isType,
+                       std::vector<std::pair<TNode, bool> >& deps) const;
+
+  std::unordered_map<TNode, uint32_t, TNodeHashFunction> d_index;
+  /** keeps everything in d_index alive */
+  std::vector<Node> d_nodes;
+  std::vector<uint32_t> d_words;
+  std::vector<uint32_t> d_roots;
+
+  std::unordered_map<std::string, uint32_t> d_stringIndex;
+  std::vector<std::string> d_strings;
+
+  // disallow copy
+  NodeArchiveWriter(const NodeArchiveWriter&) CVC4_UNDEFINED;
+  NodeArchiveWriter& operator=(const NodeArchiveWriter&) CVC4_UNDEFINED;
+};/* class NodeArchiveWriter */
+
+/**
+ * Loads an archive into a NodeManager.  The reader works directly on
+ * the bytes of the archive, which it does not own; they must remain
+ * valid while load() runs.
+ */
+class NodeArchiveReader {
+public:
+
+  /**
+   * Check the header of the archive in [data, data + size).
+   *
+   * @throws Exception if it is not a well-formed archive
+   */
+  NodeArchiveReader(NodeManager* nm, const char* data, size_t size);
+
+  /** The number of roots in the archive. */
+  size_t getNumRoots() const { return d_header->d_numRoots; }
+
+  /** The number of distinct nodes in the archive. */
+  size_t getNumNodes() const { return d_header->d_numNodes; }
+
+  /**
+   * Rebuild the archived Nodes and append the roots to roots, in the
+   * order they were added.
+   *
+   * Variables are recreated (so that, e.g., a VARIABLE is announced
+   * to the NodeManager's listeners as usual) and are distinct from
+   * any in the NodeManager already.
+   *
+   * @throws Exception if the archive is corrupt
+   */
+  void load(std::vector<Node>& roots);
+
+  /**
+   * Load the archive in the given file into nm.  The file is
+   * memory-mapped where the platform supports it.
+   *
+   * @throws Exception if the file cannot be read or is corrupt
+   */
+  static void loadFile(NodeManager* nm, const std::string& filename,
+                       std::vector<Node>& roots);
+
+private:
+
+  /** The word of the node table at pos; advances pos. */
+  uint32_t nextWord(size_t& pos) const;
+  std::string getString(uint32_t i) const;
+  Node getNode(uint32_t i) const;
+  Node mkConstant(Kind k, const std::string& payload) const;
+
+  NodeManager* d_nm;
+  const NodeArchiveHeader* d_header;
+  const uint64_t* d_stringOffsets;
+  const char* d_stringData;
+  const uint32_t* d_words;
+  const uint32_t* d_roots;
+
+  /** the nodes loaded so far, by index */
+  std::vector<Node> d_nodes;
+
+  // disallow copy
+  NodeArchiveReader(const NodeArchiveReader&) CVC4_UNDEFINED;
+  NodeArchiveReader& operator=(const NodeArchiveReader&) CVC4_UNDEFINED;
+};/* class NodeArchiveReader */
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__EXPR__NODE_ARCHIVE_H */
@@ -18,7 +18,6 @@
 #include "expr/node_manager.h"
 
 #include <algorithm>
-#include <stack>
 #include <utility>
 
 #include "base/cvc4_assert.h"
@@ -221,8 +220,10 @@ NodeManager::~NodeManager() {
 
   if(Debug.isOn("gc:leaks")) {
     Debug("gc:leaks") << "still in pool:" << endl;
-    for(NodeValuePool::const_iterator i = d_nodeValuePool.begin(),
-          iend = d_nodeValuePool.end();
+    std::vector<NodeValue*> leaked;
+    d_nodeValuePool.getAll(leaked);
+    for(std::vector<NodeValue*>::const_iterator i = leaked.begin(),
+          iend = leaked.end();
         i != iend;
         ++i) {
       Debug("gc:leaks") << "  " << *i
@@ -284,6 +285,7 @@ void NodeManager::reclaimZombies() {
   // iterator, causing a crash.  So we need to copy the set away.
 
   vector<NodeValue*> zombies;
+  vector<NodeValue*> reclaimed;
   zombies.reserve(d_zombies.size());
   remove_copy_if(d_zombies.begin(),
                  d_zombies.end(),
@@ -354,10 +356,15 @@ void NodeManager::reclaimZombies() {
         // constant, but then, you should probably use a smart-pointer
         // type for a constant payload.)
         kind::metakind::deleteNodeValueConstant(nv);
+        free(nv);
+      } else {
+        reclaimed.push_back(nv);
       }
-      free(nv);
     }
   }
+
+  // hand the storage of the whole batch back at once
+  d_nvAllocator.deallocate(reclaimed);
 }/* NodeManager::reclaimZombies() */
 
 std::vector<NodeValue*> NodeManager::TopologicalSort(
@@ -418,37 +425,13 @@ TypeNode NodeManager::getType(TNode n, bool check)
   Debug("getType") << this << " getting type for " << &n << " " << n << ", check=" << check << ", needsCheck = " << needsCheck << ", hasType = " << hasType << endl;
   
   if(needsCheck && !(*d_options)[options::earlyTypeChecking]) {
-    /* Iterate and compute the children bottom up. This avoids stack
-       overflows in computeType() when the Node graph is really deep,
-       which should only affect us when we're type checking lazily. */
-    stack<TNode> worklist;
-    worklist.push(n);
-
-    while( !worklist.empty() ) {
-      TNode m = worklist.top();
-
-      bool readyToCompute = true;
-
-      for( TNode::iterator it = m.begin(), end = m.end();
-           it != end;
-           ++it ) {
-        if( !hasAttribute(*it, TypeAttr())
-            || (check && !getAttribute(*it, TypeCheckedAttr())) ) {
-          readyToCompute = false;
-          worklist.push(*it);
-        }
-      }
-
-      if( readyToCompute ) {
-        Assert( check || m.getMetaKind()!=kind::metakind::NULLARY_OPERATOR );
-        /* All the children have types, time to compute */
-        typeNode = TypeChecker::computeType(this, m, check);
-        worklist.pop();
-      }
-    } // end while
-
-    /* Last type computed in loop should be the type of n */
-    Assert( typeNode == getAttribute(n, TypeAttr()) );
+    /* Check the children bottom up. This avoids stack overflows in
+       computeType() when the Node graph is really deep, which should
+       only affect us when we're type checking lazily. */
+    size_t base = d_typeCheckStack.size();
+    d_typeCheckStack.push_back(std::make_pair(n, false));
+    checkTypesFrom(base);
+    typeNode = getAttribute(n, TypeAttr());
   } else if( !hasType || needsCheck ) {
     /* We can compute the type top-down, without worrying about
        deep recursion. */
@@ -465,6 +448,47 @@ TypeNode NodeManager::getType(TNode n, bool check)
   return typeNode;
 }
 
+void NodeManager::checkTypes(const std::vector<TNode>& nodes) {
+  NodeManagerScope nms(this);
+
+  size_t base = d_typeCheckStack.size();
+  for(std::vector<TNode>::const_iterator i = nodes.begin();
+      i != nodes.end();
+      ++i) {
+    if(!getAttribute(*i, TypeCheckedAttr())) {
+      d_typeCheckStack.push_back(std::make_pair(*i, false));
+    }
+  }
+  checkTypesFrom(base);
+}
+
+void NodeManager::checkTypesFrom(size_t base) {
+  try {
+    while(d_typeCheckStack.size() > base) {
+      TNode m = d_typeCheckStack.back().first;
+      if(getAttribute(m, TypeCheckedAttr())) {
+        // reached before along another path
+        d_typeCheckStack.pop_back();
+      } else if(d_typeCheckStack.back().second) {
+        // everything m depends on is checked
+        d_typeCheckStack.pop_back();
+        TypeChecker::computeType(this, m, true);
+      } else {
+        // the type rule checks the operator, if any, itself
+        d_typeCheckStack.back().second = true;
+        for(TNode::iterator it = m.begin(), end = m.end(); it != end; ++it) {
+          if(!getAttribute(*it, TypeCheckedAttr())) {
+            d_typeCheckStack.push_back(std::make_pair(*it, false));
+          }
+        }
+      }
+    }
+  } catch(...) {
+    d_typeCheckStack.resize(base);
+    throw;
+  }
+}
+
 Node NodeManager::mkSkolem(const std::string& prefix, const TypeNode& type, const std::string& comment, int flags) {
   Node n = NodeBuilder<0>(this, kind::SKOLEM);
   setAttribute(n, TypeAttr(), type);
@@ -596,6 +620,10 @@ size_t NodeManager::poolSize() const{
   return d_nodeValuePool.size();
 }
 
+void NodeManager::reservePool(size_t n) {
+  d_nodeValuePool.reserve(poolSize() + n);
+}
+
 TypeNode NodeManager::mkSort(uint32_t flags) {
   NodeBuilder<1> nb(this, kind::SORT_TYPE);
   Node sortTag = NodeBuilder<0>(this, kind::SORT_TAG);
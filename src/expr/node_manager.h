@@ -36,6 +36,8 @@
 #include "expr/kind.h"
 #include "expr/metakind.h"
 #include "expr/node_value.h"
+#include "expr/node_value_allocator.h"
+#include "expr/node_value_pool.h"
 #include "options/options.h"
 
 namespace CVC4 {
@@ -50,6 +52,7 @@ namespace expr {
   }/* CVC4::expr::attr namespace */
 
   class TypeChecker;
+  class NodeArchiveReader;
 }/* CVC4::expr namespace */
 
 /**
@@ -85,6 +88,8 @@ class NodeManager {
   // friends so they can access mkVar() here, which is private
   friend Expr ExprManager::mkVar(const std::string&, Type, uint32_t flags);
   friend Expr ExprManager::mkVar(Type, uint32_t flags);
+  // friend so it can recreate the user variables of an archive
+  friend class expr::NodeArchiveReader;
 
   // friend so it can access NodeManager's d_listeners and notify clients
   friend std::vector<DatatypeType> ExprManager::mkMutualDatatypeTypes(std::vector<Datatype>&, std::set<Type>&);
@@ -94,9 +99,6 @@ class NodeManager {
     bool operator()(expr::NodeValue* nv) { return nv->d_rc > 0; }
   };
 
-  typedef std::unordered_set<expr::NodeValue*,
-                             expr::NodeValuePoolHashFunction,
-                             expr::NodeValuePoolEq> NodeValuePool;
   typedef std::unordered_set<expr::NodeValue*,
                              expr::NodeValueIDHashFunction,
                              expr::NodeValueIDEquality> NodeValueIDSet;
@@ -114,7 +116,14 @@ class NodeManager {
    */
   ListenerRegistrationList* d_registrations;
 
-  NodeValuePool d_nodeValuePool;
+  /**
+   * Storage for the non-constant NodeValues of this NodeManager.  It
+   * must outlive every NodeValue it hands out, so it is declared
+   * before (and hence destroyed after) everything that may hold one.
+   */
+  expr::NodeValueAllocator d_nvAllocator;
+
+  expr::NodeValuePool d_nodeValuePool;
 
   size_t next_id;
 
@@ -213,6 +222,21 @@ class NodeManager {
    */
   unsigned d_skolemCounter;
 
+  /**
+   * The work stack of checkTypes(): nodes to check, each paired with
+   * whether its dependencies have been pushed already.  It is kept
+   * between calls to save the allocation; a type rule that checks some
+   * other node re-enters checkTypes(), which works above the part of
+   * the stack in use.
+   */
+  std::vector<std::pair<TNode, bool> > d_typeCheckStack;
+
+  /**
+   * Type check the nodes on d_typeCheckStack above base, and their
+   * dependencies, bottom up.
+   */
+  void checkTypesFrom(size_t base);
+
   /**
    * Look up a NodeValue in the pool associated to this NodeManager.
    * The NodeValue argument need not be a "completely-constructed"
@@ -904,6 +928,20 @@ public:
    */
   TypeNode getType(TNode n, bool check = false);
 
+  /**
+   * Type check the given nodes and everything below them.  The check is
+   * a single bottom-up pass over the DAG below the nodes that visits
+   * each node once, skipping whatever has been checked before, and
+   * doesn't recurse, so arbitrarily deep terms are fine.  This is what
+   * getType(n, true) does for an unchecked n (unless early type
+   * checking is on); checking a batch of freshly built assertions at
+   * once shares the traversal among them.
+   *
+   * @throws TypeCheckingExceptionPrivate if any of the nodes is
+   * ill-typed
+   */
+  void checkTypes(const std::vector<TNode>& nodes);
+
   /**
    * Convert a node to an expression.  Uses the ExprManager
    * associated to this NodeManager.
@@ -944,6 +982,12 @@ public:
   /** Size of the node pool. */
   size_t poolSize() const;
 
+  /**
+   * Make room in the node pool for about n more nodes, so that it is
+   * not rehashed repeatedly while they are created.
+   */
+  void reservePool(size_t n);
+
   /** Deletes a list of attributes from the NM's AttributeManager.*/
   void deleteAttributes(const std::vector< const expr::attr::AttributeUniqueId* >& ids);
 
@@ -1156,24 +1200,14 @@ inline TypeNode NodeManager::mkTesterType(TypeNode domain) {
 }
 
 inline expr::NodeValue* NodeManager::poolLookup(expr::NodeValue* nv) const {
-  NodeValuePool::const_iterator find = d_nodeValuePool.find(nv);
-  if(find == d_nodeValuePool.end()) {
-    return NULL;
-  } else {
-    return *find;
-  }
+  return d_nodeValuePool.lookup(nv);
 }
 
 inline void NodeManager::poolInsert(expr::NodeValue* nv) {
-  Assert(d_nodeValuePool.find(nv) == d_nodeValuePool.end(),
-         "NodeValue already in the pool!");
   d_nodeValuePool.insert(nv);// FIXME multithreading
 }
 
 inline void NodeManager::poolRemove(expr::NodeValue* nv) {
-  Assert(d_nodeValuePool.find(nv) != d_nodeValuePool.end(),
-         "NodeValue is not in the pool!");
-
   d_nodeValuePool.erase(nv);// FIXME multithreading
 }
 
@@ -35,8 +35,9 @@ namespace attr {
 typedef Attribute<attr::VarNameTag, std::string> VarNameAttr;
 typedef Attribute<attr::GlobalVarTag(), bool> GlobalVarAttr;
 typedef Attribute<attr::SortArityTag, uint64_t> SortArityAttr;
-typedef expr::Attribute<expr::attr::TypeTag, TypeNode> TypeAttr;
-typedef expr::Attribute<expr::attr::TypeCheckedTag, bool> TypeCheckedAttr;
+// nearly every Node gets a type, so these live in dense tables
+typedef expr::DenseAttribute<expr::attr::TypeTag, TypeNode> TypeAttr;
+typedef expr::DenseAttribute<expr::attr::TypeCheckedTag, bool> TypeCheckedAttr;
 
 }/* CVC4::expr namespace */
 }/* CVC4 namespace */
@@ -43,6 +43,7 @@ class NodeManager;
 
 namespace expr {
   class NodeValue;
+  class NodeValueAllocator;
 }
 
 namespace kind {
@@ -106,6 +107,7 @@ class NodeValue {
   friend class ::CVC4::TypeNode;
   template <unsigned nchild_thresh> friend class ::CVC4::NodeBuilder;
   friend class ::CVC4::NodeManager;
+  friend class NodeValueAllocator;
 
   template <Kind k, bool pool>
   friend struct ::CVC4::kind::metakind::NodeValueConstCompare;
@@ -0,0 +1,75 @@
+/*********************                                                        */
+/*! \file node_value_allocator.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Size-class slab allocator for NodeValues.
+ **
+ ** Size-class slab allocator for NodeValues.
+ **/
+
+#include "expr/node_value_allocator.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace expr {
+
+NodeValueAllocator::NodeValueAllocator() {
+  Assert(blockSize(MAX_SLAB_CHILDREN) <= SLAB_SIZE);
+  Assert(sizeof(FreeBlock) <= sizeof(NodeValue));
+}
+
+NodeValueAllocator::~NodeValueAllocator() {
+  for(vector<char*>::iterator i = d_slabs.begin(); i != d_slabs.end(); ++i) {
+    free(*i);
+  }
+}
+
+void NodeValueAllocator::deallocate(vector<NodeValue*>& batch) {
+  // Chain the blocks up per size class, then splice each chain onto
+  // its free list in one go.
+  FreeBlock* heads[MAX_SLAB_CHILDREN + 1] = {};
+  FreeBlock* tails[MAX_SLAB_CHILDREN + 1] = {};
+  for(vector<NodeValue*>::iterator i = batch.begin(); i != batch.end(); ++i) {
+    unsigned nchildren = (*i)->d_nchildren;
+    if(nchildren > MAX_SLAB_CHILDREN) {
+      free(*i);
+      continue;
+    }
+    FreeBlock* b = reinterpret_cast<FreeBlock*>(*i);
+    b->d_next = heads[nchildren];
+    if(heads[nchildren] == NULL) {
+      tails[nchildren] = b;
+    }
+    heads[nchildren] = b;
+  }
+  for(unsigned k = 0; k <= MAX_SLAB_CHILDREN; ++k) {
+    if(heads[k] != NULL) {
+      SizeClass& c = d_classes[k];
+      tails[k]->d_next = c.d_free;
+      c.d_free = heads[k];
+    }
+  }
+  batch.clear();
+}
+
+void NodeValueAllocator::newSlab(SizeClass& c, size_t blockSize) {
+  char* slab = (char*) malloc(SLAB_SIZE);
+  if(slab == NULL) {
+    throw bad_alloc();
+  }
+  d_slabs.push_back(slab);
+  // the remainder of a slab that cannot hold a whole block is wasted
+  c.d_bump = slab;
+  c.d_end = slab + (SLAB_SIZE / blockSize) * blockSize;
+}
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,153 @@
+/*********************                                                        */
+/*! \file node_value_allocator.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Size-class slab allocator for NodeValues.
+ **
+ ** Size-class slab allocator for NodeValues.  Non-constant NodeValues
+ ** with few children (the overwhelming majority) are carved out of
+ ** large slabs, one size class per number of children, and recycled
+ ** through per-class free lists instead of going back to malloc().
+ ** Slabs are only returned to the system when the owning NodeManager
+ ** is destroyed.
+ **/
+
+#include "cvc4_private.h"
+
+/* circular dependency; force node.h first */
+#include "expr/node.h"
+
+#ifndef __CVC4__EXPR__NODE_VALUE_ALLOCATOR_H
+#define __CVC4__EXPR__NODE_VALUE_ALLOCATOR_H
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "base/cvc4_assert.h"
+#include "expr/node_value.h"
+
+namespace CVC4 {
+namespace expr {
+
+/**
+ * Hands out the storage of a NodeManager's non-constant NodeValues.
+ * Constants keep being malloc()ed, since their size depends on the
+ * payload type, which is not known when they are reclaimed.
+ */
+class NodeValueAllocator {
+ public:
+  /**
+   * NodeValues with at most this many children come from the slabs;
+   * larger ones are malloc()ed and free()d individually.
+   */
+  static const unsigned MAX_SLAB_CHILDREN = 15;
+
+  /** The size in bytes of each slab requested from the system. */
+  static const size_t SLAB_SIZE = 64 * 1024;
+
+  NodeValueAllocator();
+  ~NodeValueAllocator();
+
+  /**
+   * Allocate (uninitialized) storage for a non-constant NodeValue with
+   * nchildren children.
+   *
+   * @throws bad_alloc if the system is out of memory
+   */
+  NodeValue* allocate(unsigned nchildren) {
+    if(__builtin_expect( ( nchildren > MAX_SLAB_CHILDREN ), false )) {
+      NodeValue* nv = (NodeValue*) std::malloc(blockSize(nchildren));
+      if(nv == NULL) {
+        throw std::bad_alloc();
+      }
+      return nv;
+    }
+    SizeClass& c = d_classes[nchildren];
+    if(c.d_free != NULL) {
+      FreeBlock* b = c.d_free;
+      c.d_free = b->d_next;
+      return reinterpret_cast<NodeValue*>(b);
+    }
+    if(__builtin_expect( ( c.d_bump == c.d_end ), false )) {
+      newSlab(c, blockSize(nchildren));
+    }
+    NodeValue* nv = reinterpret_cast<NodeValue*>(c.d_bump);
+    c.d_bump += blockSize(nchildren);
+    return nv;
+  }
+
+  /**
+   * Return the storage of nv, whose d_nchildren must still be the
+   * number of children it was allocated with.
+   */
+  void deallocate(NodeValue* nv) {
+    unsigned nchildren = nv->d_nchildren;
+    if(__builtin_expect( ( nchildren > MAX_SLAB_CHILDREN ), false )) {
+      std::free(nv);
+      return;
+    }
+    SizeClass& c = d_classes[nchildren];
+    push(c, nv);
+  }
+
+  /**
+   * Return the storage of a whole batch of NodeValues at once (e.g.,
+   * the zombies collected by one NodeManager::reclaimZombies() call).
+   * The vector is left empty.
+   */
+  void deallocate(std::vector<NodeValue*>& batch);
+
+  /** The number of bytes currently held in slabs. */
+  size_t getSlabBytes() const { return d_slabs.size() * SLAB_SIZE; }
+
+ private:
+  /** A free block; overlays the header of a dead NodeValue. */
+  struct FreeBlock {
+    FreeBlock* d_next;
+  };/* struct NodeValueAllocator::FreeBlock */
+
+  struct SizeClass {
+    /** The head of the free list of recycled blocks. */
+    FreeBlock* d_free;
+    /** The unused tail [d_bump, d_end) of the most recent slab. */
+    char* d_bump;
+    char* d_end;
+
+    SizeClass() : d_free(NULL), d_bump(NULL), d_end(NULL) {}
+  };/* struct NodeValueAllocator::SizeClass */
+
+  static size_t blockSize(unsigned nchildren) {
+    return sizeof(NodeValue) + sizeof(NodeValue*) * nchildren;
+  }
+
+  static void push(SizeClass& c, NodeValue* nv) {
+    FreeBlock* b = reinterpret_cast<FreeBlock*>(nv);
+    b->d_next = c.d_free;
+    c.d_free = b;
+  }
+
+  /** Give c a fresh slab. */
+  void newSlab(SizeClass& c, size_t blockSize);
+
+  SizeClass d_classes[MAX_SLAB_CHILDREN + 1];
+
+  /** Every slab ever allocated, to be released on destruction. */
+  std::vector<char*> d_slabs;
+
+  // disallow copy
+  NodeValueAllocator(const NodeValueAllocator&) CVC4_UNDEFINED;
+  NodeValueAllocator& operator=(const NodeValueAllocator&) CVC4_UNDEFINED;
+};/* class NodeValueAllocator */
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__EXPR__NODE_VALUE_ALLOCATOR_H */
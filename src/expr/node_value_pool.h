@@ -0,0 +1,244 @@
+/*********************                                                        */
+/*! \file node_value_pool.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief The hash-consing table of NodeValues owned by a NodeManager.
+ **
+ ** The hash-consing table of NodeValues owned by a NodeManager.
+ **/
+
+#include "cvc4_private.h"
+
+/* circular dependency; force node.h first */
+#include "expr/node.h"
+
+#ifndef __CVC4__EXPR__NODE_VALUE_POOL_H
+#define __CVC4__EXPR__NODE_VALUE_POOL_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "base/cvc4_assert.h"
+#include "expr/node_value.h"
+
+namespace CVC4 {
+namespace expr {
+
+/**
+ * The set of fully-constructed NodeValues, keyed on their structure
+ * (kind and children, or constant payload).
+ *
+ * It is an open-addressing (Robin Hood) table of slots that pair a
+ * NodeValue pointer with its (mixed) pool hash.  A lookup thus
+ * computes NodeValue::poolHash() once, probes a contiguous run of
+ * slots, and only follows a pointer to compare structure when the
+ * cached hashes agree; growing the table never rehashes a NodeValue.
+ */
+class NodeValuePool {
+ public:
+  NodeValuePool() {}
+
+  /**
+   * Look up a NodeValue equal to nv in the pool.  The argument need not
+   * be completely constructed; see NodeManager::poolLookup().
+   *
+   * @return the NodeValue in the pool, or NULL if there is none
+   */
+  NodeValue* lookup(NodeValue* nv) const {
+    return d_table.lookup(nv, hash(nv));
+  }
+
+  /** Insert nv into the pool; it is an error if it is already there. */
+  void insert(NodeValue* nv) {
+    uint64_t h = hash(nv);
+    Assert(d_table.lookup(nv, h) == NULL, "NodeValue already in the pool!");
+    d_table.insert(nv, h);
+  }
+
+  /** Remove nv from the pool; it is an error if it is not there. */
+  void erase(NodeValue* nv) {
+    d_table.erase(nv, hash(nv));
+  }
+
+  /**
+   * Make room for about n NodeValues, so that a pool expected to grow
+   * large (e.g., while parsing a big input) is not rehashed repeatedly
+   * on the way.
+   */
+  void reserve(size_t n) { d_table.reserve(n); }
+
+  /** The number of NodeValues in the pool. */
+  size_t size() const { return d_table.size(); }
+
+  /** Append every NodeValue in the pool to nvs (for debugging). */
+  void getAll(std::vector<NodeValue*>& nvs) const { d_table.getAll(nvs); }
+
+ private:
+  /**
+   * An open-addressing hash table with Robin Hood insertion and
+   * backward-shift deletion (so there are no tombstones).  Capacity is
+   * a power of two and the load factor is kept at or below 7/8.
+   */
+  class Table {
+   public:
+    Table() : d_slots(NULL), d_capacity(0), d_size(0), d_shift(64) {}
+    ~Table() { delete[] d_slots; }
+
+    NodeValue* lookup(NodeValue* nv, uint64_t h) const {
+      if(d_size == 0) {
+        return NULL;
+      }
+      NodeValuePoolEq eq;
+      size_t mask = d_capacity - 1;
+      for(size_t i = home(h), d = 0; ; i = (i + 1) & mask, ++d) {
+        const Slot& slot = d_slots[i];
+        // an empty slot, or one closer to its home than we are to ours,
+        // ends the probe: nv would have displaced it on insertion
+        if(slot.d_nv == NULL || distance(slot, i) < d) {
+          return NULL;
+        }
+        if(slot.d_hash == h && eq(slot.d_nv, nv)) {
+          return slot.d_nv;
+        }
+      }
+    }
+
+    /** Insert nv, which must not already be in the table. */
+    void insert(NodeValue* nv, uint64_t h) {
+      if(__builtin_expect( ( 8 * (d_size + 1) > 7 * d_capacity ), false )) {
+        grow(d_capacity == 0 ? 16 : 2 * d_capacity);
+      }
+      place(nv, h);
+      ++d_size;
+    }
+
+    void erase(NodeValue* nv, uint64_t h) {
+      Assert(d_size > 0, "NodeValue is not in the pool!");
+      size_t mask = d_capacity - 1;
+      size_t i = home(h);
+      while(d_slots[i].d_nv != nv) {
+        Assert(d_slots[i].d_nv != NULL, "NodeValue is not in the pool!");
+        i = (i + 1) & mask;
+      }
+      // shift the rest of the cluster back over the hole
+      for(size_t j = (i + 1) & mask;
+          d_slots[j].d_nv != NULL && distance(d_slots[j], j) > 0;
+          i = j, j = (j + 1) & mask) {
+        d_slots[i] = d_slots[j];
+      }
+      d_slots[i].d_nv = NULL;
+      --d_size;
+    }
+
+    void reserve(size_t n) {
+      size_t capacity = d_capacity == 0 ? 16 : d_capacity;
+      while(8 * n > 7 * capacity) {
+        capacity *= 2;
+      }
+      if(capacity > d_capacity) {
+        grow(capacity);
+      }
+    }
+
+    size_t size() const { return d_size; }
+
+    void getAll(std::vector<NodeValue*>& nvs) const {
+      for(size_t i = 0; i < d_capacity; ++i) {
+        if(d_slots[i].d_nv != NULL) {
+          nvs.push_back(d_slots[i].d_nv);
+        }
+      }
+    }
+
+   private:
+    struct Slot {
+      uint64_t d_hash;
+      NodeValue* d_nv;
+    };/* struct NodeValuePool::Table::Slot */
+
+    size_t home(uint64_t h) const {
+      return size_t(h >> d_shift);
+    }
+
+    size_t distance(const Slot& slot, size_t i) const {
+      return (i - home(slot.d_hash)) & (d_capacity - 1);
+    }
+
+    /** Robin Hood placement of a NodeValue known to be absent. */
+    void place(NodeValue* nv, uint64_t h) {
+      Slot carry = { h, nv };
+      size_t mask = d_capacity - 1;
+      for(size_t i = home(h), d = 0; ; i = (i + 1) & mask, ++d) {
+        Slot& slot = d_slots[i];
+        if(slot.d_nv == NULL) {
+          slot = carry;
+          return;
+        }
+        size_t sd = distance(slot, i);
+        if(sd < d) {
+          std::swap(slot, carry);
+          d = sd;
+        }
+      }
+    }
+
+    void grow(size_t capacity) {
+      Slot* old = d_slots;
+      size_t oldCapacity = d_capacity;
+      d_slots = new Slot[capacity];
+      for(size_t i = 0; i < capacity; ++i) {
+        d_slots[i].d_nv = NULL;
+      }
+      d_capacity = capacity;
+      d_shift = 64;
+      while((size_t(1) << (64 - d_shift)) < capacity) {
+        --d_shift;
+      }
+      for(size_t i = 0; i < oldCapacity; ++i) {
+        if(old[i].d_nv != NULL) {
+          place(old[i].d_nv, old[i].d_hash);
+        }
+      }
+      delete[] old;
+    }
+
+    Slot* d_slots;
+    size_t d_capacity;
+    size_t d_size;
+    /** 64 - log2(d_capacity) */
+    unsigned d_shift;
+
+    // disallow copy
+    Table(const Table&) CVC4_UNDEFINED;
+    Table& operator=(const Table&) CVC4_UNDEFINED;
+  };/* class NodeValuePool::Table */
+
+  /**
+   * NodeValue::poolHash() spread over all 64 bits (Fibonacci hashing),
+   * since table slots are picked from the high bits.
+   */
+  static uint64_t hash(const NodeValue* nv) {
+    return uint64_t(nv->poolHash()) * UINT64_C(0x9e3779b97f4a7c15);
+  }
+
+  Table d_table;
+
+  // disallow copy
+  NodeValuePool(const NodeValuePool&) CVC4_UNDEFINED;
+  NodeValuePool& operator=(const NodeValuePool&) CVC4_UNDEFINED;
+};/* class NodeValuePool */
+
+}/* CVC4::expr namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__EXPR__NODE_VALUE_POOL_H */
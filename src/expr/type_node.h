@@ -40,6 +40,8 @@ class NodeManager;
 
 namespace expr {
   class NodeValue;
+  class NodeArchiveReader;
+  class NodeArchiveWriter;
 }/* CVC4::expr namespace */
 
 /**
@@ -77,6 +79,8 @@ private:
   explicit TypeNode(const expr::NodeValue*);
 
   friend class NodeManager;
+  friend class expr::NodeArchiveReader;
+  friend class expr::NodeArchiveWriter;
 
   template <unsigned nchild_thresh>
   friend class NodeBuilder;
@@ -68,4 +68,20 @@ std::ostream& operator<<(std::ostream& out, theory::bv::SatSolverMode solver) {
   return out;
 }
 
+std::ostream& operator<<(std::ostream& out, theory::bv::BvMultMode mode)
+{
+  switch (mode)
+  {
+    case theory::bv::BITVECTOR_MULT_SHIFT_ADD:
+      out << "BITVECTOR_MULT_SHIFT_ADD";
+      break;
+    case theory::bv::BITVECTOR_MULT_WALLACE:
+      out << "BITVECTOR_MULT_WALLACE";
+      break;
+    default: out << "BvMultMode:UNKNOWN![" << unsigned(mode) << "]";
+  }
+
+  return out;
+}
+
 }/* CVC4 namespace */
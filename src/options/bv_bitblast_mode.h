@@ -68,12 +68,25 @@ enum SatSolverMode
   SAT_SOLVER_CADICAL,
 }; /* enum SatSolver */
 
+/** Enumeration of the multiplier circuits of the bit-blaster */
+enum BvMultMode
+{
+  /** A row of ripple-carry adders per partial product. */
+  BITVECTOR_MULT_SHIFT_ADD,
+  /**
+   * The partial products reduced by a Wallace tree of full adders, with a
+   * final ripple-carry adder.
+   */
+  BITVECTOR_MULT_WALLACE
+}; /* enum BvMultMode */
+
 }/* CVC4::theory::bv namespace */
 }/* CVC4::theory namespace */
 
 std::ostream& operator<<(std::ostream& out, theory::bv::BitblastMode mode);
 std::ostream& operator<<(std::ostream& out, theory::bv::BvSlicerMode mode);
 std::ostream& operator<<(std::ostream& out, theory::bv::SatSolverMode mode);
+std::ostream& operator<<(std::ostream& out, theory::bv::BvMultMode mode);
 
 }/* CVC4 namespace */
 
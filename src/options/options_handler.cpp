@@ -1176,12 +1176,6 @@ theory::bv::BitblastMode OptionsHandler::stringToBitblastMode(
     }
     return theory::bv::BITBLAST_MODE_LAZY;
   } else if(optarg == "eager") {
-
-    if (options::incrementalSolving() &&
-        options::incrementalSolving.wasSetByUser()) {
-      throw OptionException(std::string("Eager bit-blasting does not currently support incremental mode. \n\
-                                         Try --bitblast=lazy"));
-    }
     if (!options::bitvectorToBool.wasSetByUser()) {
       options::bitvectorToBool.set(true);
     }
@@ -1232,6 +1226,39 @@ theory::bv::BvSlicerMode OptionsHandler::stringToBvSlicerMode(
   }
 }
 
+const std::string OptionsHandler::s_bvMultModeHelp = "\
+Multiplier circuits supported by the --bv-mult option:\n\
+\n\
+shift-add (default)\n\
++ A row of ripple-carry adders per partial product\n\
+\n\
+wallace\n\
++ The partial products reduced by a Wallace tree of full adders\n\
+";
+
+theory::bv::BvMultMode OptionsHandler::stringToBvMultMode(std::string option,
+                                                          std::string optarg)
+{
+  if (optarg == "shift-add")
+  {
+    return theory::bv::BITVECTOR_MULT_SHIFT_ADD;
+  }
+  else if (optarg == "wallace")
+  {
+    return theory::bv::BITVECTOR_MULT_WALLACE;
+  }
+  else if (optarg == "help")
+  {
+    puts(s_bvMultModeHelp.c_str());
+    exit(1);
+  }
+  else
+  {
+    throw OptionException(std::string("unknown option for --bv-mult: `")
+                          + optarg + "'.  Try --bv-mult=help.");
+  }
+}
+
 void OptionsHandler::setBitblastAig(std::string option, bool arg)
 {
   if(arg) {
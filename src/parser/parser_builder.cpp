@@ -19,6 +19,8 @@
 
 #include "parser/parser_builder.h"
 
+#include <sys/stat.h>
+
 #include <string>
 
 #include "expr/expr_manager.h"
@@ -32,6 +34,25 @@
 namespace CVC4 {
 namespace parser {
 
+namespace {
+
+/**
+ * A deliberately high estimate of the number of input bytes per
+ * distinct term, so the term count derived from it errs on the low
+ * side: over-reserving only wastes memory.
+ */
+const size_t BYTES_PER_TERM_ESTIMATE = 64;
+
+/** Size em's term tables once for the contents of the named file. */
+void reserveExprsForFile(ExprManager* em, const std::string& filename) {
+  struct stat st;
+  if(stat(filename.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+    em->reserveExprs(size_t(st.st_size) / BYTES_PER_TERM_ESTIMATE);
+  }
+}
+
+}  // namespace
+
 ParserBuilder::ParserBuilder(ExprManager* exprManager,
                              const std::string& filename) :
   d_filename(filename),
@@ -70,6 +91,7 @@ Parser* ParserBuilder::build()
   switch( d_inputType ) {
   case FILE_INPUT:
     input = Input::newFileInput(d_lang, d_filename, d_mmap);
+    reserveExprsForFile(d_exprManager, d_filename);
     break;
   case LINE_BUFFERED_STREAM_INPUT:
     assert( d_streamInput != NULL );
@@ -20,6 +20,7 @@
 #include "proof/proof.h"
 #include "smt/dump.h"
 #include "smt/smt_statistics_registry.h"
+#include "theory/rewriter.h"
 
 namespace CVC4 {
 namespace preprocessing {
@@ -54,6 +55,18 @@ void AssertionPipeline::replace(size_t i, const std::vector<Node>& ns)
   }
 }
 
+void AssertionPipeline::rewrite()
+{
+  for (size_t i = 0, size = d_nodes.size(); i < size; ++i)
+  {
+    Node n = theory::Rewriter::rewrite(d_nodes[i]);
+    if (n != d_nodes[i])
+    {
+      replace(i, n);
+    }
+  }
+}
+
 PreprocessingPassResult PreprocessingPass::apply(
     AssertionPipeline* assertionsToPreprocess) {
   TimerStat::CodeTimer codeTimer(d_timer);
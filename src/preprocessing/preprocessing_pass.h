@@ -80,6 +80,12 @@ class AssertionPipeline {
    * dependencies.
    */
   void replace(size_t i, const std::vector<Node>& ns);
+
+  /*
+   * Rewrites each assertion (see theory::Rewriter::rewrite()), replacing the
+   * ones that change.
+   */
+  void rewrite();
 }; /* class AssertionPipeline */
 
 /**
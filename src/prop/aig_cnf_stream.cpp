@@ -0,0 +1,508 @@
+/*********************                                                        */
+/*! \file aig_cnf_stream.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A CnfStream that clausifies through an and-inverter graph
+ **
+ ** A CnfStream that clausifies through an and-inverter graph.
+ **/
+
+#include "prop/aig_cnf_stream.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "base/cvc4_assert.h"
+#include "base/output.h"
+#include "options/smt_options.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/theory.h"
+#include "util/resource_manager.h"
+
+using namespace std;
+using namespace CVC4::kind;
+
+namespace CVC4 {
+namespace prop {
+
+AigCnfStream::AigCnfStream(SatSolver* satSolver, Registrar* registrar,
+                           context::Context* context, bool polarity,
+                           std::string name)
+    : CnfStream(satSolver, registrar, context, false, name),
+      d_encodings(context),
+      d_polarity(polarity),
+      d_statistics("prop::AigCnfStream" + name)
+{
+  // the gate 0 is the constant false
+  d_gates.push_back(Gate(FALSE_EDGE, FALSE_EDGE));
+  d_inputs.push_back(Node::null());
+}
+
+AigCnfStream::~AigCnfStream() {}
+
+AigCnfStream::Edge AigCnfStream::mkAnd(Edge a, Edge b) {
+  if(a > b) {
+    std::swap(a, b);
+  }
+  if(a == FALSE_EDGE || a == negate(b)) {
+    return FALSE_EDGE;
+  }
+  if(a == TRUE_EDGE || a == b) {
+    return b;
+  }
+  pair<Edge, Edge> key(a, b);
+  std::unordered_map<pair<Edge, Edge>, unsigned, EdgePairHashFunction>::
+      const_iterator i = d_strash.find(key);
+  if(i != d_strash.end()) {
+    ++d_statistics.d_strashHits;
+    return 2 * i->second;
+  }
+  unsigned gate = d_gates.size();
+  d_gates.push_back(Gate(a, b));
+  d_inputs.push_back(Node::null());
+  ++d_gates[gateOf(a)].d_fanout;
+  ++d_gates[gateOf(b)].d_fanout;
+  d_strash[key] = gate;
+  ++d_statistics.d_gates;
+  return 2 * gate;
+}
+
+AigCnfStream::Edge AigCnfStream::mkInput(TNode atom) {
+  unsigned gate = d_gates.size();
+  d_gates.push_back(Gate(FALSE_EDGE, FALSE_EDGE));
+  d_inputs.push_back(atom);
+  return 2 * gate;
+}
+
+AigCnfStream::Edge AigCnfStream::toAig(TNode node) {
+  if(node.getKind() == NOT) {
+    return negate(toAig(node[0]));
+  }
+  std::unordered_map<Node, Edge, NodeHashFunction>::const_iterator i =
+      d_nodeToEdge.find(node);
+  if(i != d_nodeToEdge.end()) {
+    return i->second;
+  }
+
+  Edge e;
+  switch(node.getKind()) {
+  case CONST_BOOLEAN:
+    e = node.getConst<bool>() ? TRUE_EDGE : FALSE_EDGE;
+    break;
+  case AND:
+    e = TRUE_EDGE;
+    for(TNode::const_iterator j = node.begin(); j != node.end(); ++j) {
+      e = mkAnd(e, toAig(*j));
+    }
+    break;
+  case OR:
+    // a | b = ~(~a & ~b)
+    e = TRUE_EDGE;
+    for(TNode::const_iterator j = node.begin(); j != node.end(); ++j) {
+      e = mkAnd(e, negate(toAig(*j)));
+    }
+    e = negate(e);
+    break;
+  case IMPLIES:
+    // a => b = ~(a & ~b)
+    e = negate(mkAnd(toAig(node[0]), negate(toAig(node[1]))));
+    break;
+  case ITE: {
+    // ite(c, t, e) = ~(~(c & t) & ~(~c & e))
+    Edge c = toAig(node[0]);
+    Edge left = mkAnd(c, toAig(node[1]));
+    Edge right = mkAnd(negate(c), toAig(node[2]));
+    e = negate(mkAnd(negate(left), negate(right)));
+    break;
+  }
+  case XOR:
+  case EQUAL:
+    if(node[0].getType().isBoolean()) {
+      // a xor b = ~(~(a & ~b) & ~(~a & b))
+      Edge a = toAig(node[0]);
+      Edge b = toAig(node[1]);
+      Edge left = mkAnd(a, negate(b));
+      Edge right = mkAnd(negate(a), b);
+      e = mkAnd(negate(left), negate(right));
+      if(node.getKind() == XOR) {
+        e = negate(e);
+      }
+      break;
+    }
+    // a theory atom
+    e = mkInput(node);
+    break;
+  default:
+    e = mkInput(node);
+    break;
+  }
+  d_nodeToEdge[node] = e;
+  return e;
+}
+
+void AigCnfStream::collectConjuncts(unsigned gate, vector<Edge>& conjuncts) {
+  vector<Edge> toVisit;
+  toVisit.push_back(d_gates[gate].d_right);
+  toVisit.push_back(d_gates[gate].d_left);
+  while(!toVisit.empty()) {
+    Edge e = toVisit.back();
+    toVisit.pop_back();
+    unsigned g = gateOf(e);
+    if(!isNegated(e) && g != 0 && !isInput(g) && d_gates[g].d_fanout == 1 &&
+       d_encodings.find(g) == d_encodings.end()) {
+      toVisit.push_back(d_gates[g].d_right);
+      toVisit.push_back(d_gates[g].d_left);
+    } else {
+      conjuncts.push_back(e);
+    }
+  }
+}
+
+bool AigCnfStream::matchIte(unsigned gate, Edge& s, Edge& t, Edge& e) {
+  Edge left = d_gates[gate].d_left;
+  Edge right = d_gates[gate].d_right;
+  if(!isNegated(left) || !isNegated(right)) {
+    return false;
+  }
+  unsigned x = gateOf(left);
+  unsigned y = gateOf(right);
+  if(x == 0 || y == 0 || isInput(x) || isInput(y) ||
+     d_gates[x].d_fanout != 1 || d_gates[y].d_fanout != 1 ||
+     d_encodings.find(x) != d_encodings.end() ||
+     d_encodings.find(y) != d_encodings.end()) {
+    return false;
+  }
+  // gate = ~(x0 & x1) & ~(y0 & y1); look for x_i = ~y_j
+  Edge xs[2] = { d_gates[x].d_left, d_gates[x].d_right };
+  Edge ys[2] = { d_gates[y].d_left, d_gates[y].d_right };
+  for(unsigned i = 0; i < 2; ++i) {
+    for(unsigned j = 0; j < 2; ++j) {
+      if(xs[i] == negate(ys[j])) {
+        // ~gate = (s & x') | (~s & y') = ite(s, x', y')
+        s = xs[i];
+        t = negate(xs[1 - i]);
+        e = negate(ys[1 - j]);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+SatLiteral AigCnfStream::encode(Edge e, unsigned polarities) {
+  if(!d_polarity) {
+    polarities = BOTH;
+  }
+  unsigned gate = gateOf(e);
+  if(isNegated(e)) {
+    // the literal of ~g implies ~g iff g implies the literal of g
+    polarities = ((polarities & POS) ? NEG : 0) | ((polarities & NEG) ? POS : 0);
+  }
+
+  SatLiteral lit;
+  if(gate == 0) {
+    lit = SatLiteral(d_satSolver->falseVar());
+  } else if(isInput(gate)) {
+    TNode atom = d_inputs[gate];
+    lit = hasLiteral(atom) ? getLiteral(atom) : convertAtom(atom);
+  } else {
+    Encoding encoding;
+    context::CDHashMap<unsigned, Encoding>::const_iterator i =
+        d_encodings.find(gate);
+    bool fresh = i == d_encodings.end();
+    if(!fresh) {
+      encoding = (*i).second;
+    }
+    unsigned missing = polarities & ~encoding.d_polarities;
+    if(missing == 0) {
+      lit = encoding.d_lit;
+    } else {
+      lit = fresh ? SatLiteral(d_satSolver->newVar(false, false, true))
+                  : encoding.d_lit;
+      d_encodings.insert(gate,
+                         Encoding(lit, encoding.d_polarities | polarities));
+      if(fresh && polarities != BOTH) {
+        ++d_statistics.d_skippedHalves;
+      }
+
+      // The definitions of the gates are permanent, even in a removable
+      // lemma: they can't be wrong
+      bool removable = d_removable;
+      d_removable = false;
+      Edge s, t, f;
+      if(matchIte(gate, s, t, f)) {
+        // lit = ite(s, t, f)
+        bool isXor = t == negate(f);
+        if(fresh) {
+          if(isXor) {
+            ++d_statistics.d_xors;
+          } else {
+            ++d_statistics.d_ites;
+          }
+        }
+        if(missing & POS) {
+          // lit => ite(s, t, f)
+          SatLiteral sLit = encode(s, BOTH);
+          SatLiteral tLit = encode(t, POS);
+          SatLiteral fLit = encode(f, POS);
+          assertClause(d_currentNode, ~lit, ~sLit, tLit);
+          assertClause(d_currentNode, ~lit, sLit, fLit);
+          if(!isXor) {
+            assertClause(d_currentNode, ~lit, tLit, fLit);
+          }
+        }
+        if(missing & NEG) {
+          // ite(s, t, f) => lit
+          SatLiteral sLit = encode(s, BOTH);
+          SatLiteral tLit = encode(t, NEG);
+          SatLiteral fLit = encode(f, NEG);
+          assertClause(d_currentNode, lit, ~sLit, ~tLit);
+          assertClause(d_currentNode, lit, sLit, ~fLit);
+          if(!isXor) {
+            assertClause(d_currentNode, lit, ~tLit, ~fLit);
+          }
+        }
+      } else {
+        vector<Edge> conjuncts;
+        collectConjuncts(gate, conjuncts);
+        if(fresh) {
+          d_statistics.d_mergedGates += conjuncts.size() - 2;
+        }
+        if(missing & POS) {
+          // lit => (c_1 & ... & c_n)
+          for(unsigned j = 0; j < conjuncts.size(); ++j) {
+            assertClause(d_currentNode, ~lit, encode(conjuncts[j], POS));
+          }
+        }
+        if(missing & NEG) {
+          // (c_1 & ... & c_n) => lit
+          SatClause clause(conjuncts.size() + 1);
+          for(unsigned j = 0; j < conjuncts.size(); ++j) {
+            clause[j] = ~encode(conjuncts[j], NEG);
+          }
+          clause[conjuncts.size()] = lit;
+          assertClause(d_currentNode, clause);
+        }
+      }
+      d_removable = removable;
+    }
+  }
+
+  return isNegated(e) ? ~lit : lit;
+}
+
+void AigCnfStream::assertEdge(TNode node, Edge e) {
+  if(e == TRUE_EDGE) {
+    return;
+  }
+  unsigned gate = gateOf(e);
+  if(gate == 0 || isInput(gate)) {
+    assertClause(node, encode(e, POS));
+    return;
+  }
+  Edge s, t, f;
+  if(!isNegated(e)) {
+    // a conjunction: assert each conjunct
+    vector<Edge> conjuncts;
+    std::unordered_set<Edge> visited;
+    vector<Edge> toVisit;
+    toVisit.push_back(e);
+    while(!toVisit.empty()) {
+      Edge c = toVisit.back();
+      toVisit.pop_back();
+      if(!visited.insert(c).second) {
+        continue;
+      }
+      unsigned g = gateOf(c);
+      if(!isNegated(c) && g != 0 && !isInput(g)) {
+        toVisit.push_back(d_gates[g].d_right);
+        toVisit.push_back(d_gates[g].d_left);
+      } else {
+        conjuncts.push_back(c);
+      }
+    }
+    for(unsigned i = 0; i < conjuncts.size(); ++i) {
+      assertEdge(node, conjuncts[i]);
+    }
+  } else if(matchIte(gate, s, t, f)) {
+    // ~ite(s, t, f) = (s => ~t) & (~s => ~f)
+    SatLiteral sLit = encode(s, BOTH);
+    assertClause(node, ~sLit, encode(negate(t), POS));
+    assertClause(node, sLit, encode(negate(f), POS));
+  } else {
+    // a disjunction: ~(c_1 & ... & c_n) = ~c_1 | ... | ~c_n
+    vector<Edge> conjuncts;
+    collectConjuncts(gate, conjuncts);
+    SatClause clause(conjuncts.size());
+    for(unsigned i = 0; i < conjuncts.size(); ++i) {
+      clause[i] = encode(negate(conjuncts[i]), POS);
+    }
+    assertClause(node, clause);
+  }
+}
+
+void AigCnfStream::exposeLiterals(TNode node) {
+  std::unordered_set<TNode, TNodeHashFunction> visited;
+  vector<TNode> toVisit;
+  toVisit.push_back(node);
+  while(!toVisit.empty()) {
+    TNode current = toVisit.back();
+    toVisit.pop_back();
+    if(!visited.insert(current).second) {
+      continue;
+    }
+    Kind k = current.getKind();
+    if(k == NOT) {
+      toVisit.push_back(current[0]);
+      continue;
+    }
+    if(k != AND && k != OR && k != IMPLIES && k != ITE && k != XOR &&
+       (k != EQUAL || !current[0].getType().isBoolean())) {
+      // an atom; it gets a literal even if the graph folded it away, as
+      // the justification heuristic may still reach it from above
+      if(!hasLiteral(current)) {
+        convertAtom(current);
+      }
+      continue;
+    }
+    if(hasLiteral(current)) {
+      continue;
+    }
+    toVisit.insert(toVisit.end(), current.begin(), current.end());
+    std::unordered_map<Node, Edge, NodeHashFunction>::const_iterator i =
+        d_nodeToEdge.find(current);
+    if(i == d_nodeToEdge.end()) {
+      continue;
+    }
+    Edge e = i->second;
+    unsigned gate = gateOf(e);
+    SatLiteral lit;
+    if(gate == 0 || isInput(gate)) {
+      // Folded to a constant or to an atom.  The heuristic still walks
+      // the subformulas below, so they get their own (full) definitions.
+      for(TNode::iterator j = current.begin(); j != current.end(); ++j) {
+        Edge child = toAig(*j);
+        if(gateOf(child) != 0 && !isInput(gateOf(child))) {
+          encode(child, BOTH);
+        }
+      }
+      if(gate == 0) {
+        lit = SatLiteral(d_satSolver->falseVar());
+      } else {
+        TNode atom = d_inputs[gate];
+        lit = hasLiteral(atom) ? getLiteral(atom) : convertAtom(atom);
+      }
+    } else {
+      context::CDHashMap<unsigned, Encoding>::const_iterator j =
+          d_encodings.find(gate);
+      if(j == d_encodings.end() || (*j).second.d_polarities != BOTH) {
+        continue;
+      }
+      lit = (*j).second.d_lit;
+    }
+    if(isNegated(e)) {
+      lit = ~lit;
+    }
+    d_nodeToLiteralMap.insert(current, lit);
+    d_nodeToLiteralMap.insert(current.notNode(), ~lit);
+  }
+}
+
+void AigCnfStream::convertAndAssert(TNode node,
+                                    bool removable,
+                                    bool negated,
+                                    ProofRule proof_id,
+                                    TNode from) {
+  Debug("cnf") << "AigCnfStream::convertAndAssert(" << node
+               << ", removable = " << (removable ? "true" : "false")
+               << ", negated = " << (negated ? "true" : "false") << ")" << endl;
+
+  if (d_convertAndAssertCounter % ResourceManager::getFrequencyCount() == 0) {
+    NodeManager::currentResourceManager()->spendResource(options::cnfStep());
+    d_convertAndAssertCounter = 0;
+  }
+  ++d_convertAndAssertCounter;
+
+  d_removable = removable;
+  Node assertion = negated ? node.negate() : Node(node);
+  d_currentNode = assertion;
+  Edge e = toAig(node);
+  assertEdge(assertion, negated ? negate(e) : e);
+  exposeLiterals(node);
+  flushClauses();
+}
+
+void AigCnfStream::ensureLiteral(TNode n, bool noPreregistration) {
+  // These are not removable and have no proof ID
+  d_removable = false;
+
+  Debug("cnf") << "AigCnfStream::ensureLiteral(" << n << ")" << endl;
+  n = stripNot(n);
+  if(hasLiteral(n)) {
+    SatLiteral lit = getLiteral(n);
+    if(!d_literalToNodeMap.contains(lit)){
+      // Store backward-mappings
+      d_literalToNodeMap.insert(lit, n);
+      d_literalToNodeMap.insert(~lit, n.notNode());
+    }
+    return;
+  }
+
+  AlwaysAssertArgument(n.getType().isBoolean(), n,
+                       "CnfStream::ensureLiteral() requires a node of Boolean type.\n"
+                       "got node: %s\n"
+                       "its type: %s\n",
+                       n.toString().c_str(),
+                       n.getType().toString().c_str());
+
+  if(theory::Theory::theoryOf(n) == theory::THEORY_BOOL && !n.isVar()) {
+    // A literal that is definitionally equal to the formula; it may be the
+    // literal of another node, if the formula folds to it in the graph
+    d_currentNode = n;
+    SatLiteral lit = encode(toAig(n), BOTH);
+    flushClauses();
+    d_nodeToLiteralMap.insert(n, lit);
+    d_nodeToLiteralMap.insert(n.notNode(), ~lit);
+    d_literalToNodeMap.insert_safe(lit, n);
+    d_literalToNodeMap.insert_safe(~lit, n.notNode());
+  } else {
+    // We have a theory atom or variable.
+    convertAtom(n, noPreregistration);
+  }
+}
+
+AigCnfStream::Statistics::Statistics(const std::string& name)
+    : d_gates(name + "::gates", 0),
+      d_strashHits(name + "::strashHits", 0),
+      d_mergedGates(name + "::mergedGates", 0),
+      d_ites(name + "::ites", 0),
+      d_xors(name + "::xors", 0),
+      d_skippedHalves(name + "::onePolarityGates", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_gates);
+  smtStatisticsRegistry()->registerStat(&d_strashHits);
+  smtStatisticsRegistry()->registerStat(&d_mergedGates);
+  smtStatisticsRegistry()->registerStat(&d_ites);
+  smtStatisticsRegistry()->registerStat(&d_xors);
+  smtStatisticsRegistry()->registerStat(&d_skippedHalves);
+}
+
+AigCnfStream::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_gates);
+  smtStatisticsRegistry()->unregisterStat(&d_strashHits);
+  smtStatisticsRegistry()->unregisterStat(&d_mergedGates);
+  smtStatisticsRegistry()->unregisterStat(&d_ites);
+  smtStatisticsRegistry()->unregisterStat(&d_xors);
+  smtStatisticsRegistry()->unregisterStat(&d_skippedHalves);
+}
+
+}/* CVC4::prop namespace */
+}/* CVC4 namespace */
@@ -0,0 +1,228 @@
+/*********************                                                        */
+/*! \file aig_cnf_stream.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A CnfStream that clausifies through an and-inverter graph
+ **
+ ** A CnfStream that first translates the Boolean structure of the
+ ** formulas into a structurally hashed and-inverter graph (AIG), and then
+ ** clausifies the graph (--cnf-aig).
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__PROP__AIG_CNF_STREAM_H
+#define __CVC4__PROP__AIG_CNF_STREAM_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "context/cdhashmap.h"
+#include "expr/node.h"
+#include "prop/cnf_stream.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace prop {
+
+/**
+ * AigCnfStream translates the Boolean structure of the formulas into an
+ * and-inverter graph: binary AND gates and negated edges, with constant
+ * folding and structural hashing, so that subformulas that only differ
+ * in their use of NOT, OR, IMPLIES, XOR, EQUAL and ITE (or in the way
+ * conjunctions are nested) share a gate.  The atoms (theory atoms and
+ * Boolean variables) are the inputs of the graph.
+ *
+ * The graph is then clausified lazily from the asserted roots:
+ *
+ * - a gate whose fanout is one, and which doesn't have a SAT literal yet,
+ *   is merged into its parent, so that a tree of ANDs becomes one n-ary
+ *   AND, with a single literal;
+ * - a gate of the shape ~(s & t) & ~(~s & e) is recognized as an
+ *   if-then-else (an XOR if e = ~t), and is given the 4 (or 6) clauses of
+ *   the ITE instead of 3 gates;
+ * - with --cnf-polarity, only the halves of the definitions that are
+ *   needed by the polarities in which the gates occur are asserted
+ *   (Plaisted-Greenbaum); the other half is asserted if the gate later
+ *   occurs in the other polarity.
+ *
+ * Only the literals of the gates that are fully defined (in both
+ * polarities) are made visible through getLiteral(), so that, e.g., the
+ * justification heuristic never reads a literal that doesn't have the
+ * value of its node.  Every atom of an asserted formula has a literal,
+ * and so does every subformula that the graph folds to a constant or to
+ * an atom, as well as the subformulas below it, as the heuristic walks
+ * the formula and not the graph.  The one-sided definitions of
+ * --cnf-polarity don't give the values of the subformulas, so that
+ * option turns the justification heuristic off.  This stream doesn't support proofs, the dumping of
+ * clauses or a full literal-to-node map, as its gates may have no node.
+ */
+class AigCnfStream : public CnfStream {
+ public:
+  /**
+   * Constructs the stream to use the given sat solver.  This does not take
+   * ownership of satSolver, registrar, or context.
+   * @param satSolver the sat solver to use
+   * @param registrar the entity that takes care of pre-registration of Nodes
+   * @param context the context that the CNF should respect
+   * @param polarity only encode the polarities in which gates occur
+   * @param name string identifier to distinguish between different instances
+   */
+  AigCnfStream(SatSolver* satSolver, Registrar* registrar,
+               context::Context* context, bool polarity = false,
+               std::string name = "");
+
+  ~AigCnfStream();
+
+  void convertAndAssert(TNode node,
+                        bool removable,
+                        bool negated,
+                        ProofRule rule,
+                        TNode from = TNode::null()) override;
+
+  void ensureLiteral(TNode n, bool noPreregistration = false) override;
+
+  /** The number of gates in the graph */
+  size_t getNumGates() const { return d_gates.size() - 1; }
+
+ private:
+  /**
+   * An edge of the graph: the index of a gate times 2, plus one if the
+   * edge is negated.  The gate of index 0 is the constant false.
+   */
+  typedef unsigned Edge;
+
+  static const Edge FALSE_EDGE = 0;
+  static const Edge TRUE_EDGE = 1;
+
+  static Edge negate(Edge e) { return e ^ 1; }
+  static unsigned gateOf(Edge e) { return e >> 1; }
+  static bool isNegated(Edge e) { return (e & 1) != 0; }
+
+  /** The polarities of a gate that have been clausified */
+  enum Polarity { POS = 1, NEG = 2, BOTH = POS | NEG };
+
+  /** A gate: either an input (an atom) or the AND of two edges */
+  struct Gate {
+    Edge d_left;
+    Edge d_right;
+    /** the number of gates using this one */
+    unsigned d_fanout;
+    Gate(Edge left, Edge right) : d_left(left), d_right(right), d_fanout(0) {}
+  };/* struct Gate */
+
+  /** The literal of a gate, and its polarities that have been clausified */
+  struct Encoding {
+    SatLiteral d_lit;
+    unsigned d_polarities;
+    Encoding() : d_polarities(0) {}
+    Encoding(SatLiteral lit, unsigned polarities)
+        : d_lit(lit), d_polarities(polarities) {}
+  };/* struct Encoding */
+
+  struct EdgePairHashFunction {
+    size_t operator()(const std::pair<Edge, Edge>& p) const {
+      return (size_t(p.first) * 0x9e3779b97f4a7c15ull) ^ p.second;
+    }
+  };/* struct EdgePairHashFunction */
+
+  /** The gates; the inputs have d_left == d_right == FALSE_EDGE */
+  std::vector<Gate> d_gates;
+
+  /** The atoms of the inputs (null for the constant and the AND gates) */
+  std::vector<Node> d_inputs;
+
+  /** The structural hash of the AND gates */
+  std::unordered_map<std::pair<Edge, Edge>, unsigned, EdgePairHashFunction>
+      d_strash;
+
+  /** The edges of the Boolean nodes (and atoms) translated so far */
+  std::unordered_map<Node, Edge, NodeHashFunction> d_nodeToEdge;
+
+  /**
+   * The clausified gates.  The graph only grows, but the clauses are
+   * context-dependent, like the node-to-literal maps.
+   */
+  context::CDHashMap<unsigned, Encoding> d_encodings;
+
+  /** Whether to only encode the polarities in which gates occur */
+  const bool d_polarity;
+
+  /** The formula being clausified, that the clauses are attributed to */
+  Node d_currentNode;
+
+  /** Returns the edge of node, translating it to the graph if needed. */
+  Edge toAig(TNode node);
+
+  /** Returns the (hashed) edge a & b. */
+  Edge mkAnd(Edge a, Edge b);
+
+  /** Returns the edge of the input for atom. */
+  Edge mkInput(TNode atom);
+
+  /** Whether the gate is an input. */
+  bool isInput(unsigned gate) const {
+    return gate != 0 && d_gates[gate].d_left == FALSE_EDGE;
+  }
+
+  /**
+   * Collects the conjuncts of the AND gate, merging the conjuncts that
+   * are themselves AND gates with a fanout of one and no literal.
+   */
+  void collectConjuncts(unsigned gate, std::vector<Edge>& conjuncts);
+
+  /**
+   * If the AND gate has the shape of an if-then-else, ~(s & a) & ~(~s & b),
+   * sets s, t and e so that the gate is ite(s, t, e) (that is, t = ~a and
+   * e = ~b), and returns true.
+   */
+  bool matchIte(unsigned gate, Edge& s, Edge& t, Edge& e);
+
+  /**
+   * Returns the SAT literal of the edge, clausifying what is needed so
+   * that the literal implies the edge (for POS), is implied by it (for
+   * NEG), or both.
+   */
+  SatLiteral encode(Edge e, unsigned polarities);
+
+  /** Asserts the clauses of the edge at the top level. */
+  void assertEdge(TNode node, Edge e);
+
+  /**
+   * Makes the literals of the subformulas of node visible through
+   * getLiteral(), where they have the value of the subformula: those of
+   * the fully clausified gates, of the subformulas folded to a constant
+   * or to an atom, and of every atom, folded away or not.  The children
+   * of a folded subformula are clausified in full.
+   */
+  void exposeLiterals(TNode node);
+
+  /** Statistics of the translation. */
+  class Statistics {
+   public:
+    IntStat d_gates;
+    IntStat d_strashHits;
+    IntStat d_mergedGates;
+    IntStat d_ites;
+    IntStat d_xors;
+    IntStat d_skippedHalves;
+    Statistics(const std::string& name);
+    ~Statistics();
+  };/* class Statistics */
+
+  Statistics d_statistics;
+
+}; /* class AigCnfStream */
+
+} /* CVC4::prop namespace */
+} /* CVC4 namespace */
+
+#endif /* __CVC4__PROP__AIG_CNF_STREAM_H */
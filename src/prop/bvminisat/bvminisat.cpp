@@ -70,6 +70,21 @@ ClauseId BVMinisatSatSolver::addClause(SatClause& clause,
   return clause_id;
 }
 
+void BVMinisatSatSolver::addClauses(const SatClauseBuffer& clauses,
+                                    bool removable) {
+  // one Minisat clause for the whole batch
+  BVMinisat::vec<BVMinisat::Lit> minisat_clause;
+  for (size_t i = 0, n = clauses.size(); i < n; ++i) {
+    minisat_clause.clear();
+    const SatLiteral* literals = clauses.clause(i);
+    for (size_t j = 0, size = clauses.clauseSize(i); j < size; ++j) {
+      minisat_clause.push(toMinisatLit(literals[j]));
+    }
+    ClauseId clause_id = ClauseIdError;
+    d_minisat->addClause(minisat_clause, clause_id);
+  }
+}
+
 SatValue BVMinisatSatSolver::propagate() {
   return toSatLiteralValue(d_minisat->propagateAssumptions());
 }
@@ -146,6 +161,18 @@ SatValue BVMinisatSatSolver::solve(long unsigned int& resource){
   return result;
 }
 
+SatValue BVMinisatSatSolver::solve(const std::vector<SatLiteral>& assumptions)
+{
+  TimerStat::CodeTimer solveTimer(d_statistics.d_statSolveTime);
+  ++d_statistics.d_statCallsToSolve;
+  BVMinisat::vec<BVMinisat::Lit> minisat_assumptions;
+  for (const SatLiteral& lit : assumptions)
+  {
+    minisat_assumptions.push(toMinisatLit(lit));
+  }
+  return toSatLiteralValue(d_minisat->solve(minisat_assumptions));
+}
+
 bool BVMinisatSatSolver::ok() const {
   return d_minisat->okay(); 
 }
@@ -70,6 +70,8 @@ public:
 
   ClauseId addClause(SatClause& clause, bool removable) override;
 
+  void addClauses(const SatClauseBuffer& clauses, bool removable) override;
+
   ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override
   {
     Unreachable("Minisat does not support native XOR reasoning");
@@ -90,6 +92,7 @@ public:
 
   SatValue solve() override;
   SatValue solve(long unsigned int&) override;
+  SatValue solve(const std::vector<SatLiteral>& assumptions) override;
   bool ok() const override;
   void getUnsatCore(SatClause& unsatCore) override;
 
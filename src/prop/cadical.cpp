@@ -84,6 +84,20 @@ ClauseId CadicalSolver::addClause(SatClause& clause, bool removable)
   return ClauseIdError;
 }
 
+void CadicalSolver::addClauses(const SatClauseBuffer& clauses, bool removable)
+{
+  const SatLiteral* literals = clauses.clause(0);
+  for (size_t i = 0, n = clauses.size(); i < n; ++i)
+  {
+    for (size_t j = 0, size = clauses.clauseSize(i); j < size; ++j)
+    {
+      d_solver->add(toCadicalLit(*literals++));
+    }
+    d_solver->add(0);
+  }
+  d_statistics.d_numClauses += clauses.size();
+}
+
 ClauseId CadicalSolver::addXorClause(SatClause& clause,
                                      bool rhs,
                                      bool removable)
@@ -117,6 +131,19 @@ SatValue CadicalSolver::solve(long unsigned int&)
   Unimplemented("Setting limits for CaDiCaL not supported yet");
 };
 
+SatValue CadicalSolver::solve(const std::vector<SatLiteral>& assumptions)
+{
+  TimerStat::CodeTimer codeTimer(d_statistics.d_solveTime);
+  for (const SatLiteral& lit : assumptions)
+  {
+    d_solver->assume(toCadicalLit(lit));
+  }
+  SatValue res = toSatValue(d_solver->solve());
+  d_okay = (res == SAT_VALUE_TRUE);
+  ++d_statistics.d_numSatCalls;
+  return res;
+}
+
 void CadicalSolver::interrupt() { d_solver->terminate(); }
 
 SatValue CadicalSolver::value(SatLiteral l)
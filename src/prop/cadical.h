@@ -37,6 +37,8 @@ class CadicalSolver : public SatSolver
 
   ClauseId addClause(SatClause& clause, bool removable) override;
 
+  void addClauses(const SatClauseBuffer& clauses, bool removable) override;
+
   ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override;
 
   SatVariable newVar(bool isTheoryAtom = false,
@@ -51,6 +53,8 @@ class CadicalSolver : public SatSolver
 
   SatValue solve(long unsigned int&) override;
 
+  SatValue solve(const std::vector<SatLiteral>& assumptions) override;
+
   void interrupt() override;
 
   SatValue value(SatLiteral l) override;
@@ -24,6 +24,7 @@
 #include "expr/expr.h"
 #include "expr/node.h"
 #include "options/bv_options.h"
+#include "options/prop_options.h"
 #include "proof/clause_id.h"
 #include "proof/cnf_proof.h"
 #include "proof/proof_manager.h"
@@ -54,7 +55,9 @@ CnfStream::CnfStream(SatSolver* satSolver, Registrar* registrar,
       d_registrar(registrar),
       d_name(name),
       d_cnfProof(NULL),
-      d_removable(false) {
+      d_removable(false),
+      d_bufferRemovable(false),
+      d_flushing(false) {
 }
 
 TseitinCnfStream::TseitinCnfStream(SatSolver* satSolver, Registrar* registrar,
@@ -63,8 +66,39 @@ TseitinCnfStream::TseitinCnfStream(SatSolver* satSolver, Registrar* registrar,
   : CnfStream(satSolver, registrar, context, fullLitToNodeMap, name)
 {}
 
+bool CnfStream::bufferClauses() {
+  if(d_cnfProof != NULL || Dump.isOn("clauses")) {
+    flushClauses();
+    return false;
+  }
+  if(d_removable != d_bufferRemovable) {
+    flushClauses();
+    d_bufferRemovable = d_removable;
+  }
+  return true;
+}
+
+void CnfStream::flushClauses() {
+  // Clauses buffered while the SAT solver takes the batch (which it
+  // shouldn't do) wait for the next round
+  if(d_flushing) {
+    return;
+  }
+  d_flushing = true;
+  while(!d_clauseBuffer.empty()) {
+    d_flushBuffer.swap(d_clauseBuffer);
+    d_satSolver->addClauses(d_flushBuffer, d_bufferRemovable);
+    d_flushBuffer.clear();
+  }
+  d_flushing = false;
+}
+
 void CnfStream::assertClause(TNode node, SatClause& c) {
   Debug("cnf") << "Inserting into stream " << c << " node = " << node << endl;
+  if(bufferClauses()) {
+    d_clauseBuffer.addClause(c);
+    return;
+  }
   if(Dump.isOn("clauses")) {
     if(c.size() == 1) {
       Dump("clauses") << AssertCommand(Expr(getNode(c[0]).toExpr()));
@@ -95,12 +129,23 @@ void CnfStream::assertClause(TNode node, SatClause& c) {
 }
 
 void CnfStream::assertClause(TNode node, SatLiteral a) {
+  if(bufferClauses()) {
+    Debug("cnf") << "Inserting into stream " << a << " node = " << node << endl;
+    d_clauseBuffer.addClause(a);
+    return;
+  }
   SatClause clause(1);
   clause[0] = a;
   assertClause(node, clause);
 }
 
 void CnfStream::assertClause(TNode node, SatLiteral a, SatLiteral b) {
+  if(bufferClauses()) {
+    Debug("cnf") << "Inserting into stream " << a << " " << b
+                 << " node = " << node << endl;
+    d_clauseBuffer.addClause(a, b);
+    return;
+  }
   SatClause clause(2);
   clause[0] = a;
   clause[1] = b;
@@ -108,6 +153,12 @@ void CnfStream::assertClause(TNode node, SatLiteral a, SatLiteral b) {
 }
 
 void CnfStream::assertClause(TNode node, SatLiteral a, SatLiteral b, SatLiteral c) {
+  if(bufferClauses()) {
+    Debug("cnf") << "Inserting into stream " << a << " " << b << " " << c
+                 << " node = " << node << endl;
+    d_clauseBuffer.addClause(a, b, c);
+    return;
+  }
   SatClause clause(3);
   clause[0] = a;
   clause[1] = b;
@@ -115,6 +166,22 @@ void CnfStream::assertClause(TNode node, SatLiteral a, SatLiteral b, SatLiteral
   assertClause(node, clause);
 }
 
+bool CnfStream::assertXor(SatLiteral a, SatLiteral b, SatLiteral c, bool rhs) {
+  // the XOR constraints are neither dumped nor part of the proofs
+  if(!options::satXor() || !d_satSolver->nativeXor() || d_cnfProof != NULL
+     || Dump.isOn("clauses")) {
+    return false;
+  }
+  Debug("cnf") << "Inserting xor into stream " << a << " " << b << " " << c
+               << " = " << rhs << endl;
+  SatClause clause(3);
+  clause[0] = a;
+  clause[1] = b;
+  clause[2] = c;
+  d_satSolver->addXorClause(clause, rhs, d_removable);
+  return true;
+}
+
 bool CnfStream::hasLiteral(TNode n) const {
   NodeToLiteralMap::const_iterator find = d_nodeToLiteralMap.find(n);
   return find != d_nodeToLiteralMap.end();
@@ -156,6 +223,7 @@ void TseitinCnfStream::ensureLiteral(TNode n, bool noPreregistration) {
     // Boolean variable), we get a SatLiteral that is definitionally
     // equal to it.
     lit = toCNF(n, false);
+    flushClauses();
 
     // Store backward-mappings
     // These may already exist
@@ -279,6 +347,11 @@ SatLiteral TseitinCnfStream::handleXor(TNode xorNode) {
 
   SatLiteral xorLit = newLiteral(xorNode);
 
+  // xorLit = a xor b
+  if (assertXor(a, b, xorLit, false)) {
+    return xorLit;
+  }
+
   assertClause(xorNode.negate(), a, b, ~xorLit);
   assertClause(xorNode.negate(), ~a, ~b, ~xorLit);
   assertClause(xorNode, a, ~b, xorLit);
@@ -401,6 +474,11 @@ SatLiteral TseitinCnfStream::handleIff(TNode iffNode) {
   // Get the now literal
   SatLiteral iffLit = newLiteral(iffNode);
 
+  // lit <-> (a <-> b), that is a xor b xor lit
+  if (assertXor(a, b, iffLit, true)) {
+    return iffLit;
+  }
+
   // lit -> ((a-> b) & (b->a))
   // ~lit | ((~a | b) & (~b | a))
   // (~a | b | ~lit) & (~b | a | ~lit)
@@ -695,6 +773,7 @@ void TseitinCnfStream::convertAndAssert(TNode node,
     });
 
   convertAndAssert(node, negated);
+  flushClauses();
   PROOF
     (if (d_cnfProof) {
       d_cnfProof->popCurrentAssertion();
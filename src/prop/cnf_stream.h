@@ -123,6 +123,34 @@ class CnfStream {
    */
   bool d_removable;
 
+  /**
+   * The clauses waiting to be given to the SAT solver, in a single call
+   * to SatSolver::addClauses(), by flushClauses().  Clauses are only
+   * buffered when they don't need ids for a proof, or to be dumped.
+   */
+  SatClauseBuffer d_clauseBuffer;
+
+  /** Whether the clauses in d_clauseBuffer are removable */
+  bool d_bufferRemovable;
+
+  /** The clauses being given to the SAT solver by flushClauses() */
+  SatClauseBuffer d_flushBuffer;
+
+  /** Whether flushClauses() is running */
+  bool d_flushing;
+
+  /**
+   * Whether the clauses can go through d_clauseBuffer; if so, makes room
+   * for clauses with the current d_removable.
+   */
+  bool bufferClauses();
+
+  /**
+   * Gives the buffered clauses to the SAT solver.  The public entry
+   * points call this before returning.
+   */
+  void flushClauses();
+
   /**
    * Asserts the given clause to the sat solver.
    * @param node the node giving rise to this clause
@@ -154,6 +182,13 @@ class CnfStream {
    */
   void assertClause(TNode node, SatLiteral a, SatLiteral b, SatLiteral c);
 
+  /**
+   * Asserts a xor b xor c = rhs as a single XOR constraint, if the SAT
+   * solver reasons natively on XORs and --sat-xor is on.
+   * @return false if the constraint has to be asserted as clauses instead
+   */
+  bool assertXor(SatLiteral a, SatLiteral b, SatLiteral c, bool rhs);
+
   /**
    * Acquires a new variable from the SAT solver to represent the node
    * and inserts the necessary data it into the mapping tables.
@@ -122,6 +122,24 @@ ClauseId CryptoMinisatSolver::addClause(SatClause& clause, bool removable){
   return ClauseIdError;
 }
 
+void CryptoMinisatSolver::addClauses(const SatClauseBuffer& clauses,
+                                     bool removable)
+{
+  // one CryptoMiniSat clause for the whole batch
+  std::vector<CMSat::Lit> internal_clause;
+  for (size_t i = 0, n = clauses.size(); i < n && d_okay; ++i)
+  {
+    internal_clause.clear();
+    const SatLiteral* literals = clauses.clause(i);
+    for (size_t j = 0, size = clauses.clauseSize(i); j < size; ++j)
+    {
+      internal_clause.push_back(toInternalLit(literals[j]));
+    }
+    ++(d_statistics.d_clausesAdded);
+    d_okay &= d_solver->add_clause(internal_clause);
+  }
+}
+
 bool CryptoMinisatSolver::ok() const {
   return d_okay; 
 }
@@ -164,6 +182,18 @@ SatValue CryptoMinisatSolver::solve(long unsigned int& resource) {
   return solve();
 }
 
+SatValue CryptoMinisatSolver::solve(const std::vector<SatLiteral>& assumptions)
+{
+  TimerStat::CodeTimer codeTimer(d_statistics.d_solveTime);
+  ++d_statistics.d_statCallsToSolve;
+  std::vector<CMSat::Lit> internal_assumptions;
+  for (const SatLiteral& lit : assumptions)
+  {
+    internal_assumptions.push_back(toInternalLit(lit));
+  }
+  return toSatLiteralValue(d_solver->solve(&internal_assumptions));
+}
+
 SatValue CryptoMinisatSolver::value(SatLiteral l){
   const std::vector<CMSat::lbool> model = d_solver->get_model();
   CMSatVar var = l.getSatVariable();
@@ -49,6 +49,7 @@ public:
   ~CryptoMinisatSolver() override;
 
   ClauseId addClause(SatClause& clause, bool removable) override;
+  void addClauses(const SatClauseBuffer& clauses, bool removable) override;
   ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override;
 
   bool nativeXor() override { return true; }
@@ -64,6 +65,7 @@ public:
   
   SatValue solve() override;
   SatValue solve(long unsigned int&) override;
+  SatValue solve(const std::vector<SatLiteral>& assumptions) override;
   bool ok() const override;
   SatValue value(SatLiteral l) override;
   SatValue modelValue(SatLiteral l) override;
@@ -22,6 +22,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <math.h>
 
+#include <algorithm>
 #include <iostream>
 #include <unordered_set>
 
@@ -114,6 +115,10 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy, CVC4::context::Context* context,
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), resources_consumed(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , inprocessings(0), vivified_clauses(0), vivified_literals(0), subsumed_clauses(0)
+  , reduce_dbs(0), tier_core(0), tier_two(0), tier_local(0), tier_lemmas(0)
+  , tier_promotions(0), deleted_conflict_clauses(0), deleted_lemmas(0)
+  , xor_constraints(0), xor_propagations(0), xor_conflicts(0), gauss_units(0), gauss_equivalences(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -131,6 +136,12 @@ Solver::Solver(CVC4::prop::TheoryProxy* proxy, CVC4::context::Context* context,
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
+  , next_reduce        (2000)
+  , lbd_stamp          (0)
+  , inprocessing       (false)
+  , next_inprocess     (options::satInprocessInterval())
+  , inprocess_props    (0)
+  , xor_dirty          (false)
 {
   PROOF(ProofManager::currentPM()->initSatProof(this);)
 
@@ -176,6 +187,8 @@ Var Solver::newVar(bool sign, bool dvar, bool isTheoryAtom, bool preRegister, bo
     decision .push();
     trail    .capacity(v+1);
     theory   .push(isTheoryAtom);
+    xor_watches.push();
+    xor_reasons.push(-1);
 
     setDecisionVar(v, dvar);
 
@@ -207,6 +220,8 @@ void Solver::resizeVars(int newSize) {
     polarity.shrink(shrinkSize);
     decision.shrink(shrinkSize);
     theory.shrink(shrinkSize);
+    xor_watches.shrink(shrinkSize);
+    xor_reasons.shrink(shrinkSize);
 
   }
 
@@ -225,6 +240,14 @@ CRef Solver::reason(Var x) {
     // What's the literal we are trying to explain
     Lit l = mkLit(x, value(x) != l_True);
 
+    // Implied by an XOR constraint
+    if (xor_reasons[x] >= 0){
+        CRef cr = xorReason(xors[xor_reasons[x]], l);
+        xor_reasons[x] = -1;
+        vardata[x] = VarData(cr, level(x), user_level(x), intro_level(x), trail_index(x));
+        return cr;
+    }
+
     // Get the explanation from the theory
     SatClause explanation_cl;
     // FIXME: at some point return a tag with the theory that spawned you
@@ -283,6 +306,7 @@ CRef Solver::reason(Var x) {
 
     // Construct the reason
     CRef real_reason = ca.alloc(explLevel, explanation, true);
+    ca[real_reason].lemma(true);
     // FIXME: at some point will need more information about where this explanation
     // came from (ie. the theory/sharing)
     Debug("pf::sat") << "Minisat::Solver registering a THEORY_LEMMA (1)" << std::endl;
@@ -655,8 +679,11 @@ int Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         Clause& c = ca[confl];
         max_resolution_level = std::max(max_resolution_level, c.level());
 
-        if (c.removable())
+        if (c.removable()) {
             claBumpActivity(c);
+            if (options::satLbd() && !c.lemma())
+                updateTier(c);
+        }
 
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
@@ -850,7 +877,7 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
     assigns[var(p)] = lbool(!sign(p));
     vardata[var(p)] = VarData(from, decisionLevel(), assertionLevel, intro_level(var(p)), trail.size());
     trail.push_(p);
-    if (theory[var(p)]) {
+    if (theory[var(p)] && !inprocessing) {
       // Enqueue to the theory
       proxy->enqueueTheoryLiteral(MinisatSatSolver::toSatLiteral(p));
     }
@@ -950,6 +977,7 @@ void Solver::propagateTheory() {
     // multiple theories can propagate the same literal
     Lit p = propagatedLiterals[i];
     if (value(p) == l_Undef) {
+      xor_reasons[var(p)] = -1;
       uncheckedEnqueue(p, CRef_Lazy);
     } else {
       if (value(p) == l_False) {
@@ -1046,6 +1074,13 @@ CRef Solver::propagateBool()
         NextClause:;
         }
         ws.shrink(i - j);
+
+        // The XOR constraints (not while vivifying, as that undoes the trail by hand)
+        if (confl == CRef_Undef && !inprocessing && !xors.empty()){
+            confl = propagateXors(var(p));
+            if (confl != CRef_Undef)
+                qhead = trail.size();
+        }
     }
     propagations += num_props;
     simpDB_props -= num_props;
@@ -1070,6 +1105,11 @@ struct reduceDB_lt {
 };
 void Solver::reduceDB()
 {
+    if (options::satLbd()) {
+        reduceDBTiered();
+        return;
+    }
+
     int     i, j;
     double  extra_lim = cla_inc / clauses_removable.size();    // Remove any clause below this activity
 
@@ -1088,6 +1128,96 @@ void Solver::reduceDB()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  reduceDBTiered : ()  ->  [void]
+|
+|  Description:
+|    The reduceDB() of --sat-lbd, called every few thousand conflicts (more each time). The
+|    conflict clauses are in tiers by their LBD: the core ones are kept, the tier2 ones go to the
+|    local tier if they haven't been used in a conflict since the last call, and the worst half of
+|    the local ones (by LBD, then activity) is removed, except those used since the last call. The
+|    removable theory lemmas are reduced apart, on their activity only, as their LBD (at the time
+|    they were added) says little about them. Binary and locked clauses are never removed.
+|________________________________________________________________________________________________@*/
+struct reduceDBTiered_lt {
+    ClauseAllocator& ca;
+    reduceDBTiered_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) {
+        return ca[x].lbd() > ca[y].lbd() || (ca[x].lbd() == ca[y].lbd() && ca[x].activity() < ca[y].activity()); }
+};
+void Solver::reduceDBTiered()
+{
+    reduce_dbs++;
+    next_reduce = conflicts + 2000 + 300 * reduce_dbs;
+
+    vec<CRef> local, lemma;
+    int i, j;
+    for (i = j = 0; i < clauses_removable.size(); i++){
+        Clause& c = ca[clauses_removable[i]];
+        if (c.lemma())
+            lemma.push(clauses_removable[i]);
+        else if (c.tier() == TIER_CORE || (c.tier() == TIER_TWO && c.used())){
+            c.used(false);
+            clauses_removable[j++] = clauses_removable[i];
+        }else{
+            c.tier(TIER_LOCAL);
+            local.push(clauses_removable[i]);
+        }
+    }
+    clauses_removable.shrink(i - j);
+
+    sort(local, reduceDBTiered_lt(ca));
+    for (i = 0; i < local.size(); i++){
+        Clause& c = ca[local[i]];
+        if (i < local.size() / 2 && !c.used() && c.size() > 2 && !locked(c)){
+            removeClause(local[i]);
+            deleted_conflict_clauses++;
+        }else{
+            c.used(false);
+            clauses_removable.push(local[i]);
+        }
+    }
+
+    sort(lemma, reduceDB_lt(ca));
+    for (i = 0; i < lemma.size(); i++){
+        Clause& c = ca[lemma[i]];
+        if (i < lemma.size() / 2 && c.size() > 2 && !locked(c)){
+            removeClause(lemma[i]);
+            deleted_lemmas++;
+        }else
+            clauses_removable.push(lemma[i]);
+    }
+
+    tier_core = tier_two = tier_local = 0;
+    for (i = 0; i < clauses_removable.size(); i++){
+        const Clause& c = ca[clauses_removable[i]];
+        if (c.lemma()) continue;
+        if      (c.tier() == TIER_CORE) tier_core++;
+        else if (c.tier() == TIER_TWO)  tier_two++;
+        else                            tier_local++;
+    }
+    tier_lemmas = clauses_removable.size() - tier_core - tier_two - tier_local;
+    checkGarbage();
+}
+
+
+void Solver::updateTier(Clause& c)
+{
+    c.used(true);
+    if (c.tier() == TIER_CORE)
+        return;
+    unsigned lbd = computeLBD(c);
+    if (lbd < c.lbd()){
+        c.lbd(lbd);
+        if (tierOf(lbd) > c.tier()){
+            c.tier(tierOf(lbd));
+            tier_promotions++;
+        }
+    }
+}
+
+
 void Solver::removeSatisfied(vec<CRef>& cs)
 {
     int i, j;
@@ -1163,6 +1293,494 @@ bool Solver::simplify()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  inprocess : [void]  ->  [bool]
+|
+|  Description:
+|    Simplify the learnt clauses at the top level: remove the ones subsumed by another clause, and
+|    shrink the others by vivification (propagating the negation of their literals one by one).
+|    Both only use Boolean propagation, and spend a fraction of the propagations of the search
+|    since the last call. The problem clauses are left alone, as are the variables: a Tseitin
+|    variable can come back in any new lemma, so it can't be eliminated. Returns FALSE if the
+|    clauses are found unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    assert(decisionLevel() == 0);
+    assert(qhead == trail.size());
+
+    // The derivations aren't recorded in the proofs
+    if (PROOF_ON())
+        return true;
+
+    inprocessings++;
+    int64_t budget = (propagations - inprocess_props) / 10 + 10000;
+
+    subsumeRemovable(budget);
+    bool res = vivifyRemovable(budget);
+
+    checkGarbage();
+    inprocess_props = propagations;
+    return res;
+}
+
+
+void Solver::subsumeRemovable(int64_t budget)
+{
+    // Occurrences of the literals in the learnt clauses
+    vec<vec<CRef> > occurs(2 * nVars());
+    for (int i = 0; i < clauses_removable.size(); i++){
+        const Clause& c = ca[clauses_removable[i]];
+        for (int k = 0; k < c.size(); k++)
+            occurs[toInt(c[k])].push(clauses_removable[i]);
+    }
+
+    for (int pass = 0; pass < 2 && budget > 0; pass++){
+        const vec<CRef>& cs = pass == 0 ? clauses_persistent : clauses_removable;
+        for (int i = 0; i < cs.size() && budget > 0; i++){
+            CRef dr = cs[i];
+            const Clause& d = ca[dr];
+            if (d.mark() == 1) continue;
+            budget -= d.size();
+
+            // The clauses subsumed by d contain its literal with the fewest occurrences
+            Lit best = d[0];
+            for (int k = 0; k < d.size(); k++){
+                seen[var(d[k])] = sign(d[k]) ? 2 : 1;
+                if (occurs[toInt(d[k])].size() < occurs[toInt(best)].size())
+                    best = d[k];
+            }
+
+            const vec<CRef>& os = occurs[toInt(best)];
+            for (int j = 0; j < os.size() && budget > 0; j++){
+                Clause& c = ca[os[j]];
+                // A clause can only go away if the one subsuming it stays at least as long
+                if (os[j] == dr || c.mark() == 1 || c.size() < d.size() || c.level() < d.level() || locked(c))
+                    continue;
+                int found = 0;
+                for (int k = 0; k < c.size() && found < d.size(); k++)
+                    if (seen[var(c[k])] == (sign(c[k]) ? 2 : 1))
+                        found++;
+                budget -= c.size();
+                if (found == d.size()){
+                    removeClause(os[j]);
+                    subsumed_clauses++;
+                }
+            }
+
+            for (int k = 0; k < d.size(); k++)
+                seen[var(d[k])] = 0;
+        }
+    }
+
+    int i, j;
+    for (i = j = 0; i < clauses_removable.size(); i++)
+        if (ca[clauses_removable[i]].mark() != 1)
+            clauses_removable[j++] = clauses_removable[i];
+    clauses_removable.shrink(i - j);
+}
+
+
+bool Solver::vivifyRemovable(int64_t budget)
+{
+    // The most recent clauses first
+    uint64_t limit = propagations + budget;
+    for (int i = clauses_removable.size() - 1; i >= 0 && propagations < limit; i--){
+        if (!vivify(i))
+            return false;
+    }
+
+    int i, j;
+    for (i = j = 0; i < clauses_removable.size(); i++)
+        if (clauses_removable[i] != CRef_Undef)
+            clauses_removable[j++] = clauses_removable[i];
+    clauses_removable.shrink(i - j);
+    return true;
+}
+
+
+bool Solver::vivify(int i)
+{
+    CRef cr = clauses_removable[i];
+    Clause& c = ca[cr];
+
+    // Shrinking a clause that was learnt at a lower user level would make it go away on pop
+    if (c.size() <= 2 || locked(c) || c.level() != assertionLevel)
+        return true;
+
+    if (satisfied(c)){
+        removeClause(cr);
+        clauses_removable[i] = CRef_Undef;
+        return true;
+    }
+
+    // Assert the negation of the literals until one is implied, or they conflict
+    vec<Lit>& lits = add_tmp;
+    lits.clear();
+    detachClause(cr, true);
+    inprocessing = true;
+    trail_lim.push(trail.size());
+    for (int k = 0; k < c.size(); k++){
+        Lit p = c[k];
+        if (value(p) == l_False)
+            continue;
+        lits.push(p);
+        if (value(p) == l_True)
+            break;
+        uncheckedEnqueue(~p);
+        if (propagateBool() != CRef_Undef)
+            break;
+    }
+    for (int k = trail.size() - 1; k >= trail_lim[0]; k--){
+        Var x = var(trail[k]);
+        assigns[x] = l_Undef;
+        vardata[x].trail_index = -1;
+        insertVarOrder(x);
+    }
+    qhead = trail_lim[0];
+    trail.shrink(trail.size() - trail_lim[0]);
+    trail_lim.shrink(1);
+    inprocessing = false;
+
+    if (lits.size() == c.size()){
+        attachClause(cr);
+        return true;
+    }
+
+    vivified_clauses++;
+    vivified_literals += c.size() - lits.size();
+    float      act  = c.activity();
+    int        lev  = c.level();
+    unsigned   lbd  = c.lbd();
+    ClauseTier tier = c.tier();
+    bool       lem  = c.lemma();
+    bool       used = c.used();
+    // Already detached
+    c.mark(1);
+    ca.free(cr);
+    clauses_removable[i] = CRef_Undef;
+
+    if (lits.size() == 0)
+        return ok = false;
+    if (lits.size() == 1){
+        uncheckedEnqueue(lits[0]);
+        return ok = (propagateBool() == CRef_Undef);
+    }
+    CRef nr = ca.alloc(lev, lits, true);
+    Clause& d = ca[nr];
+    d.activity() = act;
+    d.lbd(lbd < (unsigned)lits.size() ? lbd : lits.size());
+    d.tier(tier);
+    d.lemma(lem);
+    d.used(used);
+    attachClause(nr);
+    clauses_removable[i] = nr;
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  addXor : (ps : const vec<Lit>&) (rhs : bool) (removable : bool)  ->  [bool]
+|
+|  Description:
+|    Add the constraint ps[0] xor ... xor ps[n-1] = rhs (--sat-xor). The constraint is kept as is,
+|    and propagated with two watched variables, when it is added at the top level outside of the
+|    search on unassigned variables; otherwise it is added as its clauses. Returns FALSE if the
+|    solver is found inconsistent.
+|________________________________________________________________________________________________@*/
+bool Solver::addXor(const vec<Lit>& ps, bool rhs, bool removable)
+{
+    if (!ok) return false;
+
+    XorConstraint x;
+    x.rhs   = rhs;
+    x.level = assertionLevel;
+    for (int i = 0; i < ps.size(); i++){
+        x.rhs ^= sign(ps[i]);
+        x.vars.push_back(var(ps[i]));
+        x.level = std::max(x.level, intro_level(var(ps[i])));
+    }
+
+    // A variable occurring twice cancels out
+    std::sort(x.vars.begin(), x.vars.end());
+    size_t i, j;
+    for (i = j = 0; i < x.vars.size(); i++){
+        if (i + 1 < x.vars.size() && x.vars[i] == x.vars[i + 1]) i++;
+        else x.vars[j++] = x.vars[i];
+    }
+    x.vars.resize(j);
+
+    bool clauses = removable || minisat_busy || decisionLevel() > 0 || x.vars.size() < 3;
+    for (i = 0; i < x.vars.size() && !clauses; i++)
+        clauses = value(x.vars[i]) != l_Undef;
+    if (clauses)
+        return addXorClauses(x.vars, x.rhs, removable);
+
+    int index = xors.size();
+    xor_watches[x.vars[0]].push(index);
+    xor_watches[x.vars[1]].push(index);
+    xors.push_back(x);
+    xor_constraints++;
+    xor_dirty = true;
+    return true;
+}
+
+
+bool Solver::addXorClauses(const std::vector<Var>& vars, bool rhs, bool removable)
+{
+    assert(vars.size() < 16);
+
+    // One clause per assignment of the wrong parity, excluding it
+    vec<Lit> lits;
+    for (unsigned assignment = 0; assignment < (1u << vars.size()); assignment++){
+        bool parity = false;
+        lits.clear();
+        for (size_t i = 0; i < vars.size(); i++){
+            bool value = (assignment >> i) & 1;
+            parity ^= value;
+            lits.push(mkLit(vars[i], value));
+        }
+        ClauseId id = ClauseIdError;
+        if (parity != rhs && !addClause_(lits, removable, id))
+            return false;
+    }
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  propagateXors : (v : Var)  ->  [Clause*]
+|
+|  Description:
+|    Propagate the XOR constraints watching the variable 'v', which has just been assigned. A
+|    constraint watches two variables that are either unassigned, or assigned after all its other
+|    variables: a watch only moves to a variable that is unassigned, or assigned but not
+|    propagated yet, so that backtracking keeps the invariant. When there is no such variable,
+|    the other watched variable is implied, or the constraint is in conflict. The conflict is added
+|    as a learnt clause, so that the conflict analysis only sees clauses; the reason of an implied
+|    variable is only added when the conflict analysis asks for it (see reason()).
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateXors(Var v)
+{
+    vec<int>& ws    = xor_watches[v];
+    CRef      confl = CRef_Undef;
+    int       i, j;
+
+    for (i = j = 0; i < ws.size(); i++){
+        if (confl != CRef_Undef){
+            ws[j++] = ws[i]; continue; }
+
+        XorConstraint&    x  = xors[ws[i]];
+        std::vector<Var>& vs = x.vars;
+        if (vs[0] == v)
+            std::swap(vs[0], vs[1]);
+        assert(vs[1] == v);
+
+        // Look for new watch:
+        size_t k;
+        for (k = 2; k < vs.size(); k++)
+            if (value(vs[k]) == l_Undef || trail_index(vs[k]) >= qhead)
+                break;
+        if (k < vs.size()){
+            std::swap(vs[1], vs[k]);
+            xor_watches[vs[1]].push(ws[i]);
+            continue;
+        }
+
+        // Did not find watch -- the value of vs[0] is implied:
+        ws[j++] = ws[i];
+        bool parity = x.rhs;
+        for (k = 1; k < vs.size(); k++)
+            parity ^= value(vs[k]) == l_True;
+        Lit p = mkLit(vs[0], !parity);
+        if (value(p) == l_Undef){
+            xor_propagations++;
+            if (decisionLevel() == 0)
+                uncheckedEnqueue(p);
+            else{
+                xor_reasons[var(p)] = ws[i];
+                uncheckedEnqueue(p, CRef_Lazy); }
+        }else if (value(p) == l_False){
+            xor_conflicts++;
+            confl = xorReason(x, lit_Undef);
+        }
+    }
+    ws.shrink(i - j);
+
+    return confl;
+}
+
+
+CRef Solver::xorReason(const XorConstraint& x, Lit p)
+{
+    vec<Lit>& lits = xor_tmp;
+    lits.clear();
+    if (p != lit_Undef)
+        lits.push(p);
+    for (size_t i = 0; i < x.vars.size(); i++){
+        Var v = x.vars[i];
+        if (p == lit_Undef || v != var(p))
+            lits.push(mkLit(v, value(v) == l_True));
+    }
+
+    // Watch the literals of the highest levels, after the implied one
+    int first = p == lit_Undef ? 0 : 1;
+    for (int w = first; w < first + 2 && w < lits.size(); w++){
+        int max = w;
+        for (int k = w + 1; k < lits.size(); k++)
+            if (level(var(lits[k])) > level(var(lits[max])))
+                max = k;
+        std::swap(lits[w], lits[max]);
+    }
+
+    CRef cr = ca.alloc(x.level, lits, true);
+    ca[cr].lemma(true);
+    clauses_removable.push(cr);
+    attachClause(cr);
+    return cr;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  attachXors : [void]  ->  [void]
+|
+|  Description:
+|    Watch the XOR constraints again, after a pop at the top level, preferring the unassigned
+|    variables. The constraints with less than two unassigned variables are left to the next
+|    gaussJordan().
+|________________________________________________________________________________________________@*/
+void Solver::attachXors()
+{
+    assert(decisionLevel() == 0);
+
+    for (int v = 0; v < nVars(); v++)
+        xor_watches[v].clear();
+    for (size_t i = 0; i < xors.size(); i++){
+        std::vector<Var>& vs = xors[i].vars;
+        for (size_t k = 0, w = 0; k < vs.size() && w < 2; k++)
+            if (value(vs[k]) == l_Undef)
+                std::swap(vs[k], vs[w++]);
+        xor_watches[vs[0]].push(i);
+        xor_watches[vs[1]].push(i);
+    }
+    xor_dirty = true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  gaussJordan : [void]  ->  [bool]
+|
+|  Description:
+|    Gauss-Jordan elimination of the XOR constraints over GF(2), at the top level, the variables
+|    assigned at the top level being constants. The rows reduced to one variable are enqueued as
+|    units, and the rows reduced to two variables are added as the clauses of an equivalence.
+|    The elimination is skipped when the matrix is too large, the rows only being checked one by
+|    one. Returns FALSE if the constraints are unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::gaussJordan()
+{
+    assert(decisionLevel() == 0);
+    xor_dirty = false;
+    if (!ok) return false;
+    if (xors.empty()) return true;
+
+    // The columns are the unassigned variables of the constraints
+    std::vector<int> column(nVars(), -1);
+    std::vector<Var> vars;
+    for (size_t i = 0; i < xors.size(); i++)
+        for (size_t k = 0; k < xors[i].vars.size(); k++){
+            Var v = xors[i].vars[k];
+            if (value(v) == l_Undef && column[v] < 0){
+                column[v] = vars.size();
+                vars.push_back(v); }
+        }
+
+    size_t words = (vars.size() + 63) / 64;
+    size_t nrows = xors.size();
+    std::vector<uint64_t> rows(nrows * words, 0);
+    std::vector<char>     rhs(nrows);
+    for (size_t i = 0; i < nrows; i++){
+        bool b = xors[i].rhs;
+        for (size_t k = 0; k < xors[i].vars.size(); k++){
+            Var v = xors[i].vars[k];
+            if (value(v) == l_Undef)
+                rows[i * words + column[v] / 64] ^= uint64_t(1) << (column[v] % 64);
+            else
+                b ^= value(v) == l_True;
+        }
+        rhs[i] = b;
+    }
+
+    // Reduced row echelon form, unless the matrix is too large
+    if (nrows * vars.size() <= (uint64_t(1) << 26)){
+        size_t rank = 0;
+        for (size_t c = 0; c < vars.size() && rank < nrows; c++){
+            size_t word = c / 64;
+            uint64_t bit = uint64_t(1) << (c % 64);
+            size_t pivot = rank;
+            while (pivot < nrows && !(rows[pivot * words + word] & bit))
+                pivot++;
+            if (pivot == nrows)
+                continue;
+            if (pivot != rank){
+                std::swap_ranges(rows.begin() + pivot * words, rows.begin() + (pivot + 1) * words, rows.begin() + rank * words);
+                std::swap(rhs[pivot], rhs[rank]);
+            }
+            for (size_t r = 0; r < nrows; r++)
+                if (r != rank && (rows[r * words + word] & bit)){
+                    for (size_t w = word; w < words; w++)
+                        rows[r * words + w] ^= rows[rank * words + w];
+                    rhs[r] ^= rhs[rank];
+                }
+            rank++;
+        }
+    }
+
+    for (size_t r = 0; r < nrows; r++){
+        int count = 0;
+        Var first = var_Undef, second = var_Undef;
+        for (size_t w = 0; w < words && count <= 2; w++)
+            for (uint64_t bits = rows[r * words + w]; bits != 0 && count <= 2; bits &= bits - 1){
+                Var v = vars[w * 64 + __builtin_ctzll(bits)];
+                if (count++ == 0) first = v; else second = v;
+            }
+        if (count == 0 && rhs[r])
+            return ok = false;
+        if (count == 1){
+            // The value may have been set by an earlier row
+            Lit p = mkLit(first, !rhs[r]);
+            if (value(p) == l_False)
+                return ok = false;
+            if (value(p) == l_Undef){
+                gauss_units++;
+                uncheckedEnqueue(p);
+            }
+        }else if (count == 2){
+            // Each equivalence is added once, until popped
+            if (second < first)
+                std::swap(first, second);
+            std::pair<Lit, Lit> eq(mkLit(first), mkLit(second, rhs[r]));
+            if (xor_equivalences.count(eq))
+                continue;
+            xor_equivalences[eq] = assertionLevel;
+            std::vector<Var> pair;
+            pair.push_back(first);
+            pair.push_back(second);
+            gauss_equivalences++;
+            if (!addXorClauses(pair, rhs[r], false))
+                return false;
+        }
+    }
+
+    return ok = (propagateBool() == CRef_Undef);
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -1203,6 +1821,7 @@ lbool Solver::search(int nof_conflicts)
             // Analyze the conflict
             learnt_clause.clear();
             int max_level = analyze(confl, learnt_clause, backtrack_level);
+            unsigned lbd = options::satLbd() ? computeLBD(learnt_clause) : learnt_clause.size();
             cancelUntil(backtrack_level);
 
             // Assert the conflict clause and the asserting literal
@@ -1213,6 +1832,8 @@ lbool Solver::search(int nof_conflicts)
 
             } else {
                 CRef cr = ca.alloc(max_level, learnt_clause, true);
+                ca[cr].lbd(lbd);
+                ca[cr].tier(tierOf(lbd));
                 clauses_removable.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
@@ -1288,7 +1909,15 @@ lbool Solver::search(int nof_conflicts)
                 return l_False;
             }
 
-            if (clauses_removable.size()-nAssigns() >= max_learnts) {
+            // Simplify the learnt clauses:
+            if (decisionLevel() == 0 && options::satInprocess() && conflicts >= next_inprocess) {
+                next_inprocess = conflicts + options::satInprocessInterval();
+                if (!inprocess()) {
+                    return l_False;
+                }
+            }
+
+            if (options::satLbd() ? conflicts >= next_reduce : clauses_removable.size()-nAssigns() >= max_learnts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
             }
@@ -1385,6 +2014,9 @@ lbool Solver::solve_()
 
     popTrail();
 
+    if (ok && xor_dirty)
+        gaussJordan();
+
     model.clear();
     conflict.clear();
     if (!ok){
@@ -1623,6 +2255,26 @@ void Solver::pop()
   // Pop the OK
   ok = trail_ok.last();
   trail_ok.pop();
+
+  // Pop the XOR constraints
+  if (!xors.empty()) {
+    size_t j = 0;
+    for (size_t i = 0; i < xors.size(); ++i) {
+      if (xors[i].level <= assertionLevel) {
+        std::swap(xors[j++], xors[i]);
+      }
+    }
+    xors.resize(j);
+    attachXors();
+  }
+  std::map<std::pair<Lit, Lit>, int>::iterator it = xor_equivalences.begin();
+  while (it != xor_equivalences.end()) {
+    if (it->second > assertionLevel) {
+      xor_equivalences.erase(it++);
+    } else {
+      ++it;
+    }
+  }
 }
 
 bool Solver::flipDecision() {
@@ -1746,6 +2398,7 @@ CRef Solver::updateLemmas() {
       }
 
       lemma_ref = ca.alloc(clauseLevel, lemma, removable);
+      ca[lemma_ref].lemma(removable);
       PROOF
         (
          TNode cnf_assertion = lemmas_cnf_assertion[i].first;
@@ -1829,6 +2482,7 @@ void ClauseAllocator::reloc(CRef& cr, ClauseAllocator& to, CVC4::CoreProofProxy*
   // Copy extra data-fields:
   // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
   to[cr].mark(c.mark());
+  to[cr].copyTier(c);
   if (to[cr].removable())         to[cr].activity() = c.activity();
   else if (to[cr].has_extra()) to[cr].calcAbstraction();
 }
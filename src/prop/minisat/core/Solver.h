@@ -24,6 +24,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "cvc4_private.h"
 
 #include <iosfwd>
+#include <map>
+#include <vector>
 
 #include "base/output.h"
 #include "context/context.h"
@@ -178,6 +180,7 @@ public:
     bool    addClause (Lit p, Lit q, Lit r, bool removable, ClauseId& id); // Add a ternary clause to the solver.
     bool    addClause_(      vec<Lit>& ps, bool removable, ClauseId& id);  // Add a clause to the solver without making superflous internal copy. Will
                                                                                  // change the passed vector 'ps'.
+    bool    addXor    (const vec<Lit>& ps, bool rhs, bool removable);     // Add the constraint: the XOR of the literals is 'rhs' (--sat-xor).
 
     // Solving:
     //
@@ -271,6 +274,10 @@ public:
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, resources_consumed;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t inprocessings, vivified_clauses, vivified_literals, subsumed_clauses;
+    uint64_t reduce_dbs, tier_core, tier_two, tier_local, tier_lemmas;  // Sizes of the tiers after the last reduceDB() (--sat-lbd).
+    uint64_t tier_promotions, deleted_conflict_clauses, deleted_lemmas;
+    uint64_t xor_constraints, xor_propagations, xor_conflicts, gauss_units, gauss_equivalences;
 
 protected:
 
@@ -400,9 +407,49 @@ protected:
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+    void     reduceDBTiered   ();                                                      // Reduce the set of learnt clauses by tiers (--sat-lbd).
+    void     updateTier       (Clause& c);                                             // Mark a conflict clause as used, and promote it if its LBD went down.
+    template<class Lits>
+    unsigned computeLBD       (const Lits& c);                                         // The number of distinct decision levels of the literals.
+    ClauseTier tierOf         (unsigned lbd) const { return lbd <= 2 ? TIER_CORE : lbd <= 6 ? TIER_TWO : TIER_LOCAL; }
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
 
+    // Clause tiers (--sat-lbd):
+    //
+    uint64_t            next_reduce;        // Number of conflicts at which to reduce the learnt clauses next.
+    vec<uint64_t>       lbd_levels;         // The last computeLBD() call that saw each decision level.
+    uint64_t            lbd_stamp;          // The number of computeLBD() calls.
+
+    // Inprocessing (--sat-inprocess):
+    //
+    bool     inprocessing;                                                             // Is vivification propagating (without telling the theories).
+    uint64_t next_inprocess;                                                           // Number of conflicts at which to inprocess next.
+    uint64_t inprocess_props;                                                          // Number of propagations at the end of the last inprocessing.
+    bool     inprocess        ();                                                      // Vivify and subsume the learnt clauses. Returns FALSE on a top-level conflict.
+    void     subsumeRemovable (int64_t budget);                                        // Remove the learnt clauses subsumed by another clause.
+    bool     vivifyRemovable  (int64_t budget);                                        // Shrink the learnt clauses by propagating their negation.
+    bool     vivify           (int i);                                                 // Vivify the learnt clause clauses_removable[i].
+
+    // XOR constraints (--sat-xor):
+    //
+    struct XorConstraint {
+      std::vector<Var> vars;   // The variables; the watched ones are vars[0] and vars[1].
+      bool             rhs;    // The XOR of the variables.
+      int              level;  // The user level at which the constraint was added.
+    };
+    std::vector<XorConstraint> xors;
+    vec<vec<int> >      xor_watches;        // 'xor_watches[v]' are the indices of the XOR constraints watching 'v'.
+    vec<int>            xor_reasons;        // 'xor_reasons[v]' is the index of the XOR constraint implying 'v', until reason() adds its clause.
+    std::map<std::pair<Lit, Lit>, int> xor_equivalences; // The equivalences 'a = b' added by gaussJordan(), as '(a, b)', with their user levels.
+    bool                xor_dirty;          // Have XOR constraints been added since the last gaussJordan().
+    vec<Lit>            xor_tmp;
+    bool     addXorClauses    (const std::vector<Var>& vars, bool rhs, bool removable); // Add the clauses of an XOR constraint (at most 2^(n-1) of them).
+    CRef     propagateXors    (Var v);                                                 // Propagate the XOR constraints watching 'v'. Returns possibly conflicting clause.
+    CRef     xorReason        (const XorConstraint& x, Lit p);                         // The clause of 'x' propagating 'p' (or the conflict if 'p' is lit_Undef).
+    void     attachXors       ();                                                      // Watch the XOR constraints again, at level 0, propagating the units.
+    bool     gaussJordan      ();                                                      // Gauss-Jordan elimination of the XOR constraints, at level 0. Returns FALSE if they are unsatisfiable.
+
     // Maintaining Variable/Clause activity:
     //
     void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
@@ -500,6 +547,21 @@ inline void Solver::claBumpActivity (Clause& c) {
                 ca[clauses_removable[i]].activity() *= 1e-20;
             cla_inc *= 1e-20; } }
 
+template<class Lits>
+inline unsigned Solver::computeLBD(const Lits& c) {
+    lbd_levels.growTo(decisionLevel() + 1, 0);
+    lbd_stamp++;
+    unsigned lbd = 0;
+    for (int i = 0; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (lbd_levels[l] != lbd_stamp){
+            lbd_levels[l] = lbd_stamp;
+            lbd++;
+        }
+    }
+    return lbd;
+}
+
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
     if (ca.wasted() > ca.size() * gf)
@@ -192,6 +192,9 @@ namespace Minisat{
 //=================================================================================================
 // Clause -- a simple class for representing a clause:
 
+// The tiers of the conflict clauses, by their literal block distance (--sat-lbd):
+enum ClauseTier { TIER_LOCAL = 0, TIER_TWO = 1, TIER_CORE = 2 };
+
 class Clause {
     struct {
         unsigned mark      : 2;
@@ -199,7 +202,11 @@ class Clause {
         unsigned has_extra : 1;
         unsigned reloced   : 1;
         unsigned size      : 27;
-        unsigned level     : 32; }                            header;
+        unsigned level     : 32;
+        unsigned lbd       : 28;
+        unsigned tier      : 2;
+        unsigned lemma     : 1;
+        unsigned used      : 1; }                             header;
     union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
 
     friend class ClauseAllocator;
@@ -213,6 +220,10 @@ class Clause {
         header.reloced   = 0;
         header.size      = ps.size();
         header.level     = level;
+        header.lbd       = ps.size();
+        header.tier      = TIER_LOCAL;
+        header.lemma     = 0;
+        header.used      = 0;
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -241,6 +252,15 @@ public:
     bool         has_extra   ()      const   { return header.has_extra; }
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
+    unsigned     lbd         ()      const   { return header.lbd; }
+    void         lbd         (unsigned l)    { header.lbd = l; }
+    ClauseTier   tier        ()      const   { return (ClauseTier)header.tier; }
+    void         tier        (ClauseTier t)  { header.tier = t; }
+    bool         lemma       ()      const   { return header.lemma; }       // A removable theory lemma (not a conflict clause)
+    void         lemma       (bool b)        { header.lemma = b; }
+    bool         used        ()      const   { return header.used; }        // Used in a conflict since the last reduceDB()
+    void         used        (bool b)        { header.used = b; }
+    void         copyTier    (const Clause& c) { header.lbd = c.header.lbd < header.size ? c.header.lbd : header.size; header.tier = c.header.tier; header.lemma = c.header.lemma; header.used = c.header.used; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
     bool         reloced     ()      const   { return header.reloced; }
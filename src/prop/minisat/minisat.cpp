@@ -155,6 +155,42 @@ ClauseId MinisatSatSolver::addClause(SatClause& clause, bool removable) {
   return clause_id;
 }
 
+void MinisatSatSolver::addClauses(const SatClauseBuffer& clauses,
+                                  bool removable) {
+  // one Minisat clause for the whole batch
+  Minisat::vec<Minisat::Lit> minisat_clause;
+  for (size_t i = 0, n = clauses.size(); i < n && ok(); ++i) {
+    minisat_clause.clear();
+    const SatLiteral* literals = clauses.clause(i);
+    for (size_t j = 0, size = clauses.clauseSize(i); j < size; ++j) {
+      minisat_clause.push(toMinisatLit(literals[j]));
+    }
+    ClauseId clause_id = ClauseIdError;
+    d_minisat->addClause(minisat_clause, removable, clause_id);
+  }
+}
+
+bool MinisatSatSolver::nativeXor() {
+  // the XOR constraints have no clause ids to take part in proofs
+  return options::satXor() && !options::proof() && !options::unsatCores();
+}
+
+ClauseId MinisatSatSolver::addXorClause(SatClause& clause,
+                                        bool rhs,
+                                        bool removable) {
+  if (!ok()) {
+    return ClauseIdUndef;
+  }
+  Minisat::vec<Minisat::Lit> minisat_clause;
+  toMinisatClause(clause, minisat_clause);
+  // variable elimination doesn't know about the XOR constraints
+  for (int i = 0; i < minisat_clause.size(); ++i) {
+    d_minisat->setFrozen(Minisat::var(minisat_clause[i]), true);
+  }
+  d_minisat->addXor(minisat_clause, rhs, removable);
+  return ClauseIdError;
+}
+
 SatVariable MinisatSatSolver::newVar(bool isTheoryAtom, bool preRegister, bool canErase) {
   return d_minisat->newVar(true, true, isTheoryAtom, preRegister, canErase);
 }
@@ -244,7 +280,24 @@ MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
     d_statClausesLiterals("sat::clauses_literals"),
     d_statLearntsLiterals("sat::learnts_literals"),
     d_statMaxLiterals("sat::max_literals"),
-    d_statTotLiterals("sat::tot_literals")
+    d_statTotLiterals("sat::tot_literals"),
+    d_statInprocessings("sat::inprocessings"),
+    d_statVivifiedClauses("sat::vivified_clauses"),
+    d_statVivifiedLiterals("sat::vivified_literals"),
+    d_statSubsumedClauses("sat::subsumed_clauses"),
+    d_statReduceDBs("sat::reduce_dbs"),
+    d_statTierCore("sat::tier_core"),
+    d_statTierTwo("sat::tier_two"),
+    d_statTierLocal("sat::tier_local"),
+    d_statTierLemmas("sat::tier_lemmas"),
+    d_statTierPromotions("sat::tier_promotions"),
+    d_statDeletedConflictClauses("sat::deleted_conflict_clauses"),
+    d_statDeletedLemmas("sat::deleted_lemmas"),
+    d_statXors("sat::xors"),
+    d_statXorPropagations("sat::xor_propagations"),
+    d_statXorConflicts("sat::xor_conflicts"),
+    d_statGaussUnits("sat::gauss_units"),
+    d_statGaussEquivalences("sat::gauss_equivalences")
 {
   d_registry->registerStat(&d_statStarts);
   d_registry->registerStat(&d_statDecisions);
@@ -255,6 +308,23 @@ MinisatSatSolver::Statistics::Statistics(StatisticsRegistry* registry) :
   d_registry->registerStat(&d_statLearntsLiterals);
   d_registry->registerStat(&d_statMaxLiterals);
   d_registry->registerStat(&d_statTotLiterals);
+  d_registry->registerStat(&d_statInprocessings);
+  d_registry->registerStat(&d_statVivifiedClauses);
+  d_registry->registerStat(&d_statVivifiedLiterals);
+  d_registry->registerStat(&d_statSubsumedClauses);
+  d_registry->registerStat(&d_statReduceDBs);
+  d_registry->registerStat(&d_statTierCore);
+  d_registry->registerStat(&d_statTierTwo);
+  d_registry->registerStat(&d_statTierLocal);
+  d_registry->registerStat(&d_statTierLemmas);
+  d_registry->registerStat(&d_statTierPromotions);
+  d_registry->registerStat(&d_statDeletedConflictClauses);
+  d_registry->registerStat(&d_statDeletedLemmas);
+  d_registry->registerStat(&d_statXors);
+  d_registry->registerStat(&d_statXorPropagations);
+  d_registry->registerStat(&d_statXorConflicts);
+  d_registry->registerStat(&d_statGaussUnits);
+  d_registry->registerStat(&d_statGaussEquivalences);
 }
 
 MinisatSatSolver::Statistics::~Statistics() {
@@ -267,6 +337,23 @@ MinisatSatSolver::Statistics::~Statistics() {
   d_registry->unregisterStat(&d_statLearntsLiterals);
   d_registry->unregisterStat(&d_statMaxLiterals);
   d_registry->unregisterStat(&d_statTotLiterals);
+  d_registry->unregisterStat(&d_statInprocessings);
+  d_registry->unregisterStat(&d_statVivifiedClauses);
+  d_registry->unregisterStat(&d_statVivifiedLiterals);
+  d_registry->unregisterStat(&d_statSubsumedClauses);
+  d_registry->unregisterStat(&d_statReduceDBs);
+  d_registry->unregisterStat(&d_statTierCore);
+  d_registry->unregisterStat(&d_statTierTwo);
+  d_registry->unregisterStat(&d_statTierLocal);
+  d_registry->unregisterStat(&d_statTierLemmas);
+  d_registry->unregisterStat(&d_statTierPromotions);
+  d_registry->unregisterStat(&d_statDeletedConflictClauses);
+  d_registry->unregisterStat(&d_statDeletedLemmas);
+  d_registry->unregisterStat(&d_statXors);
+  d_registry->unregisterStat(&d_statXorPropagations);
+  d_registry->unregisterStat(&d_statXorConflicts);
+  d_registry->unregisterStat(&d_statGaussUnits);
+  d_registry->unregisterStat(&d_statGaussEquivalences);
 }
 
 void MinisatSatSolver::Statistics::init(Minisat::SimpSolver* d_minisat){
@@ -279,6 +366,23 @@ void MinisatSatSolver::Statistics::init(Minisat::SimpSolver* d_minisat){
   d_statLearntsLiterals.setData(d_minisat->learnts_literals);
   d_statMaxLiterals.setData(d_minisat->max_literals);
   d_statTotLiterals.setData(d_minisat->tot_literals);
+  d_statInprocessings.setData(d_minisat->inprocessings);
+  d_statVivifiedClauses.setData(d_minisat->vivified_clauses);
+  d_statVivifiedLiterals.setData(d_minisat->vivified_literals);
+  d_statSubsumedClauses.setData(d_minisat->subsumed_clauses);
+  d_statReduceDBs.setData(d_minisat->reduce_dbs);
+  d_statTierCore.setData(d_minisat->tier_core);
+  d_statTierTwo.setData(d_minisat->tier_two);
+  d_statTierLocal.setData(d_minisat->tier_local);
+  d_statTierLemmas.setData(d_minisat->tier_lemmas);
+  d_statTierPromotions.setData(d_minisat->tier_promotions);
+  d_statDeletedConflictClauses.setData(d_minisat->deleted_conflict_clauses);
+  d_statDeletedLemmas.setData(d_minisat->deleted_lemmas);
+  d_statXors.setData(d_minisat->xor_constraints);
+  d_statXorPropagations.setData(d_minisat->xor_propagations);
+  d_statXorConflicts.setData(d_minisat->xor_conflicts);
+  d_statGaussUnits.setData(d_minisat->gauss_units);
+  d_statGaussEquivalences.setData(d_minisat->gauss_equivalences);
 }
 
 } /* namespace CVC4::prop */
@@ -42,10 +42,9 @@ public:
   void initialize(context::Context* context, TheoryProxy* theoryProxy) override;
 
   ClauseId addClause(SatClause& clause, bool removable) override;
-  ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override
-  {
-    Unreachable("Minisat does not support native XOR reasoning");
-  }
+  void addClauses(const SatClauseBuffer& clauses, bool removable) override;
+  bool nativeXor() override;
+  ClauseId addXorClause(SatClause& clause, bool rhs, bool removable) override;
 
   SatVariable newVar(bool isTheoryAtom,
                      bool preRegister,
@@ -98,6 +97,14 @@ public:
     ReferenceStat<uint64_t> d_statConflicts, d_statClausesLiterals;
     ReferenceStat<uint64_t> d_statLearntsLiterals,  d_statMaxLiterals;
     ReferenceStat<uint64_t> d_statTotLiterals;
+    ReferenceStat<uint64_t> d_statInprocessings, d_statVivifiedClauses;
+    ReferenceStat<uint64_t> d_statVivifiedLiterals, d_statSubsumedClauses;
+    ReferenceStat<uint64_t> d_statReduceDBs, d_statTierCore, d_statTierTwo;
+    ReferenceStat<uint64_t> d_statTierLocal, d_statTierLemmas;
+    ReferenceStat<uint64_t> d_statTierPromotions, d_statDeletedConflictClauses;
+    ReferenceStat<uint64_t> d_statDeletedLemmas, d_statXors;
+    ReferenceStat<uint64_t> d_statXorPropagations, d_statXorConflicts;
+    ReferenceStat<uint64_t> d_statGaussUnits, d_statGaussEquivalences;
   public:
     Statistics(StatisticsRegistry* registry);
     ~Statistics();
@@ -28,9 +28,11 @@
 #include "options/decision_options.h"
 #include "options/main_options.h"
 #include "options/options.h"
+#include "options/prop_options.h"
 #include "options/smt_options.h"
 #include "proof/proof_manager.h"
 #include "proof/proof_manager.h"
+#include "prop/aig_cnf_stream.h"
 #include "prop/cnf_stream.h"
 #include "prop/sat_solver.h"
 #include "prop/sat_solver_factory.h"
@@ -94,13 +96,26 @@ PropEngine::PropEngine(TheoryEngine* te, DecisionEngine *de, Context* satContext
 
   d_satSolver = SatSolverFactory::createDPLLMinisat(smtStatisticsRegistry());
 
-  d_registrar = new theory::TheoryRegistrar(d_theoryEngine);
-  d_cnfStream = new CVC4::prop::TseitinCnfStream
-    (d_satSolver, d_registrar, userContext,
-     // fullLitToNode Map =
-     options::threads() > 1 ||
-     options::decisionMode() == decision::DECISION_STRATEGY_RELEVANCY ||
-     ( CVC4_USE_REPLAY && replayLog != NULL ));
+  // With --lazy-preregistration, the TheoryProxy pre-registers the atoms
+  // when they are assigned
+  if (options::lazyPreregistration()) {
+    d_registrar = new NullRegistrar();
+  } else {
+    d_registrar = new theory::TheoryRegistrar(d_theoryEngine);
+  }
+  bool fullLitToNodeMap =
+      options::threads() > 1 ||
+      options::decisionMode() == decision::DECISION_STRATEGY_RELEVANCY ||
+      ( CVC4_USE_REPLAY && replayLog != NULL );
+  // The gates of the AIG have no node, for proofs or for the literal map
+  if (options::cnfAig() && !fullLitToNodeMap && !options::proof() &&
+      !options::unsatCores() && !Dump.isOn("clauses")) {
+    d_cnfStream = new CVC4::prop::AigCnfStream
+      (d_satSolver, d_registrar, userContext, options::cnfPolarity());
+  } else {
+    d_cnfStream = new CVC4::prop::TseitinCnfStream
+      (d_satSolver, d_registrar, userContext, fullLitToNodeMap);
+  }
 
   d_theoryProxy = new TheoryProxy(
       this, d_theoryEngine, d_decisionEngine, d_context, d_cnfStream, replayLog,
@@ -38,14 +38,11 @@ class ResourceManager;
 class DecisionEngine;
 class TheoryEngine;
 
-namespace theory {
-  class TheoryRegistrar;
-}/* CVC4::theory namespace */
-
 namespace prop {
 
 class CnfStream;
 class DPLLSatSolverInterface;
+class Registrar;
 
 class PropEngine;
 
@@ -80,7 +77,7 @@ class PropEngine {
   std::vector<Node> d_assertionList;
 
   /** Theory registrar; kept around for destructor cleanup */
-  theory::TheoryRegistrar* d_registrar;
+  Registrar* d_registrar;
 
   /** The CNF converter in use */
   CnfStream* d_cnfStream;
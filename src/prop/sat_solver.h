@@ -49,6 +49,19 @@ public:
   virtual ClauseId addClause(SatClause& clause,
                              bool removable) = 0;
 
+  /**
+   * Assert a batch of clauses in the solver.  No clause ids are returned,
+   * so this is not for clauses that take part in proofs.  By default, the
+   * clauses are added one at a time with addClause().
+   */
+  virtual void addClauses(const SatClauseBuffer& clauses, bool removable) {
+    SatClause clause;
+    for (size_t i = 0, n = clauses.size(); i < n; ++i) {
+      clause.assign(clauses.clause(i), clauses.clause(i) + clauses.clauseSize(i));
+      addClause(clause, removable);
+    }
+  }
+
   /** Return true if the solver supports native xor resoning */
   virtual bool nativeXor() { return false; }
 
@@ -76,6 +89,15 @@ public:
   /** Check the satisfiability of the added clauses */
   virtual SatValue solve(long unsigned int&) = 0;
 
+  /**
+   * Check the satisfiability of the added clauses under the assumptions,
+   * that only hold for this call.
+   */
+  virtual SatValue solve(const std::vector<SatLiteral>& assumptions)
+  {
+    Unimplemented("Solving under assumptions not supported by SAT solver");
+  }
+
   /** Interrupt the solver */
   virtual void interrupt() = 0;
 
@@ -26,6 +26,7 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace CVC4 {
 namespace prop {
@@ -166,6 +167,78 @@ struct SatLiteralHashFunction {
  */
 typedef std::vector<SatLiteral> SatClause;
 
+/**
+ * A batch of clauses, stored flat: the literals of all of the clauses in
+ * one array, and the offset of the first literal of each clause.  It
+ * keeps its storage when cleared, so that a producer of many small
+ * clauses (e.g. the clausification of a bit-blasted circuit) can hand
+ * them to the SAT solver without allocating, and with one call.
+ */
+class SatClauseBuffer {
+  std::vector<SatLiteral> d_literals;
+  /** the offset of each clause, and one past the end of the last one */
+  std::vector<size_t> d_offsets;
+
+public:
+  SatClauseBuffer() : d_offsets(1, 0) {}
+
+  /** The number of clauses */
+  size_t size() const { return d_offsets.size() - 1; }
+
+  bool empty() const { return d_offsets.size() == 1; }
+
+  /** The total number of literals */
+  size_t numLiterals() const { return d_literals.size(); }
+
+  /** Removes all of the clauses */
+  void clear() {
+    d_literals.clear();
+    d_offsets.resize(1);
+  }
+
+  void swap(SatClauseBuffer& other) {
+    d_literals.swap(other.d_literals);
+    d_offsets.swap(other.d_offsets);
+  }
+
+  /** Adds the clause of the given n literals */
+  void addClause(const SatLiteral* literals, size_t n) {
+    d_literals.insert(d_literals.end(), literals, literals + n);
+    d_offsets.push_back(d_literals.size());
+  }
+
+  void addClause(const SatClause& clause) {
+    addClause(clause.data(), clause.size());
+  }
+
+  void addClause(SatLiteral a) {
+    d_literals.push_back(a);
+    d_offsets.push_back(d_literals.size());
+  }
+
+  void addClause(SatLiteral a, SatLiteral b) {
+    d_literals.push_back(a);
+    d_literals.push_back(b);
+    d_offsets.push_back(d_literals.size());
+  }
+
+  void addClause(SatLiteral a, SatLiteral b, SatLiteral c) {
+    d_literals.push_back(a);
+    d_literals.push_back(b);
+    d_literals.push_back(c);
+    d_offsets.push_back(d_literals.size());
+  }
+
+  /** The literals of clause i, which has clauseSize(i) of them */
+  const SatLiteral* clause(size_t i) const {
+    return d_literals.data() + d_offsets[i];
+  }
+
+  size_t clauseSize(size_t i) const {
+    return d_offsets[i + 1] - d_offsets[i];
+  }
+};/* class SatClauseBuffer */
+
 /**
  * Each object in the SAT solver, such as as variables and clauses, can be assigned a life span,
  * so that the SAT solver can (or should) remove them when the lifespan is over.
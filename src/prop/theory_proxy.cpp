@@ -20,6 +20,7 @@
 #include "decision/decision_engine.h"
 #include "expr/expr_stream.h"
 #include "options/decision_options.h"
+#include "options/prop_options.h"
 #include "prop/cnf_stream.h"
 #include "prop/prop_engine.h"
 #include "proof/cnf_proof.h"
@@ -51,14 +52,18 @@ TheoryProxy::TheoryProxy(PropEngine* propEngine,
       d_replayLog(replayLog),
       d_replayStream(replayStream),
       d_queue(context),
-      d_replayedDecisions("prop::theoryproxy::replayedDecisions", 0)
+      d_registered(context),
+      d_replayedDecisions("prop::theoryproxy::replayedDecisions", 0),
+      d_lazyPreregistrations("prop::theoryproxy::lazyPreregistrations", 0)
 {
   smtStatisticsRegistry()->registerStat(&d_replayedDecisions);
+  smtStatisticsRegistry()->registerStat(&d_lazyPreregistrations);
 }
 
 TheoryProxy::~TheoryProxy() {
   /* nothing to do for now */
   smtStatisticsRegistry()->unregisterStat(&d_replayedDecisions);
+  smtStatisticsRegistry()->unregisterStat(&d_lazyPreregistrations);
 }
 
 /** The lemma input channel we are using. */
@@ -73,13 +78,26 @@ LemmaOutputChannel* TheoryProxy::outputChannel() {
 
 
 void TheoryProxy::variableNotify(SatVariable var) {
-  d_theoryEngine->preRegister(getNode(SatLiteral(var)));
+  // with lazy pre-registration, enqueueTheoryLiteral() does it again
+  if (!options::lazyPreregistration()) {
+    d_theoryEngine->preRegister(getNode(SatLiteral(var)));
+  }
 }
 
 void TheoryProxy::theoryCheck(theory::Theory::Effort effort) {
   while (!d_queue.empty()) {
     TNode assertion = d_queue.front();
     d_queue.pop();
+    if (options::lazyPreregistration()) {
+      // Not in enqueueTheoryLiteral(): pre-registration may send lemmas,
+      // and the SAT solver can't take new variables while propagating
+      TNode atom =
+          assertion.getKind() == kind::NOT ? assertion[0] : assertion;
+      if (d_registered.insert(atom)) {
+        ++d_lazyPreregistrations;
+        d_theoryEngine->preRegister(atom);
+      }
+    }
     d_theoryEngine->assertFact(assertion);
   }
   d_theoryEngine->check(effort);
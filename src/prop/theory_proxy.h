@@ -26,6 +26,7 @@
 #include <iosfwd>
 #include <unordered_set>
 
+#include "context/cdhashset.h"
 #include "context/cdqueue.h"
 #include "expr/expr_stream.h"
 #include "expr/node.h"
@@ -135,6 +136,13 @@ public:
   /** Queue of asserted facts */
   context::CDQueue<TNode> d_queue;
 
+  /**
+   * The atoms pre-registered by theoryCheck(), with
+   * --lazy-preregistration.  Pre-registration is undone on backtracking,
+   * so this is in the SAT context.
+   */
+  context::CDHashSet<Node, NodeHashFunction> d_registered;
+
   /**
    * Set of all lemmas that have been "shared" in the portfolio---i.e.,
    * all imported and exported lemmas.
@@ -146,6 +154,12 @@ public:
    */
   IntStat d_replayedDecisions;
 
+  /**
+   * Statistic: the number of atoms pre-registered when assigned (via
+   * --lazy-preregistration).
+   */
+  IntStat d_lazyPreregistrations;
+
 };/* class SatSolver */
 
 }/* CVC4::prop namespace */
@@ -109,6 +109,8 @@
 #include "theory/quantifiers/sygus/ce_guided_instantiation.h"
 #include "theory/quantifiers/sygus_inference.h"
 #include "theory/quantifiers/term_util.h"
+#include "theory/rewrite_memo.h"
+#include "theory/rewriter_statistics.h"
 #include "theory/sort_inference.h"
 #include "theory/strings/theory_strings.h"
 #include "theory/substitutions.h"
@@ -574,10 +576,28 @@ public:
   /* Finishes the initialization of the private portion of SMTEngine. */
   void finishInit();
 
+  /**
+   * Stop using the rewrite memo (--rewrite-memo), saving it to its file.
+   * Must be called before the statistics registry goes away.
+   */
+  void saveRewriteMemo();
+
+  /**
+   * Stop profiling the rewriters (--rewrite-profile).  Must be called
+   * before the statistics registry goes away.
+   */
+  void unregisterRewriterStatistics();
+
  private:
   std::unique_ptr<PreprocessingPassContext> d_preprocessingPassContext;
   PreprocessingPassRegistry d_preprocessingPassRegistry;
 
+  /** The rewrite memo, if --rewrite-memo is given */
+  std::unique_ptr<theory::RewriteMemo> d_rewriteMemo;
+
+  /** The profile of the rewriters, if --rewrite-profile is given */
+  std::unique_ptr<theory::RewriterStatistics> d_rewriterStatistics;
+
   /** The top level substitutions */
   SubstitutionMap d_topLevelSubstitutions;
 
@@ -1225,6 +1245,9 @@ SmtEngine::~SmtEngine()
     d_definedFunctions->deleteSelf();
     d_fmfRecFunctionsDefined->deleteSelf();
 
+    d_private->saveRewriteMemo();
+    d_private->unregisterRewriterStatistics();
+
     //destroy all passes before destroying things that they refer to
     d_private->unregisterPreprocessingPasses();
 
@@ -1328,15 +1351,20 @@ void SmtEngine::setDefaults() {
   {
     if (options::incrementalSolving())
     {
-      if (options::incrementalSolving.wasSetByUser())
+      if (!options::incrementalSolving.wasSetByUser())
       {
+        Notice() << "SmtEngine: turning off incremental to support eager "
+                 << "bit-blasting" << endl;
+        setOption("incremental", SExpr("false"));
+      }
+      else if (!d_logic.isPure(THEORY_BV) || options::bitvectorAig())
+      {
+        // incremental eager bit-blasting solves under assumptions, without
+        // AIGs and the Ackermannization of the other theories
         throw OptionException(std::string(
-            "Eager bit-blasting does not currently support incremental mode. "
-            "Try --bitblast=lazy"));
+            "Eager bit-blasting only supports incremental mode for QF_BV, "
+            "without --bitblast-aig. Try --bitblast=lazy"));
       }
-      Notice() << "SmtEngine: turning off incremental to support eager "
-               << "bit-blasting" << endl;
-      setOption("incremental", SExpr("false"));
     }
     if (options::produceModels()
         && (d_logic.isTheoryEnabled(THEORY_ARRAYS)
@@ -1814,6 +1842,20 @@ void SmtEngine::setDefaults() {
     options::decisionMode.set(decMode);
     options::decisionStopOnly.set(stoponly);
   }
+  // The justification heuristic reads the values of the subformulas, which
+  // the one-sided gate definitions of --cnf-polarity don't give
+  if (options::cnfAig() && options::cnfPolarity()
+      && options::decisionMode() != decision::DECISION_STRATEGY_INTERNAL)
+  {
+    if (options::decisionMode.wasSetByUser())
+    {
+      throw OptionException(
+          "--cnf-polarity is only supported with --decision=internal");
+    }
+    Trace("smt") << "setting decision mode to internal for --cnf-polarity"
+                 << endl;
+    options::decisionMode.set(decision::DECISION_STRATEGY_INTERNAL);
+  }
   if( options::incrementalSolving() ){
     //disable modes not supported by incremental
     options::sortInference.set( false );
@@ -2243,6 +2285,43 @@ void SmtEngine::setDefaults() {
                << std::endl;
       options::bitvectorInequalitySolver.set(false);
     }
+    if (options::bitvectorPropagationSolver())
+    {
+      if (options::bitvectorPropagationSolver.wasSetByUser())
+      {
+        throw OptionException(
+            "--bv-propagation-solver is not supported with proofs");
+      }
+      Notice() << "SmtEngine: turning off bv propagation solver to support "
+                  "proofs"
+               << std::endl;
+      options::bitvectorPropagationSolver.set(false);
+    }
+    if (options::bitvectorSlsSolver())
+    {
+      if (options::bitvectorSlsSolver.wasSetByUser())
+      {
+        throw OptionException("--bv-sls-solver is not supported with proofs");
+      }
+      Notice() << "SmtEngine: turning off bv local search solver to support "
+                  "proofs"
+               << std::endl;
+      options::bitvectorSlsSolver.set(false);
+    }
+    // the bit-blasting proofs replay the default circuits
+    if (options::bitvectorStructuralHashing())
+    {
+      if (options::bitvectorStructuralHashing.wasSetByUser())
+      {
+        throw OptionException(
+            "--bv-structural-hashing is not supported with proofs");
+      }
+      options::bitvectorStructuralHashing.set(false);
+    }
+    if (options::bitvectorMultMode() != theory::bv::BITVECTOR_MULT_SHIFT_ADD)
+    {
+      throw OptionException("--bv-mult=wallace is not supported with proofs");
+    }
   }
 }
 
@@ -2650,6 +2729,37 @@ void SmtEnginePrivate::finishInit() {
                                            std::move(pbProc));
   d_preprocessingPassRegistry.registerPass("real-to-int", std::move(realToInt));
   d_preprocessingPassRegistry.registerPass("sym-break", std::move(sbProc));
+
+  if(!options::rewriteMemoFile().empty()) {
+    d_rewriteMemo.reset(new theory::RewriteMemo(
+        d_smt.d_nodeManager,
+        theory::RewriteMemo::makeFingerprint(d_smt.d_logic)));
+    d_rewriteMemo->load(options::rewriteMemoFile());
+    theory::Rewriter::setRewriteMemo(d_rewriteMemo.get());
+  }
+
+  if(options::rewriteProfile()) {
+    d_rewriterStatistics.reset(
+        new theory::RewriterStatistics(d_smt.d_nodeManager));
+    theory::Rewriter::setStatistics(d_rewriterStatistics.get());
+  }
+}
+
+void SmtEnginePrivate::saveRewriteMemo()
+{
+  if(d_rewriteMemo) {
+    theory::Rewriter::setRewriteMemo(NULL);
+    d_rewriteMemo->save(options::rewriteMemoFile());
+    d_rewriteMemo.reset();
+  }
+}
+
+void SmtEnginePrivate::unregisterRewriterStatistics()
+{
+  if(d_rewriterStatistics) {
+    theory::Rewriter::setStatistics(NULL);
+    d_rewriterStatistics.reset();
+  }
 }
 
 Node SmtEnginePrivate::expandDefinitions(TNode n, unordered_map<Node, Node, NodeHashFunction>& cache, bool expandOnly)
@@ -2860,9 +2970,7 @@ void SmtEnginePrivate::removeITEs() {
 
   // Remove all of the ITE occurrences and normalize
   d_iteRemover.run(d_assertions.ref(), d_iteSkolemMap, true);
-  for (unsigned i = 0; i < d_assertions.size(); ++ i) {
-    d_assertions.replace(i, Rewriter::rewrite(d_assertions[i]));
-  }
+  d_assertions.rewrite();
 }
 
 void SmtEnginePrivate::staticLearning() {
@@ -3931,7 +4039,11 @@ void SmtEnginePrivate::applySubstitutionsToAssertions() {
       }
       Trace("simplify") << "applying to " << d_assertions[i] << endl;
       spendResource(options::preprocessStep());
-      d_assertions.replace(i, Rewriter::rewrite(d_topLevelSubstitutions.apply(d_assertions[i])));
+      Node assertion =
+          Rewriter::rewrite(d_topLevelSubstitutions.apply(d_assertions[i]));
+      if (assertion != d_assertions[i]) {
+        d_assertions.replace(i, assertion);
+      }
       Trace("simplify") << "  got " << d_assertions[i] << endl;
     }
   }
@@ -4061,7 +4173,17 @@ void SmtEnginePrivate::processAssertions() {
                          "Try --bv-div-zero-const to interpret division by zero as a constant.");
   }
 
-  if (options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER)
+  if (options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER
+      && options::incrementalSolving()
+      && !d_smt.d_logic.isPure(THEORY_BV))
+  {
+    throw ModalException(
+        "Incremental eager bit-blasting does not support theory combination. "
+        "Try --bitblast=lazy");
+  }
+
+  if (options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER
+      && !options::incrementalSolving())
   {
     d_preprocessingPassRegistry.getPass("bv-ackermann")->apply(&d_assertions);
   }
@@ -4090,9 +4212,7 @@ void SmtEnginePrivate::processAssertions() {
     Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : pre-unconstrained-simp" << endl;
     dumpAssertions("pre-unconstrained-simp", d_assertions);
     Chat() << "...doing unconstrained simplification..." << endl;
-    for (unsigned i = 0; i < d_assertions.size(); ++ i) {
-      d_assertions.replace(i, Rewriter::rewrite(d_assertions[i]));
-    }
+    d_assertions.rewrite();
     unconstrainedSimp();
     Trace("smt-proc") << "SmtEnginePrivate::processAssertions() : post-unconstrained-simp" << endl;
     dumpAssertions("post-unconstrained-simp", d_assertions);
@@ -4108,9 +4228,7 @@ void SmtEnginePrivate::processAssertions() {
 
   if(options::unsatCores()) {
     // special rewriting pass for unsat cores, since many of the passes below are skipped
-    for (unsigned i = 0; i < d_assertions.size(); ++ i) {
-      d_assertions.replace(i, Rewriter::rewrite(d_assertions[i]));
-    }
+    d_assertions.rewrite();
   } else {
     applySubstitutionsToAssertions();
   }
@@ -4565,10 +4683,30 @@ Result SmtEngine::checkSatisfiability(const vector<Expr>& assumptions,
     }
 
     Result r(Result::SAT_UNKNOWN, Result::UNKNOWN_REASON);
-    for (Expr e : d_assumptions)
+    std::vector<Node> assumptionNodes;
+    for (const Expr& e : d_assumptions)
     {
       // Substitute out any abstract values in ex.
-      e = d_private->substituteAbstractValues(Node::fromExpr(e)).toExpr();
+      assumptionNodes.push_back(
+          d_private->substituteAbstractValues(Node::fromExpr(e)));
+    }
+    if (options::typeChecking())
+    {
+      // Type check all the assumptions in one pass, sharing their subterms
+      try
+      {
+        d_nodeManager->checkTypes(std::vector<TNode>(assumptionNodes.begin(),
+                                                     assumptionNodes.end()));
+      }
+      catch (const TypeCheckingExceptionPrivate& tcep)
+      {
+        throw TypeCheckingException(tcep.getNode().toExpr(),
+                                    tcep.getMessage());
+      }
+    }
+    for (const Node& n : assumptionNodes)
+    {
+      Expr e = n.toExpr();
       Assert(e.getExprManager() == d_exprManager);
       // Ensure expr is type-checked at this point.
       ensureBoolean(e);
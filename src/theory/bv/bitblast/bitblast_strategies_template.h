@@ -23,6 +23,7 @@
 #include <ostream>
 
 #include "expr/node.h"
+#include "options/bv_options.h"
 #include "theory/bv/bitblast/bitblast_utils.h"
 #include "theory/bv/theory_bv_utils.h"
 #include "theory/rewriter.h"
@@ -388,9 +389,26 @@ void DefaultMultBB (TNode node, std::vector<T>& res, TBitblaster<T>* bb) {
     std::vector<T> current;
     bb->bbTerm(node[i], current);
     newres.clear(); 
-    // constructs a simple shift and add multiplier building the result
-    // in res
-    shiftAddMultiplier(res, current, newres);
+    if (options::bitvectorStructuralHashing()
+        && bb->getCircuit(kind::BITVECTOR_MULT, res, current, newres))
+    {
+      res = newres;
+      continue;
+    }
+    if (options::bitvectorMultMode() == theory::bv::BITVECTOR_MULT_WALLACE)
+    {
+      wallaceMultiplier(res, current, newres);
+    }
+    else
+    {
+      // constructs a simple shift and add multiplier building the result
+      // in res
+      shiftAddMultiplier(res, current, newres);
+    }
+    if (options::bitvectorStructuralHashing())
+    {
+      bb->storeCircuit(kind::BITVECTOR_MULT, res, current, newres);
+    }
     res = newres;
   }
   if(Debug.isOn("bitvector-bb")) {
@@ -518,6 +536,34 @@ void uDivModRec(const std::vector<T>& a, const std::vector<T>& b, std::vector<T>
 
 }
 
+/**
+ * The quotient and remainder circuit of a by b (without the case of b = 0),
+ * shared by the terms with the same operand bits with
+ * --bv-structural-hashing.
+ */
+template <class T>
+void uDivMod(const std::vector<T>& a,
+             const std::vector<T>& b,
+             std::vector<T>& q,
+             std::vector<T>& r,
+             TBitblaster<T>* bb)
+{
+  if (!options::bitvectorStructuralHashing())
+  {
+    uDivModRec(a, b, q, r, a.size());
+    return;
+  }
+  if (bb->getCircuit(kind::BITVECTOR_UDIV_TOTAL, a, b, q)
+      && bb->getCircuit(kind::BITVECTOR_UREM_TOTAL, a, b, r))
+  {
+    return;
+  }
+  q.clear();
+  uDivModRec(a, b, q, r, a.size());
+  bb->storeCircuit(kind::BITVECTOR_UDIV_TOTAL, a, b, q);
+  bb->storeCircuit(kind::BITVECTOR_UREM_TOTAL, a, b, r);
+}
+
 template <class T>
 void DefaultUdivBB(TNode node, std::vector<T>& q, TBitblaster<T>* bb)
 {
@@ -530,7 +576,7 @@ void DefaultUdivBB(TNode node, std::vector<T>& q, TBitblaster<T>* bb)
   bb->bbTerm(node[1], b);
 
   std::vector<T> r;
-  uDivModRec(a, b, q, r, utils::getSize(node));
+  uDivMod(a, b, q, r, bb);
   // adding a special case for division by 0
   std::vector<T> iszero;
   for (unsigned i = 0; i < b.size(); ++i)
@@ -563,7 +609,7 @@ void DefaultUremBB(TNode node, std::vector<T>& rem, TBitblaster<T>* bb)
   bb->bbTerm(node[1], b);
 
   std::vector<T> q;
-  uDivModRec(a, b, q, rem, utils::getSize(node));
+  uDivMod(a, b, q, rem, bb);
   // adding a special case for division by 0
   std::vector<T> iszero;
   for (unsigned i = 0; i < b.size(); ++i)
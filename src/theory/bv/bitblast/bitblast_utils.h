@@ -20,8 +20,10 @@
 #define __CVC4__THEORY__BV__BITBLAST__BITBLAST_UTILS_H
 
 
+#include <algorithm>
 #include <ostream>
 #include "expr/node.h"
+#include "options/bv_options.h"
 
 namespace CVC4 {
 namespace theory {
@@ -59,6 +61,21 @@ template <class T> T mkIff(T a, T b);
 template <class T> T mkIte(T cond, T a, T b);
 
 
+/**
+ * With --bv-structural-hashing, the gates over Nodes are folded with the
+ * constants and with their operands, and the operands of the commutative
+ * gates are ordered, so that the same gate over the same bits is the same
+ * node (the NodeManager hashes the rest).
+ */
+inline bool hashGates() { return options::bitvectorStructuralHashing(); }
+
+/** Whether a is the negation of b */
+inline bool isNegation(TNode a, TNode b)
+{
+  return (a.getKind() == kind::NOT && a[0] == b)
+         || (b.getKind() == kind::NOT && b[0] == a);
+}
+
 template <> inline
 Node mkTrue<Node>() {
   return NodeManager::currentNM()->mkConst<bool>(true);
@@ -71,11 +88,80 @@ Node mkFalse<Node>() {
 
 template <> inline
 Node mkNot<Node>(Node a) {
+  if (hashGates())
+  {
+    if (a.isConst())
+    {
+      return NodeManager::currentNM()->mkConst<bool>(!a.getConst<bool>());
+    }
+    if (a.getKind() == kind::NOT)
+    {
+      return a[0];
+    }
+  }
   return NodeManager::currentNM()->mkNode(kind::NOT, a);
 }
 
+/**
+ * The children of an n-ary AND (OR if isAnd is false) without the neutral
+ * constants and the duplicates, in order.  Returns false if the gate is the
+ * absorbing constant.
+ */
+inline bool hashGateChildren(const std::vector<Node>& children,
+                             bool isAnd,
+                             std::vector<Node>& res)
+{
+  for (const Node& child : children)
+  {
+    if (child.isConst())
+    {
+      if (child.getConst<bool>() != isAnd)
+      {
+        return false;
+      }
+      continue;
+    }
+    res.push_back(child);
+  }
+  std::sort(res.begin(), res.end());
+  res.erase(std::unique(res.begin(), res.end()), res.end());
+  for (unsigned i = 0; i < res.size(); ++i)
+  {
+    if (res[i].getKind() == kind::NOT
+        && std::binary_search(res.begin(), res.end(), res[i][0]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** The n-ary AND (OR if isAnd is false) of the children, hashed */
+inline Node mkHashedGate(const std::vector<Node>& children, bool isAnd)
+{
+  NodeManager* nm = NodeManager::currentNM();
+  std::vector<Node> res;
+  if (!hashGateChildren(children, isAnd, res))
+  {
+    return nm->mkConst<bool>(!isAnd);
+  }
+  if (res.empty())
+  {
+    return nm->mkConst<bool>(isAnd);
+  }
+  if (res.size() == 1)
+  {
+    return res[0];
+  }
+  return nm->mkNode(isAnd ? kind::AND : kind::OR, res);
+}
+
 template <> inline
 Node mkOr<Node>(Node a, Node b) {
+  if (hashGates())
+  {
+    return mkHashedGate({a, b}, false);
+  }
   return NodeManager::currentNM()->mkNode(kind::OR, a, b);
 }
 
@@ -84,12 +170,20 @@ Node mkOr<Node>(const std::vector<Node>& children) {
   Assert (children.size());
   if (children.size() == 1)
     return children[0]; 
+  if (hashGates())
+  {
+    return mkHashedGate(children, false);
+  }
   return NodeManager::currentNM()->mkNode(kind::OR, children); 
 }
 
 
 template <> inline
 Node mkAnd<Node>(Node a, Node b) {
+  if (hashGates())
+  {
+    return mkHashedGate({a, b}, true);
+  }
   return NodeManager::currentNM()->mkNode(kind::AND, a, b);
 }
 
@@ -98,22 +192,87 @@ Node mkAnd<Node>(const std::vector<Node>& children) {
   Assert (children.size());
   if (children.size() == 1)
     return children[0]; 
+  if (hashGates())
+  {
+    return mkHashedGate(children, true);
+  }
   return NodeManager::currentNM()->mkNode(kind::AND, children); 
 }
 
 
 template <> inline
 Node mkXor<Node>(Node a, Node b) {
+  if (hashGates())
+  {
+    NodeManager* nm = NodeManager::currentNM();
+    if (a.isConst())
+    {
+      return a.getConst<bool>() ? mkNot(b) : b;
+    }
+    if (b.isConst())
+    {
+      return b.getConst<bool>() ? mkNot(a) : a;
+    }
+    if (a == b || isNegation(a, b))
+    {
+      return nm->mkConst<bool>(a != b);
+    }
+    if (b < a)
+    {
+      std::swap(a, b);
+    }
+    return nm->mkNode(kind::XOR, a, b);
+  }
   return NodeManager::currentNM()->mkNode(kind::XOR, a, b);
 }
 
 template <> inline
 Node mkIff<Node>(Node a, Node b) {
+  if (hashGates())
+  {
+    NodeManager* nm = NodeManager::currentNM();
+    if (a.isConst())
+    {
+      return a.getConst<bool>() ? b : mkNot(b);
+    }
+    if (b.isConst())
+    {
+      return b.getConst<bool>() ? a : mkNot(a);
+    }
+    if (a == b || isNegation(a, b))
+    {
+      return nm->mkConst<bool>(a == b);
+    }
+    if (b < a)
+    {
+      std::swap(a, b);
+    }
+    return nm->mkNode(kind::EQUAL, a, b);
+  }
   return NodeManager::currentNM()->mkNode(kind::EQUAL, a, b);
 }
 
 template <> inline
 Node mkIte<Node>(Node cond, Node a, Node b) {
+  if (hashGates())
+  {
+    if (cond.isConst())
+    {
+      return cond.getConst<bool>() ? a : b;
+    }
+    if (a == b)
+    {
+      return a;
+    }
+    if (a.isConst())
+    {
+      return a.getConst<bool>() ? mkOr(cond, b) : mkAnd(mkNot(cond), b);
+    }
+    if (b.isConst())
+    {
+      return b.getConst<bool>() ? mkOr(mkNot(cond), a) : mkAnd(cond, a);
+    }
+  }
   return NodeManager::currentNM()->mkNode(kind::ITE, cond, a, b);
 }
 
@@ -220,6 +379,82 @@ inline void shiftAddMultiplier(const std::vector<T>&a, const std::vector<T>&b, s
   }
 }
 
+/**
+ * Constructs a multiplier that reduces the partial products of each weight
+ * with a Wallace tree of full adders (half adders for the leftover pairs),
+ * and adds the last two rows with a ripple carry adder.
+ */
+template <class T>
+inline void wallaceMultiplier(const std::vector<T>& a,
+                              const std::vector<T>& b,
+                              std::vector<T>& res)
+{
+  Assert(a.size() == b.size() && res.size() == 0);
+  unsigned n = a.size();
+  // the partial products of weight k, the product is truncated to n bits
+  std::vector<std::vector<T> > columns(n);
+  for (unsigned i = 0; i < n; ++i)
+  {
+    for (unsigned j = 0; i + j < n; ++j)
+    {
+      columns[i + j].push_back(mkAnd(b[i], a[j]));
+    }
+  }
+
+  bool reduced = false;
+  while (!reduced)
+  {
+    reduced = true;
+    std::vector<std::vector<T> > next(n);
+    for (unsigned k = 0; k < n; ++k)
+    {
+      const std::vector<T>& column = columns[k];
+      if (column.size() <= 2)
+      {
+        next[k].insert(next[k].end(), column.begin(), column.end());
+        continue;
+      }
+      reduced = false;
+      unsigned i = 0;
+      for (; i + 1 < column.size(); i += 3)
+      {
+        T x = column[i];
+        T y = column[i + 1];
+        T x_xor_y = mkXor(x, y);
+        if (i + 2 == column.size())
+        {
+          // half adder
+          next[k].push_back(x_xor_y);
+          if (k + 1 < n)
+          {
+            next[k + 1].push_back(mkAnd(x, y));
+          }
+          continue;
+        }
+        T z = column[i + 2];
+        next[k].push_back(mkXor(x_xor_y, z));
+        if (k + 1 < n)
+        {
+          next[k + 1].push_back(mkOr(mkAnd(x, y), mkAnd(x_xor_y, z)));
+        }
+      }
+      if (i < column.size())
+      {
+        next[k].push_back(column[i]);
+      }
+    }
+    columns.swap(next);
+  }
+
+  std::vector<T> row0, row1;
+  for (unsigned k = 0; k < n; ++k)
+  {
+    row0.push_back(columns[k].size() > 0 ? columns[k][0] : mkFalse<T>());
+    row1.push_back(columns[k].size() > 1 ? columns[k][1] : mkFalse<T>());
+  }
+  rippleCarryAdder(row0, row1, res, mkFalse<T>());
+}
+
 template <class T>
 T inline uLessThanBB(const std::vector<T>&a, const std::vector<T>& b, bool orEqual) {
   Assert (a.size() && b.size());
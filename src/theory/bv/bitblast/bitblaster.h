@@ -19,6 +19,7 @@
 #ifndef __CVC4__THEORY__BV__BITBLAST__BITBLASTER_H
 #define __CVC4__THEORY__BV__BITBLAST__BITBLASTER_H
 
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -51,6 +52,7 @@ class TBitblaster
   typedef std::unordered_map<Node, Bits, NodeHashFunction> TermDefMap;
   typedef std::unordered_set<TNode, TNodeHashFunction> TNodeSet;
   typedef std::unordered_map<Node, Node, NodeHashFunction> ModelCache;
+  typedef std::map<std::pair<Kind, Bits>, Bits> CircuitCache;
 
   typedef void (*TermBBStrategy)(TNode, Bits&, TBitblaster<T>*);
   typedef T (*AtomBBStrategy)(TNode, TBitblaster<T>*);
@@ -58,6 +60,11 @@ class TBitblaster
   // caches and mappings
   TermDefMap d_termCache;
   ModelCache d_modelCache;
+  /**
+   * The multiplier and divider circuits by operator and operand bits, so that
+   * terms with the same operand bits share them (--bv-structural-hashing)
+   */
+  CircuitCache d_circuitCache;
 
   BitVectorProof* d_bvp;
 
@@ -84,6 +91,9 @@ class TBitblaster
   bool hasBBTerm(TNode node) const;
   void getBBTerm(TNode node, Bits& bits) const;
   virtual void storeBBTerm(TNode term, const Bits& bits);
+  /** Gets the circuit of operator k over the bits a and b, if built. */
+  bool getCircuit(Kind k, const Bits& a, const Bits& b, Bits& res) const;
+  void storeCircuit(Kind k, const Bits& a, const Bits& b, const Bits& res);
   /**
    * Return a constant representing the value of a in the  model.
    * If fullModel is true set unconstrained bits to 0. If not return
@@ -172,7 +182,8 @@ void TBitblaster<T>::initTermBBStrategies()
 }
 
 template <class T>
-TBitblaster<T>::TBitblaster() : d_termCache(), d_modelCache(), d_bvp(NULL)
+TBitblaster<T>::TBitblaster()
+    : d_termCache(), d_modelCache(), d_circuitCache(), d_bvp(NULL)
 {
   initAtomBBStrategies();
   initTermBBStrategies();
@@ -196,6 +207,35 @@ void TBitblaster<T>::storeBBTerm(TNode node, const Bits& bits)
   d_termCache.insert(std::make_pair(node, bits));
 }
 
+template <class T>
+bool TBitblaster<T>::getCircuit(Kind k,
+                                const Bits& a,
+                                const Bits& b,
+                                Bits& res) const
+{
+  Bits operands = a;
+  operands.insert(operands.end(), b.begin(), b.end());
+  typename CircuitCache::const_iterator it =
+      d_circuitCache.find(std::make_pair(k, operands));
+  if (it == d_circuitCache.end())
+  {
+    return false;
+  }
+  res = it->second;
+  return true;
+}
+
+template <class T>
+void TBitblaster<T>::storeCircuit(Kind k,
+                                  const Bits& a,
+                                  const Bits& b,
+                                  const Bits& res)
+{
+  Bits operands = a;
+  operands.insert(operands.end(), b.begin(), b.end());
+  d_circuitCache[std::make_pair(k, operands)] = res;
+}
+
 template <class T>
 void TBitblaster<T>::invalidateModelCache()
 {
@@ -18,6 +18,8 @@
 
 #include "theory/bv/bitblast/eager_bitblaster.h"
 
+#include <unordered_map>
+
 #include "options/bv_options.h"
 #include "proof/bitvector_proof.h"
 #include "prop/cnf_stream.h"
@@ -30,6 +32,106 @@ namespace CVC4 {
 namespace theory {
 namespace bv {
 
+namespace {
+
+unsigned findCone(std::vector<unsigned>& parent, unsigned i)
+{
+  while (parent[i] != i)
+  {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+void mergeCones(std::vector<unsigned>& parent, unsigned i, unsigned j)
+{
+  i = findCone(parent, i);
+  j = findCone(parent, j);
+  // the first formula of the cone is its representative
+  if (i < j)
+  {
+    parent[j] = i;
+  }
+  else if (j < i)
+  {
+    parent[i] = j;
+  }
+}
+
+/**
+ * Partitions the conjuncts of the assertions into cones of influence: two
+ * conjuncts are in the same cone iff they are connected by shared variables.
+ * The cones, and the conjuncts in each cone, are in the order of the first
+ * conjunct of the cone.
+ */
+void partitionCones(const std::vector<Node>& assertions,
+                    std::vector<std::vector<Node>>& cones)
+{
+  // the preprocessing can conjoin independent assertions
+  std::vector<Node> formulas;
+  std::vector<TNode> stack(assertions.rbegin(), assertions.rend());
+  while (!stack.empty())
+  {
+    TNode current = stack.back();
+    stack.pop_back();
+    if (current.getKind() == kind::AND)
+    {
+      for (unsigned i = current.getNumChildren(); i > 0; --i)
+      {
+        stack.push_back(current[i - 1]);
+      }
+    }
+    else
+    {
+      formulas.push_back(current);
+    }
+  }
+
+  std::vector<unsigned> parent(formulas.size());
+  // the first formula that reached each node, whose cone has the variables
+  // below it
+  std::unordered_map<TNode, unsigned, TNodeHashFunction> reached;
+  for (unsigned i = 0; i < formulas.size(); ++i)
+  {
+    parent[i] = i;
+    stack.push_back(formulas[i]);
+    while (!stack.empty())
+    {
+      TNode current = stack.back();
+      stack.pop_back();
+      if (current.isConst())
+      {
+        // constants don't connect the cones
+        continue;
+      }
+      std::unordered_map<TNode, unsigned, TNodeHashFunction>::const_iterator
+          it = reached.find(current);
+      if (it != reached.end())
+      {
+        mergeCones(parent, i, it->second);
+        continue;
+      }
+      reached[current] = i;
+      stack.insert(stack.end(), current.begin(), current.end());
+    }
+  }
+
+  std::unordered_map<unsigned, unsigned> coneIndex;
+  for (unsigned i = 0; i < formulas.size(); ++i)
+  {
+    unsigned root = findCone(parent, i);
+    if (coneIndex.find(root) == coneIndex.end())
+    {
+      coneIndex[root] = cones.size();
+      cones.push_back(std::vector<Node>());
+    }
+    cones[coneIndex[root]].push_back(formulas[i]);
+  }
+}
+
+}  // namespace
+
 EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv)
     : TBitblaster<Node>(),
       d_nullContext(new context::Context()),
@@ -39,7 +141,9 @@ EagerBitblaster::EagerBitblaster(TheoryBV* theory_bv)
       d_bv(theory_bv),
       d_bbAtoms(),
       d_variables(),
-      d_notify()
+      d_notify(),
+      d_gateStatistics("theory::bv::EagerBitblaster"),
+      d_statistics()
 {
   prop::SatSolver *solver = nullptr;
   switch (options::bvSatSolver())
@@ -80,6 +184,27 @@ void EagerBitblaster::bbFormula(TNode node) {
                                 TNode::null());
 }
 
+void EagerBitblaster::bbFormulas(const std::vector<Node>& formulas)
+{
+  std::vector<std::vector<Node> > cones;
+  partitionCones(formulas, cones);
+  d_statistics.d_numCones += cones.size();
+  // one cone after the other, so that the variables and clauses of a cone
+  // are next to each other in the SAT solver
+  for (const std::vector<Node>& cone : cones)
+  {
+    for (const Node& formula : cone)
+    {
+      bbFormula(formula);
+    }
+  }
+}
+
+void EagerBitblaster::bbAssumption(TNode formula)
+{
+  d_cnfStream->ensureLiteral(formula);
+}
+
 /**
  * Bitblasts the atom, assigns it a marker literal, adding it to the SAT solver
  * NOTE: duplicate clauses are not detected because of marker literal
@@ -123,6 +248,7 @@ void EagerBitblaster::storeBBAtom(TNode atom, Node atom_bb) {
   if (d_bvp) {
     d_bvp->registerAtomBB(atom.toExpr(), atom_bb.toExpr());
   }
+  d_gateStatistics.countGates(atom, {atom_bb});
   d_bbAtoms.insert(atom);
 }
 
@@ -149,6 +275,7 @@ void EagerBitblaster::bbTerm(TNode node, Bits& bits) {
   Debug("bitvector-bitblast") << "Bitblasting node " << node << "\n";
 
   d_termBBStrategies[node.getKind()](node, bits, this);
+  d_gateStatistics.countGates(node, bits);
 
   Assert(bits.size() == utils::getSize(node));
 
@@ -185,6 +312,18 @@ bool EagerBitblaster::solve() {
   return prop::SAT_VALUE_TRUE == d_satSolver->solve();
 }
 
+bool EagerBitblaster::solve(const std::vector<Node>& assumptions)
+{
+  Debug("bitvector") << "EagerBitblaster::solve(" << assumptions.size()
+                     << " assumptions). \n";
+  std::vector<prop::SatLiteral> literals;
+  for (const Node& assumption : assumptions)
+  {
+    literals.push_back(d_cnfStream->getLiteral(assumption));
+  }
+  return prop::SAT_VALUE_TRUE == d_satSolver->solve(literals);
+}
+
 /**
  * Returns the value a is currently assigned to in the SAT solver
  * or null if the value is completely unassigned.
@@ -257,6 +396,17 @@ bool EagerBitblaster::isSharedTerm(TNode node) {
   return d_bv->d_sharedTermsSet.find(node) != d_bv->d_sharedTermsSet.end();
 }
 
+EagerBitblaster::Statistics::Statistics()
+    : d_numCones("theory::bv::EagerBitblaster::NumCones", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_numCones);
+}
+
+EagerBitblaster::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_numCones);
+}
+
 
 }  // namespace bv
 }  // namespace theory
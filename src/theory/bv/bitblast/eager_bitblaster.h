@@ -25,6 +25,8 @@
 
 #include "prop/cnf_stream.h"
 #include "prop/sat_solver.h"
+#include "theory/bv/bitblast/gate_statistics.h"
+#include "util/statistics_registry.h"
 
 namespace CVC4 {
 namespace theory {
@@ -46,11 +48,20 @@ class EagerBitblaster : public TBitblaster<Node>
   Node getBBAtom(TNode node) const override;
   bool hasBBAtom(TNode atom) const override;
   void bbFormula(TNode formula);
+  /**
+   * Bit-blasts the formulas and asserts them, one cone of formulas that
+   * share variables after the other.
+   */
+  void bbFormulas(const std::vector<Node>& formulas);
+  /** Bit-blasts the formula without asserting it, to assume it in solve(). */
+  void bbAssumption(TNode formula);
   void storeBBAtom(TNode atom, Node atom_bb) override;
   void storeBBTerm(TNode node, const Bits& bits) override;
 
   bool assertToSat(TNode node, bool propagate = true);
   bool solve();
+  /** Solves under the (bit-blasted) formulas as assumptions. */
+  bool solve(const std::vector<Node>& assumptions);
   bool collectModelInfo(TheoryModel* m, bool fullModel);
   void setProofLog(BitVectorProof* bvp);
 
@@ -70,6 +81,17 @@ class EagerBitblaster : public TBitblaster<Node>
   // This is either an MinisatEmptyNotify or NULL.
   std::unique_ptr<MinisatEmptyNotify> d_notify;
 
+  GateStatistics d_gateStatistics;
+
+  class Statistics
+  {
+   public:
+    IntStat d_numCones;
+    Statistics();
+    ~Statistics();
+  };
+  Statistics d_statistics;
+
   Node getModelFromSatSolver(TNode a, bool fullModel) override;
   bool isSharedTerm(TNode node);
 };
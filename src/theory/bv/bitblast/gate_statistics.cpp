@@ -0,0 +1,111 @@
+/*********************                                                        */
+/*! \file gate_statistics.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Per-operator statistics of the bit-blasted circuits.
+ **
+ ** Per-operator statistics of the bit-blasted circuits.
+ **/
+
+#include "theory/bv/bitblast/gate_statistics.h"
+
+#include <sstream>
+
+#include "options/base_options.h"
+#include "smt/smt_statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+GateStatistics::GateStatistics(const std::string& prefix)
+    : d_prefix(prefix), d_counted(), d_gates(), d_clauses()
+{
+}
+
+GateStatistics::~GateStatistics()
+{
+  for (KindStatMap* stats : {&d_gates, &d_clauses})
+  {
+    for (const std::pair<const Kind, IntStat*>& stat : *stats)
+    {
+      smtStatisticsRegistry()->unregisterStat(stat.second);
+      delete stat.second;
+    }
+  }
+}
+
+IntStat* GateStatistics::getStat(KindStatMap& stats,
+                                 Kind k,
+                                 const std::string& name)
+{
+  KindStatMap::const_iterator it = stats.find(k);
+  if (it != stats.end())
+  {
+    return it->second;
+  }
+  std::stringstream ss;
+  ss << d_prefix << "::" << name << "::" << k;
+  IntStat* stat = new IntStat(ss.str(), 0);
+  smtStatisticsRegistry()->registerStat(stat);
+  stats[k] = stat;
+  return stat;
+}
+
+void GateStatistics::countGates(TNode term, const std::vector<Node>& bits)
+{
+  if (!options::statistics())
+  {
+    return;
+  }
+  int64_t gates = 0;
+  int64_t clauses = 0;
+  std::vector<TNode> visit(bits.begin(), bits.end());
+  while (!visit.empty())
+  {
+    TNode current = visit.back();
+    visit.pop_back();
+    unsigned numClauses;
+    switch (current.getKind())
+    {
+      case kind::NOT: numClauses = 0; break;
+      case kind::AND:
+      case kind::OR: numClauses = current.getNumChildren() + 1; break;
+      case kind::XOR: numClauses = 4; break;
+      case kind::EQUAL:
+        if (!current[0].getType().isBoolean())
+        {
+          // an atom in the condition of an ite
+          continue;
+        }
+        numClauses = 4;
+        break;
+      case kind::ITE: numClauses = 6; break;
+      default: continue;
+    }
+    if (!d_counted.insert(current).second)
+    {
+      continue;
+    }
+    if (numClauses > 0)
+    {
+      ++gates;
+      clauses += numClauses;
+    }
+    visit.insert(visit.end(), current.begin(), current.end());
+  }
+  Kind k = term.getKind();
+  *getStat(d_gates, k, "Gates") += gates;
+  *getStat(d_clauses, k, "Clauses") += clauses;
+}
+
+}  // namespace bv
+}  // namespace theory
+}  // namespace CVC4
@@ -0,0 +1,66 @@
+/*********************                                                        */
+/*! \file gate_statistics.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Per-operator statistics of the bit-blasted circuits.
+ **
+ ** Per-operator statistics of the bit-blasted circuits.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__BV__BITBLAST__GATE_STATISTICS_H
+#define __CVC4__THEORY__BV__BITBLAST__GATE_STATISTICS_H
+
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "expr/node.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+/**
+ * Counts, per operator, the gates of the bit-blasted terms and atoms and
+ * the clauses of their Tseitin encoding (with --stats).  A gate is counted
+ * for the first term whose bits contain it, so that the counts add up to
+ * the size of the circuit.
+ */
+class GateStatistics
+{
+ public:
+  GateStatistics(const std::string& prefix);
+  ~GateStatistics();
+
+  /** Counts the gates of bits, the bit-blasted form of term. */
+  void countGates(TNode term, const std::vector<Node>& bits);
+  /** Forgets the counted gates, when the circuits are encoded again. */
+  void clear() { d_counted.clear(); }
+
+ private:
+  typedef std::map<Kind, IntStat*> KindStatMap;
+
+  IntStat* getStat(KindStatMap& stats, Kind k, const std::string& name);
+
+  std::string d_prefix;
+  std::unordered_set<Node, NodeHashFunction> d_counted;
+  KindStatMap d_gates;
+  KindStatMap d_clauses;
+}; /* class GateStatistics */
+
+}  // namespace bv
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* __CVC4__THEORY__BV__BITBLAST__GATE_STATISTICS_H */
@@ -76,6 +76,7 @@ TLazyBitblaster::TLazyBitblaster(context::Context* c,
       d_emptyNotify(emptyNotify),
       d_fullModelAssertionLevel(c, 0),
       d_name(name),
+      d_gateStatistics(name),
       d_statistics(name)
 {
   d_satSolver.reset(
@@ -191,6 +192,7 @@ void TLazyBitblaster::storeBBAtom(TNode atom, Node atom_bb) {
   if( d_bvp != NULL ){
     d_bvp->registerAtomBB(atom.toExpr(), atom_bb.toExpr());
   }
+  d_gateStatistics.countGates(atom, {atom_bb});
   d_bbAtoms.insert(atom);
 }
 
@@ -241,6 +243,7 @@ void TLazyBitblaster::bbTerm(TNode node, Bits& bits) {
   ++d_statistics.d_numTerms;
 
   d_termBBStrategies[node.getKind()] (node, bits,this);
+  d_gateStatistics.countGates(node, bits);
 
   Assert (bits.size() == utils::getSize(node));
 
@@ -581,6 +584,8 @@ void TLazyBitblaster::clearSolver() {
   d_bbAtoms.clear();
   d_variables.clear();
   d_termCache.clear();
+  d_circuitCache.clear();
+  d_gateStatistics.clear();
 
   invalidateModelCache();
   // recreate sat solver
@@ -27,6 +27,7 @@
 #include "prop/registrar.h"
 #include "prop/sat_solver.h"
 #include "theory/bv/abstraction.h"
+#include "theory/bv/bitblast/gate_statistics.h"
 
 namespace CVC4 {
 namespace theory {
@@ -166,6 +167,7 @@ class TLazyBitblaster : public TBitblaster<Node>
     ~Statistics();
   };
   std::string d_name;
+  GateStatistics d_gateStatistics;
 
  // NOTE: d_statistics is public since d_bitblastTimer needs to be initalized
  //       prior to calling bbAtom. As it is now, the timer can't be initialized
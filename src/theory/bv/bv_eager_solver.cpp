@@ -17,6 +17,7 @@
 #include "theory/bv/bv_eager_solver.h"
 
 #include "options/bv_options.h"
+#include "options/smt_options.h"
 #include "proof/bitvector_proof.h"
 #include "theory/bv/bitblast/aig_bitblaster.h"
 #include "theory/bv/bitblast/eager_bitblaster.h"
@@ -27,8 +28,9 @@ namespace CVC4 {
 namespace theory {
 namespace bv {
 
-EagerBitblastSolver::EagerBitblastSolver(TheoryBV* bv)
+EagerBitblastSolver::EagerBitblastSolver(context::Context* c, TheoryBV* bv)
     : d_assertionSet(),
+      d_assumptions(c),
       d_bitblaster(nullptr),
       d_aigBitblaster(nullptr),
       d_useAig(options::bitvectorAig()),
@@ -79,6 +81,13 @@ void EagerBitblastSolver::assertFormula(TNode formula) {
   Assert(isInitialized());
   Debug("bitvector-eager") << "EagerBitblastSolver::assertFormula " << formula
                            << "\n";
+  if (options::incrementalSolving())
+  {
+    // the formula is only bit-blasted, it's assumed while it's asserted
+    Assert(!d_useAig);
+    d_bitblaster->bbAssumption(formula);
+    return;
+  }
   d_assertionSet.insert(formula);
   // ensures all atoms are bit-blasted and converted to AIG
   if (d_useAig) {
@@ -88,12 +97,36 @@ void EagerBitblastSolver::assertFormula(TNode formula) {
     Unreachable();
 #endif
   } else {
-    d_bitblaster->bbFormula(formula);
+    // bit-blasted with the other formulas, by cones, in checkSat()
+    d_pendingFormulas.push_back(formula);
+  }
+}
+
+void EagerBitblastSolver::assertAssumption(TNode atom)
+{
+  Assert(atom.getKind() == kind::BITVECTOR_EAGER_ATOM);
+  d_assumptions.insert(atom);
+}
+
+void EagerBitblastSolver::getAssumptions(std::vector<TNode>& atoms) const
+{
+  for (const Node& atom : d_assumptions)
+  {
+    atoms.push_back(atom);
   }
 }
 
 bool EagerBitblastSolver::checkSat() {
   Assert(isInitialized());
+  if (options::incrementalSolving())
+  {
+    std::vector<Node> formulas;
+    for (const Node& atom : d_assumptions)
+    {
+      formulas.push_back(atom[0]);
+    }
+    return formulas.empty() || d_bitblaster->solve(formulas);
+  }
   if (d_assertionSet.empty()) {
     return true;
   }
@@ -111,6 +144,11 @@ bool EagerBitblastSolver::checkSat() {
 #endif
   }
 
+  if (!d_pendingFormulas.empty())
+  {
+    d_bitblaster->bbFormulas(d_pendingFormulas);
+    d_pendingFormulas.clear();
+  }
   return d_bitblaster->solve();
 }
 
@@ -21,6 +21,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "context/cdhashset.h"
 #include "expr/node.h"
 #include "theory/bv/theory_bv.h"
 #include "theory/theory_model.h"
@@ -34,13 +35,22 @@ class AigBitblaster;
 
 /**
  * BitblastSolver
+ *
+ * In incremental mode, the formulas are bit-blasted once without being
+ * asserted, and each query is solved under the formulas of the eager atoms
+ * asserted in the current context as assumptions, so the encoding and the
+ * learned clauses are kept across the queries.
  */
 class EagerBitblastSolver {
  public:
-  EagerBitblastSolver(theory::bv::TheoryBV* bv);
+  EagerBitblastSolver(context::Context* c, theory::bv::TheoryBV* bv);
   ~EagerBitblastSolver();
   bool checkSat();
   void assertFormula(TNode formula);
+  /** Asserts the eager atom in the current context (incremental mode). */
+  void assertAssumption(TNode atom);
+  /** Gets the eager atoms asserted in the current context. */
+  void getAssumptions(std::vector<TNode>& atoms) const;
   // purely for debugging purposes
   bool hasAssertions(const std::vector<TNode>& formulas);
 
@@ -53,6 +63,10 @@ class EagerBitblastSolver {
  private:
   typedef std::unordered_set<TNode, TNodeHashFunction> AssertionSet;
   AssertionSet d_assertionSet;
+  /** The formulas to bit-blast by cones at the next checkSat() */
+  std::vector<Node> d_pendingFormulas;
+  /** The asserted eager atoms (incremental mode) */
+  context::CDHashSet<Node, NodeHashFunction> d_assumptions;
   /** Bitblasters */
   EagerBitblaster* d_bitblaster;
   AigBitblaster* d_aigBitblaster;
@@ -0,0 +1,1194 @@
+/*********************                                                        */
+/*! \file bv_subtheory_propagation.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Word-level propagation of known bits and intervals.
+ **
+ ** Word-level propagation of known bits and unsigned intervals over the
+ ** bit-vector operators, ahead of the bit-blaster (--bv-propagation-solver).
+ **/
+
+#include "theory/bv/bv_subtheory_propagation.h"
+
+#include <algorithm>
+
+#include "options/bv_options.h"
+#include "options/smt_options.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/bv/theory_bv.h"
+#include "theory/bv/theory_bv_utils.h"
+#include "theory/theory_model.h"
+
+using namespace std;
+using namespace CVC4::context;
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+namespace {
+
+bool isZero(const BitVector& x) { return x.getValue().isZero(); }
+
+/** The mask of the m low bits of a vector of the given size */
+BitVector lowMask(unsigned size, unsigned m)
+{
+  if (m == 0)
+  {
+    return BitVector(size);
+  }
+  if (m >= size)
+  {
+    return BitVector::mkOnes(size);
+  }
+  return BitVector::mkOnes(m).zeroExtend(size - m);
+}
+
+/** The number of low bits that are all known */
+unsigned knownLowBits(const BitVector& known)
+{
+  unsigned i = 0, size = known.getSize();
+  while (i < size && known.isBitSet(i))
+  {
+    ++i;
+  }
+  return i;
+}
+
+/** The number of low bits that are all known to be 0 */
+unsigned knownLowZeros(const BitDomain& d)
+{
+  unsigned i = 0, size = d.getSize();
+  while (i < size && d.d_known.isBitSet(i) && !d.d_value.isBitSet(i))
+  {
+    ++i;
+  }
+  return i;
+}
+
+/** The bits placed from bit low of a vector of the given size, 0 elsewhere */
+BitVector place(const BitVector& bits, unsigned size, unsigned low)
+{
+  BitVector res = bits;
+  if (low > 0)
+  {
+    res = res.concat(BitVector(low));
+  }
+  if (res.getSize() < size)
+  {
+    res = BitVector(size - res.getSize()).concat(res);
+  }
+  return res;
+}
+
+/** The extension of the known bits of a zero or sign extension */
+BitVector extendKnown(const BitVector& known, unsigned amount, bool extended)
+{
+  if (amount == 0)
+  {
+    return known;
+  }
+  BitVector high = extended ? BitVector::mkOnes(amount) : BitVector(amount);
+  return high.concat(known);
+}
+
+/** The conjunction of the facts of both reasons */
+Node mergeReasons(TNode a, TNode b)
+{
+  if (a.isNull() || a == b)
+  {
+    return b;
+  }
+  if (b.isNull())
+  {
+    return a;
+  }
+  std::vector<TNode> conjuncts;
+  for (TNode r : {a, b})
+  {
+    if (r.getKind() == kind::AND)
+    {
+      conjuncts.insert(conjuncts.end(), r.begin(), r.end());
+    }
+    else
+    {
+      conjuncts.push_back(r);
+    }
+  }
+  return utils::mkAnd(conjuncts);
+}
+
+/** Whether the domain of a term is computed from those of its operands */
+bool isSupportedKind(Kind k)
+{
+  switch (k)
+  {
+    case kind::BITVECTOR_NOT:
+    case kind::BITVECTOR_AND:
+    case kind::BITVECTOR_OR:
+    case kind::BITVECTOR_XOR:
+    case kind::BITVECTOR_CONCAT:
+    case kind::BITVECTOR_EXTRACT:
+    case kind::BITVECTOR_ZERO_EXTEND:
+    case kind::BITVECTOR_SIGN_EXTEND:
+    case kind::BITVECTOR_PLUS:
+    case kind::BITVECTOR_MULT:
+    case kind::BITVECTOR_NEG:
+    case kind::BITVECTOR_UDIV_TOTAL:
+    case kind::BITVECTOR_UREM_TOTAL:
+    case kind::BITVECTOR_SHL:
+    case kind::BITVECTOR_LSHR:
+    case kind::BITVECTOR_ASHR:
+    case kind::ITE: return true;
+    default: return false;
+  }
+}
+
+}  // namespace
+
+BitDomain::BitDomain(unsigned size)
+    : d_known(size),
+      d_value(size),
+      d_lo(size),
+      d_hi(BitVector::mkOnes(size))
+{
+}
+
+BitDomain::BitDomain(const BitVector& value)
+    : d_known(BitVector::mkOnes(value.getSize())),
+      d_value(value),
+      d_lo(value),
+      d_hi(value)
+{
+}
+
+void BitDomain::makeEmpty()
+{
+  d_lo = BitVector::mkOnes(getSize());
+  d_hi = BitVector(getSize());
+}
+
+void BitDomain::meet(const BitDomain& other)
+{
+  Assert(getSize() == other.getSize());
+  if (isEmpty())
+  {
+    return;
+  }
+  if (other.isEmpty()
+      || !isZero(d_known & other.d_known & (d_value ^ other.d_value)))
+  {
+    makeEmpty();
+    return;
+  }
+  d_known = d_known | other.d_known;
+  d_value = d_value | other.d_value;
+  if (d_lo.unsignedLessThan(other.d_lo))
+  {
+    d_lo = other.d_lo;
+  }
+  if (other.d_hi.unsignedLessThan(d_hi))
+  {
+    d_hi = other.d_hi;
+  }
+  normalize();
+}
+
+void BitDomain::normalize()
+{
+  if (isEmpty())
+  {
+    return;
+  }
+  // the interval of the bits: unknown bits all 0 to all 1
+  BitVector lo = d_value;
+  BitVector hi = d_value | ~d_known;
+  if (d_lo.unsignedLessThan(lo))
+  {
+    d_lo = lo;
+  }
+  if (hi.unsignedLessThan(d_hi))
+  {
+    d_hi = hi;
+  }
+  if (isEmpty())
+  {
+    makeEmpty();
+    return;
+  }
+  // the bits of the interval: the common prefix of its bounds
+  for (unsigned i = getSize(); i-- > 0;)
+  {
+    bool bit = d_lo.isBitSet(i);
+    if (bit != d_hi.isBitSet(i))
+    {
+      break;
+    }
+    if (!d_known.isBitSet(i))
+    {
+      d_known = d_known.setBit(i);
+      if (bit)
+      {
+        d_value = d_value.setBit(i);
+      }
+    }
+    else if (d_value.isBitSet(i) != bit)
+    {
+      makeEmpty();
+      return;
+    }
+  }
+}
+
+PropagationSolver::PropagationSolver(context::Context* c, TheoryBV* bv)
+    : SubtheorySolver(c, bv),
+      d_domains(c),
+      d_initialDomains(),
+      d_asserted(c),
+      d_explanations(c),
+      d_isComplete(c, false),
+      d_parents(),
+      d_atoms(),
+      d_registered(),
+      d_queue(),
+      d_budget(0),
+      d_conflict(),
+      d_statistics()
+{
+}
+
+bool PropagationSolver::isSupportedAtom(TNode atom)
+{
+  switch (atom.getKind())
+  {
+    case kind::EQUAL: return atom[0].getType().isBitVector();
+    case kind::BITVECTOR_ULT:
+    case kind::BITVECTOR_ULE:
+    case kind::BITVECTOR_SLT:
+    case kind::BITVECTOR_SLE: return true;
+    default: return false;
+  }
+}
+
+void PropagationSolver::preRegister(TNode node)
+{
+  if (!isSupportedAtom(node))
+  {
+    return;
+  }
+  for (unsigned i = 0; i < 2; ++i)
+  {
+    registerTerm(node[i]);
+    d_atoms[node[i]].push_back(node);
+  }
+}
+
+void PropagationSolver::registerTerm(TNode term)
+{
+  // post-order, so that the initial domains of the operands come first
+  std::vector<std::pair<TNode, bool> > stack;
+  stack.push_back(std::make_pair(term, false));
+  while (!stack.empty())
+  {
+    TNode current = stack.back().first;
+    bool operandsDone = stack.back().second;
+    stack.pop_back();
+    if (operandsDone)
+    {
+      d_initialDomains[current] = forward(current, true);
+      continue;
+    }
+    if (!d_registered.insert(current).second)
+    {
+      continue;
+    }
+    stack.push_back(std::make_pair(current, true));
+    for (const TNode& child : current)
+    {
+      if (child.getType().isBitVector())
+      {
+        d_parents[child].push_back(current);
+        stack.push_back(std::make_pair(child, false));
+      }
+    }
+  }
+}
+
+BitDomain PropagationSolver::getDomain(TNode term) const
+{
+  CDHashMap<Node, BitDomain, NodeHashFunction>::const_iterator it =
+      d_domains.find(term);
+  if (it != d_domains.end())
+  {
+    return (*it).second;
+  }
+  std::unordered_map<Node, BitDomain, NodeHashFunction>::const_iterator init =
+      d_initialDomains.find(term);
+  if (init != d_initialDomains.end())
+  {
+    return init->second;
+  }
+  if (term.getKind() == kind::CONST_BITVECTOR)
+  {
+    return BitDomain(term.getConst<BitVector>());
+  }
+  return BitDomain(utils::getSize(term));
+}
+
+BitDomain PropagationSolver::forward(TNode term, bool initial) const
+{
+  Kind k = term.getKind();
+  if (k == kind::CONST_BITVECTOR)
+  {
+    return BitDomain(term.getConst<BitVector>());
+  }
+  unsigned size = utils::getSize(term);
+  BitDomain res(size);
+  if (!isSupportedKind(k))
+  {
+    return res;
+  }
+
+  std::vector<BitDomain> ops;
+  for (const TNode& child : term)
+  {
+    // skip the condition of an ITE
+    if (!child.getType().isBitVector())
+    {
+      continue;
+    }
+    if (initial)
+    {
+      std::unordered_map<Node, BitDomain, NodeHashFunction>::const_iterator
+          it = d_initialDomains.find(child);
+      ops.push_back(it != d_initialDomains.end()
+                        ? it->second
+                        : child.getKind() == kind::CONST_BITVECTOR
+                              ? BitDomain(child.getConst<BitVector>())
+                              : BitDomain(utils::getSize(child)));
+    }
+    else
+    {
+      ops.push_back(getDomain(child));
+    }
+    res.d_reason = mergeReasons(res.d_reason, ops.back().d_reason);
+  }
+
+  BitVector ones = BitVector::mkOnes(size);
+  switch (k)
+  {
+    case kind::BITVECTOR_NOT:
+      res.d_known = ops[0].d_known;
+      res.d_value = ~ops[0].d_value & ops[0].d_known;
+      res.d_lo = ~ops[0].d_hi;
+      res.d_hi = ~ops[0].d_lo;
+      break;
+    case kind::BITVECTOR_AND:
+    case kind::BITVECTOR_OR:
+    {
+      // a bit is known if it's absorbing (0 for AND) in some operand, or
+      // neutral in all of them
+      bool isAnd = k == kind::BITVECTOR_AND;
+      BitVector absorbing(size);
+      BitVector neutral = ones;
+      for (const BitDomain& op : ops)
+      {
+        BitVector known1 = op.d_known & op.d_value;
+        BitVector known0 = op.d_known & ~op.d_value;
+        absorbing = absorbing | (isAnd ? known0 : known1);
+        neutral = neutral & (isAnd ? known1 : known0);
+      }
+      res.d_known = absorbing | neutral;
+      res.d_value = isAnd ? neutral : absorbing;
+      break;
+    }
+    case kind::BITVECTOR_XOR:
+      res.d_known = ones;
+      for (const BitDomain& op : ops)
+      {
+        res.d_known = res.d_known & op.d_known;
+        res.d_value = res.d_value ^ op.d_value;
+      }
+      res.d_value = res.d_value & res.d_known;
+      break;
+    case kind::BITVECTOR_CONCAT:
+      res.d_known = ops[0].d_known;
+      res.d_value = ops[0].d_value;
+      for (unsigned i = 1; i < ops.size(); ++i)
+      {
+        res.d_known = res.d_known.concat(ops[i].d_known);
+        res.d_value = res.d_value.concat(ops[i].d_value);
+      }
+      break;
+    case kind::BITVECTOR_EXTRACT:
+    {
+      unsigned high = utils::getExtractHigh(term);
+      unsigned low = utils::getExtractLow(term);
+      res.d_known = ops[0].d_known.extract(high, low);
+      res.d_value = ops[0].d_value.extract(high, low);
+      break;
+    }
+    case kind::BITVECTOR_ZERO_EXTEND:
+    {
+      unsigned amount =
+          term.getOperator().getConst<BitVectorZeroExtend>().zeroExtendAmount;
+      res.d_known = extendKnown(ops[0].d_known, amount, true);
+      res.d_value = ops[0].d_value.zeroExtend(amount);
+      res.d_lo = ops[0].d_lo.zeroExtend(amount);
+      res.d_hi = ops[0].d_hi.zeroExtend(amount);
+      break;
+    }
+    case kind::BITVECTOR_SIGN_EXTEND:
+    {
+      unsigned amount =
+          term.getOperator().getConst<BitVectorSignExtend>().signExtendAmount;
+      bool sign = ops[0].d_known.isBitSet(ops[0].getSize() - 1);
+      res.d_known = extendKnown(ops[0].d_known, amount, sign);
+      res.d_value = ops[0].d_value.signExtend(amount);
+      break;
+    }
+    case kind::BITVECTOR_PLUS:
+    case kind::BITVECTOR_MULT:
+    {
+      // the low bits of the result only depend on the low bits of the
+      // operands
+      bool isPlus = k == kind::BITVECTOR_PLUS;
+      unsigned known = size;
+      unsigned zeros = 0;
+      BitVector value(size, isPlus ? 0u : 1u);
+      Integer lo(isPlus ? 0 : 1);
+      Integer hi(isPlus ? 0 : 1);
+      for (const BitDomain& op : ops)
+      {
+        known = std::min(known, knownLowBits(op.d_known));
+        zeros += knownLowZeros(op);
+        value = isPlus ? value + op.d_value : value * op.d_value;
+        lo = isPlus ? lo + op.d_lo.getValue() : lo * op.d_lo.getValue();
+        hi = isPlus ? hi + op.d_hi.getValue() : hi * op.d_hi.getValue();
+      }
+      if (!isPlus && zeros > known)
+      {
+        // the trailing zeros of the operands add up in the product
+        res.d_known = lowMask(size, zeros);
+      }
+      else
+      {
+        res.d_known = lowMask(size, known);
+        res.d_value = value & res.d_known;
+      }
+      // no overflow
+      if (hi < Integer(1).multiplyByPow2(size))
+      {
+        res.d_lo = BitVector(size, lo);
+        res.d_hi = BitVector(size, hi);
+      }
+      break;
+    }
+    case kind::BITVECTOR_NEG:
+      res.d_known = lowMask(size, knownLowBits(ops[0].d_known));
+      res.d_value = (-ops[0].d_value) & res.d_known;
+      break;
+    case kind::BITVECTOR_UDIV_TOTAL:
+      if (ops[0].isFixed() && ops[1].isFixed())
+      {
+        res = BitDomain(ops[0].d_value.unsignedDivTotal(ops[1].d_value));
+      }
+      else if (!isZero(ops[1].d_hi))
+      {
+        // a division by 0 is all ones
+        res.d_lo = ops[0].d_lo.unsignedDivTotal(ops[1].d_hi);
+        if (!isZero(ops[1].d_lo))
+        {
+          res.d_hi = ops[0].d_hi.unsignedDivTotal(ops[1].d_lo);
+        }
+      }
+      break;
+    case kind::BITVECTOR_UREM_TOTAL:
+      if (ops[0].isFixed() && ops[1].isFixed())
+      {
+        res = BitDomain(ops[0].d_value.unsignedRemTotal(ops[1].d_value));
+      }
+      else if (ops[0].d_hi.unsignedLessThan(ops[1].d_lo))
+      {
+        // the remainder is the dividend
+        res.d_known = ops[0].d_known;
+        res.d_value = ops[0].d_value;
+        res.d_lo = ops[0].d_lo;
+        res.d_hi = ops[0].d_hi;
+      }
+      else
+      {
+        // a remainder by 0 is the dividend
+        res.d_hi = ops[0].d_hi;
+        if (!isZero(ops[1].d_lo)
+            && (ops[1].d_hi - BitVector(size, 1u)).unsignedLessThan(res.d_hi))
+        {
+          res.d_hi = ops[1].d_hi - BitVector(size, 1u);
+        }
+      }
+      break;
+    case kind::BITVECTOR_SHL:
+    case kind::BITVECTOR_LSHR:
+    case kind::BITVECTOR_ASHR:
+    {
+      if (!ops[1].isFixed())
+      {
+        break;
+      }
+      const BitVector& shift = ops[1].d_value;
+      unsigned amount = shift.getValue() >= Integer(size)
+                            ? size
+                            : shift.getValue().getUnsignedInt();
+      if (k == kind::BITVECTOR_SHL)
+      {
+        res.d_known = ops[0].d_known.leftShift(shift) | lowMask(size, amount);
+        res.d_value = ops[0].d_value.leftShift(shift);
+      }
+      else if (k == kind::BITVECTOR_LSHR)
+      {
+        res.d_known = ops[0].d_known.logicalRightShift(shift)
+                      | ~ones.logicalRightShift(shift);
+        res.d_value = ops[0].d_value.logicalRightShift(shift);
+      }
+      else
+      {
+        // the shifted in bits are known iff the sign bit is
+        res.d_known = ops[0].d_known.arithRightShift(shift);
+        res.d_value = ops[0].d_value.arithRightShift(shift) & res.d_known;
+      }
+      break;
+    }
+    case kind::ITE:
+      // the bits that are known and equal in both branches
+      res.d_known = ops[0].d_known & ops[1].d_known
+                    & ~(ops[0].d_value ^ ops[1].d_value);
+      res.d_value = ops[0].d_value & res.d_known;
+      res.d_lo = ops[0].d_lo.unsignedLessThan(ops[1].d_lo) ? ops[0].d_lo
+                                                            : ops[1].d_lo;
+      res.d_hi = ops[0].d_hi.unsignedLessThan(ops[1].d_hi) ? ops[1].d_hi
+                                                            : ops[0].d_hi;
+      break;
+    default: Unreachable();
+  }
+  res.normalize();
+  return res;
+}
+
+bool PropagationSolver::backward(TNode term)
+{
+  Kind k = term.getKind();
+  BitDomain d = getDomain(term);
+  unsigned size = d.getSize();
+  switch (k)
+  {
+    case kind::BITVECTOR_NOT:
+    {
+      BitDomain op(size);
+      op.d_known = d.d_known;
+      op.d_value = ~d.d_value & d.d_known;
+      op.d_lo = ~d.d_hi;
+      op.d_hi = ~d.d_lo;
+      op.normalize();
+      return update(term[0], op, d.d_reason);
+    }
+    case kind::BITVECTOR_AND:
+    case kind::BITVECTOR_OR:
+    {
+      // the neutral bits (1 for AND) of the term are neutral in all the
+      // operands, and its absorbing bits are absorbing in the operands whose
+      // other operands are all neutral there
+      bool isAnd = k == kind::BITVECTOR_AND;
+      BitVector neutral = d.d_known & (isAnd ? d.d_value : ~d.d_value);
+      BitVector absorbing = d.d_known & (isAnd ? ~d.d_value : d.d_value);
+      std::vector<BitDomain> ops;
+      for (const TNode& child : term)
+      {
+        ops.push_back(getDomain(child));
+      }
+      for (unsigned i = 0; i < ops.size(); ++i)
+      {
+        BitVector othersNeutral = BitVector::mkOnes(size);
+        Node reason = d.d_reason;
+        for (unsigned j = 0; j < ops.size(); ++j)
+        {
+          if (j != i)
+          {
+            othersNeutral = othersNeutral & ops[j].d_known
+                            & (isAnd ? ops[j].d_value : ~ops[j].d_value);
+            reason = mergeReasons(reason, ops[j].d_reason);
+          }
+        }
+        BitVector forced = absorbing & othersNeutral;
+        BitDomain op(size);
+        op.d_known = neutral | forced;
+        op.d_value = isAnd ? neutral : forced;
+        op.normalize();
+        if (!update(term[i], op, isZero(forced) ? d.d_reason : reason))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    case kind::BITVECTOR_XOR:
+    {
+      std::vector<BitDomain> ops;
+      for (const TNode& child : term)
+      {
+        ops.push_back(getDomain(child));
+      }
+      for (unsigned i = 0; i < ops.size(); ++i)
+      {
+        BitDomain op(size);
+        op.d_known = d.d_known;
+        op.d_value = d.d_value;
+        Node reason = d.d_reason;
+        for (unsigned j = 0; j < ops.size(); ++j)
+        {
+          if (j != i)
+          {
+            op.d_known = op.d_known & ops[j].d_known;
+            op.d_value = op.d_value ^ ops[j].d_value;
+            reason = mergeReasons(reason, ops[j].d_reason);
+          }
+        }
+        op.d_value = op.d_value & op.d_known;
+        op.normalize();
+        if (!update(term[i], op, reason))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    case kind::BITVECTOR_CONCAT:
+    {
+      // the first operand has the high bits
+      unsigned high = size;
+      for (const TNode& child : term)
+      {
+        unsigned low = high - utils::getSize(child);
+        BitDomain op(high - low);
+        op.d_known = d.d_known.extract(high - 1, low);
+        op.d_value = d.d_value.extract(high - 1, low);
+        op.normalize();
+        if (!update(child, op, d.d_reason))
+        {
+          return false;
+        }
+        high = low;
+      }
+      return true;
+    }
+    case kind::BITVECTOR_EXTRACT:
+    {
+      unsigned opSize = utils::getSize(term[0]);
+      unsigned low = utils::getExtractLow(term);
+      BitDomain op(opSize);
+      op.d_known = place(d.d_known, opSize, low);
+      op.d_value = place(d.d_value, opSize, low);
+      op.normalize();
+      return update(term[0], op, d.d_reason);
+    }
+    case kind::BITVECTOR_ZERO_EXTEND:
+    case kind::BITVECTOR_SIGN_EXTEND:
+    {
+      unsigned opSize = utils::getSize(term[0]);
+      BitDomain op(opSize);
+      op.d_known = d.d_known.extract(opSize - 1, 0);
+      op.d_value = d.d_value.extract(opSize - 1, 0);
+      op.normalize();
+      return update(term[0], op, d.d_reason);
+    }
+    case kind::BITVECTOR_PLUS:
+    {
+      // the low bits of an operand are the difference of the low bits of
+      // the term and of the other operands
+      std::vector<BitDomain> ops;
+      for (const TNode& child : term)
+      {
+        ops.push_back(getDomain(child));
+      }
+      for (unsigned i = 0; i < ops.size(); ++i)
+      {
+        unsigned known = knownLowBits(d.d_known);
+        BitVector sum(size);
+        Node reason = d.d_reason;
+        for (unsigned j = 0; j < ops.size() && known > 0; ++j)
+        {
+          if (j != i)
+          {
+            known = std::min(known, knownLowBits(ops[j].d_known));
+            sum = sum + ops[j].d_value;
+            reason = mergeReasons(reason, ops[j].d_reason);
+          }
+        }
+        if (known == 0)
+        {
+          continue;
+        }
+        BitDomain op(size);
+        op.d_known = lowMask(size, known);
+        op.d_value = (d.d_value - sum) & op.d_known;
+        op.normalize();
+        if (!update(term[i], op, reason))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+    case kind::BITVECTOR_NEG:
+    {
+      unsigned known = knownLowBits(d.d_known);
+      if (known == 0)
+      {
+        return true;
+      }
+      BitDomain op(size);
+      op.d_known = lowMask(size, known);
+      op.d_value = (-d.d_value) & op.d_known;
+      op.normalize();
+      return update(term[0], op, d.d_reason);
+    }
+    default: return true;
+  }
+}
+
+bool PropagationSolver::update(TNode term, const BitDomain& d, Node reason)
+{
+  BitDomain current = getDomain(term);
+  BitDomain res = current;
+  res.meet(d);
+  if (res.isEmpty())
+  {
+    d_conflict = mergeReasons(current.d_reason, reason);
+    return false;
+  }
+  if (res.sameValues(current))
+  {
+    return true;
+  }
+  res.d_reason = mergeReasons(current.d_reason, reason);
+  d_domains.insert(term, res);
+  ++(d_statistics.d_domainUpdates);
+  d_queue.push_back(term);
+  if (d_budget > 0)
+  {
+    --d_budget;
+  }
+  return true;
+}
+
+bool PropagationSolver::applyFact(TNode fact)
+{
+  bool polarity = fact.getKind() != kind::NOT;
+  TNode atom = polarity ? fact : fact[0];
+  if (!isSupportedAtom(atom))
+  {
+    return true;
+  }
+  TNode a = atom[0];
+  TNode b = atom[1];
+  BitDomain da = getDomain(a);
+  BitDomain db = getDomain(b);
+  unsigned size = da.getSize();
+
+  switch (atom.getKind())
+  {
+    case kind::EQUAL:
+      if (polarity)
+      {
+        if (!update(a, db, mergeReasons(fact, db.d_reason)))
+        {
+          return false;
+        }
+        da = getDomain(a);
+        return update(b, da, mergeReasons(fact, da.d_reason));
+      }
+      if (da.isFixed() && db.isFixed() && da.d_value == db.d_value)
+      {
+        d_conflict = mergeReasons(fact, mergeReasons(da.d_reason, db.d_reason));
+        return false;
+      }
+      return true;
+    case kind::BITVECTOR_ULT:
+    case kind::BITVECTOR_ULE:
+    {
+      // not (a < b) is b <= a, and not (a <= b) is b < a
+      bool strict = (atom.getKind() == kind::BITVECTOR_ULT) == polarity;
+      if (!polarity)
+      {
+        std::swap(a, b);
+        std::swap(da, db);
+      }
+      BitVector lower = da.d_lo;
+      BitVector upper = db.d_hi;
+      if (strict)
+      {
+        if (isZero(db.d_hi))
+        {
+          d_conflict = mergeReasons(fact, db.d_reason);
+          return false;
+        }
+        if (da.d_lo == BitVector::mkOnes(size))
+        {
+          d_conflict = mergeReasons(fact, da.d_reason);
+          return false;
+        }
+        lower = lower + BitVector(size, 1u);
+        upper = upper - BitVector(size, 1u);
+      }
+      BitDomain lowerBound(size);
+      lowerBound.d_lo = lower;
+      lowerBound.normalize();
+      if (!update(b, lowerBound, mergeReasons(fact, da.d_reason)))
+      {
+        return false;
+      }
+      BitDomain upperBound(size);
+      upperBound.d_hi = upper;
+      upperBound.normalize();
+      return update(a, upperBound, mergeReasons(fact, db.d_reason));
+    }
+    default:
+    {
+      // the signed comparisons are only evaluated
+      Node reason;
+      int value = decide(atom, reason);
+      if (value >= 0 && (value == 1) != polarity)
+      {
+        d_conflict = mergeReasons(fact, reason);
+        return false;
+      }
+      return true;
+    }
+  }
+}
+
+int PropagationSolver::decide(TNode atom, Node& reason) const
+{
+  BitDomain da = getDomain(atom[0]);
+  BitDomain db = getDomain(atom[1]);
+  reason = mergeReasons(da.d_reason, db.d_reason);
+  switch (atom.getKind())
+  {
+    case kind::EQUAL:
+      if (da.isFixed() && db.isFixed())
+      {
+        return da.d_value == db.d_value ? 1 : 0;
+      }
+      if (!isZero(da.d_known & db.d_known & (da.d_value ^ db.d_value))
+          || da.d_hi.unsignedLessThan(db.d_lo)
+          || db.d_hi.unsignedLessThan(da.d_lo))
+      {
+        return 0;
+      }
+      return -1;
+    case kind::BITVECTOR_ULT:
+      if (da.d_hi.unsignedLessThan(db.d_lo)) return 1;
+      if (db.d_hi.unsignedLessThanEq(da.d_lo)) return 0;
+      return -1;
+    case kind::BITVECTOR_ULE:
+      if (da.d_hi.unsignedLessThanEq(db.d_lo)) return 1;
+      if (db.d_hi.unsignedLessThan(da.d_lo)) return 0;
+      return -1;
+    case kind::BITVECTOR_SLT:
+      if (!da.isFixed() || !db.isFixed()) return -1;
+      return da.d_value.signedLessThan(db.d_value) ? 1 : 0;
+    case kind::BITVECTOR_SLE:
+      if (!da.isFixed() || !db.isFixed()) return -1;
+      return da.d_value.signedLessThanEq(db.d_value) ? 1 : 0;
+    default: return -1;
+  }
+}
+
+bool PropagationSolver::processQueue()
+{
+  while (!d_queue.empty())
+  {
+    if (d_budget == 0)
+    {
+      // the domains are still sound, if not the tightest
+      d_queue.clear();
+      break;
+    }
+    Node term = d_queue.back();
+    d_queue.pop_back();
+
+    NodeListMap::const_iterator it = d_parents.find(term);
+    if (it != d_parents.end())
+    {
+      for (const Node& parent : it->second)
+      {
+        BitDomain d = forward(parent, false);
+        if (!update(parent, d, d.d_reason))
+        {
+          return false;
+        }
+      }
+    }
+
+    if (!backward(term))
+    {
+      return false;
+    }
+
+    it = d_atoms.find(term);
+    if (it == d_atoms.end())
+    {
+      continue;
+    }
+    for (const Node& atom : it->second)
+    {
+      CDHashMap<Node, Node, NodeHashFunction>::const_iterator asserted =
+          d_asserted.find(atom);
+      if (asserted != d_asserted.end())
+      {
+        if (!applyFact((*asserted).second))
+        {
+          return false;
+        }
+        continue;
+      }
+      // propagate the atoms decided by the domains
+      Node reason;
+      int value = decide(atom, reason);
+      if (value < 0 || reason.isNull())
+      {
+        continue;
+      }
+      Node literal = value == 1 ? atom : atom.notNode();
+      if (d_explanations.find(literal) != d_explanations.end())
+      {
+        continue;
+      }
+      Debug("bv-propagation") << "PropagationSolver::propagate " << literal
+                              << " by " << reason << "\n";
+      d_explanations.insert(literal, reason);
+      ++(d_statistics.d_propagations);
+      d_bv->storePropagation(literal, SUB_PROPAGATION);
+    }
+  }
+  return true;
+}
+
+void PropagationSolver::assertFact(TNode fact)
+{
+  d_assertionQueue.push_back(fact);
+  d_isComplete = false;
+}
+
+bool PropagationSolver::check(Theory::Effort e)
+{
+  Debug("bv-propagation") << "PropagationSolver::check(" << e << ")\n";
+  ++(d_statistics.d_numCallsToCheck);
+  d_bv->spendResource(options::theoryCheckStep());
+
+  d_budget = options::bitvectorPropagationBudget();
+  d_conflict = Node::null();
+
+  // all the facts are known before the atoms are propagated
+  std::vector<TNode> facts;
+  while (!done())
+  {
+    TNode fact = get();
+    TNode atom = fact.getKind() == kind::NOT ? fact[0] : fact;
+    d_asserted.insert(atom, fact);
+    facts.push_back(fact);
+  }
+  bool ok = true;
+  for (unsigned i = 0; i < facts.size() && ok; ++i)
+  {
+    ok = applyFact(facts[i]);
+  }
+  if (ok)
+  {
+    ok = processQueue();
+  }
+  d_queue.clear();
+
+  if (!ok)
+  {
+    Assert(!d_conflict.isNull());
+    ++(d_statistics.d_conflicts);
+    Debug("bv-propagation") << "PropagationSolver::conflict " << d_conflict
+                            << "\n";
+    d_bv->setConflict(d_conflict);
+    return false;
+  }
+
+  if (Theory::fullEffort(e))
+  {
+    std::vector<Node> terms;
+    if (computeComplete(terms))
+    {
+      ++(d_statistics.d_completeChecks);
+      d_isComplete = true;
+    }
+  }
+  return true;
+}
+
+bool PropagationSolver::isFixedCone(TNode term,
+                                    NodeSet& visited,
+                                    std::vector<Node>& terms) const
+{
+  if (!visited.insert(term).second)
+  {
+    return true;
+  }
+  BitDomain d = getDomain(term);
+  if (!d.isFixed())
+  {
+    return false;
+  }
+  terms.push_back(term);
+  Kind k = term.getKind();
+  if (k == kind::CONST_BITVECTOR || term.isVar())
+  {
+    return true;
+  }
+  // the operators whose domain is exact when the operands are fixed
+  if (!isSupportedKind(k) || k == kind::ITE)
+  {
+    return false;
+  }
+  for (const TNode& child : term)
+  {
+    if (!isFixedCone(child, visited, terms))
+    {
+      return false;
+    }
+  }
+  BitDomain f = forward(term, false);
+  return f.isFixed() && f.d_value == d.d_value;
+}
+
+bool PropagationSolver::computeComplete(std::vector<Node>& terms) const
+{
+  NodeSet visited;
+  for (AssertionQueue::const_iterator it = d_assertionQueue.begin(),
+                                      end = d_assertionQueue.end();
+       it != end;
+       ++it)
+  {
+    TNode fact = *it;
+    bool polarity = fact.getKind() != kind::NOT;
+    TNode atom = polarity ? fact : fact[0];
+    if (!isSupportedAtom(atom) || !isFixedCone(atom[0], visited, terms)
+        || !isFixedCone(atom[1], visited, terms))
+    {
+      return false;
+    }
+    Node reason;
+    if (decide(atom, reason) != (polarity ? 1 : 0))
+    {
+      return false;
+    }
+  }
+  for (TNode t : d_bv->d_sharedTermsSet)
+  {
+    if (t.getType().isBitVector() && !isFixedCone(t, visited, terms))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PropagationSolver::explain(TNode literal, std::vector<TNode>& assumptions)
+{
+  CDHashMap<Node, Node, NodeHashFunction>::const_iterator it =
+      d_explanations.find(literal);
+  Assert(it != d_explanations.end());
+  TNode reason = (*it).second;
+  if (reason.getKind() == kind::AND)
+  {
+    assumptions.insert(assumptions.end(), reason.begin(), reason.end());
+  }
+  else
+  {
+    assumptions.push_back(reason);
+  }
+}
+
+bool PropagationSolver::collectModelInfo(TheoryModel* m, bool fullModel)
+{
+  Debug("bitvector-model") << "PropagationSolver::collectModelInfo \n";
+  std::vector<Node> terms;
+  bool complete = computeComplete(terms);
+  Assert(complete);
+  for (const Node& t : terms)
+  {
+    if (t.isVar() || d_bv->isSharedTerm(t))
+    {
+      Node value = utils::mkConst(getDomain(t).d_value);
+      if (!m->assertEquality(t, value, true))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+Node PropagationSolver::getModelValue(TNode var)
+{
+  BitDomain d = getDomain(var);
+  if (!d.isFixed())
+  {
+    return Node::null();
+  }
+  return utils::mkConst(d.d_value);
+}
+
+EqualityStatus PropagationSolver::getEqualityStatus(TNode a, TNode b)
+{
+  if (!isComplete())
+  {
+    return EQUALITY_UNKNOWN;
+  }
+  BitDomain da = getDomain(a);
+  BitDomain db = getDomain(b);
+  if (!da.isFixed() || !db.isFixed())
+  {
+    return EQUALITY_UNKNOWN;
+  }
+  return da.d_value == db.d_value ? EQUALITY_TRUE_IN_MODEL
+                                  : EQUALITY_FALSE_IN_MODEL;
+}
+
+PropagationSolver::Statistics::Statistics()
+    : d_numCallsToCheck("theory::bv::PropagationSolver::NumCallsToCheck", 0),
+      d_domainUpdates("theory::bv::PropagationSolver::DomainUpdates", 0),
+      d_conflicts("theory::bv::PropagationSolver::Conflicts", 0),
+      d_propagations("theory::bv::PropagationSolver::Propagations", 0),
+      d_completeChecks("theory::bv::PropagationSolver::CompleteChecks", 0)
+{
+  smtStatisticsRegistry()->registerStat(&d_numCallsToCheck);
+  smtStatisticsRegistry()->registerStat(&d_domainUpdates);
+  smtStatisticsRegistry()->registerStat(&d_conflicts);
+  smtStatisticsRegistry()->registerStat(&d_propagations);
+  smtStatisticsRegistry()->registerStat(&d_completeChecks);
+}
+
+PropagationSolver::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_numCallsToCheck);
+  smtStatisticsRegistry()->unregisterStat(&d_domainUpdates);
+  smtStatisticsRegistry()->unregisterStat(&d_conflicts);
+  smtStatisticsRegistry()->unregisterStat(&d_propagations);
+  smtStatisticsRegistry()->unregisterStat(&d_completeChecks);
+}
+
+}  // namespace bv
+}  // namespace theory
+}  // namespace CVC4
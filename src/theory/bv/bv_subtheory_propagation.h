@@ -0,0 +1,181 @@
+/*********************                                                        */
+/*! \file bv_subtheory_propagation.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Word-level propagation of known bits and intervals.
+ **
+ ** Word-level propagation of known bits and unsigned intervals over the
+ ** bit-vector operators, ahead of the bit-blaster (--bv-propagation-solver).
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__BV__BV_SUBTHEORY__PROPAGATION_H
+#define __CVC4__THEORY__BV__BV_SUBTHEORY__PROPAGATION_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "context/cdhashmap.h"
+#include "context/cdo.h"
+#include "theory/bv/bv_subtheory.h"
+#include "util/bitvector.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+/**
+ * The abstract value of a bit-vector term: the bits that are known, with
+ * their values, and an unsigned interval.  The domain follows from the
+ * conjunction of facts d_reason (null if it follows from no fact).
+ */
+struct BitDomain {
+  /** The known bits */
+  BitVector d_known;
+  /** The values of the known bits (the other bits are 0) */
+  BitVector d_value;
+  /** The unsigned interval [d_lo, d_hi] */
+  BitVector d_lo;
+  BitVector d_hi;
+  Node d_reason;
+
+  BitDomain() {}
+  /** All the values of the given size */
+  explicit BitDomain(unsigned size);
+  /** The given value */
+  explicit BitDomain(const BitVector& value);
+
+  unsigned getSize() const { return d_known.getSize(); }
+  /** Whether the domain has no value (its reason is inconsistent) */
+  bool isEmpty() const { return d_hi.unsignedLessThan(d_lo); }
+  /** Whether the domain has one value, d_value */
+  bool isFixed() const { return d_lo == d_hi; }
+  /** Whether the domain has the same values as the other */
+  bool sameValues(const BitDomain& other) const {
+    return d_known == other.d_known && d_value == other.d_value
+           && d_lo == other.d_lo && d_hi == other.d_hi;
+  }
+
+  /** Intersects the domain with the other (ignoring the reasons). */
+  void meet(const BitDomain& other);
+  /** Tightens the interval by the bits, and the bits by the interval. */
+  void normalize();
+  void makeEmpty();
+};/* struct BitDomain */
+
+/**
+ * PropagationSolver keeps a domain (BitDomain) per term of the registered
+ * atoms, and propagates the asserted facts through the operators, forward
+ * (from the operands to the term) and backward (from the term to the
+ * operands), up to a budget of domain updates per check.  It reports the
+ * conflicts it finds, and propagates the atoms that the domains decide,
+ * explained by the facts the domains follow from.  If, at full effort, all
+ * the terms of the facts are fixed, the solver is complete and the
+ * bit-blaster isn't called.
+ */
+class PropagationSolver : public SubtheorySolver {
+ public:
+  PropagationSolver(context::Context* c, TheoryBV* bv);
+
+  bool check(Theory::Effort e) override;
+  void explain(TNode literal, std::vector<TNode>& assumptions) override;
+  void preRegister(TNode node) override;
+  bool isComplete() override { return d_isComplete; }
+  bool collectModelInfo(TheoryModel* m, bool fullModel) override;
+  Node getModelValue(TNode var) override;
+  EqualityStatus getEqualityStatus(TNode a, TNode b) override;
+  void assertFact(TNode fact) override;
+
+ private:
+  typedef std::unordered_set<Node, NodeHashFunction> NodeSet;
+  typedef std::unordered_map<Node, std::vector<Node>, NodeHashFunction>
+      NodeListMap;
+
+  /** The domains derived from the facts */
+  context::CDHashMap<Node, BitDomain, NodeHashFunction> d_domains;
+  /** The domains of the registered terms, without any fact */
+  std::unordered_map<Node, BitDomain, NodeHashFunction> d_initialDomains;
+  /** The asserted literal of the asserted registered atoms */
+  context::CDHashMap<Node, Node, NodeHashFunction> d_asserted;
+  /** The explanations of the propagated literals */
+  context::CDHashMap<Node, Node, NodeHashFunction> d_explanations;
+  context::CDO<bool> d_isComplete;
+
+  /** The terms of which a registered term is an operand */
+  NodeListMap d_parents;
+  /** The registered atoms of which a term is a side */
+  NodeListMap d_atoms;
+  NodeSet d_registered;
+
+  /** The terms whose domain changed, to propagate */
+  std::vector<Node> d_queue;
+  /** The domain updates left in this check */
+  unsigned d_budget;
+  /** The facts of the conflict found, if any */
+  Node d_conflict;
+
+  static bool isSupportedAtom(TNode atom);
+  void registerTerm(TNode term);
+  BitDomain getDomain(TNode term) const;
+
+  /** Returns the domain of term computed from those of its operands. */
+  BitDomain forward(TNode term, bool initial) const;
+  /** Updates the domains of the operands of term from its domain. */
+  bool backward(TNode term);
+  /** Applies the asserted literal to the domains of the sides. */
+  bool applyFact(TNode fact);
+  /**
+   * Whether the domains decide the atom: returns 1 if it's true, 0 if it's
+   * false and -1 if unknown, and sets reason to the facts it follows from.
+   */
+  int decide(TNode atom, Node& reason) const;
+
+  /**
+   * Intersects the domain of term with d, that follows from reason, and
+   * queues term if it changed.  Returns false on a conflict.
+   */
+  bool update(TNode term, const BitDomain& d, Node reason);
+  /** Propagates the changed domains, up to the budget. */
+  bool processQueue();
+
+  /**
+   * Whether all the terms in the cone of term are fixed, and consistent
+   * with their operands; collects them in terms.
+   */
+  bool isFixedCone(TNode term, NodeSet& visited,
+                   std::vector<Node>& terms) const;
+  /**
+   * Whether the fixed domains are a model of the asserted facts; collects
+   * the terms to assert in the model.
+   */
+  bool computeComplete(std::vector<Node>& terms) const;
+
+  class Statistics {
+   public:
+    IntStat d_numCallsToCheck;
+    IntStat d_domainUpdates;
+    IntStat d_conflicts;
+    IntStat d_propagations;
+    IntStat d_completeChecks;
+    Statistics();
+    ~Statistics();
+  };/* class Statistics */
+
+  Statistics d_statistics;
+};/* class PropagationSolver */
+
+}  // namespace bv
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* __CVC4__THEORY__BV__BV_SUBTHEORY__PROPAGATION_H */
@@ -0,0 +1,980 @@
+/*********************                                                        */
+/*! \file bv_subtheory_sls.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Stochastic local search for models of the bit-vector facts.
+ **
+ ** Word-level stochastic local search for a model of the asserted
+ ** bit-vector facts, ahead of the bit-blaster (--bv-sls-solver).
+ **/
+
+#include "theory/bv/bv_subtheory_sls.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "options/bv_options.h"
+#include "options/smt_options.h"
+#include "smt/smt_statistics_registry.h"
+#include "theory/bv/theory_bv.h"
+#include "theory/bv/theory_bv_utils.h"
+#include "theory/theory_model.h"
+#include "util/random.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+namespace {
+
+/** The score of a falsified fact is at most this weight */
+const double s_falsifiedWeight = 0.5;
+
+/** The probability of a propagation move, rather than a scored move */
+const double s_propagationProb = 0.5;
+
+BitVector mkBool(bool value) { return BitVector(1, value ? 1u : 0u); }
+
+/** The size of the value of a term: 1 for the Boolean terms */
+unsigned getValueSize(TNode term)
+{
+  TypeNode type = term.getType();
+  if (type.isBoolean())
+  {
+    return 1;
+  }
+  return type.isBitVector() ? type.getBitVectorSize() : 0;
+}
+
+/** The number of bits in which a and b differ */
+unsigned hammingDistance(const BitVector& a, const BitVector& b)
+{
+  BitVector diff = a ^ b;
+  unsigned res = 0;
+  for (unsigned i = 0, size = diff.getSize(); i < size; ++i)
+  {
+    res += diff.isBitSet(i) ? 1 : 0;
+  }
+  return res;
+}
+
+/** The ratio of n to 2^size */
+double fractionOfPow2(const Integer& n, unsigned size)
+{
+  // the high bits of n are enough for a double
+  if (size > 53)
+  {
+    return std::ldexp(n.divByPow2(size - 53).getUnsignedLong(), -53);
+  }
+  return std::ldexp(n.getUnsignedLong(), -int(size));
+}
+
+/** A random value of the given size */
+BitVector randomValue(unsigned size)
+{
+  Random& rnd = Random::getRandom();
+  BitVector res(0);
+  while (res.getSize() < size)
+  {
+    res = res.concat(BitVector(64, Integer(rnd.rand())));
+  }
+  return res.extract(size - 1, 0);
+}
+
+/** A random value in [lo, hi], which isn't empty */
+BitVector randomValue(const BitVector& lo, const BitVector& hi)
+{
+  unsigned size = lo.getSize();
+  Integer range = hi.getValue() - lo.getValue() + 1;
+  Integer offset = randomValue(size).getValue().euclidianDivideRemainder(range);
+  return BitVector(size, lo.getValue() + offset);
+}
+
+/**
+ * A value x of the operand of a comparison for which x < o (x <= o if not
+ * strict), or o < x (o <= x) if the operand is the right one, or a random
+ * value if there is none
+ */
+BitVector inverseUnsignedLessThan(const BitVector& o, bool strict, bool left)
+{
+  unsigned size = o.getSize();
+  BitVector zero(size);
+  BitVector ones = BitVector::mkOnes(size);
+  BitVector one(size, 1u);
+  if (left)
+  {
+    if (strict && o == zero)
+    {
+      return randomValue(size);
+    }
+    return randomValue(zero, strict ? o - one : o);
+  }
+  if (strict && o == ones)
+  {
+    return randomValue(size);
+  }
+  return randomValue(strict ? o + one : o, ones);
+}
+
+/** A value x for which x * o = t, or a random value if there is none */
+BitVector inverseMult(const BitVector& o, const BitVector& t)
+{
+  unsigned size = o.getSize();
+  // o = 2^k * odd, and x * o = t iff t = 2^k * t' and x * odd = t' over
+  // the size - k low bits, whatever the k high bits of x
+  unsigned k = 0;
+  while (k < size && !o.isBitSet(k))
+  {
+    if (t.isBitSet(k))
+    {
+      return randomValue(size);
+    }
+    ++k;
+  }
+  if (k == size)
+  {
+    return randomValue(size);
+  }
+  Integer mod = Integer(1).multiplyByPow2(size - k);
+  Integer inverse = o.getValue().divByPow2(k).modInverse(mod);
+  BitVector res(size - k, t.getValue().divByPow2(k) * inverse);
+  return k == 0 ? res : randomValue(k).concat(res);
+}
+
+/** Whether the value of a term is computed from those of its operands */
+bool isSupportedKind(Kind k)
+{
+  switch (k)
+  {
+    case kind::NOT:
+    case kind::AND:
+    case kind::OR:
+    case kind::XOR:
+    case kind::IMPLIES:
+    case kind::EQUAL:
+    case kind::ITE:
+    case kind::BITVECTOR_ULT:
+    case kind::BITVECTOR_ULE:
+    case kind::BITVECTOR_SLT:
+    case kind::BITVECTOR_SLE:
+    case kind::BITVECTOR_COMP:
+    case kind::BITVECTOR_NOT:
+    case kind::BITVECTOR_AND:
+    case kind::BITVECTOR_OR:
+    case kind::BITVECTOR_XOR:
+    case kind::BITVECTOR_NAND:
+    case kind::BITVECTOR_NOR:
+    case kind::BITVECTOR_XNOR:
+    case kind::BITVECTOR_CONCAT:
+    case kind::BITVECTOR_EXTRACT:
+    case kind::BITVECTOR_ZERO_EXTEND:
+    case kind::BITVECTOR_SIGN_EXTEND:
+    case kind::BITVECTOR_PLUS:
+    case kind::BITVECTOR_SUB:
+    case kind::BITVECTOR_MULT:
+    case kind::BITVECTOR_NEG:
+    case kind::BITVECTOR_UDIV_TOTAL:
+    case kind::BITVECTOR_UREM_TOTAL:
+    case kind::BITVECTOR_SHL:
+    case kind::BITVECTOR_LSHR:
+    case kind::BITVECTOR_ASHR: return true;
+    default: return false;
+  }
+}
+
+}  // namespace
+
+SlsSolver::SlsSolver(context::Context* c, TheoryBV* bv)
+    : SubtheorySolver(c, bv),
+      d_terms(),
+      d_termIndex(),
+      d_operands(),
+      d_parents(),
+      d_supported(),
+      d_hasVariables(),
+      d_values(),
+      d_cones(),
+      d_atomVariables(),
+      d_constraints(),
+      d_scores(),
+      d_constraintOf(),
+      d_numUnsat(0),
+      d_budget(0),
+      d_isComplete(c, false),
+      d_statistics()
+{
+}
+
+unsigned SlsSolver::registerTerm(TNode term)
+{
+  // post-order, so that the operands are registered (and evaluated) first
+  std::vector<std::pair<TNode, bool> > stack;
+  stack.push_back(std::make_pair(term, false));
+  while (!stack.empty())
+  {
+    TNode current = stack.back().first;
+    bool operandsDone = stack.back().second;
+    stack.pop_back();
+    if (d_termIndex.find(current) != d_termIndex.end())
+    {
+      continue;
+    }
+    TypeNode type = current.getType();
+    bool supported = (type.isBitVector() || type.isBoolean())
+                     && (current.isConst()
+                         || (current.isVar() && type.isBitVector())
+                         || isSupportedKind(current.getKind()));
+    if (!operandsDone && supported && current.getNumChildren() > 0)
+    {
+      stack.push_back(std::make_pair(current, true));
+      for (const TNode& child : current)
+      {
+        stack.push_back(std::make_pair(child, false));
+      }
+      continue;
+    }
+
+    unsigned index = d_terms.size();
+    d_terms.push_back(current);
+    d_termIndex[current] = index;
+    d_operands.push_back(std::vector<unsigned>());
+    d_parents.push_back(std::vector<unsigned>());
+    bool hasVariables = current.isVar();
+    if (supported)
+    {
+      for (const TNode& child : current)
+      {
+        unsigned op = d_termIndex[child];
+        d_operands[index].push_back(op);
+        d_parents[op].push_back(index);
+        supported = supported && d_supported[op];
+        hasVariables = hasVariables || d_hasVariables[op];
+      }
+    }
+    d_supported.push_back(supported);
+    d_hasVariables.push_back(hasVariables);
+    d_values.push_back(BitVector(getValueSize(current)));
+    if (supported)
+    {
+      d_values[index] = evaluate(index);
+    }
+    // the cones of the variables below changed
+    d_cones.clear();
+  }
+  return d_termIndex[term];
+}
+
+BitVector SlsSolver::evaluate(unsigned term) const
+{
+  TNode t = d_terms[term];
+  Kind k = t.getKind();
+  if (k == kind::CONST_BITVECTOR)
+  {
+    return t.getConst<BitVector>();
+  }
+  if (k == kind::CONST_BOOLEAN)
+  {
+    return mkBool(t.getConst<bool>());
+  }
+  const std::vector<unsigned>& ops = d_operands[term];
+  if (ops.empty())
+  {
+    // a variable
+    return d_values[term];
+  }
+
+  const BitVector& a = d_values[ops[0]];
+  switch (k)
+  {
+    case kind::NOT:
+    case kind::BITVECTOR_NOT: return ~a;
+    case kind::BITVECTOR_NEG: return -a;
+    case kind::BITVECTOR_EXTRACT:
+      return a.extract(utils::getExtractHigh(t), utils::getExtractLow(t));
+    case kind::BITVECTOR_ZERO_EXTEND:
+      return a.zeroExtend(
+          t.getOperator().getConst<BitVectorZeroExtend>().zeroExtendAmount);
+    case kind::BITVECTOR_SIGN_EXTEND:
+      return a.signExtend(
+          t.getOperator().getConst<BitVectorSignExtend>().signExtendAmount);
+    case kind::ITE:
+      return a.isBitSet(0) ? d_values[ops[1]] : d_values[ops[2]];
+    default: break;
+  }
+
+  // the n-ary operators are folded from the left
+  BitVector res = a;
+  for (unsigned i = 1; i < ops.size(); ++i)
+  {
+    const BitVector& b = d_values[ops[i]];
+    switch (k)
+    {
+      case kind::AND:
+      case kind::BITVECTOR_AND: res = res & b; break;
+      case kind::OR:
+      case kind::BITVECTOR_OR: res = res | b; break;
+      case kind::XOR:
+      case kind::BITVECTOR_XOR: res = res ^ b; break;
+      case kind::BITVECTOR_NAND: res = ~(res & b); break;
+      case kind::BITVECTOR_NOR: res = ~(res | b); break;
+      case kind::BITVECTOR_XNOR: res = ~(res ^ b); break;
+      case kind::IMPLIES: res = ~res | b; break;
+      case kind::EQUAL:
+      case kind::BITVECTOR_COMP: res = mkBool(res == b); break;
+      case kind::BITVECTOR_ULT: res = mkBool(res.unsignedLessThan(b)); break;
+      case kind::BITVECTOR_ULE:
+        res = mkBool(res.unsignedLessThanEq(b));
+        break;
+      case kind::BITVECTOR_SLT: res = mkBool(res.signedLessThan(b)); break;
+      case kind::BITVECTOR_SLE: res = mkBool(res.signedLessThanEq(b)); break;
+      case kind::BITVECTOR_CONCAT: res = res.concat(b); break;
+      case kind::BITVECTOR_PLUS: res = res + b; break;
+      case kind::BITVECTOR_SUB: res = res - b; break;
+      case kind::BITVECTOR_MULT: res = res * b; break;
+      case kind::BITVECTOR_UDIV_TOTAL: res = res.unsignedDivTotal(b); break;
+      case kind::BITVECTOR_UREM_TOTAL: res = res.unsignedRemTotal(b); break;
+      case kind::BITVECTOR_SHL: res = res.leftShift(b); break;
+      case kind::BITVECTOR_LSHR: res = res.logicalRightShift(b); break;
+      case kind::BITVECTOR_ASHR: res = res.arithRightShift(b); break;
+      default: Unreachable("SlsSolver: unsupported operator %s",
+                           kindToString(k).c_str());
+    }
+  }
+  return res;
+}
+
+double SlsSolver::score(const Constraint& c) const
+{
+  if (d_values[c.d_atom].isBitSet(0) == c.d_polarity)
+  {
+    return 1;
+  }
+  TNode atom = d_terms[c.d_atom];
+  const std::vector<unsigned>& ops = d_operands[c.d_atom];
+  switch (atom.getKind())
+  {
+    case kind::EQUAL:
+    {
+      // a falsified disequality has no distance to the values satisfying it
+      if (!c.d_polarity || !atom[0].getType().isBitVector())
+      {
+        return 0;
+      }
+      const BitVector& a = d_values[ops[0]];
+      unsigned size = a.getSize();
+      return s_falsifiedWeight
+             * (1 - double(hammingDistance(a, d_values[ops[1]])) / size);
+    }
+    case kind::BITVECTOR_ULT:
+    case kind::BITVECTOR_ULE:
+    case kind::BITVECTOR_SLT:
+    case kind::BITVECTOR_SLE:
+    {
+      BitVector a = d_values[ops[0]];
+      BitVector b = d_values[ops[1]];
+      unsigned size = a.getSize();
+      Kind k = atom.getKind();
+      if (k == kind::BITVECTOR_SLT || k == kind::BITVECTOR_SLE)
+      {
+        // flipping the sign bits maps the signed order to the unsigned one
+        BitVector sign = BitVector::mkMinSigned(size);
+        a = a ^ sign;
+        b = b ^ sign;
+      }
+      bool strict = k == kind::BITVECTOR_ULT || k == kind::BITVECTOR_SLT;
+      if (!c.d_polarity)
+      {
+        // not (a < b) is b <= a, and not (a <= b) is b < a
+        std::swap(a, b);
+        strict = !strict;
+      }
+      // a < b (a <= b) is falsified, so a >= b (a > b)
+      Integer distance = a.getValue() - b.getValue();
+      if (strict)
+      {
+        distance = distance + 1;
+      }
+      return s_falsifiedWeight * (1 - fractionOfPow2(distance, size));
+    }
+    default: return 0;
+  }
+}
+
+const std::vector<unsigned>& SlsSolver::getCone(unsigned var)
+{
+  IndexListMap::const_iterator it = d_cones.find(var);
+  if (it != d_cones.end())
+  {
+    return it->second;
+  }
+  std::vector<unsigned>& cone = d_cones[var];
+  std::unordered_set<unsigned> visited;
+  std::vector<unsigned> stack(d_parents[var]);
+  while (!stack.empty())
+  {
+    unsigned current = stack.back();
+    stack.pop_back();
+    if (!d_supported[current] || !visited.insert(current).second)
+    {
+      continue;
+    }
+    cone.push_back(current);
+    stack.insert(stack.end(),
+                 d_parents[current].begin(),
+                 d_parents[current].end());
+  }
+  // the terms are registered after their operands
+  std::sort(cone.begin(), cone.end());
+  return cone;
+}
+
+const std::vector<unsigned>& SlsSolver::getAtomVariables(unsigned atom)
+{
+  IndexListMap::const_iterator it = d_atomVariables.find(atom);
+  if (it != d_atomVariables.end())
+  {
+    return it->second;
+  }
+  std::vector<unsigned>& vars = d_atomVariables[atom];
+  std::unordered_set<unsigned> visited;
+  std::vector<unsigned> stack(1, atom);
+  while (!stack.empty())
+  {
+    unsigned current = stack.back();
+    stack.pop_back();
+    if (!visited.insert(current).second)
+    {
+      continue;
+    }
+    if (d_terms[current].isVar())
+    {
+      vars.push_back(current);
+    }
+    stack.insert(stack.end(),
+                 d_operands[current].begin(),
+                 d_operands[current].end());
+  }
+  std::sort(vars.begin(), vars.end());
+  return vars;
+}
+
+bool SlsSolver::collectConstraints()
+{
+  d_constraints.clear();
+  d_scores.clear();
+  d_constraintOf.clear();
+  d_numUnsat = 0;
+  for (AssertionQueue::const_iterator it = d_assertionQueue.begin(),
+                                      end = d_assertionQueue.end();
+       it != end;
+       ++it)
+  {
+    TNode fact = *it;
+    bool polarity = fact.getKind() != kind::NOT;
+    TNode atom = polarity ? fact : fact[0];
+    unsigned index = registerTerm(atom);
+    if (!d_supported[index])
+    {
+      Debug("bv-sls") << "SlsSolver: unsupported fact " << fact << "\n";
+      return false;
+    }
+    if (d_constraintOf.find(index) != d_constraintOf.end())
+    {
+      continue;
+    }
+    d_constraintOf[index] = d_constraints.size();
+    Constraint c = {index, polarity};
+    d_constraints.push_back(c);
+  }
+  // the model has to assign the shared terms
+  for (TNode t : d_bv->d_sharedTermsSet)
+  {
+    if (t.getType().isBitVector() && !d_supported[registerTerm(t)])
+    {
+      Debug("bv-sls") << "SlsSolver: unsupported shared term " << t << "\n";
+      return false;
+    }
+  }
+  for (const Constraint& c : d_constraints)
+  {
+    d_scores.push_back(score(c));
+    if (d_values[c.d_atom].isBitSet(0) != c.d_polarity)
+    {
+      ++d_numUnsat;
+    }
+  }
+  return true;
+}
+
+double SlsSolver::assign(unsigned var, const BitVector& value)
+{
+  double delta = 0;
+  d_values[var] = value;
+  for (unsigned term : getCone(var))
+  {
+    std::unordered_map<unsigned, unsigned>::const_iterator it =
+        d_constraintOf.find(term);
+    if (it == d_constraintOf.end())
+    {
+      d_values[term] = evaluate(term);
+      continue;
+    }
+    const Constraint& c = d_constraints[it->second];
+    bool wasSat = d_values[term].isBitSet(0) == c.d_polarity;
+    d_values[term] = evaluate(term);
+    bool isSat = d_values[term].isBitSet(0) == c.d_polarity;
+    if (wasSat && !isSat)
+    {
+      ++d_numUnsat;
+    }
+    else if (!wasSat && isSat)
+    {
+      --d_numUnsat;
+    }
+    double s = score(c);
+    delta += s - d_scores[it->second];
+    d_scores[it->second] = s;
+  }
+  return delta;
+}
+
+unsigned SlsSolver::getNumMoves(unsigned var) const
+{
+  // a flip of each bit, an increment, a decrement and a negation
+  return d_values[var].getSize() + 3;
+}
+
+BitVector SlsSolver::getMove(unsigned var, unsigned i) const
+{
+  const BitVector& value = d_values[var];
+  unsigned size = value.getSize();
+  if (i < size)
+  {
+    return value ^ BitVector(size).setBit(i);
+  }
+  if (i == size)
+  {
+    return value + BitVector(size, 1u);
+  }
+  if (i == size + 1)
+  {
+    return value - BitVector(size, 1u);
+  }
+  return ~value;
+}
+
+unsigned SlsSolver::pickFalsified() const
+{
+  std::vector<unsigned> falsified;
+  for (const Constraint& c : d_constraints)
+  {
+    if (d_values[c.d_atom].isBitSet(0) != c.d_polarity)
+    {
+      falsified.push_back(c.d_atom);
+    }
+  }
+  Assert(!falsified.empty());
+  return falsified[Random::getRandom().pick(0, falsified.size() - 1)];
+}
+
+bool SlsSolver::bestMove()
+{
+  // the candidates are the variables of a random falsified fact
+  const std::vector<unsigned>& candidates = getAtomVariables(pickFalsified());
+  bool found = false;
+  double bestDelta = 0;
+  unsigned bestVar = 0;
+  BitVector bestValue;
+  for (unsigned i = 0; i < candidates.size() && d_budget > 0; ++i)
+  {
+    unsigned var = candidates[i];
+    BitVector old = d_values[var];
+    for (unsigned j = 0, n = getNumMoves(var); j < n && d_budget > 0; ++j)
+    {
+      --d_budget;
+      ++(d_statistics.d_scoredMoves);
+      BitVector value = getMove(var, j);
+      double delta = assign(var, value);
+      assign(var, old);
+      if (delta > bestDelta)
+      {
+        found = true;
+        bestDelta = delta;
+        bestVar = var;
+        bestValue = value;
+      }
+    }
+  }
+  if (found)
+  {
+    Debug("bv-sls") << "SlsSolver: " << d_terms[bestVar] << " := "
+                    << bestValue << " (+" << bestDelta << ")\n";
+    assign(bestVar, bestValue);
+  }
+  return found;
+}
+
+void SlsSolver::randomMove()
+{
+  Assert(d_numUnsat > 0 && d_budget > 0);
+  --d_budget;
+  ++(d_statistics.d_randomMoves);
+  Random& rnd = Random::getRandom();
+  const std::vector<unsigned>& vars = getAtomVariables(pickFalsified());
+  Assert(!vars.empty());
+  unsigned var = vars[rnd.pick(0, vars.size() - 1)];
+  BitVector value = getMove(var, rnd.pick(0, getNumMoves(var) - 1));
+  Debug("bv-sls") << "SlsSolver: random " << d_terms[var] << " := " << value
+                  << "\n";
+  assign(var, value);
+}
+
+BitVector SlsSolver::inverseValue(unsigned term,
+                                  unsigned i,
+                                  const BitVector& target) const
+{
+  TNode t = d_terms[term];
+  Kind k = t.getKind();
+  const std::vector<unsigned>& ops = d_operands[term];
+  const BitVector& x = d_values[ops[i]];
+  unsigned size = x.getSize();
+  switch (k)
+  {
+    case kind::NOT:
+    case kind::BITVECTOR_NOT: return ~target;
+    case kind::BITVECTOR_NEG: return -target;
+    case kind::EQUAL:
+    case kind::BITVECTOR_COMP:
+    {
+      const BitVector& o = d_values[ops[1 - i]];
+      if (target.isBitSet(0))
+      {
+        return o;
+      }
+      // any other value, e.g. one that differs in a random bit
+      return o ^ BitVector(size).setBit(Random::getRandom().pick(0, size - 1));
+    }
+    case kind::BITVECTOR_ULT:
+    case kind::BITVECTOR_ULE:
+    case kind::BITVECTOR_SLT:
+    case kind::BITVECTOR_SLE:
+    {
+      BitVector o = d_values[ops[1 - i]];
+      bool isSigned = k == kind::BITVECTOR_SLT || k == kind::BITVECTOR_SLE;
+      BitVector sign = BitVector::mkMinSigned(size);
+      if (isSigned)
+      {
+        // flipping the sign bits maps the signed order to the unsigned one
+        o = o ^ sign;
+      }
+      bool strict = k == kind::BITVECTOR_ULT || k == kind::BITVECTOR_SLT;
+      bool left = i == 0;
+      if (!target.isBitSet(0))
+      {
+        // not (a < b) is b <= a, and not (a <= b) is b < a
+        strict = !strict;
+        left = !left;
+      }
+      BitVector res = inverseUnsignedLessThan(o, strict, left);
+      return isSigned ? res ^ sign : res;
+    }
+    case kind::AND:
+    case kind::BITVECTOR_AND:
+    case kind::OR:
+    case kind::BITVECTOR_OR:
+    case kind::XOR:
+    case kind::BITVECTOR_XOR:
+    case kind::BITVECTOR_PLUS:
+    case kind::BITVECTOR_MULT:
+    {
+      // the other operands, folded
+      bool isAnd = k == kind::AND || k == kind::BITVECTOR_AND;
+      bool isOr = k == kind::OR || k == kind::BITVECTOR_OR;
+      bool isXor = k == kind::XOR || k == kind::BITVECTOR_XOR;
+      BitVector o = isAnd ? BitVector::mkOnes(size)
+                          : k == kind::BITVECTOR_MULT ? BitVector(size, 1u)
+                                                      : BitVector(size);
+      for (unsigned j = 0; j < ops.size(); ++j)
+      {
+        if (j == i)
+        {
+          continue;
+        }
+        const BitVector& v = d_values[ops[j]];
+        o = isAnd ? o & v
+                  : isOr ? o | v
+                         : isXor ? o ^ v
+                                 : k == kind::BITVECTOR_PLUS ? o + v : o * v;
+      }
+      if (isAnd)
+      {
+        // the bits of target must be set in o; the bits set in o but not
+        // in target must be clear in x, the other bits are kept
+        return (target & o) == target ? target | (x & ~o) : target;
+      }
+      if (isOr)
+      {
+        // the bits set in o must be set in target; the bits of target that
+        // aren't set in o must be set in x, the other bits are kept
+        return (o & ~target) == BitVector(size)
+                   ? (target & ~o) | (x & target & o)
+                   : target;
+      }
+      if (isXor)
+      {
+        return target ^ o;
+      }
+      return k == kind::BITVECTOR_PLUS ? target - o : inverseMult(o, target);
+    }
+    case kind::BITVECTOR_SUB:
+      return i == 0 ? target + d_values[ops[1]] : d_values[ops[0]] - target;
+    case kind::BITVECTOR_CONCAT:
+    {
+      // the operands after the i-th one are the low bits
+      unsigned low = 0;
+      for (unsigned j = i + 1; j < ops.size(); ++j)
+      {
+        low += d_values[ops[j]].getSize();
+      }
+      return target.extract(low + size - 1, low);
+    }
+    case kind::BITVECTOR_EXTRACT:
+    {
+      // the extracted bits are replaced, the other bits are kept
+      unsigned high = utils::getExtractHigh(t);
+      unsigned low = utils::getExtractLow(t);
+      BitVector res = target;
+      if (high + 1 < size)
+      {
+        res = x.extract(size - 1, high + 1).concat(res);
+      }
+      if (low > 0)
+      {
+        res = res.concat(x.extract(low - 1, 0));
+      }
+      return res;
+    }
+    case kind::BITVECTOR_ZERO_EXTEND:
+    case kind::BITVECTOR_SIGN_EXTEND: return target.extract(size - 1, 0);
+    case kind::ITE:
+    {
+      if (i > 0)
+      {
+        return target;
+      }
+      // select a branch with the target value
+      bool thenValue = d_values[ops[1]] == target;
+      bool elseValue = d_values[ops[2]] == target;
+      if (thenValue != elseValue)
+      {
+        return mkBool(thenValue);
+      }
+      return randomValue(1);
+    }
+    case kind::BITVECTOR_SHL:
+      if (i == 0)
+      {
+        return target.logicalRightShift(d_values[ops[1]]);
+      }
+      break;
+    case kind::BITVECTOR_LSHR:
+      if (i == 0)
+      {
+        return target.leftShift(d_values[ops[1]]);
+      }
+      break;
+    default: break;
+  }
+  return randomValue(size);
+}
+
+void SlsSolver::propagationMove()
+{
+  Assert(d_numUnsat > 0 && d_budget > 0);
+  --d_budget;
+  ++(d_statistics.d_propagationMoves);
+  Random& rnd = Random::getRandom();
+  unsigned term = pickFalsified();
+  BitVector target = mkBool(!d_values[term].isBitSet(0));
+  std::vector<unsigned> candidates;
+  while (!d_terms[term].isVar())
+  {
+    const std::vector<unsigned>& ops = d_operands[term];
+    candidates.clear();
+    for (unsigned i = 0; i < ops.size(); ++i)
+    {
+      if (d_hasVariables[ops[i]])
+      {
+        candidates.push_back(i);
+      }
+    }
+    Assert(!candidates.empty());
+    unsigned i = candidates[rnd.pick(0, candidates.size() - 1)];
+    target = inverseValue(term, i, target);
+    term = ops[i];
+  }
+  Debug("bv-sls") << "SlsSolver: propagated " << d_terms[term] << " := "
+                  << target << "\n";
+  assign(term, target);
+}
+
+bool SlsSolver::search()
+{
+  TimerStat::CodeTimer searchTimer(d_statistics.d_searchTime);
+  for (const Constraint& c : d_constraints)
+  {
+    // no move changes a fact without variables
+    if (d_values[c.d_atom].isBitSet(0) != c.d_polarity
+        && getAtomVariables(c.d_atom).empty())
+    {
+      return false;
+    }
+  }
+  d_budget = options::bitvectorSlsBudget();
+  Random& rnd = Random::getRandom();
+  while (d_numUnsat > 0 && d_budget > 0)
+  {
+    if (rnd.pickWithProb(s_propagationProb))
+    {
+      propagationMove();
+    }
+    else if (!bestMove() && d_budget > 0)
+    {
+      randomMove();
+    }
+  }
+  return d_numUnsat == 0;
+}
+
+void SlsSolver::assertFact(TNode fact)
+{
+  d_assertionQueue.push_back(fact);
+  d_isComplete = false;
+}
+
+bool SlsSolver::check(Theory::Effort e)
+{
+  Debug("bv-sls") << "SlsSolver::check(" << e << ")\n";
+  ++(d_statistics.d_numCallsToCheck);
+
+  // the search is over all the facts, which stay in the assertion queue
+  while (!done())
+  {
+    get();
+  }
+  if (!Theory::fullEffort(e) || d_isComplete)
+  {
+    return true;
+  }
+
+  d_bv->spendResource(options::theoryCheckStep());
+  if (collectConstraints() && search())
+  {
+    Debug("bv-sls") << "SlsSolver: found a model\n";
+    ++(d_statistics.d_models);
+    d_isComplete = true;
+  }
+  return true;
+}
+
+void SlsSolver::explain(TNode literal, std::vector<TNode>& assumptions)
+{
+  Unreachable("SlsSolver propagates no literal");
+}
+
+bool SlsSolver::collectModelInfo(TheoryModel* m, bool fullModel)
+{
+  Debug("bitvector-model") << "SlsSolver::collectModelInfo \n";
+  Assert(isComplete());
+  std::vector<unsigned> terms;
+  for (const Constraint& c : d_constraints)
+  {
+    const std::vector<unsigned>& vars = getAtomVariables(c.d_atom);
+    terms.insert(terms.end(), vars.begin(), vars.end());
+  }
+  for (TNode t : d_bv->d_sharedTermsSet)
+  {
+    if (t.getType().isBitVector())
+    {
+      unsigned term = registerTerm(t);
+      if (d_supported[term])
+      {
+        terms.push_back(term);
+      }
+    }
+  }
+  for (unsigned term : terms)
+  {
+    if (!m->assertEquality(d_terms[term], utils::mkConst(d_values[term]), true))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+Node SlsSolver::getModelValue(TNode var)
+{
+  std::unordered_map<Node, unsigned, NodeHashFunction>::const_iterator it =
+      d_termIndex.find(var);
+  if (it == d_termIndex.end() || !d_supported[it->second])
+  {
+    return Node::null();
+  }
+  return utils::mkConst(d_values[it->second]);
+}
+
+EqualityStatus SlsSolver::getEqualityStatus(TNode a, TNode b)
+{
+  if (!isComplete())
+  {
+    return EQUALITY_UNKNOWN;
+  }
+  Node va = getModelValue(a);
+  Node vb = getModelValue(b);
+  if (va.isNull() || vb.isNull())
+  {
+    return EQUALITY_UNKNOWN;
+  }
+  return va == vb ? EQUALITY_TRUE_IN_MODEL : EQUALITY_FALSE_IN_MODEL;
+}
+
+SlsSolver::Statistics::Statistics()
+    : d_numCallsToCheck("theory::bv::SlsSolver::NumCallsToCheck", 0),
+      d_scoredMoves("theory::bv::SlsSolver::ScoredMoves", 0),
+      d_randomMoves("theory::bv::SlsSolver::RandomMoves", 0),
+      d_propagationMoves("theory::bv::SlsSolver::PropagationMoves", 0),
+      d_models("theory::bv::SlsSolver::Models", 0),
+      d_searchTime("theory::bv::SlsSolver::SearchTime")
+{
+  smtStatisticsRegistry()->registerStat(&d_numCallsToCheck);
+  smtStatisticsRegistry()->registerStat(&d_scoredMoves);
+  smtStatisticsRegistry()->registerStat(&d_randomMoves);
+  smtStatisticsRegistry()->registerStat(&d_propagationMoves);
+  smtStatisticsRegistry()->registerStat(&d_models);
+  smtStatisticsRegistry()->registerStat(&d_searchTime);
+}
+
+SlsSolver::Statistics::~Statistics()
+{
+  smtStatisticsRegistry()->unregisterStat(&d_numCallsToCheck);
+  smtStatisticsRegistry()->unregisterStat(&d_scoredMoves);
+  smtStatisticsRegistry()->unregisterStat(&d_randomMoves);
+  smtStatisticsRegistry()->unregisterStat(&d_propagationMoves);
+  smtStatisticsRegistry()->unregisterStat(&d_models);
+  smtStatisticsRegistry()->unregisterStat(&d_searchTime);
+}
+
+}  // namespace bv
+}  // namespace theory
+}  // namespace CVC4
@@ -0,0 +1,173 @@
+/*********************                                                        */
+/*! \file bv_subtheory_sls.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Stochastic local search for models of the bit-vector facts.
+ **
+ ** Word-level stochastic local search for a model of the asserted
+ ** bit-vector facts, ahead of the bit-blaster (--bv-sls-solver).
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__BV__BV_SUBTHEORY__SLS_H
+#define __CVC4__THEORY__BV__BV_SUBTHEORY__SLS_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "context/cdo.h"
+#include "theory/bv/bv_subtheory.h"
+#include "util/bitvector.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+namespace theory {
+namespace bv {
+
+/**
+ * SlsSolver searches for a model of the asserted facts by local search over
+ * the values of the bit-vector variables, evaluating the term DAG of the
+ * facts with the operations of BitVector.  Each fact is scored by how close
+ * the current values are to satisfying it; a move changes the value of one
+ * variable below a random falsified fact.  The search alternates between
+ * propagation moves, that propagate the value a falsified fact needs down a
+ * path to a variable, inverting the operators on the way, and scored moves
+ * (flipping a bit of a variable, incrementing, decrementing or negating
+ * it), of which it takes the best if it improves the score, and a random
+ * one otherwise.  The search is limited to a budget of moves per check.
+ *
+ * The solver never finds conflicts: if, at full effort, the search
+ * satisfies all the facts, the solver is complete and the bit-blaster isn't
+ * called; otherwise the facts are left to the bit-blaster.  The values are
+ * kept across checks, so that the search starts from the last assignment.
+ */
+class SlsSolver : public SubtheorySolver {
+ public:
+  SlsSolver(context::Context* c, TheoryBV* bv);
+
+  bool check(Theory::Effort e) override;
+  void explain(TNode literal, std::vector<TNode>& assumptions) override;
+  bool isComplete() override { return d_isComplete; }
+  bool collectModelInfo(TheoryModel* m, bool fullModel) override;
+  Node getModelValue(TNode var) override;
+  EqualityStatus getEqualityStatus(TNode a, TNode b) override;
+  void assertFact(TNode fact) override;
+
+ private:
+  typedef std::unordered_map<unsigned, std::vector<unsigned>> IndexListMap;
+
+  /** An asserted fact: the registered atom and the asserted polarity */
+  struct Constraint {
+    unsigned d_atom;
+    bool d_polarity;
+  };/* struct Constraint */
+
+  /** The registered terms, operands first */
+  std::vector<Node> d_terms;
+  std::unordered_map<Node, unsigned, NodeHashFunction> d_termIndex;
+  /** The operands of each registered term */
+  std::vector<std::vector<unsigned>> d_operands;
+  /** The registered terms of which each registered term is an operand */
+  std::vector<std::vector<unsigned>> d_parents;
+  /**
+   * Whether each registered term is a constant, a bit-vector variable or an
+   * operator the solver evaluates, over such terms
+   */
+  std::vector<bool> d_supported;
+  /** Whether each registered term has a variable below it */
+  std::vector<bool> d_hasVariables;
+  /** The current values of the registered terms (of size 1 if Boolean) */
+  std::vector<BitVector> d_values;
+
+  /** The terms above each variable, operands first (computed on demand) */
+  IndexListMap d_cones;
+  /** The variables below each atom (computed on demand) */
+  IndexListMap d_atomVariables;
+
+  /** The facts of the current check, and the score of each */
+  std::vector<Constraint> d_constraints;
+  std::vector<double> d_scores;
+  /** The constraint of each asserted atom */
+  std::unordered_map<unsigned, unsigned> d_constraintOf;
+  /** The number of facts the current values falsify */
+  unsigned d_numUnsat;
+  /** The moves left in this check */
+  unsigned d_budget;
+
+  context::CDO<bool> d_isComplete;
+
+  /** Registers the term and its operands; returns its index. */
+  unsigned registerTerm(TNode term);
+  /** The value of the term computed from those of its operands */
+  BitVector evaluate(unsigned term) const;
+  /** The score of the constraint under the current values, in [0, 1] */
+  double score(const Constraint& c) const;
+  const std::vector<unsigned>& getCone(unsigned var);
+  const std::vector<unsigned>& getAtomVariables(unsigned atom);
+
+  /**
+   * Collects the asserted facts; returns false if the solver doesn't
+   * evaluate some fact or shared term.
+   */
+  bool collectConstraints();
+  /**
+   * Sets the variable to the value and updates its cone and the scores;
+   * returns the change of the total score.
+   */
+  double assign(unsigned var, const BitVector& value);
+  /** The value of the i-th move of the variable */
+  BitVector getMove(unsigned var, unsigned i) const;
+  unsigned getNumMoves(unsigned var) const;
+  /** The atom of a random falsified fact */
+  unsigned pickFalsified() const;
+  /**
+   * Takes the best move of the variables of a random falsified fact if it
+   * improves the score; returns false if none does.
+   */
+  bool bestMove();
+  /** Takes a random move of a variable of a random falsified fact. */
+  void randomMove();
+  /**
+   * Returns a value of the i-th operand of term for which term takes the
+   * target value, given the values of the other operands, or a random
+   * value if there is none.
+   */
+  BitVector inverseValue(unsigned term,
+                         unsigned i,
+                         const BitVector& target) const;
+  /**
+   * Propagates the value of the atom of a random falsified fact down to a
+   * variable, through random operands with variables, and assigns it.
+   */
+  void propagationMove();
+  /** Searches for values satisfying all the facts, up to the budget. */
+  bool search();
+
+  class Statistics {
+   public:
+    IntStat d_numCallsToCheck;
+    IntStat d_scoredMoves;
+    IntStat d_randomMoves;
+    IntStat d_propagationMoves;
+    IntStat d_models;
+    TimerStat d_searchTime;
+    Statistics();
+    ~Statistics();
+  };/* class Statistics */
+
+  Statistics d_statistics;
+};/* class SlsSolver */
+
+}  // namespace bv
+}  // namespace theory
+}  // namespace CVC4
+
+#endif /* __CVC4__THEORY__BV__BV_SUBTHEORY__SLS_H */
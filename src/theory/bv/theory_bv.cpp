@@ -24,6 +24,8 @@
 #include "theory/bv/bv_subtheory_bitblast.h"
 #include "theory/bv/bv_subtheory_core.h"
 #include "theory/bv/bv_subtheory_inequality.h"
+#include "theory/bv/bv_subtheory_propagation.h"
+#include "theory/bv/bv_subtheory_sls.h"
 #include "theory/bv/slicer.h"
 #include "theory/bv/theory_bv_rewrite_rules_normalization.h"
 #include "theory/bv/theory_bv_rewrite_rules_simplification.h"
@@ -73,7 +75,7 @@ TheoryBV::TheoryBV(context::Context* c, context::UserContext* u,
   getExtTheory()->addFunctionKind(kind::BITVECTOR_TO_NAT);
   getExtTheory()->addFunctionKind(kind::INT_TO_BITVECTOR);
   if (options::bitblastMode() == theory::bv::BITBLAST_MODE_EAGER) {
-    d_eagerSolver = new EagerBitblastSolver(this);
+    d_eagerSolver = new EagerBitblastSolver(c, this);
     return;
   }
 
@@ -98,6 +100,20 @@ TheoryBV::TheoryBV(context::Context* c, context::UserContext* u,
     d_subtheoryMap[SUB_ALGEBRAIC] = alg_solver;
   }
 
+  if (options::bitvectorPropagationSolver() && !options::proof())
+  {
+    SubtheorySolver* prop_solver = new PropagationSolver(c, this);
+    d_subtheories.push_back(prop_solver);
+    d_subtheoryMap[SUB_PROPAGATION] = prop_solver;
+  }
+
+  if (options::bitvectorSlsSolver() && !options::proof())
+  {
+    SubtheorySolver* sls_solver = new SlsSolver(c, this);
+    d_subtheories.push_back(sls_solver);
+    d_subtheoryMap[SUB_SLS] = sls_solver;
+  }
+
   BitblastSolver* bb_solver = new BitblastSolver(c, this);
   if (options::bvAbstraction()) {
     bb_solver->setAbstraction(d_abstractionModule);
@@ -332,7 +348,20 @@ void TheoryBV::check(Effort e)
       Assert (fact.getKind() == kind::BITVECTOR_EAGER_ATOM);
       assertions.push_back(fact);
     }
-    Assert (d_eagerSolver->hasAssertions(assertions));
+    if (options::incrementalSolving())
+    {
+      // the query is under the eager atoms of all the asserted levels
+      for (TNode atom : assertions)
+      {
+        d_eagerSolver->assertAssumption(atom);
+      }
+      assertions.clear();
+      d_eagerSolver->getAssumptions(assertions);
+    }
+    else
+    {
+      Assert(d_eagerSolver->hasAssertions(assertions));
+    }
 
     bool ok = d_eagerSolver->checkSat();
     if (!ok) {
@@ -234,6 +234,8 @@ private:
   friend class CoreSolver;
   friend class InequalitySolver;
   friend class AlgebraicSolver;
+  friend class PropagationSolver;
+  friend class SlsSolver;
   friend class EagerBitblastSolver;
 };/* class TheoryBV */
 
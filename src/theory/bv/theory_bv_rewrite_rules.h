@@ -24,6 +24,7 @@
 #include "context/context.h"
 #include "smt/command.h"
 #include "theory/bv/theory_bv_utils.h"
+#include "theory/rewriter.h"
 #include "theory/theory.h"
 #include "util/statistics_registry.h"
 
@@ -368,6 +369,18 @@ class RewriteRule {
     Unreachable();
   }
 
+  /** The name of the rule, for the statistics of --rewrite-profile */
+  static const char* getName() {
+    static const std::string s_name = makeName();
+    return s_name.c_str();
+  }
+
+  static std::string makeName() {
+    std::ostringstream os;
+    os << rule;
+    return os.str();
+  }
+
 public:
 
   RewriteRule() {
@@ -397,6 +410,7 @@ public:
       //++ s_statistics->d_ruleApplications;
       Node result = apply(node);
       if (result != node) {
+        Rewriter::ruleFired(THEORY_BV, getName());
         if(Dump.isOn("bv-rewrites")) {
           std::ostringstream os;
           os << "RewriteRule <"<<rule<<">; expect unsat";
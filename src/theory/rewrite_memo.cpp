@@ -0,0 +1,392 @@
+/*********************                                                        */
+/*! \file rewrite_memo.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A persistent memo of rewrites, shared across runs.
+ **
+ ** A persistent memo of rewrites, shared across runs.
+ **/
+
+#include "theory/rewrite_memo.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "base/configuration.h"
+#include "base/cvc4_assert.h"
+#include "base/output.h"
+#include "expr/node_archive.h"
+#include "expr/node_manager.h"
+#include "options/options.h"
+#include "smt/smt_statistics_registry.h"
+#include "util/regexp.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace theory {
+
+namespace {
+
+const uint64_t SEED = 0xcbf29ce484222325ULL;
+
+inline uint64_t mix(uint64_t h, uint64_t x) {
+  return h ^ (x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+/** FNV-1a; unlike std::hash, the same on every platform and run. */
+uint64_t hashString(const string& s) {
+  uint64_t h = SEED;
+  for(string::const_iterator i = s.begin(); i != s.end(); ++i) {
+    h = (h ^ (unsigned char) *i) * 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/** Options that cannot change the result of a rewrite. */
+const char* const s_ignoredOptions[] = {
+  "rewrite-memo", "statistics", "stats-every-query", "stats-hide-zeros",
+  "verbosity", "print-success", "interactive", "interactive-prompt",
+  "interactive-mode", "regular-output-channel", "diagnostic-output-channel",
+  "tlimit", "tlimit-per", "rlimit", "rlimit-per"
+};
+
+}/* anonymous namespace */
+
+RewriteMemo::RewriteMemo(NodeManager* nm, const string& fingerprint) :
+  d_nm(nm),
+  d_fingerprint(fingerprint),
+  d_hits("theory::RewriteMemo::hits", 0),
+  d_misses("theory::RewriteMemo::misses", 0),
+  d_rejected("theory::RewriteMemo::rejected", 0),
+  d_recorded("theory::RewriteMemo::recorded", 0),
+  d_loaded("theory::RewriteMemo::loaded", 0) {
+  smtStatisticsRegistry()->registerStat(&d_hits);
+  smtStatisticsRegistry()->registerStat(&d_misses);
+  smtStatisticsRegistry()->registerStat(&d_rejected);
+  smtStatisticsRegistry()->registerStat(&d_recorded);
+  smtStatisticsRegistry()->registerStat(&d_loaded);
+}
+
+RewriteMemo::~RewriteMemo() {
+  smtStatisticsRegistry()->unregisterStat(&d_hits);
+  smtStatisticsRegistry()->unregisterStat(&d_misses);
+  smtStatisticsRegistry()->unregisterStat(&d_rejected);
+  smtStatisticsRegistry()->unregisterStat(&d_recorded);
+  smtStatisticsRegistry()->unregisterStat(&d_loaded);
+}
+
+string RewriteMemo::makeFingerprint(const LogicInfo& logic) {
+  const char* const* ignoredEnd = s_ignoredOptions +
+    sizeof(s_ignoredOptions) / sizeof(*s_ignoredOptions);
+  stringstream ss;
+  ss << "CVC4 " << Configuration::getVersionString() << endl
+     << "logic " << logic.getLogicString() << endl;
+  vector<vector<string> > opts = Options::current()->getOptions();
+  for(size_t i = 0; i < opts.size(); ++i) {
+    if(std::find(s_ignoredOptions, ignoredEnd, opts[i][0]) == ignoredEnd) {
+      ss << opts[i][0] << ' ' << opts[i][1] << endl;
+    }
+  }
+  return ss.str();
+}
+
+void RewriteMemo::collectVariables(TNode n, vector<TNode>& vars) {
+  unordered_set<TNode, TNodeHashFunction> visited;
+  vector<TNode> stack;
+  stack.push_back(n);
+  while(!stack.empty()) {
+    TNode cur = stack.back();
+    stack.pop_back();
+    if(!visited.insert(cur).second) {
+      continue;
+    }
+    if(cur.isVar()) {
+      vars.push_back(cur);
+      continue;
+    }
+    for(unsigned i = cur.getNumChildren(); i > 0; --i) {
+      stack.push_back(cur[i - 1]);
+    }
+    if(cur.getMetaKind() == kind::metakind::PARAMETERIZED) {
+      // the operator is a child of cur, so this TNode stays valid
+      stack.push_back(cur.getOperator());
+    }
+  }
+}
+
+uint64_t RewriteMemo::typeHash(TypeNode t) {
+  unordered_map<TypeNode, uint64_t, TypeNodeHashFunction>::iterator i =
+    d_typeHashes.find(t);
+  if(i != d_typeHashes.end()) {
+    return i->second;
+  }
+  // sorts are printed by name, and all other types by structure
+  uint64_t h = hashString(t.toString());
+  d_typeHashes[t] = h;
+  return h;
+}
+
+uint64_t RewriteMemo::structuralHash(TNode n, vector<TNode>& vars) {
+  Assert(vars.empty());
+  collectVariables(n, vars);
+
+  unordered_map<TNode, uint64_t, TNodeHashFunction> hashes;
+  for(size_t i = 0; i < vars.size(); ++i) {
+    TNode v = vars[i];
+    hashes[v] = mix(mix(mix(SEED, v.getKind()), i), typeHash(v.getType()));
+  }
+
+  // post-order, without recursion: terms can be very deep
+  vector<pair<TNode, bool> > stack;
+  stack.push_back(make_pair(n, false));
+  while(!stack.empty()) {
+    TNode cur = stack.back().first;
+    if(hashes.find(cur) != hashes.end()) {
+      stack.pop_back();
+    } else if(cur.isConst()) {
+      hashes[cur] = mix(mix(SEED, cur.getKind()), hashString(cur.toString()));
+      stack.pop_back();
+    } else if(cur.getNumChildren() == 0) {
+      hashes[cur] = mix(mix(SEED, cur.getKind()), typeHash(cur.getType()));
+      stack.pop_back();
+    } else if(!stack.back().second) {
+      stack.back().second = true;
+      for(unsigned i = cur.getNumChildren(); i > 0; --i) {
+        stack.push_back(make_pair(cur[i - 1], false));
+      }
+      if(cur.getMetaKind() == kind::metakind::PARAMETERIZED) {
+        stack.push_back(make_pair(TNode(cur.getOperator()), false));
+      }
+    } else {
+      uint64_t h = mix(mix(SEED, cur.getKind()), cur.getNumChildren());
+      if(cur.getMetaKind() == kind::metakind::PARAMETERIZED) {
+        h = mix(h, hashes[cur.getOperator()]);
+      }
+      for(unsigned i = 0; i < cur.getNumChildren(); ++i) {
+        h = mix(h, hashes[cur[i]]);
+      }
+      hashes[cur] = h;
+      stack.pop_back();
+    }
+  }
+
+  // The normal forms of some theories order terms by id, so only reuse
+  // a rewrite for variables in the same relative order.
+  vector<pair<uint64_t, size_t> > byId;
+  for(size_t i = 0; i < vars.size(); ++i) {
+    byId.push_back(make_pair(vars[i].getId(), i));
+  }
+  sort(byId.begin(), byId.end());
+  uint64_t h = hashes[n];
+  for(size_t i = 0; i < byId.size(); ++i) {
+    h = mix(h, byId[i].second);
+  }
+  return h;
+}
+
+RewriteMemo::EntryMap::iterator RewriteMemo::find(TNode n, uint64_t h,
+                                                  const vector<TNode>& vars) {
+  pair<EntryMap::iterator, EntryMap::iterator> range = d_entries.equal_range(h);
+  for(EntryMap::iterator i = range.first; i != range.second; ++i) {
+    const Entry& e = i->second;
+    if(e.d_vars.size() != vars.size()) {
+      continue;
+    }
+    bool compatible = true;
+    for(size_t j = 0; compatible && j < vars.size(); ++j) {
+      compatible = e.d_kinds[j] == vars[j].getKind() &&
+        typeHash(e.d_vars[j].getType()) == typeHash(vars[j].getType());
+    }
+    if(compatible &&
+       e.d_lhs.substitute(e.d_vars.begin(), e.d_vars.end(),
+                          vars.begin(), vars.end()) == n) {
+      return i;
+    }
+  }
+  return d_entries.end();
+}
+
+Node RewriteMemo::getPlaceholder(unsigned i, TypeNode t) {
+  Node& placeholder = d_placeholders[make_pair(i, t)];
+  if(placeholder.isNull()) {
+    placeholder = d_nm->mkBoundVar(t);
+  }
+  return placeholder;
+}
+
+Node RewriteMemo::lookup(TNode n) {
+  vector<TNode> vars;
+  uint64_t h = structuralHash(n, vars);
+  EntryMap::iterator i = find(n, h, vars);
+  if(i == d_entries.end()) {
+    ++d_misses;
+    return Node::null();
+  }
+  const Entry& e = i->second;
+  return e.d_rhs.substitute(e.d_vars.begin(), e.d_vars.end(),
+                            vars.begin(), vars.end());
+}
+
+void RewriteMemo::validated(bool used) {
+  if(used) {
+    ++d_hits;
+  } else {
+    ++d_rejected;
+  }
+}
+
+void RewriteMemo::record(TNode n, TNode result) {
+  vector<TNode> vars;
+  uint64_t h = structuralHash(n, vars);
+
+  // a rewrite introducing a (fresh) variable can't be reused
+  unordered_set<TNode, TNodeHashFunction> varSet(vars.begin(), vars.end());
+  vector<TNode> resultVars;
+  collectVariables(result, resultVars);
+  for(size_t i = 0; i < resultVars.size(); ++i) {
+    if(varSet.find(resultVars[i]) == varSet.end()) {
+      return;
+    }
+  }
+
+  Entry e;
+  for(size_t i = 0; i < vars.size(); ++i) {
+    e.d_vars.push_back(getPlaceholder(i, vars[i].getType()));
+    e.d_kinds.push_back(vars[i].getKind());
+  }
+  e.d_lhs = n.substitute(vars.begin(), vars.end(),
+                         e.d_vars.begin(), e.d_vars.end());
+  e.d_rhs = result.substitute(vars.begin(), vars.end(),
+                              e.d_vars.begin(), e.d_vars.end());
+
+  EntryMap::iterator i = find(n, h, vars);
+  if(i != d_entries.end()) {
+    // a candidate that was rejected, or one for a different normal form
+    i->second = e;
+  } else if(d_entries.size() < s_maxEntries) {
+    d_entries.insert(make_pair(h, e));
+  } else {
+    return;
+  }
+  ++d_recorded;
+}
+
+size_t RewriteMemo::load(const string& filename) {
+  if(!ifstream(filename.c_str()).good()) {
+    // the first run
+    return 0;
+  }
+  vector<Node> roots;
+  try {
+    expr::NodeArchiveReader::loadFile(d_nm, filename, roots);
+  } catch(Exception& e) {
+    Warning() << "ignoring rewrite memo `" << filename << "': "
+              << e.getMessage() << endl;
+    return 0;
+  }
+  if(roots.empty() || roots[0] != d_nm->mkConst(String(d_fingerprint))) {
+    Warning() << "ignoring rewrite memo `" << filename
+              << "': it was saved by another version, logic or options"
+              << endl;
+    return 0;
+  }
+
+  size_t loaded = 0;
+  for(size_t i = 1; i < roots.size(); ++i) {
+    // see save()
+    TNode r = roots[i];
+    if(r.getKind() != kind::SEXPR || r.getNumChildren() != 3 ||
+       r[0].getKind() != kind::CONST_STRING) {
+      continue;
+    }
+    Entry e;
+    e.d_lhs = r[1];
+    e.d_rhs = r[2];
+    stringstream ss(r[0].getConst<String>().toString());
+    uint64_t h;
+    unsigned k;
+    ss >> h;
+    while(ss >> k && k < kind::LAST_KIND) {
+      e.d_kinds.push_back(Kind(k));
+    }
+
+    vector<TNode> vars, rhsVars;
+    collectVariables(e.d_lhs, vars);
+    collectVariables(e.d_rhs, rhsVars);
+    unordered_set<TNode, TNodeHashFunction> varSet(vars.begin(), vars.end());
+    bool ok = !ss.bad() && ss.eof() && vars.size() == e.d_kinds.size();
+    for(size_t j = 0; ok && j < vars.size(); ++j) {
+      ok = vars[j].getKind() == kind::BOUND_VARIABLE;
+    }
+    for(size_t j = 0; ok && j < rhsVars.size(); ++j) {
+      ok = varSet.find(rhsVars[j]) != varSet.end();
+    }
+    if(!ok) {
+      Debug("rewrite-memo") << "skipping malformed entry " << r << endl;
+      continue;
+    }
+    e.d_vars.assign(vars.begin(), vars.end());
+    d_entries.insert(make_pair(h, e));
+    ++loaded;
+  }
+  d_loaded += loaded;
+  Trace("rewrite-memo") << "loaded " << loaded << " rewrites from "
+                        << filename << endl;
+  return loaded;
+}
+
+void RewriteMemo::save(const string& filename) const {
+  // Each entry is saved as one root (SEXPR meta lhs rhs), so that an
+  // entry that can't be archived is skipped as a whole; meta holds the
+  // hash and the kinds of the variables.  The writer indexes TNodes, so
+  // the roots must stay alive until it's done.
+  expr::NodeArchiveWriter writer;
+  vector<Node> roots;
+  roots.push_back(d_nm->mkConst(String(d_fingerprint)));
+  writer.addRoot(roots.back());
+  for(EntryMap::const_iterator i = d_entries.begin();
+      i != d_entries.end();
+      ++i) {
+    const Entry& e = i->second;
+    stringstream ss;
+    ss << i->first;
+    for(size_t j = 0; j < e.d_kinds.size(); ++j) {
+      ss << ' ' << unsigned(e.d_kinds[j]);
+    }
+    roots.push_back(d_nm->mkNode(kind::SEXPR,
+                                 d_nm->mkConst(String(ss.str())),
+                                 e.d_lhs, e.d_rhs));
+    try {
+      writer.addRoot(roots.back());
+    } catch(Exception& ex) {
+      Debug("rewrite-memo") << "not saving " << e.d_lhs << ": "
+                            << ex.getMessage() << endl;
+    }
+  }
+
+  string tmp = filename + ".tmp";
+  ofstream out(tmp.c_str(), ios::out | ios::binary | ios::trunc);
+  writer.write(out);
+  out.close();
+  if(!out || rename(tmp.c_str(), filename.c_str()) != 0) {
+    Warning() << "cannot save rewrite memo to `" << filename << "'" << endl;
+    remove(tmp.c_str());
+    return;
+  }
+  Trace("rewrite-memo") << "saved " << d_entries.size() << " rewrites to "
+                        << filename << endl;
+}
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
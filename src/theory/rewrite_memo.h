@@ -0,0 +1,168 @@
+/*********************                                                        */
+/*! \file rewrite_memo.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief A persistent memo of rewrites, shared across runs.
+ **
+ ** A persistent memo of rewrites, shared across runs.  The rewrite
+ ** caches of the Rewriter live in node attributes and die with the
+ ** NodeManager; a RewriteMemo remembers top-level rewrites up to the
+ ** renaming of variables, and can be saved to (and loaded from) a node
+ ** archive, so that a later run on the same or a similar problem can
+ ** skip rewrites it has already done.
+ **
+ ** Entries are keyed by a structural hash that does not depend on node
+ ** ids: variables are numbered in order of first occurrence and hashed
+ ** by that number, their kind and their type.  An entry stores its two
+ ** sides with the variables replaced by placeholder bound variables,
+ ** and is instantiated by substituting the variables of the term being
+ ** rewritten back in.  Since the normal forms of some theories depend
+ ** on the (id) order of the subterms, a memoized rewrite is only a
+ ** candidate, which the Rewriter checks before using.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__REWRITE_MEMO_H
+#define __CVC4__THEORY__REWRITE_MEMO_H
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "expr/node.h"
+#include "expr/type_node.h"
+#include "theory/logic_info.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+
+class NodeManager;
+
+namespace theory {
+
+class RewriteMemo {
+ public:
+  /**
+   * Create an empty memo for the nodes of nm.  The fingerprint
+   * identifies everything a rewrite can depend on other than the term
+   * itself (see makeFingerprint()); a saved memo is only loaded back
+   * under the same fingerprint.
+   */
+  RewriteMemo(NodeManager* nm, const std::string& fingerprint);
+  ~RewriteMemo();
+
+  /**
+   * The fingerprint of the current configuration: the CVC4 version,
+   * the logic and the current options.
+   */
+  static std::string makeFingerprint(const LogicInfo& logic);
+
+  /**
+   * Add the entries saved in filename.  A missing file is an empty
+   * memo; an unreadable file, or one saved under another fingerprint,
+   * is ignored with a warning.
+   *
+   * @return the number of entries loaded
+   */
+  size_t load(const std::string& filename);
+
+  /**
+   * Save all entries (loaded or recorded) to filename.  The file is
+   * replaced atomically; on failure, a warning is issued and filename
+   * is left as it was.
+   */
+  void save(const std::string& filename) const;
+
+  /**
+   * Returns the memoized rewrite of n with the variables of n
+   * substituted back in, or the null node if there is none.  The result
+   * is only a candidate; report whether it was used with validated().
+   */
+  Node lookup(TNode n);
+
+  /** Report whether the candidate returned by lookup() was used. */
+  void validated(bool used);
+
+  /**
+   * Remember that n rewrites to result, replacing any entry for n.
+   * Does nothing if result has variables that n doesn't have, or if
+   * the memo is full.
+   */
+  void record(TNode n, TNode result);
+
+  /** The NodeManager whose nodes this memo holds. */
+  NodeManager* getNodeManager() const { return d_nm; }
+
+  /** The number of entries. */
+  size_t size() const { return d_entries.size(); }
+
+ private:
+  /** An entry: lhs rewrites to rhs, both over the placeholders vars. */
+  struct Entry {
+    Node d_lhs;
+    Node d_rhs;
+    /** the placeholders, in order of first occurrence in d_lhs */
+    std::vector<Node> d_vars;
+    /** the kinds of the variables the placeholders stand for */
+    std::vector<Kind> d_kinds;
+  };
+
+  typedef std::unordered_multimap<uint64_t, Entry> EntryMap;
+
+  /**
+   * The structural hash of n.  The variables of n are stored in vars
+   * in order of first occurrence (in a pre-order, left-to-right walk
+   * that includes operators).
+   */
+  uint64_t structuralHash(TNode n, std::vector<TNode>& vars);
+
+  /** A hash of t that is stable across runs. */
+  uint64_t typeHash(TypeNode t);
+
+  /**
+   * Find the entry matching n, whose hash is h and variables vars, or
+   * d_entries.end().
+   */
+  EntryMap::iterator find(TNode n, uint64_t h, const std::vector<TNode>& vars);
+
+  /** The i-th placeholder of type t. */
+  Node getPlaceholder(unsigned i, TypeNode t);
+
+  /** Append the variables of n to vars, in order of first occurrence. */
+  static void collectVariables(TNode n, std::vector<TNode>& vars);
+
+  /** Don't record new entries beyond this many. */
+  static const size_t s_maxEntries = 1 << 20;
+
+  NodeManager* d_nm;
+  std::string d_fingerprint;
+  EntryMap d_entries;
+  std::unordered_map<TypeNode, uint64_t, TypeNodeHashFunction> d_typeHashes;
+  std::map<std::pair<unsigned, TypeNode>, Node> d_placeholders;
+
+  IntStat d_hits;
+  IntStat d_misses;
+  IntStat d_rejected;
+  IntStat d_recorded;
+  IntStat d_loaded;
+
+  // disallow copy
+  RewriteMemo(const RewriteMemo&) CVC4_UNDEFINED;
+  RewriteMemo& operator=(const RewriteMemo&) CVC4_UNDEFINED;
+};/* class RewriteMemo */
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__REWRITE_MEMO_H */
@@ -20,6 +20,8 @@
 #include "theory/theory.h"
 #include "smt/smt_engine_scope.h"
 #include "smt/smt_statistics_registry.h"
+#include "theory/rewrite_memo.h"
+#include "theory/rewriter_statistics.h"
 #include "theory/rewriter_tables.h"
 #include "util/resource_manager.h"
 
@@ -29,6 +31,8 @@ namespace CVC4 {
 namespace theory {
 
 unsigned long Rewriter::d_iterationCount = 0;
+RewriteMemo* Rewriter::s_rewriteMemo = NULL;
+RewriterStatistics* Rewriter::s_statistics = NULL;
 
 static TheoryId theoryOf(TNode node) {
   return Theory::theoryOf(THEORY_OF_TYPE_BASED, node);
@@ -38,6 +42,19 @@ static TheoryId theoryOf(TNode node) {
 static CVC4_THREAD_LOCAL std::unordered_set<Node, NodeHashFunction>* s_rewriteStack = NULL;
 #endif /* CVC4_ASSERTIONS */
 
+/** Whether a top-level rewrite is consulting the RewriteMemo */
+static CVC4_THREAD_LOCAL bool s_inRewriteMemo = false;
+
+/**
+ * Marks the extent of a top-level rewrite that consults the
+ * RewriteMemo; the rewrites nested in it don't.
+ */
+class RewriteMemoScope {
+public:
+  RewriteMemoScope() { s_inRewriteMemo = true; }
+  ~RewriteMemoScope() { s_inRewriteMemo = false; }
+};/* class RewriteMemoScope */
+
 class RewriterInitializer {
   static RewriterInitializer s_rewriterInitializer;
   RewriterInitializer() {
@@ -69,25 +86,165 @@ struct RewriteStackElement {
   unsigned originalTheoryId : 8;
   /** Index of the child this node is done rewriting */
   unsigned nextChild        : 32;
-  /** Builder for this node */
-  NodeBuilder<> builder;
+  /**
+   * Where the rewritten children of this node start in the children
+   * stack of the RewriteWorkspace
+   */
+  size_t childrenBegin;
 
   /**
    * Construct a fresh stack element.
    */
-  RewriteStackElement(TNode node, TheoryId theoryId) :
+  RewriteStackElement(TNode node, TheoryId theoryId, size_t childrenBegin) :
     node(node),
     original(node),
     theoryId(theoryId),
     originalTheoryId(theoryId),
-    nextChild(0) {
+    nextChild(0),
+    childrenBegin(childrenBegin) {
   }
 };
 
+/**
+ * The stacks of a call to Rewriter::rewriteTo(): the nodes being
+ * rewritten, and the rewritten children of each, waiting for their
+ * parent.  They are kept from one rewrite to the next, so that their
+ * storage is reused; as rewriteTo() is reentrant (a change of theory in
+ * the post-rewrite starts a nested rewrite, and theory rewriters may
+ * ask for rewrites too), there is one per active call.
+ */
+struct RewriteWorkspace {
+  std::vector<RewriteStackElement> stack;
+  std::vector<Node> children;
+};/* struct RewriteWorkspace */
+
+/** The workspaces not in use by a rewriteTo() */
+static CVC4_THREAD_LOCAL std::vector<RewriteWorkspace*>* s_freeWorkspaces = NULL;
+
+/**
+ * Takes a RewriteWorkspace from the free list for the extent of a
+ * rewriteTo(), and gives it back, empty, at the end.
+ */
+class RewriteWorkspaceScope {
+  RewriteWorkspace* d_workspace;
+public:
+  RewriteWorkspaceScope() {
+    if(s_freeWorkspaces == NULL || s_freeWorkspaces->empty()) {
+      d_workspace = new RewriteWorkspace();
+    } else {
+      d_workspace = s_freeWorkspaces->back();
+      s_freeWorkspaces->pop_back();
+    }
+  }
+  ~RewriteWorkspaceScope() {
+    // drop the references (but keep the storage)
+    d_workspace->stack.clear();
+    d_workspace->children.clear();
+    if(s_freeWorkspaces == NULL) {
+      s_freeWorkspaces = new std::vector<RewriteWorkspace*>();
+    }
+    s_freeWorkspaces->push_back(d_workspace);
+  }
+  RewriteWorkspace* operator->() const { return d_workspace; }
+};/* class RewriteWorkspaceScope */
+
 Node Rewriter::rewrite(TNode node) {
+  if(s_rewriteMemo != NULL && !s_inRewriteMemo &&
+     node.getNumChildren() > 0 &&
+     s_rewriteMemo->getNodeManager() == NodeManager::currentNM()) {
+    return rewriteWithMemo(theoryOf(node), node);
+  }
   return rewriteTo(theoryOf(node), node);
 }
 
+void Rewriter::setRewriteMemo(RewriteMemo* memo) {
+  s_rewriteMemo = memo;
+}
+
+void Rewriter::setStatistics(RewriterStatistics* statistics) {
+  s_statistics = statistics;
+}
+
+RewriterStatistics* Rewriter::currentStatistics() {
+  if(__builtin_expect(s_statistics != NULL, false) &&
+     s_statistics->getNodeManager() == NodeManager::currentNM()) {
+    return s_statistics;
+  }
+  return NULL;
+}
+
+void Rewriter::recordRuleFired(theory::TheoryId theoryId, const char* rule) {
+  RewriterStatistics* stats = currentStatistics();
+  if(stats != NULL) {
+    stats->ruleFired(theoryId, rule);
+  }
+}
+
+Node Rewriter::rewriteWithMemo(theory::TheoryId theoryId, TNode node) {
+  Node cached = getPostRewriteCache(theoryId, node);
+  if(!cached.isNull()) {
+    return cached;
+  }
+
+  RewriteMemoScope scope;
+  Node candidate = s_rewriteMemo->lookup(node);
+  if(!candidate.isNull()) {
+    // The candidate is equivalent to node, as it is an instance of a
+    // rewrite done earlier; but it may not be in normal form here, e.g.
+    // if the normal form orders subterms by id.
+    bool valid = isRewriteFixpoint(candidate);
+    s_rewriteMemo->validated(valid);
+    if(valid) {
+      Trace("rewriter") << "Rewriter::rewriteWithMemo(" << node << ") => "
+                        << candidate << std::endl;
+      setPostRewriteCache(theoryId, node, candidate);
+      return candidate;
+    }
+  }
+  Node result = rewriteTo(theoryId, node);
+  s_rewriteMemo->record(node, result);
+  return result;
+}
+
+bool Rewriter::isRewriteFixpoint(TNode n) {
+  std::unordered_set<TNode, TNodeHashFunction> visited;
+  vector<TNode> toVisit;
+  vector<TNode> checked;
+  toVisit.push_back(n);
+  while(!toVisit.empty()) {
+    TNode cur = toVisit.back();
+    toVisit.pop_back();
+    if(!visited.insert(cur).second) {
+      continue;
+    }
+    TheoryId theoryId = theoryOf(cur);
+    Node cached = getPostRewriteCache(theoryId, cur);
+    if(!cached.isNull()) {
+      if(cached != cur) {
+        return false;
+      }
+      continue;
+    }
+    RewriteResponse pre = callPreRewrite(theoryId, cur);
+    if(pre.status != REWRITE_DONE || pre.node != cur) {
+      return false;
+    }
+    RewriteResponse post = callPostRewrite(theoryId, cur);
+    if(post.status != REWRITE_DONE || post.node != cur) {
+      return false;
+    }
+    checked.push_back(cur);
+    toVisit.insert(toVisit.end(), cur.begin(), cur.end());
+  }
+  // rewriteTo() would have found the same, so cache it
+  for(size_t i = 0; i < checked.size(); ++i) {
+    TheoryId theoryId = theoryOf(checked[i]);
+    setPreRewriteCache(theoryId, checked[i], checked[i]);
+    setPostRewriteCache(theoryId, checked[i], checked[i]);
+  }
+  return true;
+}
+
 Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 
 #ifdef CVC4_ASSERTIONS
@@ -100,15 +257,23 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 
   Trace("rewriter") << "Rewriter::rewriteTo(" << theoryId << "," << node << ")"<< std::endl;
 
+  // Only profile if asked to (--rewrite-profile)
+  RewriterStatistics* stats = currentStatistics();
+
   // Check if it's been cached already
   Node cached = getPostRewriteCache(theoryId, node);
   if (!cached.isNull()) {
+    if (stats != NULL) {
+      ++stats->d_postCacheHits;
+    }
     return cached;
   }
 
   // Put the node on the stack in order to start the "recursive" rewrite
-  vector<RewriteStackElement> rewriteStack;
-  rewriteStack.push_back(RewriteStackElement(node, theoryId));
+  RewriteWorkspaceScope workspace;
+  vector<RewriteStackElement>& rewriteStack = workspace->stack;
+  vector<Node>& children = workspace->children;
+  rewriteStack.push_back(RewriteStackElement(node, theoryId, 0));
 
   ResourceManager* rm = NULL;
   bool hasSmtEngine = smt::smtEngineInScope();
@@ -129,16 +294,28 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
 
     Trace("rewriter") << "Rewriter::rewriting: " << (TheoryId) rewriteStackTop.theoryId << "," << rewriteStackTop.node << std::endl;
 
+    // Whether the post-rewrite of the node is in the cache
+    bool postCached = false;
+
     // Before rewriting children we need to do a pre-rewrite of the node
     if (rewriteStackTop.nextChild == 0) {
 
       // Check if the pre-rewrite has already been done (it's in the cache)
       Node cached = Rewriter::getPreRewriteCache((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
       if (cached.isNull()) {
+        TheoryId profileTheoryId = (TheoryId) rewriteStackTop.theoryId;
+        Kind profileKind = rewriteStackTop.node.getKind();
+        unsigned calls = 0;
+        uint64_t nanos = 0;
         // Rewrite until fix-point is reached
         for(;;) {
           // Perform the pre-rewrite
+          uint64_t start = stats == NULL ? 0 : RewriterStatistics::now();
           RewriteResponse response = Rewriter::callPreRewrite((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
+          ++calls;
+          if (stats != NULL) {
+            nanos += RewriterStatistics::now() - start;
+          }
           // Put the rewritten node to the top of the stack
           rewriteStackTop.node = response.node;
           TheoryId newTheory = theoryOf(rewriteStackTop.node);
@@ -148,59 +325,104 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
           }
           rewriteStackTop.theoryId = newTheory;
         }
+        if (stats != NULL) {
+          ++stats->d_preCacheMisses;
+          stats->d_preRewrites.add(profileTheoryId, profileKind, calls, nanos);
+        }
         // Cache the rewrite
         Rewriter::setPreRewriteCache((TheoryId) rewriteStackTop.originalTheoryId, rewriteStackTop.original, rewriteStackTop.node);
       }
       // Otherwise we're have already been pre-rewritten (in pre-rewrite cache)
       else {
+        if (stats != NULL) {
+          ++stats->d_preCacheHits;
+        }
         // Continue with the cached version
         rewriteStackTop.node = cached;
         rewriteStackTop.theoryId = theoryOf(cached);
       }
-    }
 
-    rewriteStackTop.original =rewriteStackTop.node;
-    // Now it's time to rewrite the children, check if this has already been done
-    Node cached = Rewriter::getPostRewriteCache((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
-    // If not, go through the children
-    if(cached.isNull()) {
-
-      // The child we need to rewrite
-      unsigned child = rewriteStackTop.nextChild++;
-
-      // To build the rewritten expression we set up the builder
-      if(child == 0) {
-        if (rewriteStackTop.node.getNumChildren() > 0) {
-          // The children will add themselves to the builder once they're done
-          rewriteStackTop.builder << rewriteStackTop.node.getKind();
-          kind::MetaKind metaKind = rewriteStackTop.node.getMetaKind();
-          if (metaKind == kind::metakind::PARAMETERIZED) {
-            rewriteStackTop.builder << rewriteStackTop.node.getOperator();
-          }
+      rewriteStackTop.original = rewriteStackTop.node;
+      // Now it's time to rewrite the children, check if this has already
+      // been done (only once: the children don't change it)
+      cached = Rewriter::getPostRewriteCache((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
+      if (!cached.isNull()) {
+        if (stats != NULL) {
+          ++stats->d_postCacheHits;
         }
+        // We were already in cache, so just remember it
+        rewriteStackTop.node = cached;
+        rewriteStackTop.theoryId = theoryOf(cached);
+        postCached = true;
+      } else if (stats != NULL) {
+        ++stats->d_postCacheMisses;
       }
+    }
+
+    // If not, go through the children
+    if (!postCached) {
 
-      // Process the next child
-      if(child < rewriteStackTop.node.getNumChildren()) {
+      // Process the next child that isn't in the cache already; the
+      // ones that are go straight to the children stack
+      const unsigned numChildren = rewriteStackTop.node.getNumChildren();
+      bool pushed = false;
+      while (rewriteStackTop.nextChild < numChildren) {
         // The child node
-        Node childNode = rewriteStackTop.node[child];
+        TNode childNode = rewriteStackTop.node[rewriteStackTop.nextChild++];
+        TheoryId childTheoryId = theoryOf(childNode);
+        Node childCached = Rewriter::getPostRewriteCache(childTheoryId, childNode);
+        if (!childCached.isNull()) {
+          if (stats != NULL) {
+            ++stats->d_postCacheHits;
+          }
+          children.push_back(childCached);
+          continue;
+        }
         // Push the rewrite request to the stack (NOTE: rewriteStackTop might be a bad reference now)
-        rewriteStack.push_back(RewriteStackElement(childNode, theoryOf(childNode)));
+        rewriteStack.push_back(RewriteStackElement(childNode, childTheoryId, children.size()));
+        pushed = true;
+        break;
+      }
+      if (pushed) {
         // Go on with the rewriting
         continue;
       }
 
-      // Incorporate the children if necessary
-      if (rewriteStackTop.node.getNumChildren() > 0) {
-        Node rewritten = rewriteStackTop.builder;
-        rewriteStackTop.node = rewritten;
-        rewriteStackTop.theoryId = theoryOf(rewriteStackTop.node);
+      // Incorporate the children if necessary, building a new node only
+      // if one of them changed
+      if (numChildren > 0) {
+        const Node* rewrittenChildren = &children[rewriteStackTop.childrenBegin];
+        unsigned i = 0;
+        while (i < numChildren && rewrittenChildren[i] == rewriteStackTop.node[i]) {
+          ++i;
+        }
+        if (i < numChildren) {
+          NodeBuilder<> builder(rewriteStackTop.node.getKind());
+          if (rewriteStackTop.node.getMetaKind() == kind::metakind::PARAMETERIZED) {
+            builder << rewriteStackTop.node.getOperator();
+          }
+          for (i = 0; i < numChildren; ++i) {
+            builder << rewrittenChildren[i];
+          }
+          rewriteStackTop.node = builder;
+          rewriteStackTop.theoryId = theoryOf(rewriteStackTop.node);
+        }
+        children.resize(rewriteStackTop.childrenBegin);
       }
 
       // Done with all pre-rewriting, so let's do the post rewrite
+      TheoryId profileTheoryId = (TheoryId) rewriteStackTop.theoryId;
+      Kind profileKind = rewriteStackTop.node.getKind();
+      unsigned calls = 0;
+      uint64_t nanos = 0;
       for(;;) {
         // Do the post-rewrite
+        uint64_t start = stats == NULL ? 0 : RewriterStatistics::now();
         RewriteResponse response = Rewriter::callPostRewrite((TheoryId) rewriteStackTop.theoryId, rewriteStackTop.node);
+        ++calls;
+        if (stats != NULL) {
+          nanos += RewriterStatistics::now() - start;
+        }
         // We continue with the response we got
         TheoryId newTheoryId = theoryOf(response.node);
         if (newTheoryId != (TheoryId) rewriteStackTop.theoryId || response.status == REWRITE_AGAIN_FULL) {
@@ -230,13 +452,11 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
         Assert(Rewriter::callPostRewrite((TheoryId) rewriteStackTop.theoryId, response.node).node != rewriteStackTop.node);
 	rewriteStackTop.node = response.node;
       }
+      if (stats != NULL) {
+        stats->d_postRewrites.add(profileTheoryId, profileKind, calls, nanos);
+      }
       // We're done with the post rewrite, so we add to the cache
       Rewriter::setPostRewriteCache((TheoryId) rewriteStackTop.originalTheoryId, rewriteStackTop.original, rewriteStackTop.node);
-
-    } else {
-      // We were already in cache, so just remember it
-      rewriteStackTop.node = cached;
-      rewriteStackTop.theoryId = theoryOf(cached);
     }
 
     // If this is the last node, just return
@@ -245,8 +465,8 @@ Node Rewriter::rewriteTo(theory::TheoryId theoryId, Node node) {
       return rewriteStackTop.node;
     }
 
-    // We're done with this node, append it to the parent
-    rewriteStack[rewriteStack.size() - 2].builder << rewriteStackTop.node;
+    // We're done with this node, hand it to the parent
+    children.push_back(rewriteStackTop.node);
     rewriteStack.pop_back();
   }
 
@@ -260,6 +480,13 @@ void Rewriter::clearCaches() {
     s_rewriteStack = NULL;
   }
 #endif
+  if(s_freeWorkspaces != NULL) {
+    for(size_t i = 0; i < s_freeWorkspaces->size(); ++i) {
+      delete (*s_freeWorkspaces)[i];
+    }
+    delete s_freeWorkspaces;
+    s_freeWorkspaces = NULL;
+  }
   Rewriter::clearCachesInternal();
 }
 
@@ -49,6 +49,8 @@ struct RewriteResponse {
 };/* struct RewriteResponse */
 
 class RewriterInitializer;
+class RewriteMemo;
+class RewriterStatistics;
 
 /**
  * The main rewriter class.  All functionality is static.
@@ -101,6 +103,27 @@ class Rewriter {
    */
   static void shutdown();
   static void clearCachesInternal();
+
+  /** The memo consulted by rewrite(), or NULL */
+  static RewriteMemo* s_rewriteMemo;
+
+  /** Rewrites node, consulting (and updating) s_rewriteMemo. */
+  static Node rewriteWithMemo(theory::TheoryId theoryId, TNode node);
+
+  /**
+   * Returns true if rewriting n would give back n: every subterm of n
+   * is left alone by the pre- and post-rewrite of its theory.
+   */
+  static bool isRewriteFixpoint(TNode n);
+
+  /** The statistics of --rewrite-profile, or NULL */
+  static RewriterStatistics* s_statistics;
+
+  /** Returns s_statistics, if they are for the current NodeManager. */
+  static RewriterStatistics* currentStatistics();
+
+  /** The slow path of ruleFired(). */
+  static void recordRuleFired(theory::TheoryId theoryId, const char* rule);
 public:
 
   /**
@@ -113,6 +136,29 @@ public:
    * Garbage collects the rewrite caches.
    */
   static void clearCaches();
+
+  /**
+   * Consult memo in top-level calls to rewrite(), and record their
+   * results in it.  Only rewrites of the nodes of memo's NodeManager
+   * use it.  Pass NULL to stop using a memo.
+   */
+  static void setRewriteMemo(RewriteMemo* memo);
+
+  /**
+   * Record profiling information in statistics (--rewrite-profile), for
+   * the rewrites of the nodes of its NodeManager.  Pass NULL to stop.
+   */
+  static void setStatistics(RewriterStatistics* statistics);
+
+  /**
+   * Note that the rewrite rule named rule, of the rewriter of theoryId,
+   * has fired.  This is cheap unless the rewriters are being profiled.
+   */
+  static void ruleFired(theory::TheoryId theoryId, const char* rule) {
+    if(__builtin_expect(s_statistics != NULL, false)) {
+      recordRuleFired(theoryId, rule);
+    }
+  }
 };/* class Rewriter */
 
 }/* CVC4::theory namespace */
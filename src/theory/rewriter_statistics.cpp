@@ -0,0 +1,134 @@
+/*********************                                                        */
+/*! \file rewriter_statistics.cpp
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Profiling statistics for the Rewriter.
+ **
+ ** Profiling statistics for the Rewriter.
+ **/
+
+#include "theory/rewriter_statistics.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include "smt/smt_statistics_registry.h"
+#include "util/safe_print.h"
+
+using namespace std;
+
+namespace CVC4 {
+namespace theory {
+
+void RewriteProfileStat::add(TheoryId theoryId, Kind k, unsigned calls,
+                             uint64_t nanos) {
+  Row& row = d_table[make_pair(theoryId, k)];
+  ++row.d_nodes;
+  row.d_calls += calls;
+  row.d_maxCalls = max(row.d_maxCalls, calls);
+  row.d_nanos += nanos;
+}
+
+namespace {
+
+typedef pair<uint64_t, pair<TheoryId, Kind> > ByTime;
+
+struct MoreTime {
+  bool operator()(const ByTime& a, const ByTime& b) const {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  }
+};/* struct MoreTime */
+
+}/* anonymous namespace */
+
+void RewriteProfileStat::flushInformation(ostream& out) const {
+  vector<ByTime> order;
+  for(Table::const_iterator i = d_table.begin(); i != d_table.end(); ++i) {
+    order.push_back(make_pair(i->second.d_nanos, i->first));
+  }
+  sort(order.begin(), order.end(), MoreTime());
+  out << "[";
+  for(size_t i = 0; i < order.size(); ++i) {
+    const Row& row = d_table.find(order[i].second)->second;
+    if(i > 0) {
+      out << ", ";
+    }
+    // format the time apart, not to change the flags of out
+    stringstream time;
+    time << fixed << setprecision(6) << row.d_nanos / 1e9 << "s";
+    out << "(" << order[i].second.first << " " << order[i].second.second
+        << " : " << row.d_nodes << " nodes, " << row.d_calls
+        << " calls, max " << row.d_maxCalls << ", " << time.str() << ")";
+  }
+  out << "]";
+}
+
+void RewriteProfileStat::safeFlushInformation(int fd) const {
+  // the names of the theories and kinds can't be printed without
+  // allocating, so print their numbers
+  safe_print(fd, "[");
+  for(Table::const_iterator i = d_table.begin(); i != d_table.end(); ++i) {
+    if(i != d_table.begin()) {
+      safe_print(fd, ", ");
+    }
+    safe_print(fd, "(");
+    safe_print<uint32_t>(fd, i->first.first);
+    safe_print(fd, " ");
+    safe_print<uint32_t>(fd, i->first.second);
+    safe_print(fd, " : ");
+    safe_print<uint64_t>(fd, i->second.d_nodes);
+    safe_print(fd, " nodes, ");
+    safe_print<uint64_t>(fd, i->second.d_calls);
+    safe_print(fd, " calls, max ");
+    safe_print<uint32_t>(fd, i->second.d_maxCalls);
+    safe_print(fd, ", ");
+    safe_print<uint64_t>(fd, i->second.d_nanos);
+    safe_print(fd, "ns)");
+  }
+  safe_print(fd, "]");
+}
+
+RewriterStatistics::RewriterStatistics(NodeManager* nm) :
+  d_preRewrites("theory::Rewriter::preRewrites"),
+  d_postRewrites("theory::Rewriter::postRewrites"),
+  d_preCacheHits("theory::Rewriter::preCacheHits", 0),
+  d_preCacheMisses("theory::Rewriter::preCacheMisses", 0),
+  d_postCacheHits("theory::Rewriter::postCacheHits", 0),
+  d_postCacheMisses("theory::Rewriter::postCacheMisses", 0),
+  d_rulesFired("theory::Rewriter::rulesFired"),
+  d_nm(nm) {
+  smtStatisticsRegistry()->registerStat(&d_preRewrites);
+  smtStatisticsRegistry()->registerStat(&d_postRewrites);
+  smtStatisticsRegistry()->registerStat(&d_preCacheHits);
+  smtStatisticsRegistry()->registerStat(&d_preCacheMisses);
+  smtStatisticsRegistry()->registerStat(&d_postCacheHits);
+  smtStatisticsRegistry()->registerStat(&d_postCacheMisses);
+  smtStatisticsRegistry()->registerStat(&d_rulesFired);
+}
+
+RewriterStatistics::~RewriterStatistics() {
+  smtStatisticsRegistry()->unregisterStat(&d_preRewrites);
+  smtStatisticsRegistry()->unregisterStat(&d_postRewrites);
+  smtStatisticsRegistry()->unregisterStat(&d_preCacheHits);
+  smtStatisticsRegistry()->unregisterStat(&d_preCacheMisses);
+  smtStatisticsRegistry()->unregisterStat(&d_postCacheHits);
+  smtStatisticsRegistry()->unregisterStat(&d_postCacheMisses);
+  smtStatisticsRegistry()->unregisterStat(&d_rulesFired);
+}
+
+void RewriterStatistics::ruleFired(TheoryId theoryId, const char* rule) {
+  d_rulesFired << getStatsPrefix(theoryId) + "::" + rule;
+}
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
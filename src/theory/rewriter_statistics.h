@@ -0,0 +1,118 @@
+/*********************                                                        */
+/*! \file rewriter_statistics.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Profiling statistics for the Rewriter.
+ **
+ ** Profiling statistics for the Rewriter (--rewrite-profile): the calls
+ ** to each theory rewriter by kind, with their time and the number of
+ ** iterations needed to reach a fixpoint, the hit rates of the rewrite
+ ** caches, and the named rewrite rules that fire.  The Rewriter is
+ ** static, but these statistics are owned by an SmtEngine (see
+ ** Rewriter::setStatistics()), so that they go away with its statistics
+ ** registry.
+ **/
+
+#include "cvc4_private.h"
+
+#ifndef __CVC4__THEORY__REWRITER_STATISTICS_H
+#define __CVC4__THEORY__REWRITER_STATISTICS_H
+
+#include <stdint.h>
+#include <time.h>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "expr/kind.h"
+#include "lib/clock_gettime.h"
+#include "util/statistics_registry.h"
+
+namespace CVC4 {
+
+class NodeManager;
+
+namespace theory {
+
+/**
+ * A table of the work done by the pre- or post-rewriters, by theory
+ * and by the kind of the node being rewritten.  For each pair, it
+ * keeps the number of nodes rewritten, the number of calls to the
+ * rewriter (a node may need several to reach a fixpoint), the largest
+ * number of calls needed for a single node, and the time spent in the
+ * calls.  The time is inclusive: it counts the rewrites a theory
+ * rewriter asks the Rewriter for, too.
+ */
+class RewriteProfileStat : public Stat {
+ public:
+  RewriteProfileStat(const std::string& name) : Stat(name) {}
+
+  /**
+   * Record that the rewriter of theoryId reached a fixpoint on a node
+   * of kind k after the given number of calls, taking nanos
+   * nanoseconds in all.
+   */
+  void add(TheoryId theoryId, Kind k, unsigned calls, uint64_t nanos);
+
+  /** Print the rows, the most expensive first. */
+  void flushInformation(std::ostream& out) const override;
+
+  void safeFlushInformation(int fd) const override;
+
+ private:
+  struct Row {
+    uint64_t d_nodes;
+    uint64_t d_calls;
+    unsigned d_maxCalls;
+    uint64_t d_nanos;
+    Row() : d_nodes(0), d_calls(0), d_maxCalls(0), d_nanos(0) {}
+  };
+  typedef std::map<std::pair<TheoryId, Kind>, Row> Table;
+  Table d_table;
+};/* class RewriteProfileStat */
+
+/** The statistics gathered by the Rewriter under --rewrite-profile. */
+class RewriterStatistics {
+ public:
+  /** Create (and register) the statistics, for rewrites of the nodes of nm. */
+  RewriterStatistics(NodeManager* nm);
+  ~RewriterStatistics();
+
+  /** The NodeManager whose rewrites are recorded. */
+  NodeManager* getNodeManager() const { return d_nm; }
+
+  /** A monotonic clock, in nanoseconds. */
+  static uint64_t now() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return uint64_t(t.tv_sec) * 1000000000 + t.tv_nsec;
+  }
+
+  /** Record that the named rewrite rule of theoryId changed a node. */
+  void ruleFired(TheoryId theoryId, const char* rule);
+
+  RewriteProfileStat d_preRewrites;
+  RewriteProfileStat d_postRewrites;
+  IntStat d_preCacheHits;
+  IntStat d_preCacheMisses;
+  IntStat d_postCacheHits;
+  IntStat d_postCacheMisses;
+  /** the named rules that fired, as "theory::rule" */
+  HistogramStat<std::string> d_rulesFired;
+
+ private:
+  NodeManager* d_nm;
+};/* class RewriterStatistics */
+
+}/* CVC4::theory namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__THEORY__REWRITER_STATISTICS_H */
@@ -3456,5 +3456,6 @@ Node TheoryStringsRewriter::returnRewrite(Node node, Node ret, const char* c)
 {
   Trace("strings-rewrite") << "Rewrite " << node << " to " << ret << " by " << c
                            << "." << std::endl;
+  Rewriter::ruleFired(THEORY_STRINGS, c);
   return ret;
 }
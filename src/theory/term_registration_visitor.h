@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "context/cdflat_hashmap.h"
 #include "context/context.h"
 #include "theory/shared_terms_database.h"
 
@@ -42,7 +43,7 @@ class PreRegisterVisitor {
   /** The engine */
   TheoryEngine* d_engine;
 
-  typedef context::CDHashMap<TNode, theory::Theory::Set, TNodeHashFunction> TNodeToTheorySetMap;
+  typedef context::CDFlatHashMap<TNode, theory::Theory::Set, TNodeHashFunction> TNodeToTheorySetMap;
 
   /**
    * Map from terms to the theories that have already had this term pre-registered.
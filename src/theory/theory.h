@@ -28,6 +28,7 @@
 #include "context/cdlist.h"
 #include "context/cdhashset.h"
 #include "context/cdo.h"
+#include "context/cdvalue.h"
 #include "context/context.h"
 #include "expr/node.h"
 #include "lib/ffs.h"
@@ -113,13 +114,13 @@ private:
   context::CDList<Assertion> d_facts;
 
   /** Index into the head of the facts list */
-  context::CDO<unsigned> d_factsHead;
+  context::CDValue<unsigned> d_factsHead;
 
   /** Add shared term to the theory. */
   void addSharedTermInternal(TNode node);
 
   /** Indices for splitting on the shared terms. */
-  context::CDO<unsigned> d_sharedTermsIndex;
+  context::CDValue<unsigned> d_sharedTermsIndex;
 
   /** The care graph the theory will use during combination. */
   CareGraph* d_careGraph;
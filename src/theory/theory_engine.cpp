@@ -27,6 +27,7 @@
 #include "options/options.h"
 #include "options/proof_options.h"
 #include "options/quantifiers_options.h"
+#include "options/theory_options.h"
 #include "proof/cnf_proof.h"
 #include "proof/lemma_proof.h"
 #include "proof/proof_manager.h"
@@ -311,6 +312,8 @@ TheoryEngine::TheoryEngine(context::Context* context,
   d_channels(channels),
   d_inPreregister(false),
   d_factsAsserted(context, false),
+  d_theoriesWithFacts(context),
+  d_skippedChecks("theory::TheoryEngine::skippedChecks", 0),
   d_preRegistrationVisitor(this, context),
   d_sharedTermsVisitor(d_sharedTerms),
   d_unconstrainedSimp(new UnconstrainedSimplifier(context, logicInfo)),
@@ -336,6 +339,7 @@ TheoryEngine::TheoryEngine(context::Context* context,
   d_iteUtilities = new ITEUtilities();
 
   smtStatisticsRegistry()->registerStat(&d_arithSubstitutionsAdded);
+  smtStatisticsRegistry()->registerStat(&d_skippedChecks);
 }
 
 TheoryEngine::~TheoryEngine() {
@@ -366,6 +370,7 @@ TheoryEngine::~TheoryEngine() {
   delete d_iteUtilities;
 
   smtStatisticsRegistry()->unregisterStat(&d_arithSubstitutionsAdded);
+  smtStatisticsRegistry()->unregisterStat(&d_skippedChecks);
 }
 
 void TheoryEngine::interrupt() { d_interrupted = true; }
@@ -505,6 +510,25 @@ void TheoryEngine::dumpAssertions(const char* tag) {
   }
 }
 
+/**
+ * Whether the theory has new facts, or must be checked anyway at this
+ * effort (full effort, quantifiers, or no --watch-theory-checks).
+ */
+bool TheoryEngine::wakeTheory(TheoryId theory, Theory::Effort effort) {
+  Theory::Set withFacts = d_theoriesWithFacts.get();
+  if (Theory::setContains(theory, withFacts)) {
+    d_theoriesWithFacts = Theory::setRemove(theory, withFacts);
+    return true;
+  }
+  // Quantifiers instantiate from the facts of all the theories
+  if (options::watchTheoryChecks() && !Theory::fullEffort(effort) &&
+      theory != THEORY_QUANTIFIERS) {
+    ++d_skippedChecks;
+    return false;
+  }
+  return true;
+}
+
 /**
  * Check all (currently-active) theories for conflicts.
  * @param effort the effort level to use
@@ -519,7 +543,7 @@ void TheoryEngine::check(Theory::Effort effort) {
 #undef CVC4_FOR_EACH_THEORY_STATEMENT
 #endif
 #define CVC4_FOR_EACH_THEORY_STATEMENT(THEORY) \
-    if (theory::TheoryTraits<THEORY>::hasCheck && d_logicInfo.isTheoryEnabled(THEORY)) { \
+    if (theory::TheoryTraits<THEORY>::hasCheck && d_logicInfo.isTheoryEnabled(THEORY) && wakeTheory(THEORY, effort)) { \
        theoryOf(THEORY)->check(effort); \
        if (d_inConflict) { \
          Debug("conflict") << THEORY << " in conflict. " << std::endl; \
@@ -1256,6 +1280,7 @@ void TheoryEngine::assertToTheory(TNode assertion, TNode originalAssertion, theo
       toTheory->assertFact(assertion, true);
       // Mark that we have more information
       d_factsAsserted = true;
+      d_theoriesWithFacts = Theory::setInsert(toTheoryId, d_theoriesWithFacts);
     } else {
       Assert(toTheoryId == THEORY_SAT_SOLVER);
       // Check for propositional conflict
@@ -1299,6 +1324,7 @@ void TheoryEngine::assertToTheory(TNode assertion, TNode originalAssertion, theo
       theoryOf(toTheoryId)->assertFact(assertion, preregistered);
       // Mark that we have more information
       d_factsAsserted = true;
+      d_theoriesWithFacts = Theory::setInsert(toTheoryId, d_theoriesWithFacts);
     }
     return;
   }
@@ -1345,6 +1371,7 @@ void TheoryEngine::assertToTheory(TNode assertion, TNode originalAssertion, theo
     // Assert away
     theoryOf(toTheoryId)->assertFact(assertion, preregistered);
     d_factsAsserted = true;
+    d_theoriesWithFacts = Theory::setInsert(toTheoryId, d_theoriesWithFacts);
   }
 
   return;
@@ -28,6 +28,7 @@
 
 #include "base/cvc4_assert.h"
 #include "context/cdhashset.h"
+#include "context/cdvalue.h"
 #include "expr/node.h"
 #include "options/options.h"
 #include "options/smt_options.h"
@@ -351,7 +352,7 @@ class TheoryEngine {
   /**
    * Are we in conflict.
    */
-  context::CDO<bool> d_inConflict;
+  context::CDValue<bool> d_inConflict;
 
   /**
    * Called by the theories to notify of a conflict.
@@ -399,7 +400,7 @@ class TheoryEngine {
   /**
    * The index of the next literal to be propagated by a theory.
    */
-  context::CDO<unsigned> d_propagatedLiteralsIndex;
+  context::CDValue<unsigned> d_propagatedLiteralsIndex;
 
   /**
    * Called by the output channel to propagate literals and facts
@@ -561,7 +562,22 @@ private:
    * Did the theories get any new facts since the last time we called
    * check()
    */
-  context::CDO<bool> d_factsAsserted;
+  context::CDValue<bool> d_factsAsserted;
+
+  /**
+   * The theories that were asserted facts since their last check(), for
+   * --watch-theory-checks.
+   */
+  context::CDValue<theory::Theory::Set> d_theoriesWithFacts;
+
+  /**
+   * Whether theory must be checked at the given effort; if so, forgets
+   * its new facts.
+   */
+  bool wakeTheory(theory::TheoryId theory, theory::Theory::Effort effort);
+
+  /** The number of checks skipped by --watch-theory-checks */
+  IntStat d_skippedChecks;
 
   /**
    * Map from equality atoms to theories that would like to be notified about them.
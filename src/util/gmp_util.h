@@ -27,6 +27,8 @@
  */
 #include <cstddef>
 
+#include <stdint.h>
+#include <climits>
 #include <gmpxx.h>
 
 namespace CVC4 {
@@ -42,6 +44,38 @@ inline size_t gmpz_hash(const mpz_t toHash) {
   return hash;
 }/* gmpz_hash() */
 
+/** Sets z to the value of x. */
+inline void gmpz_set_int64(mpz_t z, int64_t x) {
+  if(x >= LONG_MIN && x <= LONG_MAX) {
+    mpz_set_si(z, static_cast<long>(x));
+  } else {
+    uint64_t magnitude = x < 0 ? -static_cast<uint64_t>(x) : x;
+    mpz_import(z, 1, 1, sizeof(magnitude), 0, 0, &magnitude);
+    if(x < 0) {
+      mpz_neg(z, z);
+    }
+  }
+}/* gmpz_set_int64() */
+
+/**
+ * Sets x to the value of z and returns true if z fits in the symmetric
+ * range [-INT64_MAX, INT64_MAX]; otherwise returns false.
+ */
+inline bool gmpz_get_int64(const mpz_t z, int64_t& x) {
+  if(mpz_sizeinbase(z, 2) > 63) {
+    return false;
+  }
+  if(sizeof(long) >= sizeof(int64_t)) {
+    x = mpz_get_si(z);
+  } else {
+    uint64_t magnitude = 0;
+    mpz_export(&magnitude, NULL, 1, sizeof(magnitude), 0, 0, z);
+    x = mpz_sgn(z) < 0 ? -static_cast<int64_t>(magnitude)
+                       : static_cast<int64_t>(magnitude);
+  }
+  return true;
+}/* gmpz_get_int64() */
+
 }/* CVC4 namespace */
 
 #endif /* __CVC4__GMP_UTIL_H */
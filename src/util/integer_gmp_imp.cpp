@@ -35,56 +35,60 @@ using namespace std;
 namespace CVC4 {
 
 Integer::Integer(const char* s, unsigned base)
-  : d_value(s, base)
+  : Integer(mpz_class(s, base))
 {}
 
 Integer::Integer(const std::string& s, unsigned base)
-  : d_value(s, base)
+  : Integer(mpz_class(s, base))
 {}
 
 
 bool Integer::fitsSignedInt() const {
-  return d_value.fits_sint_p();
+  return isSmall() && d_small <= std::numeric_limits<int>::max() &&
+    d_small >= std::numeric_limits<int>::min();
 }
 
 bool Integer::fitsUnsignedInt() const {
-  return d_value.fits_uint_p();
+  return isSmall() && d_small >= 0 &&
+    uint64_t(d_small) <= std::numeric_limits<unsigned int>::max();
 }
 
 signed int Integer::getSignedInt() const {
   // ensure there isn't overflow
-  CheckArgument(d_value <= std::numeric_limits<int>::max(), this,
-                "Overflow detected in Integer::getSignedInt().");
-  CheckArgument(d_value >= std::numeric_limits<int>::min(), this,
-                "Overflow detected in Integer::getSignedInt().");
   CheckArgument(fitsSignedInt(), this,
                 "Overflow detected in Integer::getSignedInt().");
-  return (signed int) d_value.get_si();
+  return (signed int) d_small;
 }
 
 unsigned int Integer::getUnsignedInt() const {
   // ensure there isn't overflow
-  CheckArgument(d_value <= std::numeric_limits<unsigned int>::max(), this,
-                "Overflow detected in Integer::getUnsignedInt()");
-  CheckArgument(d_value >= std::numeric_limits<unsigned int>::min(), this,
+  CheckArgument(fitsUnsignedInt(), this,
                 "Overflow detected in Integer::getUnsignedInt()");
   CheckArgument(fitsSignedInt(), this,
                 "Overflow detected in Integer::getUnsignedInt()");
-  return (unsigned int) d_value.get_ui();
+  return (unsigned int) d_small;
 }
 
 bool Integer::fitsSignedLong() const {
-  return d_value.fits_slong_p();
+  if(isSmall()) {
+    return d_small <= std::numeric_limits<long>::max() &&
+      d_small >= std::numeric_limits<long>::min();
+  }
+  return d_big->fits_slong_p();
 }
 
 bool Integer::fitsUnsignedLong() const {
-  return d_value.fits_ulong_p();
+  if(isSmall()) {
+    return d_small >= 0 &&
+      uint64_t(d_small) <= std::numeric_limits<unsigned long>::max();
+  }
+  return d_big->fits_ulong_p();
 }
 
 Integer Integer::oneExtend(uint32_t size, uint32_t amount) const {
   // check that the size is accurate
   DebugCheckArgument((*this) < Integer(1).multiplyByPow2(size), size);
-  mpz_class res = d_value;
+  mpz_class res = get_mpz();
 
   for (unsigned i = size; i < size + amount; ++i) {
     mpz_setbit(res.get_mpz_t(), i);
@@ -96,23 +100,23 @@ Integer Integer::oneExtend(uint32_t size, uint32_t amount) const {
 Integer Integer::exactQuotient(const Integer& y) const {
   DebugCheckArgument(y.divides(*this), y);
   mpz_class q;
-  mpz_divexact(q.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+  mpz_divexact(q.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
   return Integer( q );
 }
 
 Integer Integer::modAdd(const Integer& y, const Integer& m) const
 {
   mpz_class res;
-  mpz_add(res.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.d_value.get_mpz_t());
+  mpz_add(res.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
+  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.get_mpz().get_mpz_t());
   return Integer(res);
 }
 
 Integer Integer::modMultiply(const Integer& y, const Integer& m) const
 {
   mpz_class res;
-  mpz_mul(res.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.d_value.get_mpz_t());
+  mpz_mul(res.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
+  mpz_mod(res.get_mpz_t(), res.get_mpz_t(), m.get_mpz().get_mpz_t());
   return Integer(res);
 }
 
@@ -120,7 +124,7 @@ Integer Integer::modInverse(const Integer& m) const
 {
   PrettyCheckArgument(m > 0, m, "m must be greater than zero");
   mpz_class res;
-  if (mpz_invert(res.get_mpz_t(), d_value.get_mpz_t(), m.d_value.get_mpz_t())
+  if (mpz_invert(res.get_mpz_t(), get_mpz().get_mpz_t(), m.get_mpz().get_mpz_t())
       == 0)
   {
     return Integer(-1);
@@ -20,12 +20,16 @@
 #ifndef __CVC4__INTEGER_H
 #define __CVC4__INTEGER_H
 
+#include <stdint.h>
+
 #include <string>
 #include <iosfwd>
 #include <limits>
+#include <utility>
 
 #include "base/exception.h"
 #include "util/gmp_util.h"
+#include "util/small_arith.h"
 
 namespace CVC4 {
 
@@ -34,26 +38,65 @@ class Rational;
 class CVC4_PUBLIC Integer {
 private:
   /**
-   * Stores the value of the rational is stored in a C++ GMP integer class.
-   * Using this instead of mpz_t allows for easier destruction.
+   * The value, if it is in the small range [-INT64_MAX, INT64_MAX]
+   * (see util/small_arith.h).  Only meaningful when d_big is NULL.
    */
-  mpz_class d_value;
+  int64_t d_small;
+
+  /**
+   * The value, as a C++ GMP integer class, if it is outside the small
+   * range; NULL otherwise.  Every operation keeps this invariant, so a
+   * value has exactly one representation and no GMP limbs are allocated
+   * for the coefficients that fit in a machine word.
+   */
+  mpz_class* d_big;
+
+  bool isSmall() const { return d_big == NULL; }
 
   /**
-   * Gets a reference to the gmp data that backs up the integer.
+   * Gets a copy of the value as GMP data.
    * Only accessible to friend classes.
    */
-  const mpz_class& get_mpz() const { return d_value; }
+  mpz_class get_mpz() const {
+    if(isSmall()) {
+      mpz_class z;
+      gmpz_set_int64(z.get_mpz_t(), d_small);
+      return z;
+    }
+    return *d_big;
+  }
 
   /**
    * Constructs an Integer by copying a GMP C++ primitive.
    */
-  Integer(const mpz_class& val) : d_value(val) {}
+  Integer(const mpz_class& val) : d_small(0), d_big(NULL) {
+    if(!gmpz_get_int64(val.get_mpz_t(), d_small)) {
+      d_big = new mpz_class(val);
+    }
+  }
+
+  /** Constructs an Integer from a value known to be in the small range. */
+  static Integer fromSmall(int64_t z) {
+    Integer i;
+    i.d_small = z;
+    return i;
+  }
+
+  /** Compares with y, when this or y is not small. */
+  int cmpBig(const Integer& y) const {
+    if(isSmall()) {
+      return -y.cmpBig(*this);
+    } else if(y.isSmall()) {
+      // a big value lies outside the small range
+      return mpz_sgn(d_big->get_mpz_t());
+    }
+    return mpz_cmp(d_big->get_mpz_t(), y.d_big->get_mpz_t());
+  }
 
 public:
 
   /** Constructs a rational with the value 0. */
-  Integer() : d_value(0){}
+  Integer() : d_small(0), d_big(NULL) {}
 
   /**
    * Constructs a Integer from a C string.
@@ -64,110 +107,190 @@ public:
   explicit Integer(const char* s, unsigned base = 10);
   explicit Integer(const std::string& s, unsigned base = 10);
 
-  Integer(const Integer& q) : d_value(q.d_value) {}
+  Integer(const Integer& q) :
+    d_small(q.d_small),
+    d_big(q.isSmall() ? NULL : new mpz_class(*q.d_big)) {
+  }
 
-  Integer(  signed int z) : d_value(z) {}
-  Integer(unsigned int z) : d_value(z) {}
-  Integer(  signed long int z) : d_value(z) {}
-  Integer(unsigned long int z) : d_value(z) {}
+  Integer(Integer&& q) : d_small(q.d_small), d_big(q.d_big) {
+    q.d_small = 0;
+    q.d_big = NULL;
+  }
+
+  Integer(  signed int z) : d_small(z), d_big(NULL) {}
+  Integer(unsigned int z) : d_small(z), d_big(NULL) {}
+  Integer(  signed long int z) : d_small(z), d_big(NULL) {
+    if(!small_arith::fits(z)) {
+      d_small = 0;
+      d_big = new mpz_class(z);
+    }
+  }
+  Integer(unsigned long int z) : d_small(z), d_big(NULL) {
+    if(z > uint64_t(small_arith::kMax)) {
+      d_small = 0;
+      d_big = new mpz_class(z);
+    }
+  }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Integer( int64_t z) : d_value(static_cast<long>(z)) {}
-  Integer(uint64_t z) : d_value(static_cast<unsigned long>(z)) {}
+  Integer( int64_t z) : d_small(0), d_big(NULL) {
+    if(small_arith::fits(z)) {
+      d_small = z;
+    } else {
+      d_big = new mpz_class;
+      gmpz_set_int64(d_big->get_mpz_t(), z);
+    }
+  }
+  Integer(uint64_t z) : d_small(0), d_big(NULL) {
+    if(z <= uint64_t(small_arith::kMax)) {
+      d_small = z;
+    } else {
+      d_big = new mpz_class;
+      mpz_import(d_big->get_mpz_t(), 1, 1, sizeof(z), 0, 0, &z);
+    }
+  }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
-  ~Integer() {}
+  ~Integer() { delete d_big; }
 
   /**
-   * Returns a copy of d_value to enable public access of GMP data.
+   * Returns a copy of the value to enable public access of GMP data.
    */
   mpz_class getValue() const
   {
-    return d_value;
+    return get_mpz();
   }
 
   Integer& operator=(const Integer& x){
     if(this == &x) return *this;
-    d_value = x.d_value;
+    if(x.isSmall()) {
+      delete d_big;
+      d_big = NULL;
+      d_small = x.d_small;
+    } else if(isSmall()) {
+      d_big = new mpz_class(*x.d_big);
+    } else {
+      *d_big = *x.d_big;
+    }
+    return *this;
+  }
+
+  Integer& operator=(Integer&& x){
+    if(this == &x) return *this;
+    std::swap(d_small, x.d_small);
+    std::swap(d_big, x.d_big);
     return *this;
   }
 
   bool operator==(const Integer& y) const {
-    return d_value == y.d_value;
+    if(isSmall() || y.isSmall()) {
+      return isSmall() && y.isSmall() && d_small == y.d_small;
+    }
+    return *d_big == *y.d_big;
   }
 
   Integer operator-() const {
-    return Integer(-(d_value));
+    if(isSmall()) {
+      return fromSmall(-d_small);
+    }
+    return Integer(-(*d_big));
   }
 
 
   bool operator!=(const Integer& y) const {
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   bool operator< (const Integer& y) const {
-    return d_value < y.d_value;
+    if(isSmall() && y.isSmall()) {
+      return d_small < y.d_small;
+    }
+    return cmpBig(y) < 0;
   }
 
   bool operator<=(const Integer& y) const {
-    return d_value <= y.d_value;
+    if(isSmall() && y.isSmall()) {
+      return d_small <= y.d_small;
+    }
+    return cmpBig(y) <= 0;
   }
 
   bool operator> (const Integer& y) const {
-    return d_value > y.d_value;
+    return y < *this;
   }
 
   bool operator>=(const Integer& y) const {
-    return d_value >= y.d_value;
+    return y <= *this;
   }
 
 
   Integer operator+(const Integer& y) const {
-    return Integer( d_value + y.d_value );
+    int64_t r;
+    if(isSmall() && y.isSmall() && small_arith::add(d_small, y.d_small, r)) {
+      return fromSmall(r);
+    }
+    return Integer( get_mpz() + y.get_mpz() );
   }
   Integer& operator+=(const Integer& y) {
-    d_value += y.d_value;
-    return *this;
+    return *this = *this + y;
   }
 
   Integer operator-(const Integer& y) const {
-    return Integer( d_value - y.d_value );
+    int64_t r;
+    if(isSmall() && y.isSmall() && small_arith::sub(d_small, y.d_small, r)) {
+      return fromSmall(r);
+    }
+    return Integer( get_mpz() - y.get_mpz() );
   }
   Integer& operator-=(const Integer& y) {
-    d_value -= y.d_value;
-    return *this;
+    return *this = *this - y;
   }
 
   Integer operator*(const Integer& y) const {
-    return Integer( d_value * y.d_value );
+    int64_t r;
+    if(isSmall() && y.isSmall() && small_arith::mul(d_small, y.d_small, r)) {
+      return fromSmall(r);
+    }
+    return Integer( get_mpz() * y.get_mpz() );
   }
   Integer& operator*=(const Integer& y) {
-    d_value *= y.d_value;
-    return *this;
+    return *this = *this * y;
   }
 
 
   Integer bitwiseOr(const Integer& y) const {
+    if(isSmall() && y.isSmall() && small_arith::fits(d_small | y.d_small)) {
+      return fromSmall(d_small | y.d_small);
+    }
     mpz_class result;
-    mpz_ior(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_ior(result.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer(result);
   }
 
   Integer bitwiseAnd(const Integer& y) const {
+    if(isSmall() && y.isSmall() && small_arith::fits(d_small & y.d_small)) {
+      return fromSmall(d_small & y.d_small);
+    }
     mpz_class result;
-    mpz_and(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_and(result.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer(result);
   }
 
   Integer bitwiseXor(const Integer& y) const {
+    if(isSmall() && y.isSmall() && small_arith::fits(d_small ^ y.d_small)) {
+      return fromSmall(d_small ^ y.d_small);
+    }
     mpz_class result;
-    mpz_xor(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_xor(result.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer(result);
   }
 
   Integer bitwiseNot() const {
+    if(isSmall() && small_arith::fits(~d_small)) {
+      return fromSmall(~d_small);
+    }
     mpz_class result;
-    mpz_com(result.get_mpz_t(), d_value.get_mpz_t());
+    mpz_com(result.get_mpz_t(), get_mpz().get_mpz_t());
     return Integer(result);
   }
 
@@ -176,7 +299,7 @@ public:
    */
   Integer multiplyByPow2(uint32_t pow) const{
     mpz_class result;
-    mpz_mul_2exp(result.get_mpz_t(), d_value.get_mpz_t(), pow);
+    mpz_mul_2exp(result.get_mpz_t(), get_mpz().get_mpz_t(), pow);
     return Integer( result );
   }
 
@@ -185,7 +308,10 @@ public:
    * current Integer to 1.
    */
   Integer setBit(uint32_t i) const {
-    mpz_class res = d_value;
+    if(isSmall() && i < 62) {
+      return fromSmall(d_small | (int64_t(1) << i));
+    }
+    mpz_class res = get_mpz();
     mpz_setbit(res.get_mpz_t(), i);
     return Integer(res);
   }
@@ -201,16 +327,23 @@ public:
   Integer oneExtend(uint32_t size, uint32_t amount) const;
 
   uint32_t toUnsignedInt() const {
-    return  mpz_get_ui(d_value.get_mpz_t());
+    if(isSmall()) {
+      return uint32_t(small_arith::abs(d_small));
+    }
+    return  mpz_get_ui(d_big->get_mpz_t());
   }
 
   /** See GMP Documentation. */
   Integer extractBitRange(uint32_t bitCount, uint32_t low) const {
     // bitCount = high-low+1
     uint32_t high = low + bitCount-1;
+    if(isSmall() && high < 62) {
+      // the (arithmetic) shift of a two's complement value
+      return fromSmall((d_small >> low) & ((int64_t(1) << bitCount) - 1));
+    }
     //— Function: void mpz_fdiv_r_2exp (mpz_t r, mpz_t n, mp_bitcnt_t b)
     mpz_class rem, div;
-    mpz_fdiv_r_2exp(rem.get_mpz_t(), d_value.get_mpz_t(), high+1);
+    mpz_fdiv_r_2exp(rem.get_mpz_t(), get_mpz().get_mpz_t(), high+1);
     mpz_fdiv_q_2exp(div.get_mpz_t(), rem.get_mpz_t(), low);
 
     return Integer(div);
@@ -220,33 +353,51 @@ public:
    * Returns the floor(this / y)
    */
   Integer floorDivideQuotient(const Integer& y) const {
-    mpz_class q;
-    mpz_fdiv_q(q.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-    return Integer( q );
+    Integer q, r;
+    floorQR(q, r, *this, y);
+    return q;
   }
 
   /**
    * Returns r == this - floor(this/y)*y
    */
   Integer floorDivideRemainder(const Integer& y) const {
-    mpz_class r;
-    mpz_fdiv_r(r.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
-    return Integer( r );
+    Integer q, r;
+    floorQR(q, r, *this, y);
+    return r;
   }
 
   /**
    * Computes a floor quotient and remainder for x divided by y.
    */
   static void floorQR(Integer& q, Integer& r, const Integer& x, const Integer& y) {
-    mpz_fdiv_qr(q.d_value.get_mpz_t(), r.d_value.get_mpz_t(), x.d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    if(x.isSmall() && y.isSmall() && y.d_small != 0) {
+      // neither can overflow in the symmetric range
+      int64_t qs = x.d_small / y.d_small, rs = x.d_small % y.d_small;
+      if(rs != 0 && (rs < 0) != (y.d_small < 0)) {
+        qs -= 1;
+        rs += y.d_small;
+      }
+      q = fromSmall(qs);
+      r = fromSmall(rs);
+      return;
+    }
+    mpz_class qz, rz;
+    mpz_fdiv_qr(qz.get_mpz_t(), rz.get_mpz_t(), x.get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
+    q = Integer(qz);
+    r = Integer(rz);
   }
 
   /**
    * Returns the ceil(this / y)
    */
   Integer ceilingDivideQuotient(const Integer& y) const {
+    if(isSmall() && y.isSmall() && y.d_small != 0) {
+      int64_t qs = d_small / y.d_small, rs = d_small % y.d_small;
+      return fromSmall(rs != 0 && (rs < 0) == (y.d_small < 0) ? qs + 1 : qs);
+    }
     mpz_class q;
-    mpz_cdiv_q(q.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_cdiv_q(q.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer( q );
   }
 
@@ -254,8 +405,12 @@ public:
    * Returns the ceil(this / y)
    */
   Integer ceilingDivideRemainder(const Integer& y) const {
+    if(isSmall() && y.isSmall() && y.d_small != 0) {
+      int64_t rs = d_small % y.d_small;
+      return fromSmall(rs != 0 && (rs < 0) == (y.d_small < 0) ? rs - y.d_small : rs);
+    }
     mpz_class r;
-    mpz_cdiv_r(r.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_cdiv_r(r.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer( r );
   }
 
@@ -324,8 +479,11 @@ public:
    * Returns y mod 2^exp
    */
   Integer modByPow2(uint32_t exp) const {
+    if(isSmall() && exp < 62) {
+      return fromSmall(d_small & ((int64_t(1) << exp) - 1));
+    }
     mpz_class res;
-    mpz_fdiv_r_2exp(res.get_mpz_t(), d_value.get_mpz_t(), exp);
+    mpz_fdiv_r_2exp(res.get_mpz_t(), get_mpz().get_mpz_t(), exp);
     return Integer(res);
   }
 
@@ -333,14 +491,20 @@ public:
    * Returns y / 2^exp
    */
   Integer divByPow2(uint32_t exp) const {
+    if(isSmall() && exp < 64) {
+      return fromSmall(d_small >> exp);
+    }
     mpz_class res;
-    mpz_fdiv_q_2exp(res.get_mpz_t(), d_value.get_mpz_t(), exp);
+    mpz_fdiv_q_2exp(res.get_mpz_t(), get_mpz().get_mpz_t(), exp);
     return Integer(res);
   }
 
 
   int sgn() const {
-    return mpz_sgn(d_value.get_mpz_t());
+    if(isSmall()) {
+      return (d_small > 0) - (d_small < 0);
+    }
+    return mpz_sgn(d_big->get_mpz_t());
   }
 
   inline bool strictlyPositive() const {
@@ -356,11 +520,11 @@ public:
   }
 
   bool isOne() const {
-    return mpz_cmp_si(d_value.get_mpz_t(), 1) == 0;
+    return isSmall() && d_small == 1;
   }
 
   bool isNegativeOne() const {
-    return mpz_cmp_si(d_value.get_mpz_t(), -1) == 0;
+    return isSmall() && d_small == -1;
   }
 
   /**
@@ -370,7 +534,7 @@ public:
    */
   Integer pow(unsigned long int exp) const {
     mpz_class result;
-    mpz_pow_ui(result.get_mpz_t(), d_value.get_mpz_t(), exp);
+    mpz_pow_ui(result.get_mpz_t(), get_mpz().get_mpz_t(), exp);
     return Integer(result);
   }
 
@@ -378,8 +542,12 @@ public:
    * Return the greatest common divisor of this integer with another.
    */
   Integer gcd(const Integer& y) const {
+    if(isSmall() && y.isSmall()) {
+      return fromSmall(small_arith::gcd(small_arith::abs(d_small),
+                                        small_arith::abs(y.d_small)));
+    }
     mpz_class result;
-    mpz_gcd(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_gcd(result.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer(result);
   }
 
@@ -388,7 +556,7 @@ public:
    */
   Integer lcm(const Integer& y) const {
     mpz_class result;
-    mpz_lcm(result.get_mpz_t(), d_value.get_mpz_t(), y.d_value.get_mpz_t());
+    mpz_lcm(result.get_mpz_t(), get_mpz().get_mpz_t(), y.get_mpz().get_mpz_t());
     return Integer(result);
   }
 
@@ -421,7 +589,10 @@ public:
    * ! zero.divides(zero)
    */
   bool divides(const Integer& y) const {
-    int res = mpz_divisible_p(y.d_value.get_mpz_t(), d_value.get_mpz_t());
+    if(isSmall() && y.isSmall()) {
+      return d_small == 0 ? y.d_small == 0 : y.d_small % d_small == 0;
+    }
+    int res = mpz_divisible_p(y.get_mpz().get_mpz_t(), get_mpz().get_mpz_t());
     return res != 0;
   }
 
@@ -429,11 +600,14 @@ public:
    * Return the absolute value of this integer.
    */
   Integer abs() const {
-    return d_value >= 0 ? *this : -*this;
+    return sgn() >= 0 ? *this : -*this;
   }
 
   std::string toString(int base = 10) const{
-    return d_value.get_str(base);
+    if(isSmall() && base == 10) {
+      return std::to_string(d_small);
+    }
+    return get_mpz().get_str(base);
   }
 
   bool fitsSignedInt() const;
@@ -449,19 +623,17 @@ public:
   bool fitsUnsignedLong() const;
 
   long getLong() const {
-    long si = d_value.get_si();
-    // ensure there wasn't overflow
-    CheckArgument(mpz_cmp_si(d_value.get_mpz_t(), si) == 0, this,
+    // ensure there isn't overflow
+    CheckArgument(fitsSignedLong(), this,
                  "Overflow detected in Integer::getLong().");
-    return si;
+    return isSmall() ? long(d_small) : mpz_get_si(d_big->get_mpz_t());
   }
 
   unsigned long getUnsignedLong() const {
-    unsigned long ui = d_value.get_ui();
-    // ensure there wasn't overflow
-    CheckArgument(mpz_cmp_ui(d_value.get_mpz_t(), ui) == 0, this,
+    // ensure there isn't overflow
+    CheckArgument(fitsUnsignedLong(), this,
                   "Overflow detected in Integer::getUnsignedLong().");
-    return ui;
+    return isSmall() ? (unsigned long)(d_small) : mpz_get_ui(d_big->get_mpz_t());
   }
 
   /**
@@ -469,7 +641,11 @@ public:
    * numerator, the denominator.
    */
   size_t hash() const {
-    return gmpz_hash(d_value.get_mpz_t());
+    // agrees with gmpz_hash() on one-limb values
+    if(isSmall()) {
+      return size_t(small_arith::abs(d_small));
+    }
+    return gmpz_hash(d_big->get_mpz_t());
   }
 
   /**
@@ -479,7 +655,10 @@ public:
    * @return true if bit n is set in this integer; false otherwise
    */
   bool testBit(unsigned n) const {
-    return mpz_tstbit(d_value.get_mpz_t(), n);
+    if(isSmall()) {
+      return n < 63 ? (d_small >> n) & 1 : d_small < 0;
+    }
+    return mpz_tstbit(d_big->get_mpz_t(), n);
   }
 
   /**
@@ -487,11 +666,14 @@ public:
    * @return k if the integer is equal to 2^(k-1) and 0 otherwise
    */
   unsigned isPow2() const {
-    if (d_value <= 0) return 0;
+    if (sgn() <= 0) return 0;
+    if (isSmall()) {
+      return (d_small & (d_small - 1)) == 0 ? __builtin_ctzll(d_small) + 1 : 0;
+    }
     // check that the number of ones in the binary representation is 1
-    if (mpz_popcount(d_value.get_mpz_t()) == 1) {
+    if (mpz_popcount(d_big->get_mpz_t()) == 1) {
       // return the index of the first one plus 1
-      return mpz_scan1(d_value.get_mpz_t(), 0) + 1;
+      return mpz_scan1(d_big->get_mpz_t(), 0) + 1;
     }
     return 0; 
   }
@@ -504,15 +686,21 @@ public:
   size_t length() const {
     if(sgn() == 0){
       return 1;
+    }else if(isSmall()){
+      return 64 - __builtin_clzll(small_arith::abs(d_small));
     }else{
-      return mpz_sizeinbase(d_value.get_mpz_t(),2);
+      return mpz_sizeinbase(d_big->get_mpz_t(),2);
     }
   }
 
   static void extendedGcd(Integer& g, Integer& s, Integer& t, const Integer& a, const Integer& b){
     //see the documentation for:
     //mpz_gcdext (mpz_t g, mpz_t s, mpz_t t, mpz_t a, mpz_t b);
-    mpz_gcdext (g.d_value.get_mpz_t(), s.d_value.get_mpz_t(), t.d_value.get_mpz_t(), a.d_value.get_mpz_t(), b.d_value.get_mpz_t());
+    mpz_class gz, sz, tz;
+    mpz_gcdext (gz.get_mpz_t(), sz.get_mpz_t(), tz.get_mpz_t(), a.get_mpz().get_mpz_t(), b.get_mpz().get_mpz_t());
+    g = Integer(gz);
+    s = Integer(sz);
+    t = Integer(tz);
   }
 
   /** Returns a reference to the minimum of two integers. */
@@ -15,6 +15,7 @@
  **/
 #include "util/rational.h"
 
+#include <limits>
 #include <sstream>
 #include <string>
 
@@ -55,6 +56,83 @@ std::ostream& operator<<(std::ostream& os, const Rational& q){
   return os << q.toString();
 }
 
+cln::cl_I Rational::toClI(int64_t x) {
+  if(x >= std::numeric_limits<long>::min() &&
+     x <= std::numeric_limits<long>::max()) {
+    return cln::cl_I(static_cast<long>(x));
+  }
+  // long is narrower than 64 bits
+  return cln::ash(cln::cl_I(static_cast<long>(x >> 32)), 32) +
+    cln::cl_I(static_cast<unsigned long>(x & 0xffffffff));
+}
+
+/**
+ * Sets x to the value of z and returns true if z is in the small range;
+ * otherwise returns false.
+ */
+static bool fromClI(const cln::cl_I& z, int64_t& x) {
+  if(cln::integer_length(z) > 63) {
+    return false;
+  }
+  if(cln::integer_length(z) <= std::numeric_limits<long>::digits) {
+    x = cln::cl_I_to_long(z);
+  } else {
+    int64_t high = cln::cl_I_to_long(cln::ash(z, -32));
+    uint64_t low = cln::cl_I_to_ulong(cln::ldb(z, cln::cl_byte(32, 0)));
+    x = high * (int64_t(1) << 32) + int64_t(low);
+  }
+  return small_arith::fits(x);
+}
+
+void Rational::setCanonical(const cln::cl_RA& val) {
+  if(fromClI(cln::numerator(val), d_num) &&
+     fromClI(cln::denominator(val), d_den)) {
+    delete d_big;
+    d_big = NULL;
+  } else if(isSmall()) {
+    d_big = new cln::cl_RA(val);
+  } else {
+    *d_big = val;
+  }
+}
+
+void Rational::readRational(const char* s, unsigned base) {
+  cln::cl_read_flags flags;
+
+  flags.syntax = cln::syntax_rational;
+  flags.lsyntax = cln::lsyntax_standard;
+  flags.rational_base = base;
+  cln::cl_RA value;
+  try{
+    value = read_rational(flags, s, NULL, NULL);
+  }catch(...){
+    std::stringstream ss;
+    ss << "Rational() failed to parse value \"" <<s << "\" in base=" <<base;
+    throw std::invalid_argument(ss.str());
+  }
+  setCanonical(value);
+}
+
+Rational Rational::addBig(const Rational& y) const {
+  return Rational(get_cl_RA() + y.get_cl_RA());
+}
+
+Rational Rational::subBig(const Rational& y) const {
+  return Rational(get_cl_RA() - y.get_cl_RA());
+}
+
+Rational Rational::mulBig(const Rational& y) const {
+  return Rational(get_cl_RA() * y.get_cl_RA());
+}
+
+Rational Rational::divBig(const Rational& y) const {
+  return Rational(get_cl_RA() / y.get_cl_RA());
+}
+
+int Rational::cmpBig(const Rational& y) const {
+  return cln::compare(get_cl_RA(), y.get_cl_RA());
+}
+
 
 
 /** Equivalent to calling (this->abs()).cmp(b.abs()) */
@@ -88,9 +166,7 @@ Maybe<Rational> Rational::fromDouble(double d)
 {
   try{
     cln::cl_DF fromD = d;
-    Rational q;
-    q.d_value = cln::rationalize(fromD);
-    return q;
+    return Rational(cln::rationalize(fromD));
   }catch(cln::floating_point_underflow_exception& fpue){
     return Maybe<Rational>();
   }catch(cln::floating_point_nan_exception& fpne){
@@ -21,8 +21,10 @@
 #define __CVC4__RATIONAL_H
 
 #include <gmp.h>
+#include <stdint.h>
 #include <string>
 #include <sstream>
+#include <utility>
 #include <cassert>
 #include <cln/rational.h>
 #include <cln/input.h>
@@ -36,6 +38,7 @@
 #include "base/exception.h"
 #include "util/integer.h"
 #include "util/maybe.h"
+#include "util/small_arith.h"
 
 namespace CVC4 {
 
@@ -57,19 +60,71 @@ namespace CVC4 {
 class CVC4_PUBLIC Rational {
 private:
   /**
-   * Stores the value of the rational is stored in a C++ GMP rational class.
-   * Using this instead of mpq_t allows for easier destruction.
+   * The numerator and denominator, if both are in the small range
+   * [-INT64_MAX, INT64_MAX] (see util/small_arith.h).  Only meaningful
+   * when d_big is NULL.
    */
-  cln::cl_RA d_value;
+  int64_t d_num;
+  int64_t d_den;
 
   /**
-   * Constructs a Rational from a mpq_class object.
-   * Does a deep copy.
-   * Assumes that the value is in canonical form, and thus does not
-   * have to call canonicalize() on the value.
+   * The value, as a CLN rational, if its numerator or denominator is
+   * outside the small range; NULL otherwise.  Every operation keeps this
+   * invariant, so a value has exactly one representation.  CLN already
+   * stores small integers unboxed, but not small fractions, which are the
+   * common case in the simplex tableau.
    */
-  //Rational(const mpq_class& val) : d_value(val) {  }
-  Rational(const cln::cl_RA& val) : d_value(val) {  }
+  cln::cl_RA* d_big;
+
+  bool isSmall() const { return d_big == NULL; }
+
+  /** Converts a small value to CLN. */
+  static cln::cl_I toClI(int64_t x);
+
+  /** Gets a copy of the value as CLN data. */
+  cln::cl_RA get_cl_RA() const {
+    if(isSmall()) {
+      cln::cl_RA q = toClI(d_num);
+      if(d_den != 1) {
+        q /= toClI(d_den);
+      }
+      return q;
+    }
+    return *d_big;
+  }
+
+  /**
+   * Constructs a Rational from a CLN rational, which is always in
+   * canonical form.
+   */
+  Rational(const cln::cl_RA& val) : d_num(0), d_den(1), d_big(NULL) {
+    setCanonical(val);
+  }
+
+  /** Constructs the small rational n/d, which must be canonical. */
+  Rational(int64_t n, int64_t d, bool) : d_num(n), d_den(d), d_big(NULL) {}
+
+  /** Sets the value to val. */
+  void setCanonical(const cln::cl_RA& val);
+
+  /** Sets the value to n/d. */
+  void setSmall(int64_t n, int64_t d) {
+    if(d == 0 || !small_arith::canonicalize(n, d, d_num, d_den)) {
+      cln::cl_RA q = toClI(n);
+      q /= toClI(d);
+      setCanonical(q);
+    }
+  }
+
+  /** Parses s, throwing std::invalid_argument if it is not a rational. */
+  void readRational(const char* s, unsigned base);
+
+  /** The multiprecision fallbacks of the arithmetic operators. */
+  Rational addBig(const Rational& y) const;
+  Rational subBig(const Rational& y) const;
+  Rational mulBig(const Rational& y) const;
+  Rational divBig(const Rational& y) const;
+  int cmpBig(const Rational& y) const;
 
 public:
 
@@ -82,7 +137,7 @@ public:
   static Rational fromDecimal(const std::string& dec);
 
   /** Constructs a rational with the value 0/1. */
-  Rational() : d_value(0){
+  Rational() : d_num(0), d_den(1), d_big(NULL) {
   }
   /**
    * Constructs a Rational from a C string in a given base (defaults to 10).
@@ -91,95 +146,103 @@ public:
    * For more information about what is a valid rational string,
    * see GMP's documentation for mpq_set_str().
    */
-  explicit Rational(const char* s, unsigned base = 10)
+  explicit Rational(const char* s, unsigned base = 10) :
+    d_num(0), d_den(1), d_big(NULL)
   {
-    cln::cl_read_flags flags;
-
-    flags.syntax = cln::syntax_rational;
-    flags.lsyntax = cln::lsyntax_standard;
-    flags.rational_base = base;
-    try{
-      d_value = read_rational(flags, s, NULL, NULL);
-    }catch(...){
-      std::stringstream ss;
-      ss << "Rational() failed to parse value \"" <<s << "\" in base=" <<base;
-      throw std::invalid_argument(ss.str());
-    }
+    readRational(s, base);
   }
-  Rational(const std::string& s, unsigned base = 10)
+  Rational(const std::string& s, unsigned base = 10) :
+    d_num(0), d_den(1), d_big(NULL)
   {
-    cln::cl_read_flags flags;
-
-    flags.syntax = cln::syntax_rational;
-    flags.lsyntax = cln::lsyntax_standard;
-    flags.rational_base = base;
-    try{
-      d_value = read_rational(flags, s.c_str(), NULL, NULL);
-    }catch(...){
-      std::stringstream ss;
-      ss << "Rational() failed to parse value \"" <<s << "\" in base=" <<base;
-      throw std::invalid_argument(ss.str());
-    }
+    readRational(s.c_str(), base);
   }
 
   /**
    * Creates a Rational from another Rational, q, by performing a deep copy.
    */
-  Rational(const Rational& q) : d_value(q.d_value) { }
+  Rational(const Rational& q) :
+    d_num(q.d_num),
+    d_den(q.d_den),
+    d_big(q.isSmall() ? NULL : new cln::cl_RA(*q.d_big)) {
+  }
+
+  Rational(Rational&& q) : d_num(q.d_num), d_den(q.d_den), d_big(q.d_big) {
+    q.d_num = 0;
+    q.d_den = 1;
+    q.d_big = NULL;
+  }
 
   /**
    * Constructs a canonical Rational from a numerator.
    */
-  Rational(signed int n) : d_value((signed long int)n) { }
-  Rational(unsigned int n) : d_value((unsigned long int)n) { }
-  Rational(signed long int n) : d_value(n) { }
-  Rational(unsigned long int n) : d_value(n) { }
+  Rational(signed int n) : d_num(n), d_den(1), d_big(NULL) { }
+  Rational(unsigned int n) : d_num(n), d_den(1), d_big(NULL) { }
+  Rational(signed long int n) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, 1);
+  }
+  Rational(unsigned long int n) : d_num(0), d_den(1), d_big(NULL) {
+    setCanonical(cln::cl_I(n));
+  }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n) : d_value(static_cast<long>(n)) { }
-  Rational(uint64_t n) : d_value(static_cast<unsigned long>(n)) { }
+  Rational(int64_t n) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, 1);
+  }
+  Rational(uint64_t n) : d_num(0), d_den(1), d_big(NULL) {
+    setCanonical(cln::cl_I(static_cast<unsigned long>(n)));
+  }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   /**
    * Constructs a canonical Rational from a numerator and denominator.
    */
-  Rational(signed int n, signed int d) : d_value((signed long int)n) {
-    d_value /= cln::cl_I(d);
+  Rational(signed int n, signed int d) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(unsigned int n, unsigned int d) : d_value((unsigned long int)n) {
-    d_value /= cln::cl_I(d);
+  Rational(unsigned int n, unsigned int d) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(signed long int n, signed long int d) : d_value(n) {
-    d_value /= cln::cl_I(d);
+  Rational(signed long int n, signed long int d) :
+    d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(unsigned long int n, unsigned long int d) : d_value(n) {
-    d_value /= cln::cl_I(d);
+  Rational(unsigned long int n, unsigned long int d) :
+    d_num(0), d_den(1), d_big(NULL) {
+    cln::cl_RA q = cln::cl_I(n);
+    q /= cln::cl_I(d);
+    setCanonical(q);
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n, int64_t d) : d_value(static_cast<long>(n)) {
-    d_value /= cln::cl_I(d);
+  Rational(int64_t n, int64_t d) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(uint64_t n, uint64_t d) : d_value(static_cast<unsigned long>(n)) {
-    d_value /= cln::cl_I(d);
+  Rational(uint64_t n, uint64_t d) : d_num(0), d_den(1), d_big(NULL) {
+    cln::cl_RA q = cln::cl_I(static_cast<unsigned long>(n));
+    q /= cln::cl_I(static_cast<unsigned long>(d));
+    setCanonical(q);
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   Rational(const Integer& n, const Integer& d) :
-    d_value(n.get_cl_I())
+    d_num(0), d_den(1), d_big(NULL)
   {
-    d_value /= d.get_cl_I();
+    cln::cl_RA q = n.get_cl_I();
+    q /= d.get_cl_I();
+    setCanonical(q);
+  }
+  Rational(const Integer& n) : d_num(0), d_den(1), d_big(NULL) {
+    setCanonical(n.get_cl_I());
   }
-  Rational(const Integer& n) : d_value(n.get_cl_I()){  }
 
-  ~Rational() {}
+  ~Rational() { delete d_big; }
 
   /**
-   * Returns a copy of d_value to enable public access of CLN data.
+   * Returns a copy of the value to enable public access of CLN data.
    */
   cln::cl_RA getValue() const
   {
-    return d_value;
+    return get_cl_RA();
   }
 
   /**
@@ -187,7 +250,10 @@ public:
    * Note that this makes a deep copy of the numerator.
    */
   Integer getNumerator() const {
-    return Integer(cln::numerator(d_value));
+    if(isSmall()) {
+      return Integer(toClI(d_num));
+    }
+    return Integer(cln::numerator(*d_big));
   }
 
   /**
@@ -195,7 +261,10 @@ public:
    * Note that this makes a deep copy of the denominator.
    */
   Integer getDenominator() const {
-    return Integer(cln::denominator(d_value));
+    if(isSmall()) {
+      return Integer(toClI(d_den));
+    }
+    return Integer(cln::denominator(*d_big));
   }
 
   /** Return an exact rational for a double d. */
@@ -207,41 +276,51 @@ public:
    * infinity, and underflow may result in zero.
    */
   double getDouble() const {
-    return cln::double_approx(d_value);
+    return cln::double_approx(get_cl_RA());
   }
 
   Rational inverse() const {
-    return Rational(cln::recip(d_value));
+    if(isSmall() && d_num != 0) {
+      return d_num < 0 ? Rational(-d_den, -d_num, true)
+                       : Rational(d_den, d_num, true);
+    }
+    return Rational(cln::recip(get_cl_RA()));
   }
 
   int cmp(const Rational& x) const {
-    //Don't use mpq_class's cmp() function.
-    //The name ends up conflicting with this function.
-    return cln::compare(d_value, x.d_value);
+    int c;
+    if(isSmall() && x.isSmall() &&
+       small_arith::ratCmp(d_num, d_den, x.d_num, x.d_den, c)) {
+      return c;
+    }
+    return cmpBig(x);
   }
 
 
   int sgn() const {
-    if(cln::zerop(d_value)){
+    if(isSmall()) {
+      return (d_num > 0) - (d_num < 0);
+    }
+    if(cln::zerop(*d_big)){
        return 0;
-    }else if(cln::minusp(d_value)){
+    }else if(cln::minusp(*d_big)){
        return -1;
     }else{
-      assert(cln::plusp(d_value));
+      assert(cln::plusp(*d_big));
       return 1;
     }
   }
 
   bool isZero() const {
-    return cln::zerop(d_value);
+    return isSmall() && d_num == 0;
   }
 
   bool isOne() const {
-    return d_value == 1;
+    return isSmall() && d_num == 1 && d_den == 1;
   }
 
   bool isNegativeOne() const {
-    return d_value == -1;
+    return isSmall() && d_num == -1 && d_den == 1;
   }
 
   Rational abs() const {
@@ -253,15 +332,26 @@ public:
   }
 
   bool isIntegral() const{
-    return getDenominator() == 1;
+    if(isSmall()) {
+      return d_den == 1;
+    }
+    return cln::denominator(*d_big) == 1;
   }
 
   Integer floor() const {
-    return Integer(cln::floor1(d_value));
+    if(isSmall()) {
+      int64_t q = d_num / d_den;
+      return Integer(toClI(d_num % d_den < 0 ? q - 1 : q));
+    }
+    return Integer(cln::floor1(*d_big));
   }
 
   Integer ceiling() const {
-    return Integer(cln::ceiling1(d_value));
+    if(isSmall()) {
+      int64_t q = d_num / d_den;
+      return Integer(toClI(d_num % d_den > 0 ? q + 1 : q));
+    }
+    return Integer(cln::ceiling1(*d_big));
   }
 
   Rational floor_frac() const {
@@ -270,79 +360,149 @@ public:
 
   Rational& operator=(const Rational& x){
     if(this == &x) return *this;
-    d_value = x.d_value;
+    if(x.isSmall()) {
+      delete d_big;
+      d_big = NULL;
+      d_num = x.d_num;
+      d_den = x.d_den;
+    } else if(isSmall()) {
+      d_big = new cln::cl_RA(*x.d_big);
+    } else {
+      *d_big = *x.d_big;
+    }
+    return *this;
+  }
+
+  Rational& operator=(Rational&& x){
+    if(this == &x) return *this;
+    std::swap(d_num, x.d_num);
+    std::swap(d_den, x.d_den);
+    std::swap(d_big, x.d_big);
     return *this;
   }
 
   Rational operator-() const{
-    return Rational(-(d_value));
+    if(isSmall()) {
+      return Rational(-d_num, d_den, true);
+    }
+    return Rational(-(*d_big));
   }
 
   bool operator==(const Rational& y) const {
-    return d_value == y.d_value;
+    if(isSmall() || y.isSmall()) {
+      return isSmall() && y.isSmall() && d_num == y.d_num && d_den == y.d_den;
+    }
+    return *d_big == *y.d_big;
   }
 
   bool operator!=(const Rational& y) const {
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   bool operator< (const Rational& y) const {
-    return d_value < y.d_value;
+    return cmp(y) < 0;
   }
 
   bool operator<=(const Rational& y) const {
-    return d_value <= y.d_value;
+    return cmp(y) <= 0;
   }
 
   bool operator> (const Rational& y) const {
-    return d_value > y.d_value;
+    return cmp(y) > 0;
   }
 
   bool operator>=(const Rational& y) const {
-    return d_value >= y.d_value;
+    return cmp(y) >= 0;
   }
 
   Rational operator+(const Rational& y) const{
-    return Rational( d_value + y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return addBig(y);
   }
   Rational operator-(const Rational& y) const {
-    return Rational( d_value - y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, -y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return subBig(y);
   }
 
   Rational operator*(const Rational& y) const {
-    return Rational( d_value * y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratMul(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return mulBig(y);
   }
   Rational operator/(const Rational& y) const {
-    return Rational( d_value / y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() && y.d_num != 0 &&
+       small_arith::ratDiv(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return divBig(y);
   }
 
   Rational& operator+=(const Rational& y){
-    d_value += y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = addBig(y);
   }
-
   Rational& operator-=(const Rational& y){
-    d_value -= y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, -y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = subBig(y);
   }
 
   Rational& operator*=(const Rational& y){
-    d_value *= y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratMul(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = mulBig(y);
   }
 
   Rational& operator/=(const Rational& y){
-    d_value /= y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() && y.d_num != 0 &&
+       small_arith::ratDiv(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = divBig(y);
   }
 
   /** Returns a string representing the rational in the given base. */
   std::string toString(int base = 10) const {
+    if(isSmall() && base == 10) {
+      return d_den == 1 ? std::to_string(d_num)
+                        : std::to_string(d_num) + "/" + std::to_string(d_den);
+    }
     cln::cl_print_flags flags;
     flags.rational_base = base;
     flags.rational_readably = false;
     std::stringstream ss;
-    print_rational(ss, flags, d_value);
+    print_rational(ss, flags, get_cl_RA());
     return ss.str();
   }
 
@@ -351,7 +511,10 @@ public:
    * denominator.
    */
   size_t hash() const {
-    return equal_hashcode(d_value);
+    if(isSmall()) {
+      return size_t(small_arith::abs(d_num)) xor size_t(d_den);
+    }
+    return equal_hashcode(*d_big);
   }
 
   uint32_t complexity() const {
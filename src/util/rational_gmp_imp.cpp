@@ -33,6 +33,28 @@ std::ostream& operator<<(std::ostream& os, const Rational& q){
   return os << q.toString();
 }
 
+Rational Rational::addBig(const Rational& y) const {
+  return Rational(get_mpq() + y.get_mpq());
+}
+
+Rational Rational::subBig(const Rational& y) const {
+  return Rational(get_mpq() - y.get_mpq());
+}
+
+Rational Rational::mulBig(const Rational& y) const {
+  return Rational(get_mpq() * y.get_mpq());
+}
+
+Rational Rational::divBig(const Rational& y) const {
+  return Rational(get_mpq() / y.get_mpq());
+}
+
+int Rational::cmpBig(const Rational& y) const {
+  //Don't use mpq_class's cmp() function.
+  //The name ends up conflicting with this function.
+  return mpq_cmp(get_mpq().get_mpq_t(), y.get_mpq().get_mpq_t());
+}
+
 
 /* Computes a rational given a decimal string. The rational
  * version of <code>xxx.yyy</code> is <code>xxxyyy/(10^3)</code>.
@@ -91,9 +113,9 @@ Maybe<Rational> Rational::fromDouble(double d)
 {
   using namespace std;
   if(isfinite(d)){
-    Rational q;
-    mpq_set_d(q.d_value.get_mpq_t(), d);
-    return q;
+    mpq_class q;
+    mpq_set_d(q.get_mpq_t(), d);
+    return Rational(q);
   }
   return Maybe<Rational>();
 }
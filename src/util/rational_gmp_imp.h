@@ -28,11 +28,15 @@
 #include <cstddef>
 
 #include <gmp.h>
+#include <stdint.h>
+
 #include <string>
+#include <utility>
 
 #include "base/exception.h"
 #include "util/integer.h"
 #include "util/maybe.h"
+#include "util/small_arith.h"
 
 namespace CVC4 {
 
@@ -54,10 +58,34 @@ namespace CVC4 {
 class CVC4_PUBLIC Rational {
 private:
   /**
-   * Stores the value of the rational is stored in a C++ GMP rational class.
-   * Using this instead of mpq_t allows for easier destruction.
+   * The numerator and denominator, if both are in the small range
+   * [-INT64_MAX, INT64_MAX] (see util/small_arith.h).  Only meaningful
+   * when d_big is NULL.
    */
-  mpq_class d_value;
+  int64_t d_num;
+  int64_t d_den;
+
+  /**
+   * The value, as a C++ GMP rational class, if its numerator or
+   * denominator is outside the small range; NULL otherwise.  Every
+   * operation keeps this invariant, so a value has exactly one
+   * representation, and the arithmetic on small values (most
+   * coefficients in practice) neither allocates nor calls into GMP.
+   */
+  mpq_class* d_big;
+
+  bool isSmall() const { return d_big == NULL; }
+
+  /** Gets a copy of the value as GMP data. */
+  mpq_class get_mpq() const {
+    if(isSmall()) {
+      mpq_class q;
+      gmpz_set_int64(q.get_num_mpz_t(), d_num);
+      gmpz_set_int64(q.get_den_mpz_t(), d_den);
+      return q;
+    }
+    return *d_big;
+  }
 
   /**
    * Constructs a Rational from a mpq_class object.
@@ -65,7 +93,48 @@ private:
    * Assumes that the value is in canonical form, and thus does not
    * have to call canonicalize() on the value.
    */
-  Rational(const mpq_class& val) : d_value(val) {  }
+  Rational(const mpq_class& val) : d_num(0), d_den(1), d_big(NULL) {
+    setCanonical(val);
+  }
+
+  /** Constructs the small rational n/d, which must be canonical. */
+  Rational(int64_t n, int64_t d, bool) : d_num(n), d_den(d), d_big(NULL) {}
+
+  /** Sets the value to val, which must be canonical. */
+  void setCanonical(const mpq_class& val) {
+    if(gmpz_get_int64(val.get_num_mpz_t(), d_num) &&
+       gmpz_get_int64(val.get_den_mpz_t(), d_den)) {
+      delete d_big;
+      d_big = NULL;
+    } else if(isSmall()) {
+      d_big = new mpq_class(val);
+    } else {
+      *d_big = val;
+    }
+  }
+
+  /** Sets the value to val, canonicalizing it first. */
+  void setValue(mpq_class val) {
+    val.canonicalize();
+    setCanonical(val);
+  }
+
+  /** Sets the value to n/d, for d != 0. */
+  void setSmall(int64_t n, int64_t d) {
+    if(d == 0 || !small_arith::canonicalize(n, d, d_num, d_den)) {
+      mpq_class q;
+      gmpz_set_int64(q.get_num_mpz_t(), n);
+      gmpz_set_int64(q.get_den_mpz_t(), d);
+      setValue(q);
+    }
+  }
+
+  /** The multiprecision fallbacks of the arithmetic operators. */
+  Rational addBig(const Rational& y) const;
+  Rational subBig(const Rational& y) const;
+  Rational mulBig(const Rational& y) const;
+  Rational divBig(const Rational& y) const;
+  int cmpBig(const Rational& y) const;
 
 public:
 
@@ -78,9 +147,7 @@ public:
   static Rational fromDecimal(const std::string& dec);
 
   /** Constructs a rational with the value 0/1. */
-  Rational() : d_value(0){
-    d_value.canonicalize();
-  }
+  Rational() : d_num(0), d_den(1), d_big(NULL) {}
 
   /**
    * Constructs a Rational from a C string in a given base (defaults to 10).
@@ -89,88 +156,102 @@ public:
    * For more information about what is a valid rational string,
    * see GMP's documentation for mpq_set_str().
    */
-  explicit Rational(const char* s, unsigned base = 10): d_value(s, base) {
-    d_value.canonicalize();
+  explicit Rational(const char* s, unsigned base = 10) :
+    d_num(0), d_den(1), d_big(NULL) {
+    setValue(mpq_class(s, base));
   }
-  Rational(const std::string& s, unsigned base = 10) : d_value(s, base) {
-    d_value.canonicalize();
+  Rational(const std::string& s, unsigned base = 10) :
+    d_num(0), d_den(1), d_big(NULL) {
+    setValue(mpq_class(s, base));
   }
 
   /**
    * Creates a Rational from another Rational, q, by performing a deep copy.
    */
-  Rational(const Rational& q) : d_value(q.d_value) {
-    d_value.canonicalize();
+  Rational(const Rational& q) :
+    d_num(q.d_num),
+    d_den(q.d_den),
+    d_big(q.isSmall() ? NULL : new mpq_class(*q.d_big)) {
+  }
+
+  Rational(Rational&& q) : d_num(q.d_num), d_den(q.d_den), d_big(q.d_big) {
+    q.d_num = 0;
+    q.d_den = 1;
+    q.d_big = NULL;
   }
 
   /**
    * Constructs a canonical Rational from a numerator.
    */
-  Rational(signed int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(signed int n) : d_num(n), d_den(1), d_big(NULL) {}
+  Rational(unsigned int n) : d_num(n), d_den(1), d_big(NULL) {}
+  Rational(signed long int n) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, 1);
   }
-  Rational(unsigned int n) : d_value(n,1) {
-    d_value.canonicalize();
-  }
-  Rational(signed long int n) : d_value(n,1) {
-    d_value.canonicalize();
-  }
-  Rational(unsigned long int n) : d_value(n,1) {
-    d_value.canonicalize();
+  Rational(unsigned long int n) : d_num(0), d_den(1), d_big(NULL) {
+    setValue(mpq_class(n, 1));
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n) : d_value(static_cast<long>(n), 1) {
-    d_value.canonicalize();
+  Rational(int64_t n) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, 1);
   }
-  Rational(uint64_t n) : d_value(static_cast<unsigned long>(n), 1) {
-    d_value.canonicalize();
+  Rational(uint64_t n) : d_num(0), d_den(1), d_big(NULL) {
+    setCanonical(Integer(n).get_mpz());
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   /**
    * Constructs a canonical Rational from a numerator and denominator.
    */
-  Rational(signed int n, signed int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(signed int n, signed int d) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(unsigned int n, unsigned int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(unsigned int n, unsigned int d) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(signed long int n, signed long int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(signed long int n, signed long int d) :
+    d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(unsigned long int n, unsigned long int d) : d_value(n,d) {
-    d_value.canonicalize();
+  Rational(unsigned long int n, unsigned long int d) :
+    d_num(0), d_den(1), d_big(NULL) {
+    setValue(mpq_class(n, d));
   }
 
 #ifdef CVC4_NEED_INT64_T_OVERLOADS
-  Rational(int64_t n, int64_t d) : d_value(static_cast<long>(n), static_cast<long>(d)) {
-    d_value.canonicalize();
+  Rational(int64_t n, int64_t d) : d_num(0), d_den(1), d_big(NULL) {
+    setSmall(n, d);
   }
-  Rational(uint64_t n, uint64_t d) : d_value(static_cast<unsigned long>(n), static_cast<unsigned long>(d)) {
-    d_value.canonicalize();
+  Rational(uint64_t n, uint64_t d) : d_num(0), d_den(1), d_big(NULL) {
+    setValue(mpq_class(Integer(n).get_mpz(), Integer(d).get_mpz()));
   }
 #endif /* CVC4_NEED_INT64_T_OVERLOADS */
 
   Rational(const Integer& n, const Integer& d) :
-    d_value(n.get_mpz(), d.get_mpz())
+    d_num(0), d_den(1), d_big(NULL)
   {
-    d_value.canonicalize();
+    if(n.isSmall() && d.isSmall() && d.d_small != 0) {
+      setSmall(n.d_small, d.d_small);
+    } else {
+      setValue(mpq_class(n.get_mpz(), d.get_mpz()));
+    }
   }
   Rational(const Integer& n) :
-    d_value(n.get_mpz())
+    d_num(n.d_small), d_den(1), d_big(NULL)
   {
-    d_value.canonicalize();
+    if(!n.isSmall()) {
+      d_big = new mpq_class(n.get_mpz());
+    }
   }
-  ~Rational() {}
+  ~Rational() { delete d_big; }
 
   /**
-   * Returns a copy of d_value to enable public access of GMP data.
+   * Returns a copy of the value to enable public access of GMP data.
    */
   mpq_class getValue() const
   {
-    return d_value;
+    return get_mpq();
   }
 
   /**
@@ -178,7 +259,10 @@ public:
    * Note that this makes a deep copy of the numerator.
    */
   Integer getNumerator() const {
-    return Integer(d_value.get_num());
+    if(isSmall()) {
+      return Integer::fromSmall(d_num);
+    }
+    return Integer(d_big->get_num());
   }
 
   /**
@@ -186,7 +270,10 @@ public:
    * Note that this makes a deep copy of the denominator.
    */
   Integer getDenominator() const {
-    return Integer(d_value.get_den());
+    if(isSmall()) {
+      return Integer::fromSmall(d_den);
+    }
+    return Integer(d_big->get_den());
   }
 
   static Maybe<Rational> fromDouble(double d);
@@ -197,33 +284,47 @@ public:
    * infinity, and underflow may result in zero.
    */
   double getDouble() const {
-    return d_value.get_d();
+    if(isSmall() && d_den == 1 && small_arith::abs(d_num) <= (int64_t(1) << 53)) {
+      // exactly representable
+      return double(d_num);
+    }
+    return get_mpq().get_d();
   }
 
   Rational inverse() const {
+    if(isSmall() && d_num != 0) {
+      return d_num < 0 ? Rational(-d_den, -d_num, true)
+                       : Rational(d_den, d_num, true);
+    }
     return Rational(getDenominator(), getNumerator());
   }
 
   int cmp(const Rational& x) const {
-    //Don't use mpq_class's cmp() function.
-    //The name ends up conflicting with this function.
-    return mpq_cmp(d_value.get_mpq_t(), x.d_value.get_mpq_t());
+    int c;
+    if(isSmall() && x.isSmall() &&
+       small_arith::ratCmp(d_num, d_den, x.d_num, x.d_den, c)) {
+      return c;
+    }
+    return cmpBig(x);
   }
 
   int sgn() const {
-    return mpq_sgn(d_value.get_mpq_t());
+    if(isSmall()) {
+      return (d_num > 0) - (d_num < 0);
+    }
+    return mpq_sgn(d_big->get_mpq_t());
   }
 
   bool isZero() const {
-    return sgn() == 0;
+    return isSmall() && d_num == 0;
   }
 
   bool isOne() const {
-    return mpq_cmp_si(d_value.get_mpq_t(), 1, 1) == 0;
+    return isSmall() && d_num == 1 && d_den == 1;
   }
 
   bool isNegativeOne() const {
-    return mpq_cmp_si(d_value.get_mpq_t(), -1, 1) == 0;
+    return isSmall() && d_num == -1 && d_den == 1;
   }
 
   Rational abs() const {
@@ -235,14 +336,22 @@ public:
   }
 
   Integer floor() const {
+    if(isSmall()) {
+      int64_t q = d_num / d_den;
+      return Integer::fromSmall(d_num % d_den < 0 ? q - 1 : q);
+    }
     mpz_class q;
-    mpz_fdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_fdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
   Integer ceiling() const {
+    if(isSmall()) {
+      int64_t q = d_num / d_den;
+      return Integer::fromSmall(d_num % d_den > 0 ? q + 1 : q);
+    }
     mpz_class q;
-    mpz_cdiv_q(q.get_mpz_t(), d_value.get_num_mpz_t(), d_value.get_den_mpz_t());
+    mpz_cdiv_q(q.get_mpz_t(), d_big->get_num_mpz_t(), d_big->get_den_mpz_t());
     return Integer(q);
   }
 
@@ -252,78 +361,152 @@ public:
 
   Rational& operator=(const Rational& x){
     if(this == &x) return *this;
-    d_value = x.d_value;
+    if(x.isSmall()) {
+      delete d_big;
+      d_big = NULL;
+      d_num = x.d_num;
+      d_den = x.d_den;
+    } else if(isSmall()) {
+      d_big = new mpq_class(*x.d_big);
+    } else {
+      *d_big = *x.d_big;
+    }
+    return *this;
+  }
+
+  Rational& operator=(Rational&& x){
+    if(this == &x) return *this;
+    std::swap(d_num, x.d_num);
+    std::swap(d_den, x.d_den);
+    std::swap(d_big, x.d_big);
     return *this;
   }
 
   Rational operator-() const{
-    return Rational(-(d_value));
+    if(isSmall()) {
+      return Rational(-d_num, d_den, true);
+    }
+    return Rational(-(*d_big));
   }
 
   bool operator==(const Rational& y) const {
-    return d_value == y.d_value;
+    if(isSmall() || y.isSmall()) {
+      return isSmall() && y.isSmall() && d_num == y.d_num && d_den == y.d_den;
+    }
+    return *d_big == *y.d_big;
   }
 
   bool operator!=(const Rational& y) const {
-    return d_value != y.d_value;
+    return !(*this == y);
   }
 
   bool operator< (const Rational& y) const {
-    return d_value < y.d_value;
+    return cmp(y) < 0;
   }
 
   bool operator<=(const Rational& y) const {
-    return d_value <= y.d_value;
+    return cmp(y) <= 0;
   }
 
   bool operator> (const Rational& y) const {
-    return d_value > y.d_value;
+    return cmp(y) > 0;
   }
 
   bool operator>=(const Rational& y) const {
-    return d_value >= y.d_value;
+    return cmp(y) >= 0;
   }
 
   Rational operator+(const Rational& y) const{
-    return Rational( d_value + y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return addBig(y);
   }
   Rational operator-(const Rational& y) const {
-    return Rational( d_value - y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, -y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return subBig(y);
   }
 
   Rational operator*(const Rational& y) const {
-    return Rational( d_value * y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratMul(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return mulBig(y);
   }
   Rational operator/(const Rational& y) const {
-    return Rational( d_value / y.d_value );
+    int64_t n, d;
+    if(isSmall() && y.isSmall() && y.d_num != 0 &&
+       small_arith::ratDiv(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      return Rational(n, d, true);
+    }
+    return divBig(y);
   }
 
   Rational& operator+=(const Rational& y){
-    d_value += y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = addBig(y);
   }
   Rational& operator-=(const Rational& y){
-    d_value -= y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratAdd(d_num, d_den, -y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = subBig(y);
   }
 
   Rational& operator*=(const Rational& y){
-    d_value *= y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() &&
+       small_arith::ratMul(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = mulBig(y);
   }
 
   Rational& operator/=(const Rational& y){
-    d_value /= y.d_value;
-    return (*this);
+    int64_t n, d;
+    if(isSmall() && y.isSmall() && y.d_num != 0 &&
+       small_arith::ratDiv(d_num, d_den, y.d_num, y.d_den, n, d)) {
+      d_num = n;
+      d_den = d;
+      return (*this);
+    }
+    return (*this) = divBig(y);
   }
 
   bool isIntegral() const{
-    return getDenominator() == 1;
+    if(isSmall()) {
+      return d_den == 1;
+    }
+    return mpz_cmp_ui(d_big->get_den_mpz_t(), 1) == 0;
   }
 
   /** Returns a string representing the rational in the given base. */
   std::string toString(int base = 10) const {
-    return d_value.get_str(base);
+    if(isSmall() && base == 10) {
+      return d_den == 1 ? std::to_string(d_num)
+                        : std::to_string(d_num) + "/" + std::to_string(d_den);
+    }
+    return get_mpq().get_str(base);
   }
 
   /**
@@ -331,8 +514,13 @@ public:
    * denominator.
    */
   size_t hash() const {
-    size_t numeratorHash = gmpz_hash(d_value.get_num_mpz_t());
-    size_t denominatorHash = gmpz_hash(d_value.get_den_mpz_t());
+    if(isSmall()) {
+      // agrees with gmpz_hash() on one-limb values
+      return size_t(small_arith::abs(d_num)) xor size_t(d_den);
+    }
+
+    size_t numeratorHash = gmpz_hash(d_big->get_num_mpz_t());
+    size_t denominatorHash = gmpz_hash(d_big->get_den_mpz_t());
 
     return numeratorHash xor denominatorHash;
   }
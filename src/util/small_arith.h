@@ -0,0 +1,145 @@
+/*********************                                                        */
+/*! \file small_arith.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Overflow-checked machine arithmetic for small Integers and
+ ** Rationals.
+ **
+ ** Overflow-checked machine arithmetic backing the small-value
+ ** representation of Integer and Rational.  A small value is an int64_t
+ ** in the symmetric range [-INT64_MAX, INT64_MAX], so that negation and
+ ** absolute value never overflow; a small rational is a pair of small
+ ** values n/d with d > 0 and gcd(|n|, d) = 1.  Every operation returns
+ ** false, leaving its outputs unspecified, when the result does not fit,
+ ** in which case the caller redoes the operation in multiprecision.
+ **/
+
+#include "cvc4_public.h"
+
+#ifndef __CVC4__SMALL_ARITH_H
+#define __CVC4__SMALL_ARITH_H
+
+#include <stdint.h>
+
+namespace CVC4 {
+namespace small_arith {
+
+/** The largest small value; the smallest one is -kMax. */
+static const int64_t kMax = INT64_MAX;
+
+/** Returns true if x is in the small range. */
+inline bool fits(int64_t x) { return x != INT64_MIN; }
+
+inline bool add(int64_t a, int64_t b, int64_t& r) {
+  return !__builtin_add_overflow(a, b, &r) && fits(r);
+}
+
+inline bool sub(int64_t a, int64_t b, int64_t& r) {
+  return !__builtin_sub_overflow(a, b, &r) && fits(r);
+}
+
+inline bool mul(int64_t a, int64_t b, int64_t& r) {
+  return !__builtin_mul_overflow(a, b, &r) && fits(r);
+}
+
+/** The gcd of two non-negative values; gcd(0, 0) = 0. */
+inline int64_t gcd(int64_t a, int64_t b) {
+  while(b != 0) {
+    int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+inline int64_t abs(int64_t a) { return a < 0 ? -a : a; }
+
+/**
+ * Sets rn/rd to the canonical form of n/d, for d != 0.  This is the only
+ * operation accepting INT64_MIN (for which it fails).
+ */
+inline bool canonicalize(int64_t n, int64_t d, int64_t& rn, int64_t& rd) {
+  if(!fits(n) || !fits(d)) {
+    return false;
+  }
+  if(d < 0) {
+    n = -n;
+    d = -d;
+  }
+  int64_t g = gcd(abs(n), d);
+  rn = n / g;
+  rd = d / g;
+  return true;
+}
+
+/** rn/rd = an/ad + bn/bd, following Knuth (TAOCP 4.5.1). */
+inline bool ratAdd(int64_t an, int64_t ad, int64_t bn, int64_t bd,
+                   int64_t& rn, int64_t& rd) {
+  if(ad == 1 && bd == 1) {
+    rd = 1;
+    return add(an, bn, rn);
+  }
+  int64_t g = gcd(ad, bd);
+  if(g == 1) {
+    int64_t x, y;
+    return mul(an, bd, x) && mul(bn, ad, y) && add(x, y, rn) &&
+      mul(ad, bd, rd);
+  }
+  int64_t x, y, t;
+  if(!(mul(an, bd / g, x) && mul(bn, ad / g, y) && add(x, y, t))) {
+    return false;
+  }
+  int64_t g2 = gcd(abs(t), g);
+  rn = t / g2;
+  return mul(ad / g, bd / g2, rd);
+}
+
+/** rn/rd = an/ad * bn/bd. */
+inline bool ratMul(int64_t an, int64_t ad, int64_t bn, int64_t bd,
+                   int64_t& rn, int64_t& rd) {
+  if(an == 0 || bn == 0) {
+    rn = 0;
+    rd = 1;
+    return true;
+  }
+  int64_t g1 = gcd(abs(an), bd);
+  int64_t g2 = gcd(abs(bn), ad);
+  return mul(an / g1, bn / g2, rn) && mul(ad / g2, bd / g1, rd);
+}
+
+/** rn/rd = (an/ad) / (bn/bd), for bn != 0. */
+inline bool ratDiv(int64_t an, int64_t ad, int64_t bn, int64_t bd,
+                   int64_t& rn, int64_t& rd) {
+  return bn < 0 ? ratMul(an, ad, -bd, -bn, rn, rd)
+                : ratMul(an, ad, bd, bn, rn, rd);
+}
+
+/** Sets c to the sign of an/ad - bn/bd. */
+inline bool ratCmp(int64_t an, int64_t ad, int64_t bn, int64_t bd, int& c) {
+  int sa = (an > 0) - (an < 0), sb = (bn > 0) - (bn < 0);
+  if(sa != sb) {
+    c = sa < sb ? -1 : 1;
+    return true;
+  }
+  int64_t x, y;
+  if(ad == bd) {
+    x = an;
+    y = bn;
+  } else if(!(mul(an, bd, x) && mul(bn, ad, y))) {
+    return false;
+  }
+  c = x < y ? -1 : (x == y ? 0 : 1);
+  return true;
+}
+
+}/* CVC4::small_arith namespace */
+}/* CVC4 namespace */
+
+#endif /* __CVC4__SMALL_ARITH_H */
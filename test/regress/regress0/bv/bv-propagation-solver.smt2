@@ -0,0 +1,28 @@
+; COMMAND-LINE: --incremental --bv-propagation-solver
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 64))
+(declare-fun y () (_ BitVec 64))
+(declare-fun z () (_ BitVec 64))
+(declare-fun q () (_ BitVec 64))
+(assert (= x #x00000000deadbeef))
+(assert (= y #x0000000000012345))
+(assert (= z (bvmul x y)))
+(assert (= q (bvudiv z y)))
+(check-sat)
+(push 1)
+(assert (not (= q x)))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (bvult (bvand z #x000000000000ffff) (bvlshr y #x0000000000000001)))
+(assert (= ((_ extract 3 0) (bvadd q #x0000000000000001)) #x1))
+(check-sat)
+(pop 1)
+(declare-fun w () (_ BitVec 8))
+(assert (bvult w ((_ extract 7 0) y)))
+(assert (bvugt w #x40))
+(check-sat)
@@ -0,0 +1,22 @@
+; COMMAND-LINE: --incremental --bv-sls-solver
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 32))
+(declare-fun y () (_ BitVec 32))
+(declare-fun z () (_ BitVec 32))
+(assert (= (bvadd x y) #x12345678))
+(assert (= (bvxor x z) #xdeadbeef))
+(assert (bvult #x00001000 x))
+(assert (bvslt z #x00000000))
+(assert (not (= y #x00000000)))
+(assert (bvule (bvand y #x000000ff) #x00000010))
+(assert (= ((_ extract 31 24) (bvmul x #x00000003)) #x2a))
+(check-sat)
+(push 1)
+(assert (bvult x #x00000800))
+(check-sat)
+(pop 1)
+(assert (not (= (bvlshr z #x0000001c) #x0000000f)))
+(check-sat)
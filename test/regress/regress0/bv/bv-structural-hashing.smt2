@@ -0,0 +1,13 @@
+; COMMAND-LINE: --bv-structural-hashing --bv-mult=wallace
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 12))
+(declare-fun y () (_ BitVec 12))
+(declare-fun z () (_ BitVec 12))
+(assert (not (= y #x000)))
+(assert (or
+  (not (= (bvmul x y) (bvmul y x)))
+  (not (= (bvmul (bvmul x y) z) (bvmul x (bvmul y z))))
+  (not (= x (bvadd (bvmul (bvudiv x y) y) (bvurem x y))))
+  (not (= (bvmul x #x003) (bvadd x (bvshl x #x001))))))
+(check-sat)
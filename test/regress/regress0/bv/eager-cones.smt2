@@ -0,0 +1,17 @@
+; COMMAND-LINE: --bitblast=eager
+; EXPECT: unsat
+(set-logic QF_BV)
+(declare-fun a () (_ BitVec 16))
+(declare-fun b () (_ BitVec 16))
+(declare-fun c () (_ BitVec 16))
+(declare-fun d () (_ BitVec 16))
+(declare-fun e () (_ BitVec 16))
+(declare-fun f () (_ BitVec 16))
+(declare-fun p () Bool)
+(assert (= (bvmul a b) #x0f0f))
+(assert (bvult a #x0100))
+(assert (and (= (bvadd c d) #x1234) (bvult c d)))
+(assert (or p (= ((_ extract 3 0) e) #xa)))
+(assert (ite p (bvslt e f) (= f #x0000)))
+(assert (= (bvmul c c) #x0f0f))
+(check-sat)
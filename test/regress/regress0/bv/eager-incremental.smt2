@@ -0,0 +1,25 @@
+; COMMAND-LINE: --incremental --bitblast=eager
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_BV)
+(declare-fun x () (_ BitVec 16))
+(declare-fun y () (_ BitVec 16))
+(assert (= (bvmul x y) #x0f0f))
+(check-sat)
+(push 1)
+(assert (= x #x0000))
+(check-sat)
+(pop 1)
+(push 1)
+(assert (bvult x #x0100))
+(check-sat)
+(push 1)
+(assert (= x y))
+(check-sat)
+(pop 1)
+(pop 1)
+(assert (= x #x0001))
+(check-sat)
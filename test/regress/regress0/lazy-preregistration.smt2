@@ -0,0 +1,20 @@
+; COMMAND-LINE: --incremental --lazy-preregistration --watch-theory-checks
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_UFLIA)
+(declare-fun f (Int) Int)
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (or (< x 0) (> (f x) 10) (= y (+ x 1))))
+(assert (or (> x 5) (= (f y) z)))
+(assert (=> (> z 100) (and (< y 0) (> y 10))))
+(assert (or (= (f z) (f (+ z 1))) (< (f z) x) (> (f (+ z 2)) y)))
+(check-sat)
+(push 1)
+(assert (> z 100))
+(check-sat)
+(pop 1)
+(assert (= x 3))
+(check-sat)
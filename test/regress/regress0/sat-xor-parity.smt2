@@ -0,0 +1,26 @@
+; COMMAND-LINE: --incremental --sat-xor
+; EXPECT: sat
+; EXPECT: unsat
+; EXPECT: sat
+(set-logic QF_UFLIA)
+(declare-fun a () Bool)
+(declare-fun b () Bool)
+(declare-fun c () Bool)
+(declare-fun d () Bool)
+(declare-fun e () Bool)
+(declare-fun f () Bool)
+(declare-fun g () Bool)
+(declare-fun h () Bool)
+(declare-fun x () Int)
+(assert (xor a (xor b (xor c (xor d (xor e (xor f (xor g h))))))))
+(assert (= a (> x 0)))
+(assert (= h (< x 0)))
+(check-sat)
+(push 1)
+; the same parity, in another order, the other way
+(assert (not (xor (xor h g) (xor (xor f e) (xor (xor d c) (xor b a))))))
+(check-sat)
+(pop 1)
+(assert (= b (xor c d)))
+(assert (= e (= f g)))
+(check-sat)
@@ -0,0 +1,23 @@
+; COMMAND-LINE: --cnf-aig --decision=justification --simplification=none
+; EXPECT: sat
+(set-logic QF_UF)
+(set-info :status sat)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun d () U)
+(declare-fun p () Bool)
+(declare-fun q () Bool)
+
+; in the and-inverter graph, the disjunction folds to true and the
+; conjunction to (= (f a) (f c)); their atoms are left without a gate
+(assert (and (or (and (= a b) (not (= c d))) (=> (= a b) (= c d)))
+             (= (f a) (f c))))
+; the conjunction folds to false
+(assert (or (= (f b) (f c)) (and (=> (= b c) p) (not (=> (= b c) p)))))
+; an if-then-else gate
+(assert (or (and p (=> q (= a c))) (and (= b d) (not (=> q (= a c))))))
+(assert (ite p (not (= (f b) (f d))) (xor q (= a d))))
+(check-sat)
@@ -0,0 +1,20 @@
+; COMMAND-LINE: --cnf-aig --decision=justification --simplification=none
+; EXPECT: unsat
+(set-logic QF_UF)
+(set-info :status unsat)
+(declare-sort U 0)
+(declare-fun f (U) U)
+(declare-fun a () U)
+(declare-fun b () U)
+(declare-fun c () U)
+(declare-fun d () U)
+(declare-fun p () Bool)
+
+; in the and-inverter graph, the disjunction folds to true and the
+; conjunction to false; their atoms are left without a gate
+(assert (or (and (= a b) (not (= c d))) (=> (= a b) (= c d))))
+(assert (or (= (f b) (f c)) (and (=> (= b c) p) (not (=> (= b c) p)))))
+(assert (and (=> p (= (f a) (f b))) (=> (not p) (= (f a) (f c)))))
+(assert (not (= (f a) (f b))))
+(assert (or (not (= (f a) (f c))) (and (= a d) (not (= a d)))))
+(check-sat)
@@ -0,0 +1,192 @@
+/*********************                                                        */
+/*! \file cdflat_hashmap_black.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Black box testing of CVC4::context::CDFlatHashMap<>.
+ **
+ ** Black box testing of CVC4::context::CDFlatHashMap<>.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <map>
+
+#include "base/cvc4_assert.h"
+#include "context/cdflat_hashmap.h"
+#include "context/cdhashmap.h"
+#include "context/cdinsert_hashmap.h"
+#include "context/cdtrail_hashmap.h"
+#include "context/context.h"
+
+using namespace std;
+using CVC4::AssertionException;
+using CVC4::context::Context;
+using CVC4::context::CDFlatHashMap;
+using CVC4::context::CDHashMap;
+using CVC4::context::CDInsertHashMap;
+using CVC4::context::CDTrailHashMap;
+
+class CDFlatHashMapBlack : public CxxTest::TestSuite {
+  Context* d_context;
+
+  /** A tiny linear congruential generator, for reproducible workloads. */
+  static unsigned next(unsigned& seed) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+  }
+
+ public:
+  void setUp() { d_context = new Context; }
+
+  void tearDown() { delete d_context; }
+
+  // Returns true if the elements in map are the same as expected.
+  static bool ElementsAre(const CDFlatHashMap<int, int>& map,
+                          const std::map<int, int>& expected) {
+    return std::map<int, int>(map.begin(), map.end()) == expected;
+  }
+
+  void testSimpleSequence() {
+    CDFlatHashMap<int, int> map(d_context);
+    TS_ASSERT(ElementsAre(map, {}));
+
+    map.insert(3, 4);
+    TS_ASSERT(ElementsAre(map, {{3, 4}}));
+
+    d_context->push();
+    map.insert(5, 6);
+    map.insert(9, 8);
+    TS_ASSERT(ElementsAre(map, {{3, 4}, {5, 6}, {9, 8}}));
+
+    d_context->push();
+    map.insert(1, 2);
+    map[3] = 7;
+    map[5] = 0;
+    TS_ASSERT(ElementsAre(map, {{1, 2}, {3, 7}, {5, 0}, {9, 8}}));
+    TS_ASSERT_EQUALS(map.size(), 4u);
+    TS_ASSERT_EQUALS((*map.find(3)).second, 7);
+    TS_ASSERT_EQUALS(map.find(1)->second, 2);
+    TS_ASSERT(map.find(10) == map.end());
+
+    d_context->pop();
+    TS_ASSERT(ElementsAre(map, {{3, 4}, {5, 6}, {9, 8}}));
+    TS_ASSERT_EQUALS(map.count(1), 0u);
+
+    d_context->pop();
+    TS_ASSERT(ElementsAre(map, {{3, 4}}));
+    TS_ASSERT_EQUALS(map[3].get(), 4);
+  }
+
+  void testInsertAtContextLevelZero() {
+    CDFlatHashMap<int, int> map(d_context);
+    map.insert(3, 4);
+
+    d_context->push();
+    map.insert(5, 6);
+    map.insertAtContextLevelZero(23, 317);
+    map.insert(23, 324);
+    TS_ASSERT(ElementsAre(map, {{3, 4}, {5, 6}, {23, 324}}));
+    TS_ASSERT_THROWS(map.insertAtContextLevelZero(23, 0), AssertionException);
+    TS_ASSERT_THROWS(map.insertAtContextLevelZero(3, 0), AssertionException);
+
+    d_context->pop();
+    TS_ASSERT(ElementsAre(map, {{3, 4}, {23, 317}}));
+  }
+
+  // Returns the elements in a CDHashMap.
+  static std::map<int, int> GetElements(const CDHashMap<int, int>& map) {
+    std::map<int, int> elements;
+    for(CDHashMap<int, int>::iterator i = map.begin(); i != map.end(); ++i) {
+      elements.insert(*i);
+    }
+    return elements;
+  }
+
+  void testAgreesWithCDHashMap() {
+    // a random walk of pushes, pops, insertions and overwrites
+    CDFlatHashMap<int, int> flat(d_context);
+    CDHashMap<int, int> reference(d_context);
+    unsigned seed = 7;
+    for(unsigned step = 0; step < 20000; ++step) {
+      unsigned r = next(seed) % 16;
+      if(r == 0 && d_context->getLevel() < 30) {
+        d_context->push();
+      } else if(r == 1 && d_context->getLevel() > 0) {
+        d_context->pop();
+      } else if(r == 2) {
+        int k = 1000 + step;
+        flat.insertAtContextLevelZero(k, step);
+        reference.insertAtContextLevelZero(k, step);
+      } else {
+        int k = next(seed) % 500;
+        flat.insert(k, step);
+        reference.insert(k, step);
+      }
+      if(step % 64 == 0) {
+        TS_ASSERT(ElementsAre(flat, GetElements(reference)));
+      }
+    }
+    d_context->popto(0);
+    TS_ASSERT(ElementsAre(flat, GetElements(reference)));
+  }
+
+  /**
+   * Runs a search-like workload on a map M: descend numLevels levels,
+   * inserting insertsPerLevel fresh keys and looking up as many at each,
+   * then backtrack a random number of levels, numRounds times.  Counts
+   * the lookups that hit in hits.
+   */
+  template <class M>
+  void runWorkload(unsigned numRounds, unsigned numLevels,
+                   unsigned insertsPerLevel, unsigned& hits) {
+    M map(d_context);
+    unsigned seed = 11;
+    int fresh = 0;
+    for(unsigned r = 0; r < numRounds; ++r) {
+      while(d_context->getLevel() < int(numLevels)) {
+        d_context->push();
+        for(unsigned i = 0; i < insertsPerLevel; ++i) {
+          map.insert(fresh++, i);
+          hits += map.contains(next(seed) % fresh);
+        }
+      }
+      d_context->popto(next(seed) % numLevels);
+    }
+    d_context->popto(0);
+  }
+
+  void testSameLookupsAsOtherMaps() {
+    const unsigned numRounds = 500;
+    const unsigned numLevels = 40;
+    const unsigned insertsPerLevel = 20;
+
+    unsigned flatHits = 0, hashHits = 0, insertHits = 0, trailHits = 0;
+    runWorkload<ContainsAdapter<CDFlatHashMap<int, int> > >(
+        numRounds, numLevels, insertsPerLevel, flatHits);
+    runWorkload<ContainsAdapter<CDHashMap<int, int> > >(
+        numRounds, numLevels, insertsPerLevel, hashHits);
+    runWorkload<CDInsertHashMap<int, int> >(
+        numRounds, numLevels, insertsPerLevel, insertHits);
+    runWorkload<CDTrailHashMap<int, int> >(
+        numRounds, numLevels, insertsPerLevel, trailHits);
+    TS_ASSERT(flatHits > 0);
+    TS_ASSERT_EQUALS(flatHits, hashHits);
+    TS_ASSERT_EQUALS(flatHits, insertHits);
+    TS_ASSERT_EQUALS(flatHits, trailHits);
+  }
+
+  /** Gives the maps without contains() the interface of the others. */
+  template <class M>
+  class ContainsAdapter : public M {
+   public:
+    ContainsAdapter(Context* c) : M(c) {}
+    bool contains(int k) const { return M::count(k) > 0; }
+  };
+};
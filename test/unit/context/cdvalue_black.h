@@ -0,0 +1,125 @@
+/*********************                                                        */
+/*! \file cdvalue_black.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief Black box testing of CVC4::context::CDValue<>.
+ **
+ ** Black box testing of CVC4::context::CDValue<>.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <deque>
+#include <memory>
+
+#include "context/cdo.h"
+#include "context/cdvalue.h"
+#include "context/context.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::context;
+
+class CDValueBlack : public CxxTest::TestSuite {
+private:
+
+  Context* d_context;
+
+public:
+
+  void setUp() {
+    d_context = new Context;
+  }
+
+  void tearDown() {
+    delete d_context;
+  }
+
+  void testIntCDValue() {
+    // Test that push/pop maintains the original value
+    CDValue<int> a1(d_context);
+    TS_ASSERT_EQUALS(a1.get(), 0);
+    a1 = 5;
+    d_context->push();
+    a1 = 10;
+    a1 = 11;
+    TS_ASSERT_EQUALS(a1.get(), 11);
+    d_context->push();
+    d_context->push();
+    a1 = -3;
+    d_context->pop();
+    TS_ASSERT_EQUALS(a1.get(), 11);
+    d_context->pop();
+    TS_ASSERT_EQUALS(a1.get(), 11);
+    d_context->pop();
+    TS_ASSERT_EQUALS(a1.get(), 5);
+
+    // the same level again, in a new Scope
+    d_context->push();
+    a1 = 7;
+    d_context->pop();
+    TS_ASSERT_EQUALS(a1.get(), 5);
+  }
+
+  void testCreatedAboveBottom() {
+    CDValue<bool> b(d_context);
+    d_context->push();
+    CDValue<unsigned> u(d_context, 42);
+    b = true;
+    TS_ASSERT(b);
+    TS_ASSERT_EQUALS(u.get(), 42u);
+    d_context->pop();
+    // like a CDO<>, the bottom Scope holds T()
+    TS_ASSERT(!b);
+    TS_ASSERT_EQUALS(u.get(), 0u);
+  }
+
+  void testDestroyedWhileLogged() {
+    d_context->push();
+    {
+      unique_ptr<CDValue<size_t> > v(new CDValue<size_t>(d_context));
+      *v = 3;
+      d_context->push();
+      *v = 4;
+    }
+    // popping must not touch the destroyed value
+    d_context->pop();
+    d_context->pop();
+  }
+
+  void testAgreesWithCDO() {
+    // a random walk of pushes, pops and writes
+    const unsigned n = 16;
+    deque<CDO<int> > cdos;
+    deque<CDValue<int> > values;
+    for(unsigned i = 0; i < n; ++i) {
+      cdos.emplace_back(d_context);
+      values.emplace_back(d_context);
+    }
+    unsigned seed = 1;
+    for(unsigned step = 0; step < 10000; ++step) {
+      seed = seed * 1103515245 + 12345;
+      unsigned r = (seed >> 16) % 8;
+      if(r == 0 && d_context->getLevel() < 20) {
+        d_context->push();
+      } else if(r == 1 && d_context->getLevel() > 0) {
+        d_context->pop();
+      } else {
+        unsigned i = (seed >> 8) % n;
+        cdos[i].set(step);
+        values[i].set(step);
+      }
+      for(unsigned i = 0; i < n; ++i) {
+        TS_ASSERT_EQUALS(cdos[i].get(), values[i].get());
+      }
+    }
+    d_context->popto(0);
+  }
+};
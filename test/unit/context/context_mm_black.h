@@ -96,6 +96,71 @@ public:
 #endif /* __CVC4__CONTEXT__CONTEXT_MM_H */
   }
 
+  void testHugeAllocation() {
+#ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
+    // Requests bigger than a chunk get a chunk of their own
+    const size_t len = 5 * 16384 + 17;
+    d_cmm->push();
+    char* small = (char*)d_cmm->newData(100);
+    char* big = (char*)d_cmm->newData(len);
+    memset(big, 'b', len);
+    char* small2 = (char*)d_cmm->newData(100);
+    // the shared chunk is still in use
+    TS_ASSERT_EQUALS(small2, small + 100);
+    TS_ASSERT_EQUALS(d_cmm->getStatistics().d_hugeAllocations, 1u);
+    d_cmm->pop();
+
+    // a huge chunk of the popped region is reused
+    uint64_t allocated = d_cmm->getStatistics().d_chunksAllocated;
+    d_cmm->push();
+    TS_ASSERT_EQUALS((char*)d_cmm->newData(len - 1000), big);
+    TS_ASSERT_EQUALS(d_cmm->getStatistics().d_chunksAllocated, allocated);
+    d_cmm->pop();
+#endif /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
+  }
+
+  void testRetention() {
+#ifndef CVC4_DEBUG_CONTEXT_MEMORY_MANAGER
+    // A deep region followed by repeated backtracking: after the first
+    // round, every chunk comes from the free list
+    const unsigned rounds = 10;
+    const unsigned perLevel = 64 * 1024;
+    for(unsigned r = 0; r < rounds; ++r) {
+      uint64_t allocated = d_cmm->getStatistics().d_chunksAllocated;
+      uint64_t reused = d_cmm->getStatistics().d_chunksReused;
+      for(unsigned level = 0; level < 50; ++level) {
+        d_cmm->push();
+        for(unsigned i = 0; i < perLevel / 512; ++i) {
+          d_cmm->newData(512);
+        }
+      }
+      if(r > 0) {
+        TS_ASSERT_EQUALS(d_cmm->getStatistics().d_chunksAllocated,
+                         allocated);
+        TS_ASSERT(d_cmm->getStatistics().d_chunksReused > reused);
+      }
+      for(unsigned level = 0; level < 50; ++level) {
+        d_cmm->pop();
+      }
+      if(r == 0) {
+        // more than the default retention, but what the levels needed
+        TS_ASSERT(d_cmm->getRetainedBytes() > 100 * 16384);
+      }
+    }
+    TS_ASSERT_EQUALS(d_cmm->getStatistics().d_chunksFreed, 0u);
+
+    // an explicit limit takes precedence over the high-water marks
+    d_cmm->setMaxRetainedBytes(0);
+    d_cmm->push();
+    d_cmm->newData(512);
+    d_cmm->pop();
+    TS_ASSERT(d_cmm->getRetainedBytes() <= 100 * 16384);
+    TS_ASSERT(d_cmm->getStatistics().d_chunksFreed > 0);
+    TS_ASSERT(d_cmm->getStatistics().d_bytesAllocated <
+              d_cmm->getStatistics().d_maxBytesAllocated);
+#endif /* CVC4_DEBUG_CONTEXT_MEMORY_MANAGER */
+  }
+
   void tearDown() {
     delete d_cmm;
   }
@@ -17,6 +17,7 @@
 #include <cxxtest/TestSuite.h>
 
 #include <string>
+#include <vector>
 
 #include "base/cvc4_assert.h"
 #include "expr/attribute.h"
@@ -53,6 +54,10 @@ typedef Attribute<Test3, bool> TestFlag3;
 typedef Attribute<Test4, bool> TestFlag4;
 typedef Attribute<Test5, bool> TestFlag5;
 
+typedef Attribute<Test1, Node> TestNodeAttr;
+typedef DenseAttribute<Test1, Node> TestDenseNodeAttr;
+typedef DenseAttribute<Test1, bool> TestDenseFlag;
+
 class AttributeWhite : public CxxTest::TestSuite {
 
   ExprManager* d_em;
@@ -134,8 +139,84 @@ public:
 //    TS_ASSERT_DIFFERS(theory::PostRewriteCache::s_id, theory::PostRewriteCacheTop::s_id);
 //    TS_ASSERT_DIFFERS(theory::PreRewriteCacheTop::s_id, theory::PostRewriteCacheTop::s_id);
 
-    lastId = attr::LastAttributeId<TypeNode, false>::getId();
+    lastId = attr::DenseAttributeTraits<TypeNode>::getCleanup().size();
     TS_ASSERT_LESS_THAN(TypeAttr::s_id, lastId);
+
+    lastId = attr::DenseAttributeTraits<bool>::getCleanup().size();
+    TS_ASSERT_LESS_THAN(TypeCheckedAttr::s_id, lastId);
+    TS_ASSERT_LESS_THAN(TestDenseFlag::s_id, lastId);
+    TS_ASSERT_DIFFERS(TypeCheckedAttr::s_id, TestDenseFlag::s_id);
+  }
+
+  void testDenseAttributes() {
+    AttributeManager& am = *d_nm->d_attrManager;
+    size_t initialNodes = am.d_denseNodes.size();
+    size_t initialBools = am.d_denseBools.size();
+
+    Node a = d_nm->mkVar(*d_booleanType);
+    Node* b = new Node(d_nm->mkVar(*d_booleanType));
+
+    TS_ASSERT(! a.hasAttribute(TestDenseNodeAttr()));
+    TS_ASSERT(a.getAttribute(TestDenseNodeAttr()).isNull());
+    TS_ASSERT(a.hasAttribute(TestDenseFlag()));
+    TS_ASSERT(! a.getAttribute(TestDenseFlag()));
+
+    a.setAttribute(TestDenseNodeAttr(), *b);
+    b->setAttribute(TestDenseNodeAttr(), Node::null());
+    b->setAttribute(TestDenseFlag(), true);
+
+    Node n;
+    TS_ASSERT(a.getAttribute(TestDenseNodeAttr(), n));
+    TS_ASSERT_EQUALS(n, *b);
+    TS_ASSERT(b->hasAttribute(TestDenseNodeAttr()));
+    TS_ASSERT(b->getAttribute(TestDenseNodeAttr()).isNull());
+    TS_ASSERT(b->getAttribute(TestDenseFlag()));
+    TS_ASSERT(! a.getAttribute(TestDenseFlag()));
+    TS_ASSERT(! a.hasAttribute(TestNodeAttr()));
+    TS_ASSERT_EQUALS(am.d_denseNodes.size(), initialNodes + 2);
+    TS_ASSERT_EQUALS(am.d_denseBools.size(), initialBools + 1);
+
+    b->setAttribute(TestDenseFlag(), false);
+    TS_ASSERT(! b->getAttribute(TestDenseFlag()));
+    TS_ASSERT_EQUALS(am.d_denseBools.size(), initialBools);
+
+    // b stays alive through a's attribute until that is deleted
+    NodeValue* bnv = b->d_nv;
+    delete b;
+    TS_ASSERT(d_nm->hasAttribute(bnv, TestDenseNodeAttr()));
+
+    std::vector<const AttributeUniqueId*> ids;
+    AttributeUniqueId id = AttributeManager::getAttributeId(TestDenseNodeAttr());
+    TS_ASSERT_EQUALS(id.getTableId(), AttrTableDenseNode);
+    ids.push_back(&id);
+    d_nm->deleteAttributes(ids);
+    TS_ASSERT(! a.hasAttribute(TestDenseNodeAttr()));
+    TS_ASSERT_EQUALS(am.d_denseNodes.size(), initialNodes);
+  }
+
+  void testDenseAndHashTablesAgree() {
+    // The same Node-valued attribute and flag on many Nodes, kept in the
+    // hash tables and in the dense tables
+    const unsigned numNodes = 10000;
+
+    vector<Node> nodes;
+    for(unsigned i = 0; i < numNodes; ++i) {
+      nodes.push_back(d_nm->mkSkolem("x", *d_booleanType));
+    }
+    for(unsigned i = 0; i < numNodes; ++i) {
+      nodes[i].setAttribute(TestNodeAttr(), nodes[numNodes - 1 - i]);
+      nodes[i].setAttribute(TestDenseNodeAttr(), nodes[numNodes - 1 - i]);
+      if(i % 3 == 0) {
+        nodes[i].setAttribute(TestFlag5(), true);
+        nodes[i].setAttribute(TestDenseFlag(), true);
+      }
+    }
+    for(unsigned i = 0; i < numNodes; ++i) {
+      TS_ASSERT_EQUALS(nodes[i].getAttribute(TestDenseNodeAttr()),
+                       nodes[i].getAttribute(TestNodeAttr()));
+      TS_ASSERT_EQUALS(nodes[i].getAttribute(TestDenseFlag()),
+                       nodes[i].getAttribute(TestFlag5()));
+    }
   }
 
   void testAttributes() {
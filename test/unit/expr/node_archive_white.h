@@ -0,0 +1,199 @@
+/*********************                                                        */
+/*! \file node_archive_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::expr::NodeArchiveWriter and
+ ** NodeArchiveReader.
+ **
+ ** White box testing of CVC4::expr::NodeArchiveWriter and
+ ** NodeArchiveReader.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/exception.h"
+#include "expr/node.h"
+#include "expr/node_archive.h"
+#include "expr/node_manager.h"
+#include "util/bitvector.h"
+#include "util/rational.h"
+#include "util/regexp.h"
+
+using namespace CVC4;
+using namespace CVC4::expr;
+using namespace CVC4::kind;
+using namespace std;
+
+class NodeArchiveWhite : public CxxTest::TestSuite {
+
+  NodeManager* d_from;
+  NodeManager* d_to;
+
+  /** Copy an archive into suitably aligned storage. */
+  static vector<uint64_t> toBuffer(const string& s) {
+    vector<uint64_t> buffer(s.size() / sizeof(uint64_t) + 1);
+    s.copy(reinterpret_cast<char*>(&buffer[0]), s.size());
+    return buffer;
+  }
+
+public:
+
+  void setUp() {
+    d_from = new NodeManager(NULL);
+    d_to = new NodeManager(NULL);
+  }
+
+  void tearDown() {
+    delete d_to;
+    delete d_from;
+  }
+
+  void testRoundTrip() {
+    vector<string> printed, printedTypes;
+    stringstream archive;
+    {
+      NodeManagerScope nms(d_from);
+      NodeManager* nm = d_from;
+      int flags = NodeManager::SKOLEM_EXACT_NAME;
+      TypeNode u = nm->mkSort("U");
+      TypeNode bv8 = nm->mkBitVectorType(8);
+      Node x = nm->mkSkolem("x", u, "", flags);
+      Node y = nm->mkSkolem("y", u, "", flags);
+      Node f = nm->mkSkolem("f", nm->mkFunctionType(u, u), "", flags);
+      Node a = nm->mkSkolem("a", bv8, "", flags);
+      Node i = nm->mkSkolem("i", nm->integerType(), "", flags);
+      Node s = nm->mkSkolem("s", nm->stringType(), "", flags);
+
+      vector<Node> roots;
+      roots.push_back(nm->mkNode(EQUAL,
+                                 nm->mkNode(APPLY_UF, f,
+                                            nm->mkNode(APPLY_UF, f, x)),
+                                 y));
+      roots.push_back(nm->mkNode(EQUAL,
+                                 nm->mkNode(BITVECTOR_PLUS, a,
+                                            nm->mkConst(BitVector(8, 3u))),
+                                 nm->mkNode(nm->mkConst(BitVectorExtract(7, 0)),
+                                            a)));
+      roots.push_back(nm->mkNode(LEQ,
+                                 nm->mkNode(MULT,
+                                            nm->mkConst(Rational(-3, 4)), i),
+                                 nm->mkConst(Rational(1000000007))));
+      roots.push_back(nm->mkNode(EQUAL, s, nm->mkConst(String("abc"))));
+      roots.push_back(nm->mkNode(AND, roots[0], nm->mkConst(true)));
+
+      NodeArchiveWriter writer;
+      for(size_t k = 0; k < roots.size(); ++k) {
+        TS_ASSERT_EQUALS(writer.addRoot(roots[k]), k);
+        printed.push_back(roots[k].toString());
+        printedTypes.push_back(roots[k].getType().toString());
+      }
+      writer.write(archive);
+    }
+
+    NodeManagerScope nms(d_to);
+    vector<uint64_t> buffer = toBuffer(archive.str());
+    NodeArchiveReader reader(d_to, reinterpret_cast<const char*>(&buffer[0]),
+                             archive.str().size());
+    TS_ASSERT_EQUALS(reader.getNumRoots(), printed.size());
+    vector<Node> loaded;
+    reader.load(loaded);
+    TS_ASSERT_EQUALS(loaded.size(), printed.size());
+    for(size_t k = 0; k < loaded.size(); ++k) {
+      TS_ASSERT_EQUALS(loaded[k].toString(), printed[k]);
+      TS_ASSERT_EQUALS(loaded[k].getType().toString(), printedTypes[k]);
+    }
+    // the shared subterm comes back shared
+    TS_ASSERT_EQUALS(loaded[4][0], loaded[0]);
+  }
+
+  void testSharing() {
+    const unsigned depth = 64;
+    stringstream archive;
+    size_t numNodes;
+    {
+      NodeManagerScope nms(d_from);
+      Node x = d_from->mkSkolem("x", d_from->booleanType());
+      Node y = d_from->mkSkolem("y", d_from->booleanType());
+      // tree size 2^depth, DAG size linear in depth
+      Node t = x;
+      for(unsigned k = 0; k < depth; ++k) {
+        t = d_from->mkNode(AND, t, d_from->mkNode(OR, t, y));
+      }
+      NodeArchiveWriter writer;
+      writer.addRoot(t);
+      writer.addRoot(t[0]);
+      numNodes = writer.getNumNodes();
+      // x, y, their shared type, and two nodes per level
+      TS_ASSERT_EQUALS(numNodes, 3 + 2 * depth);
+      writer.write(archive);
+    }
+
+    NodeManagerScope nms(d_to);
+    vector<uint64_t> buffer = toBuffer(archive.str());
+    NodeArchiveReader reader(d_to, reinterpret_cast<const char*>(&buffer[0]),
+                             archive.str().size());
+    TS_ASSERT_EQUALS(reader.getNumNodes(), numNodes);
+    vector<Node> loaded;
+    reader.load(loaded);
+    TS_ASSERT_EQUALS(loaded.size(), 2u);
+    TS_ASSERT_EQUALS(loaded[0][0], loaded[1]);
+    TS_ASSERT_EQUALS(loaded[0][1][0], loaded[1]);
+  }
+
+  void testDeepTerm() {
+    const unsigned depth = 200000;
+    stringstream archive;
+    {
+      NodeManagerScope nms(d_from);
+      Node t = d_from->mkSkolem("x", d_from->booleanType());
+      for(unsigned k = 0; k < depth; ++k) {
+        t = d_from->mkNode(NOT, t);
+      }
+      NodeArchiveWriter writer;
+      writer.addRoot(t);
+      writer.write(archive);
+    }
+
+    NodeManagerScope nms(d_to);
+    vector<uint64_t> buffer = toBuffer(archive.str());
+    NodeArchiveReader reader(d_to, reinterpret_cast<const char*>(&buffer[0]),
+                             archive.str().size());
+    vector<Node> loaded;
+    reader.load(loaded);
+    TS_ASSERT_EQUALS(loaded.size(), 1u);
+    TS_ASSERT_EQUALS(loaded[0].getKind(), NOT);
+  }
+
+  void testCorrupt() {
+    stringstream archive;
+    {
+      NodeManagerScope nms(d_from);
+      Node x = d_from->mkSkolem("x", d_from->booleanType());
+      NodeArchiveWriter writer;
+      writer.addRoot(d_from->mkNode(NOT, x));
+      writer.write(archive);
+    }
+
+    NodeManagerScope nms(d_to);
+    string s = archive.str();
+    vector<uint64_t> buffer = toBuffer(s);
+    const char* data = reinterpret_cast<const char*>(&buffer[0]);
+    // truncated
+    TS_ASSERT_THROWS(NodeArchiveReader(d_to, data, s.size() - 8), Exception);
+    TS_ASSERT_THROWS(NodeArchiveReader(d_to, data, 4), Exception);
+    // bad magic
+    reinterpret_cast<char*>(&buffer[0])[0] = 'X';
+    TS_ASSERT_THROWS(NodeArchiveReader(d_to, data, s.size()), Exception);
+  }
+};
@@ -16,9 +16,12 @@
 
 #include <cxxtest/TestSuite.h>
 
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "expr/node_manager.h"
+#include "expr/node_manager_attributes.h"
 #include "util/integer.h"
 #include "util/rational.h"
 
@@ -49,6 +52,54 @@ public:
     TS_ASSERT_EQUALS(n.getId(), m.getId());
   }
 
+  void testReservePool() {
+    Node x = d_nm->mkSkolem("x", d_nm->booleanType());
+    Node n = d_nm->mkNode(kind::NOT, x);
+    size_t size = d_nm->poolSize();
+    d_nm->reservePool(100000);
+    TS_ASSERT_EQUALS(d_nm->poolSize(), size);
+    TS_ASSERT_EQUALS(d_nm->mkNode(kind::NOT, x), n);
+  }
+
+  void testCheckTypes() {
+    Node x = d_nm->mkSkolem("x", d_nm->booleanType());
+    Node y = d_nm->mkSkolem("y", d_nm->booleanType());
+    // a DAG with exponentially many paths
+    Node dag = x;
+    for(unsigned k = 0; k < 64; ++k) {
+      dag = d_nm->mkNode(kind::AND, dag, d_nm->mkNode(kind::OR, dag, y));
+    }
+    // and a deep one
+    Node deep = y;
+    for(unsigned k = 0; k < 200000; ++k) {
+      deep = d_nm->mkNode(kind::NOT, deep);
+    }
+    std::vector<TNode> nodes;
+    nodes.push_back(dag);
+    nodes.push_back(deep);
+    nodes.push_back(dag[1]);
+    d_nm->checkTypes(nodes);
+    TS_ASSERT(d_nm->getAttribute(dag, TypeCheckedAttr()));
+    TS_ASSERT(d_nm->getAttribute(dag[0][0][1], TypeCheckedAttr()));
+    TS_ASSERT(d_nm->getAttribute(deep, TypeCheckedAttr()));
+    TS_ASSERT(d_nm->getAttribute(deep[0][0][0], TypeCheckedAttr()));
+    TS_ASSERT_EQUALS(deep.getType(true), d_nm->booleanType());
+    TS_ASSERT(d_nm->d_typeCheckStack.empty());
+
+    // an ill-typed node (unless early type checking catches it already)
+    Node i = d_nm->mkSkolem("i", d_nm->integerType());
+    Node bad;
+    try {
+      bad = d_nm->mkNode(kind::AND, x, d_nm->mkNode(kind::NOT, i));
+    } catch(TypeCheckingExceptionPrivate&) {
+    }
+    if(!bad.isNull()) {
+      nodes.push_back(bad);
+      TS_ASSERT_THROWS(d_nm->checkTypes(nodes), TypeCheckingExceptionPrivate);
+      TS_ASSERT(d_nm->d_typeCheckStack.empty());
+    }
+  }
+
   void testOversizedNodeBuilder() {
     NodeBuilder<> nb;
 
@@ -0,0 +1,121 @@
+/*********************                                                        */
+/*! \file node_value_allocator_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::expr::NodeValueAllocator.
+ **
+ ** White box testing of CVC4::expr::NodeValueAllocator.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <vector>
+
+#include "expr/node.h"
+#include "expr/node_manager.h"
+#include "expr/node_value_allocator.h"
+
+using namespace CVC4;
+using namespace CVC4::expr;
+using namespace CVC4::kind;
+using namespace std;
+
+class NodeValueAllocatorWhite : public CxxTest::TestSuite {
+
+  NodeManager* d_nm;
+  NodeManagerScope* d_scope;
+
+public:
+
+  void setUp() {
+    d_nm = new NodeManager(NULL);
+    d_scope = new NodeManagerScope(d_nm);
+  }
+
+  void tearDown() {
+    delete d_scope;
+    delete d_nm;
+  }
+
+  void testRecycle() {
+    NodeValueAllocator a;
+    NodeValue* nv = a.allocate(2);
+    nv->d_nchildren = 2;
+    a.deallocate(nv);
+    TS_ASSERT_EQUALS(a.allocate(2), nv);
+    TS_ASSERT_DIFFERS(a.allocate(3), nv);
+  }
+
+  void testLargeNodes() {
+    NodeValueAllocator a;
+    unsigned n = NodeValueAllocator::MAX_SLAB_CHILDREN + 1;
+    NodeValue* nv = a.allocate(n);
+    nv->d_nchildren = n;
+    TS_ASSERT_EQUALS(a.getSlabBytes(), 0u);
+    a.deallocate(nv);
+  }
+
+  void testBatch() {
+    NodeValueAllocator a;
+    vector<NodeValue*> batch;
+    for(unsigned i = 0; i < 10000; ++i) {
+      unsigned n = i % (NodeValueAllocator::MAX_SLAB_CHILDREN + 3);
+      NodeValue* nv = a.allocate(n);
+      nv->d_nchildren = n;
+      batch.push_back(nv);
+    }
+    size_t slabBytes = a.getSlabBytes();
+    a.deallocate(batch);
+    TS_ASSERT(batch.empty());
+    for(unsigned i = 0; i < 10000; ++i) {
+      unsigned n = i % (NodeValueAllocator::MAX_SLAB_CHILDREN + 3);
+      batch.push_back(a.allocate(n));
+      batch.back()->d_nchildren = n;
+    }
+    // everything came off the free lists
+    TS_ASSERT_EQUALS(a.getSlabBytes(), slabBytes);
+    a.deallocate(batch);
+  }
+
+  void testConstructionAndCollection() {
+    const unsigned numVars = 64;
+    const unsigned numNodes = 200000;
+
+    vector<Node> vars;
+    for(unsigned i = 0; i < numVars; ++i) {
+      vars.push_back(d_nm->mkSkolem("x", d_nm->booleanType()));
+    }
+    size_t baseline = d_nm->poolSize();
+    size_t slabBytes = 0;
+
+    for(unsigned round = 0; round < 2; ++round) {
+      vector<Node> nodes;
+      nodes.reserve(numNodes);
+      for(unsigned i = 0; i < numNodes; ++i) {
+        nodes.push_back(d_nm->mkNode(AND,
+                                     vars[i % numVars],
+                                     vars[(i / numVars) % numVars],
+                                     vars[(i / (numVars * numVars)) % numVars]));
+      }
+      TS_ASSERT_EQUALS(d_nm->poolSize(), baseline + numNodes);
+
+      nodes.clear();
+      d_nm->reclaimAllZombies();
+      TS_ASSERT_EQUALS(d_nm->poolSize(), baseline);
+
+      // the second round reuses the blocks freed by the first
+      if(round == 0) {
+        slabBytes = d_nm->d_nvAllocator.getSlabBytes();
+      } else {
+        TS_ASSERT_EQUALS(d_nm->d_nvAllocator.getSlabBytes(), slabBytes);
+      }
+    }
+  }
+};
@@ -22,6 +22,7 @@
 #include "context/context.h"
 #include "expr/expr_manager.h"
 #include "expr/node_manager.h"
+#include "prop/aig_cnf_stream.h"
 #include "prop/cnf_stream.h"
 #include "prop/prop_engine.h"
 #include "prop/theory_proxy.h"
@@ -45,9 +46,10 @@ using namespace std;
 class FakeSatSolver : public SatSolver {
   SatVariable d_nextVar;
   bool d_addClauseCalled;
+  unsigned d_numClauses;
 
  public:
-  FakeSatSolver() : d_nextVar(0), d_addClauseCalled(false) {}
+  FakeSatSolver() : d_nextVar(0), d_addClauseCalled(false), d_numClauses(0) {}
 
   SatVariable newVar(bool theoryAtom, bool preRegister, bool canErase) {
     return d_nextVar++;
@@ -59,6 +61,7 @@ class FakeSatSolver : public SatSolver {
 
   ClauseId addClause(SatClause& c, bool lemma) {
     d_addClauseCalled = true;
+    ++d_numClauses;
     return ClauseIdUndef;
   }
 
@@ -73,6 +76,8 @@ class FakeSatSolver : public SatSolver {
 
   unsigned int addClauseCalled() { return d_addClauseCalled; }
 
+  unsigned numClauses() const { return d_numClauses; }
+
   unsigned getAssertionLevel() const { return 0; }
 
   bool isDecision(Node) const { return false; }
@@ -282,4 +287,85 @@ class CnfStreamWhite : public CxxTest::TestSuite {
     TS_ASSERT(d_satSolver->addClauseCalled());
     TS_ASSERT(d_cnfStream->hasLiteral(a_and_b));
   }
+
+  void testAigXor() {
+    NodeManagerScope nms(d_nodeManager);
+    AigCnfStream aig(d_satSolver, d_cnfRegistrar, d_cnfContext);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_xor_b = d_nodeManager->mkNode(kind::XOR, a, b);
+    aig.ensureLiteral(a_xor_b);
+    TS_ASSERT(aig.hasLiteral(a_xor_b));
+    // the XOR gate is detected: 4 clauses, not 3 gates
+    TS_ASSERT_EQUALS(d_satSolver->numClauses(), 4u);
+  }
+
+  void testAigStructuralHashing() {
+    NodeManagerScope nms(d_nodeManager);
+    AigCnfStream aig(d_satSolver, d_cnfRegistrar, d_cnfContext);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_and_b = d_nodeManager->mkNode(kind::AND, a, b);
+    Node not_a_or_not_b =
+        d_nodeManager->mkNode(kind::OR, a.notNode(), b.notNode());
+    aig.ensureLiteral(a_and_b);
+    unsigned clauses = d_satSolver->numClauses();
+    TS_ASSERT_EQUALS(clauses, 3u);
+    aig.ensureLiteral(not_a_or_not_b);
+    TS_ASSERT_EQUALS(d_satSolver->numClauses(), clauses);
+    TS_ASSERT_EQUALS(aig.getLiteral(not_a_or_not_b), ~aig.getLiteral(a_and_b));
+    TS_ASSERT_EQUALS(aig.getNumGates(), 3u);
+  }
+
+  void testAigPolarity() {
+    NodeManagerScope nms(d_nodeManager);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node c = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_and_b = d_nodeManager->mkNode(kind::AND, a, b);
+    Node n = d_nodeManager->mkNode(kind::OR, a_and_b, c);
+    {
+      AigCnfStream aig(d_satSolver, d_cnfRegistrar, d_cnfContext);
+      aig.convertAndAssert(n, false, false, RULE_INVALID, Node::null());
+      // (g | c), (~g | a), (~g | b), (g | ~a | ~b)
+      TS_ASSERT_EQUALS(d_satSolver->numClauses(), 4u);
+      TS_ASSERT(aig.hasLiteral(a_and_b));
+    }
+    unsigned clauses = d_satSolver->numClauses();
+    context::Context context;
+    AigCnfStream aig(d_satSolver, d_cnfRegistrar, &context, true);
+    aig.convertAndAssert(n, false, false, RULE_INVALID, Node::null());
+    // (g | c), (~g | a), (~g | b)
+    TS_ASSERT_EQUALS(d_satSolver->numClauses() - clauses, 3u);
+    // a_and_b only implies its gate's literal, so it's not visible
+    TS_ASSERT(!aig.hasLiteral(a_and_b));
+    aig.ensureLiteral(a_and_b);
+    TS_ASSERT_EQUALS(d_satSolver->numClauses() - clauses, 4u);
+    TS_ASSERT(aig.hasLiteral(a_and_b));
+  }
+
+  void testAigFolding() {
+    NodeManagerScope nms(d_nodeManager);
+    AigCnfStream aig(d_satSolver, d_cnfRegistrar, d_cnfContext);
+    Node a = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node b = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node c = d_nodeManager->mkVar(d_nodeManager->booleanType());
+    Node a_and_not_b = d_nodeManager->mkNode(kind::AND, a, b.notNode());
+    Node a_implies_b = d_nodeManager->mkNode(kind::IMPLIES, a, b);
+    // (a & ~b) | (a => b) folds to true, and n to c
+    Node t = d_nodeManager->mkNode(kind::OR, a_and_not_b, a_implies_b);
+    Node n = d_nodeManager->mkNode(kind::AND, t, c);
+    aig.convertAndAssert(n, false, false, RULE_INVALID, Node::null());
+    // the justification heuristic walks the formula, not the graph, so
+    // everything in it has a literal with its value
+    TS_ASSERT(aig.hasLiteral(n));
+    TS_ASSERT_EQUALS(aig.getLiteral(n), aig.getLiteral(c));
+    TS_ASSERT(aig.hasLiteral(t));
+    TS_ASSERT(aig.hasLiteral(a_and_not_b));
+    TS_ASSERT(aig.hasLiteral(a_implies_b));
+    TS_ASSERT_EQUALS(aig.getLiteral(a_implies_b),
+                     ~aig.getLiteral(a_and_not_b));
+    TS_ASSERT(aig.hasLiteral(a));
+    TS_ASSERT(aig.hasLiteral(b));
+  }
 };
@@ -0,0 +1,181 @@
+/*********************                                                        */
+/*! \file rewrite_memo_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::RewriteMemo.
+ **
+ ** White box testing of CVC4::theory::RewriteMemo, and of its use by
+ ** the Rewriter.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+
+#include "expr/node.h"
+#include "expr/node_manager.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+#include "theory/rewrite_memo.h"
+#include "theory/rewriter.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::smt;
+using namespace CVC4::theory;
+
+class RewriteMemoWhite : public CxxTest::TestSuite {
+  ExprManager* d_em;
+  NodeManager* d_nm;
+  SmtEngine* d_smt;
+  SmtScope* d_scope;
+  string d_filename;
+
+ public:
+  void setUp() {
+    d_em = new ExprManager();
+    d_nm = NodeManager::fromExprManager(d_em);
+    d_smt = new SmtEngine(d_em);
+    d_scope = new SmtScope(d_smt);
+
+    char filename[] = "/tmp/rewrite_memo_white.XXXXXX";
+    int fd = mkstemp(filename);
+    TS_ASSERT_DIFFERS(fd, -1);
+    close(fd);
+    d_filename = filename;
+  }
+
+  void tearDown() {
+    Rewriter::setRewriteMemo(NULL);
+    unlink(d_filename.c_str());
+    delete d_scope;
+    delete d_smt;
+    delete d_em;
+  }
+
+  /** (x and y) or not (x and y), which rewrites to true. */
+  Node mkTautology(Node x, Node y) {
+    Node conj = d_nm->mkNode(kind::AND, x, y);
+    return d_nm->mkNode(kind::OR, conj, conj.notNode());
+  }
+
+  void testAlphaRenamedHit() {
+    RewriteMemo memo(d_nm, "fingerprint");
+    Rewriter::setRewriteMemo(&memo);
+    TypeNode boolType = d_nm->booleanType();
+    Node x = d_nm->mkVar("x", boolType);
+    Node y = d_nm->mkVar("y", boolType);
+    Node u = d_nm->mkVar("u", boolType);
+    Node v = d_nm->mkVar("v", boolType);
+
+    TS_ASSERT_EQUALS(Rewriter::rewrite(mkTautology(x, y)),
+                     d_nm->mkConst(true));
+    TS_ASSERT_EQUALS(memo.size(), 1u);
+    TS_ASSERT_EQUALS(memo.d_misses.getData(), 1);
+
+    TS_ASSERT_EQUALS(Rewriter::rewrite(mkTautology(u, v)),
+                     d_nm->mkConst(true));
+    TS_ASSERT_EQUALS(memo.d_hits.getData(), 1);
+    TS_ASSERT_EQUALS(memo.size(), 1u);
+
+    // a different variable order is a different entry
+    TS_ASSERT_EQUALS(Rewriter::rewrite(mkTautology(v, u)),
+                     d_nm->mkConst(true));
+    TS_ASSERT_EQUALS(memo.d_hits.getData(), 1);
+    TS_ASSERT_EQUALS(memo.size(), 2u);
+  }
+
+  void testInstantiation() {
+    RewriteMemo memo(d_nm, "fingerprint");
+    TypeNode bvType = d_nm->mkBitVectorType(8);
+    Node x = d_nm->mkVar("x", bvType);
+    Node y = d_nm->mkVar("y", bvType);
+    Node u = d_nm->mkVar("u", bvType);
+    Node v = d_nm->mkVar("v", bvType);
+
+    memo.record(d_nm->mkNode(kind::BITVECTOR_AND, x, y),
+                d_nm->mkNode(kind::BITVECTOR_AND, y, x));
+    TS_ASSERT_EQUALS(memo.lookup(d_nm->mkNode(kind::BITVECTOR_AND, u, v)),
+                     d_nm->mkNode(kind::BITVECTOR_AND, v, u));
+    TS_ASSERT(memo.lookup(d_nm->mkNode(kind::BITVECTOR_OR, u, v)).isNull());
+    TS_ASSERT(memo.lookup(d_nm->mkNode(kind::BITVECTOR_AND, u, u)).isNull());
+
+    // a rewrite introducing a variable is not recorded
+    memo.record(d_nm->mkNode(kind::BITVECTOR_OR, x, x),
+                d_nm->mkNode(kind::BITVECTOR_OR, x, y));
+    TS_ASSERT_EQUALS(memo.size(), 1u);
+  }
+
+  void testRejectedCandidate() {
+    RewriteMemo memo(d_nm, "fingerprint");
+    Rewriter::setRewriteMemo(&memo);
+    TypeNode boolType = d_nm->booleanType();
+    Node x = d_nm->mkVar("x", boolType);
+    Node y = d_nm->mkVar("y", boolType);
+    Node u = d_nm->mkVar("u", boolType);
+    Node v = d_nm->mkVar("v", boolType);
+
+    // a bogus entry: x and y "rewrites to" a term that isn't normal
+    Node conj = d_nm->mkNode(kind::AND, x, y);
+    memo.record(conj, d_nm->mkNode(kind::AND, conj, d_nm->mkConst(true)));
+
+    Node uv = d_nm->mkNode(kind::AND, u, v);
+    TS_ASSERT_EQUALS(Rewriter::rewrite(uv), uv);
+    TS_ASSERT_EQUALS(memo.d_rejected.getData(), 1);
+    TS_ASSERT_EQUALS(memo.d_hits.getData(), 0);
+
+    // the entry was replaced by the real rewrite
+    TS_ASSERT_EQUALS(memo.lookup(conj), conj);
+  }
+
+  void testSaveAndLoad() {
+    TypeNode intType = d_nm->integerType();
+    TypeNode bvType = d_nm->mkBitVectorType(16);
+    Node x = d_nm->mkVar("x", intType);
+    Node a = d_nm->mkVar("a", bvType);
+    Node f = d_nm->mkVar("f", d_nm->mkFunctionType(intType, intType));
+    Node one = d_nm->mkConst(Rational(1));
+    Node fx = d_nm->mkNode(kind::APPLY_UF, f, x);
+    Node n1 = d_nm->mkNode(kind::PLUS, fx, one);
+    Node n2 = d_nm->mkNode(kind::BITVECTOR_NOT,
+                           d_nm->mkNode(kind::BITVECTOR_NOT, a));
+    {
+      RewriteMemo memo(d_nm, "fingerprint");
+      memo.record(n1, d_nm->mkNode(kind::PLUS, one, fx));
+      memo.record(n2, a);
+      TS_ASSERT_EQUALS(memo.size(), 2u);
+      memo.save(d_filename);
+    }
+
+    RewriteMemo memo(d_nm, "fingerprint");
+    TS_ASSERT_EQUALS(memo.load(d_filename), 2u);
+    Node y = d_nm->mkVar("y", intType);
+    Node b = d_nm->mkVar("b", bvType);
+    Node g = d_nm->mkVar("g", d_nm->mkFunctionType(intType, intType));
+    Node gy = d_nm->mkNode(kind::APPLY_UF, g, y);
+    TS_ASSERT_EQUALS(memo.lookup(d_nm->mkNode(kind::PLUS, gy, one)),
+                     d_nm->mkNode(kind::PLUS, one, gy));
+    TS_ASSERT_EQUALS(memo.lookup(d_nm->mkNode(
+                         kind::BITVECTOR_NOT,
+                         d_nm->mkNode(kind::BITVECTOR_NOT, b))),
+                     b);
+
+    // under another configuration, nothing is loaded
+    RewriteMemo other(d_nm, "another fingerprint");
+    TS_ASSERT_EQUALS(other.load(d_filename), 0u);
+    TS_ASSERT_EQUALS(other.size(), 0u);
+
+    // and a missing file is an empty memo
+    unlink(d_filename.c_str());
+    TS_ASSERT_EQUALS(other.load(d_filename), 0u);
+  }
+};/* class RewriteMemoWhite */
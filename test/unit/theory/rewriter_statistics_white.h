@@ -0,0 +1,84 @@
+/*********************                                                        */
+/*! \file rewriter_statistics_white.h
+ ** \verbatim
+ ** Top contributors (to current version):
+ **
+ ** This file is part of the CVC4 project.
+ ** Copyright (c) 2009-2018 by the authors listed in the file AUTHORS
+ ** in the top-level source directory) and their institutional affiliations.
+ ** All rights reserved.  See the file COPYING in the top-level source
+ ** directory for licensing information.\endverbatim
+ **
+ ** \brief White box testing of CVC4::theory::RewriterStatistics.
+ **
+ ** White box testing of CVC4::theory::RewriterStatistics, the profile of
+ ** the rewriters kept under --rewrite-profile.
+ **/
+
+#include <cxxtest/TestSuite.h>
+
+#include <sstream>
+#include <string>
+
+#include "expr/node.h"
+#include "expr/node_manager.h"
+#include "smt/smt_engine.h"
+#include "smt/smt_engine_scope.h"
+#include "theory/rewriter.h"
+#include "theory/rewriter_statistics.h"
+
+using namespace std;
+using namespace CVC4;
+using namespace CVC4::smt;
+using namespace CVC4::theory;
+
+class RewriterStatisticsWhite : public CxxTest::TestSuite {
+  ExprManager* d_em;
+  NodeManager* d_nm;
+  SmtEngine* d_smt;
+  SmtScope* d_scope;
+
+ public:
+  void setUp() {
+    d_em = new ExprManager();
+    d_nm = NodeManager::fromExprManager(d_em);
+    d_smt = new SmtEngine(d_em);
+    d_scope = new SmtScope(d_smt);
+  }
+
+  void tearDown() {
+    Rewriter::setStatistics(NULL);
+    delete d_scope;
+    delete d_smt;
+    delete d_em;
+  }
+
+  static string flush(const Stat& stat) {
+    stringstream ss;
+    stat.flushInformation(ss);
+    return ss.str();
+  }
+
+  void testProfile() {
+    RewriterStatistics stats(d_nm);
+    Rewriter::setStatistics(&stats);
+
+    TypeNode bvType = d_nm->mkBitVectorType(8);
+    Node x = d_nm->mkVar("x", bvType);
+    Node notNotX = d_nm->mkNode(
+        kind::BITVECTOR_NOT, d_nm->mkNode(kind::BITVECTOR_NOT, x));
+    TS_ASSERT_EQUALS(Rewriter::rewrite(notNotX), x);
+
+    TS_ASSERT_LESS_THAN(0, stats.d_postCacheMisses.getData());
+    string post = flush(stats.d_postRewrites);
+    TS_ASSERT_DIFFERS(post.find("THEORY_BV BITVECTOR_NOT : "), string::npos);
+    TS_ASSERT_DIFFERS(flush(stats.d_rulesFired).find("theory::bv::NotIdemp"),
+                      string::npos);
+
+    // the second time, it's a cache hit
+    int64_t hits = stats.d_postCacheHits.getData();
+    TS_ASSERT_EQUALS(Rewriter::rewrite(notNotX), x);
+    TS_ASSERT_EQUALS(stats.d_postCacheHits.getData(), hits + 1);
+    TS_ASSERT_EQUALS(flush(stats.d_postRewrites), post);
+  }
+};/* class RewriterStatisticsWhite */
@@ -23,6 +23,7 @@
 #include "smt/smt_engine_scope.h"
 #include "theory/bv/theory_bv.h"
 #include "theory/bv/bitblast/eager_bitblaster.h"
+#include "theory/bv/bv_subtheory_propagation.h"
 #include "expr/node.h"
 #include "expr/node_manager.h"
 #include "context/context.h"
@@ -85,6 +86,72 @@ public:
     delete bb;
   }
 
+  void testBitblastMultiplierChains() {
+    // chains of multipliers give the CNF stream and the SAT solver many small
+    // clauses, which must all get there: the model satisfies each chain
+    d_smt->setOption("bitblast", SExpr("eager"));
+    EagerBitblaster* bb = new EagerBitblaster(dynamic_cast<TheoryBV*>(
+        d_smt->d_theoryEngine->d_theoryTable[THEORY_BV]));
+    const unsigned width = 32;
+    vector<Node> vars;
+    for (unsigned i = 0; i < 8; ++i) {
+      Node x = d_nm->mkSkolem("x", d_nm->mkBitVectorType(width));
+      Node y = d_nm->mkSkolem("y", d_nm->mkBitVectorType(width));
+      Node z = d_nm->mkSkolem("z", d_nm->mkBitVectorType(width));
+      Node xy = d_nm->mkNode(kind::BITVECTOR_MULT, x, y);
+      Node xyz = d_nm->mkNode(kind::BITVECTOR_MULT, xy, z);
+      Node one = d_nm->mkConst<BitVector>(BitVector(width, 1u));
+      bb->bbFormula(d_nm->mkNode(kind::EQUAL, xyz, x));
+      // rules out y = z = 1
+      bb->bbFormula(d_nm->mkNode(kind::NOT, d_nm->mkNode(kind::EQUAL, y, one)));
+      vars.push_back(x);
+      vars.push_back(y);
+      vars.push_back(z);
+    }
+    TS_ASSERT(bb->solve());
+    for (unsigned i = 0; i < vars.size(); i += 3) {
+      BitVector x =
+          bb->getModelFromSatSolver(vars[i], true).getConst<BitVector>();
+      BitVector y =
+          bb->getModelFromSatSolver(vars[i + 1], true).getConst<BitVector>();
+      BitVector z =
+          bb->getModelFromSatSolver(vars[i + 2], true).getConst<BitVector>();
+      TS_ASSERT(x * y * z == x);
+      TS_ASSERT(y != BitVector(width, 1u));
+    }
+    delete bb;
+  }
+
+  void testBitDomain() {
+    // the known bits tighten the interval, and the interval the known bits
+    BitDomain d(8);
+    d.d_known = BitVector(8, 0xf0u);
+    d.d_value = BitVector(8, 0x30u);
+    d.normalize();
+    TS_ASSERT(d.d_lo == BitVector(8, 0x30u));
+    TS_ASSERT(d.d_hi == BitVector(8, 0x3fu));
+
+    BitDomain e(8);
+    e.d_lo = BitVector(8, 0x34u);
+    e.d_hi = BitVector(8, 0x37u);
+    e.normalize();
+    TS_ASSERT(e.d_known == BitVector(8, 0xfcu));
+    TS_ASSERT(e.d_value == BitVector(8, 0x34u));
+
+    d.meet(e);
+    TS_ASSERT(!d.isEmpty());
+    TS_ASSERT(d.d_lo == BitVector(8, 0x34u));
+    TS_ASSERT(d.d_hi == BitVector(8, 0x37u));
+
+    BitDomain f(BitVector(8, 0x36u));
+    d.meet(f);
+    TS_ASSERT(d.isFixed());
+    TS_ASSERT(d.d_value == BitVector(8, 0x36u));
+
+    d.meet(BitDomain(BitVector(8, 0x35u)));
+    TS_ASSERT(d.isEmpty());
+  }
+
   void testMkUmulo() {
     d_smt->setOption("incremental", SExpr("true"));
     for (size_t w = 1; w < 16; ++w) {
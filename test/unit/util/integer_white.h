@@ -51,4 +51,78 @@ public:
                      Integer((unsigned long)u_above2tothe29));
 
   }
+
+  // Around 2^63, where the representation of the value changes
+  void testSmallValueBoundaries(){
+    const Integer max("9223372036854775807"); // 2^63 - 1
+    const Integer big = max + 1;
+
+    TS_ASSERT_EQUALS(big.toString(), "9223372036854775808");
+    TS_ASSERT_EQUALS(big - 1, max);
+    TS_ASSERT_EQUALS((-max - 1).toString(), "-9223372036854775808");
+    TS_ASSERT_EQUALS(-max - 1, -big);
+    TS_ASSERT_EQUALS((max * 2).toString(), "18446744073709551614");
+    TS_ASSERT_EQUALS((max * 2).floorDivideQuotient(2), max);
+    TS_ASSERT(max < big);
+    TS_ASSERT(-big < -max);
+    TS_ASSERT(Integer(0) < big);
+    TS_ASSERT(-big < Integer(0));
+    TS_ASSERT_EQUALS(big.length(), 64u);
+    TS_ASSERT_EQUALS(max.length(), 63u);
+    TS_ASSERT_EQUALS(big.isPow2(), 64u);
+    TS_ASSERT_EQUALS(Integer(64).isPow2(), 7u);
+    TS_ASSERT(max.testBit(62));
+    TS_ASSERT(!max.testBit(63));
+    TS_ASSERT(Integer(-1).testBit(100));
+    TS_ASSERT_EQUALS(big.gcd(max + 3), Integer(2));
+    TS_ASSERT_EQUALS(Integer(-12).gcd(Integer(18)), Integer(6));
+    TS_ASSERT_EQUALS(Integer(-7).floorDivideQuotient(2), Integer(-4));
+    TS_ASSERT_EQUALS(Integer(-7).floorDivideRemainder(2), Integer(1));
+    TS_ASSERT_EQUALS(Integer(-7).ceilingDivideQuotient(2), Integer(-3));
+    TS_ASSERT_EQUALS(Integer(-7).ceilingDivideRemainder(2), Integer(-1));
+    TS_ASSERT_EQUALS(Integer(-5).modByPow2(3), Integer(3));
+    TS_ASSERT_EQUALS(Integer(-5).divByPow2(1), Integer(-3));
+    TS_ASSERT(Integer(3).divides(max + 2));
+    TS_ASSERT(!Integer(0).divides(Integer(5)));
+
+    Integer i = max;
+    i += 1;
+    TS_ASSERT_EQUALS(i, big);
+    i -= 1;
+    TS_ASSERT_EQUALS(i, max);
+    TS_ASSERT_EQUALS(i.hash(), max.hash());
+    TS_ASSERT(i.fitsSignedLong() || sizeof(long) < 8);
+    TS_ASSERT(!big.fitsSignedLong());
+  }
+
+  void testBitwiseBoundaries(){
+    const Integer max("9223372036854775807"); // 2^63 - 1
+    const Integer min = -max - 1;
+
+    TS_ASSERT_EQUALS(max.bitwiseNot(), min);
+    TS_ASSERT_EQUALS(max.bitwiseNot().toString(), "-9223372036854775808");
+    TS_ASSERT_EQUALS(-max.bitwiseNot(), max + 1);
+    TS_ASSERT_EQUALS(max.bitwiseNot().hash(), min.hash());
+    TS_ASSERT_EQUALS((-max).bitwiseAnd(Integer(-2)), min);
+    TS_ASSERT_EQUALS(-(-max).bitwiseAnd(Integer(-2)), max + 1);
+    TS_ASSERT_EQUALS(max.bitwiseXor(Integer(-1)), min);
+    TS_ASSERT_EQUALS(max.bitwiseXor(Integer(-1)) + 1, -max);
+    TS_ASSERT_EQUALS(min.bitwiseNot(), max);
+    TS_ASSERT_EQUALS(min.bitwiseOr(Integer(1)), -max);
+    TS_ASSERT_EQUALS(min.bitwiseAnd(max), Integer(0));
+
+    const Integer values[] = { Integer(0), Integer(1), Integer(-1),
+                               Integer(-2), max, max - 1, -max, -max + 1,
+                               min, max + 1, Integer(1).multiplyByPow2(62),
+                               -Integer(1).multiplyByPow2(62) };
+    for(const Integer& x : values) {
+      TS_ASSERT_EQUALS(x.bitwiseNot(), -x - 1);
+      for(const Integer& y : values) {
+        Integer o = x.bitwiseOr(y), a = x.bitwiseAnd(y), e = x.bitwiseXor(y);
+        TS_ASSERT_EQUALS(o + a, x + y);
+        TS_ASSERT_EQUALS(o - a, e);
+        TS_ASSERT_EQUALS(e.bitwiseXor(y), x);
+      }
+    }
+  }
 };
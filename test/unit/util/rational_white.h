@@ -441,4 +441,43 @@ public:
                      Rational((unsigned long)u_above2tothe29));
 
   }
+
+  void testSmallValueBoundaries(){
+    const Integer max("9223372036854775807"); // 2^63 - 1
+    const Rational big(max + 1);
+    const Rational bigger(max + 1, Integer(3));
+    const Rational small(max);
+
+    TS_ASSERT_EQUALS((small + Rational(1)).toString(), "9223372036854775808");
+    TS_ASSERT_EQUALS(small + Rational(1), big);
+    TS_ASSERT_EQUALS(big - Rational(1), small);
+    TS_ASSERT_EQUALS((-small - Rational(1)).toString(), "-9223372036854775808");
+    TS_ASSERT_EQUALS(-small - Rational(1), -big);
+    TS_ASSERT_EQUALS((small * Rational(2)) / Rational(2), small);
+    TS_ASSERT_EQUALS((bigger * Rational(3)), big);
+    TS_ASSERT_EQUALS((bigger / big).toString(), "1/3");
+    TS_ASSERT_EQUALS(Rational(1, 3) * Rational(3, 1), Rational(1));
+    TS_ASSERT(bigger < big);
+    TS_ASSERT(small < big);
+    TS_ASSERT(-big < -small);
+    TS_ASSERT_EQUALS(big.cmp(small), 1);
+    TS_ASSERT_EQUALS(small.inverse().inverse(), small);
+    TS_ASSERT_EQUALS(big.inverse().getDenominator(), max + 1);
+
+    Rational q(small);
+    q += Rational(1, 2);
+    TS_ASSERT_EQUALS(q.toString(), "18446744073709551615/2");
+    TS_ASSERT_EQUALS(q.floor(), max);
+    TS_ASSERT_EQUALS(q.ceiling(), max + 1);
+    q -= Rational(1, 2);
+    TS_ASSERT_EQUALS(q, small);
+    TS_ASSERT_EQUALS(q.hash(), small.hash());
+
+    TS_ASSERT_EQUALS(Rational(-7, 2).floor(), Integer(-4));
+    TS_ASSERT_EQUALS(Rational(-7, 2).ceiling(), Integer(-3));
+    TS_ASSERT_EQUALS(Rational(6, -4).toString(), "-3/2");
+    TS_ASSERT_EQUALS(Rational(1, 6) + Rational(1, 3), Rational(1, 2));
+    TS_ASSERT_EQUALS(Rational(1, 6) - Rational(1, 6), Rational(0));
+    TS_ASSERT(Rational(1, 6) - Rational(1, 6) == 0);
+  }
 };